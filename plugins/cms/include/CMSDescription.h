@@ -0,0 +1,58 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_CMS_DESCRIPTION_H
+#define NEURALA_CMS_DESCRIPTION_H
+
+#include <string>
+#include <vector>
+
+namespace neurala::plug::cms
+{
+/**
+ * @brief Characteristics of a CMS camera, as described by its XML file in ResourcesCMS.
+ */
+struct CMSDescription
+{
+	std::string siliosSN;
+	/// Central wavelength of each band, in nanometers.
+	std::vector<double> filterCentering;
+	/// Full width at half maximum of each band, in nanometers.
+	std::vector<double> filterFWHM;
+	/// Bands by bands crosstalk correction matrix, in row-major order.
+	std::vector<double> crosstalkCorrectionCoefficients;
+
+	/// Returns the number of spectral bands.
+	std::size_t bands() const noexcept { return filterCentering.size(); }
+};
+
+/**
+ * @brief Reads the description of a camera from the XML file at @p path.
+ *
+ * @return true if the file could be read and describes at least one band
+ */
+bool loadDescription(const std::string& path, CMSDescription& description);
+
+/**
+ * @brief Returns the path of the XML file describing the camera with serial number @p serialNumber.
+ */
+std::string descriptionPath(const std::string& serialNumber);
+
+} // namespace neurala::plug::cms
+
+#endif // NEURALA_CMS_DESCRIPTION_H
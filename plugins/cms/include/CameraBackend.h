@@ -0,0 +1,97 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_CMS_CAMERA_BACKEND_H
+#define NEURALA_CMS_CAMERA_BACKEND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace neurala::plug::cms
+{
+/**
+ * @brief 8-bit image owned by a backend, with interleaved channels.
+ *
+ * It stays valid until the next frame is latched.
+ */
+struct BackendImage
+{
+	const std::uint8_t* data = nullptr;
+	std::size_t width = 0;
+	std::size_t height = 0;
+	/// Distance between two rows in bytes.
+	std::size_t stride = 0;
+	std::size_t channels = 0;
+};
+
+/**
+ * @brief Access to a CMS camera, either through the CMS library or simulated.
+ *
+ * The backend acquires raw mosaic frames on its own thread and signals each of them through the
+ * event handler. The images are computed on demand, on the thread of the caller, from the latched
+ * frame.
+ */
+class CameraBackend
+{
+public:
+	using EventHandler = std::function<void()>;
+
+	virtual ~CameraBackend() = default;
+
+	/// Returns the serial number of the camera, which names its description in ResourcesCMS.
+	virtual std::string serialNumber() const = 0;
+
+	/// Returns the model of the camera.
+	virtual std::string cameraType() const = 0;
+
+	/**
+	 * @brief Sets the function called, on a thread of the backend, each time a raw frame is acquired.
+	 *
+	 * The previous function is not called anymore once this returns.
+	 */
+	virtual void setEventHandler(EventHandler handler) = 0;
+
+	/// Latches the newest acquired raw frame, from which the images below are computed.
+	virtual void latchFrame() = 0;
+
+	/// Returns the latched raw mosaic frame, with a single channel.
+	virtual BackendImage raw() = 0;
+
+	/// Computes the band-interleaved multispectral cube of the latched frame.
+	virtual BackendImage cube() = 0;
+
+	/// Computes the BGR display image of the latched frame, once its cube has been computed.
+	virtual BackendImage display() = 0;
+};
+
+#ifdef NEURALA_CMS_VENDOR_BACKEND
+/**
+ * @brief Opens the camera through the CMS library.
+ *
+ * The frame rate and gain are set from NeuralaCMSOverrides.json, which the library would otherwise
+ * reset on connection.
+ */
+std::unique_ptr<CameraBackend> openVendorBackend();
+#endif
+
+} // namespace neurala::plug::cms
+
+#endif // NEURALA_CMS_CAMERA_BACKEND_H
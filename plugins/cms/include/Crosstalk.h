@@ -0,0 +1,104 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_CMS_CROSSTALK_H
+#define NEURALA_CMS_CROSSTALK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "neurala/utils/BlockPool.h"
+
+#include "Simd.h"
+
+namespace neurala::plug::cms
+{
+/**
+ * @brief Corrects the crosstalk between the bands of 8-bit band-interleaved cubes.
+ *
+ * Each pixel of the corrected cube is the product of the correction matrix, as given by
+ * crosstalkCorrectionCoefficients in the description of the camera, and the measured pixel. Rows
+ * are processed in blocks spread over the workers of the shared Executor.
+ */
+class CrosstalkCorrection
+{
+public:
+	/// Implementation of the per-pixel product.
+	using EKernel = cms::EKernel;
+
+	/**
+	 * @brief Constructs a correction from a @p bands by @p bands matrix in row-major order.
+	 *
+	 * @param coefficients correction matrix, where row i gives the weights of the measured bands
+	 *                     in the corrected band i
+	 * @param bands        number of bands of the cubes
+	 * @param threads      number of threads, the number of workers of the shared executor if 0
+	 *
+	 * @throw std::invalid_argument if the size of the matrix does not match @p bands
+	 */
+	CrosstalkCorrection(const std::vector<double>& coefficients, std::size_t bands, std::size_t threads = 0);
+
+	/// Returns the number of bands of the cubes.
+	std::size_t bands() const noexcept { return m_bands; }
+
+	/// Returns the fastest kernel supported by the processor.
+	static EKernel bestKernel() noexcept { return cms::bestKernel(); }
+
+	/// Returns the kernel in use.
+	EKernel kernel() const noexcept { return m_kernel; }
+
+	/// Selects the kernel in use, falling back to a slower one if the processor lacks support.
+	void kernel(EKernel kernel) noexcept;
+
+	/**
+	 * @brief Corrects a cube of @p width by @p height pixels.
+	 *
+	 * Corrected values are rounded to the nearest integer and saturated to [0, 255]. The input and
+	 * output may be the same cube.
+	 *
+	 * @param input        measured cube
+	 * @param inputStride  distance between two rows of @p input in bytes
+	 * @param output       corrected cube
+	 * @param outputStride distance between two rows of @p output in bytes
+	 */
+	void operator()(const std::uint8_t* input,
+	                std::size_t inputStride,
+	                std::uint8_t* output,
+	                std::size_t outputStride,
+	                std::size_t width,
+	                std::size_t height);
+
+private:
+	// Rows processed by a thread at a time.
+	static constexpr std::size_t kRowsPerBlock = 16;
+
+	std::vector<float> m_coefficients;
+	std::size_t m_bands;
+	EKernel m_kernel;
+	BlockPool m_pool;
+};
+
+/**
+ * @brief Reference implementation of CrosstalkCorrection for a single pixel.
+ */
+void correctPixel(const float* coefficients, std::size_t bands, const std::uint8_t* input, std::uint8_t* output) noexcept;
+
+} // namespace neurala::plug::cms
+
+#endif // NEURALA_CMS_CROSSTALK_H
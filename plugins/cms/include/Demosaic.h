@@ -0,0 +1,139 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_CMS_DEMOSAIC_H
+#define NEURALA_CMS_DEMOSAIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "neurala/utils/BlockPool.h"
+
+#include "Mosaic.h"
+#include "Simd.h"
+
+namespace neurala::plug::cms
+{
+/// Interpolation of the bands of a macropixel.
+enum class EDemosaic : unsigned char
+{
+	/// Mean of the photosites of the band in the macropixel.
+	nearest,
+	/// Bilinear interpolation at the center of the macropixel, between the photosites of the band
+	/// closest to the center in the neighboring macropixels.
+	bilinear
+};
+
+/**
+ * @brief Parses a mosaic pattern written as "WxH:b,b,...", giving the band of each photosite of a
+ *        W by H macropixel in row-major order.
+ *
+ * @throw std::invalid_argument if the pattern is invalid
+ */
+MosaicPattern parseMosaicPattern(const std::string& text);
+
+/**
+ * @brief Computes 8-bit band-interleaved cubes, of one pixel per macropixel, from raw mosaic
+ *        frames.
+ *
+ * Blocks of macropixel rows are processed in parallel. Each block is first split into one plane
+ * per photosite of the macropixel, from which each band is computed over whole rows, then the
+ * bands are interleaved. All kernels give the same results as reference().
+ */
+class Demosaic
+{
+public:
+	using EKernel = cms::EKernel;
+
+	/**
+	 * @param pattern layout of the bands, which must all be present
+	 * @param mode    interpolation of the bands
+	 * @param threads number of threads, the number of workers of the shared executor if 0
+	 *
+	 * @throw std::invalid_argument if the pattern is invalid
+	 */
+	Demosaic(const MosaicPattern& pattern, EDemosaic mode, std::size_t threads = 0);
+
+	/// Returns the number of bands of the cubes.
+	std::size_t bands() const noexcept { return m_bands.size(); }
+
+	const MosaicPattern& pattern() const noexcept { return m_pattern; }
+
+	EDemosaic mode() const noexcept { return m_mode; }
+
+	/// Returns the kernel in use.
+	EKernel kernel() const noexcept { return m_kernel; }
+
+	/// Selects the kernel in use, falling back to a slower one if the processor lacks support.
+	void kernel(EKernel kernel) noexcept;
+
+	/**
+	 * @brief Computes the cube of a raw frame of @p width by @p height photosites.
+	 *
+	 * The cube has one pixel per whole macropixel of the frame.
+	 *
+	 * @param raw        raw frame
+	 * @param rawStride  distance between two rows of @p raw in bytes
+	 * @param cube       band-interleaved cube
+	 * @param cubeStride distance between two rows of @p cube in bytes
+	 */
+	void operator()(const std::uint8_t* raw,
+	                std::size_t rawStride,
+	                std::size_t width,
+	                std::size_t height,
+	                std::uint8_t* cube,
+	                std::size_t cubeStride);
+
+	/// Computes the pixel (@p x, @p y) of the cube of a raw frame, one photosite at a time.
+	void reference(const std::uint8_t* raw,
+	               std::size_t rawStride,
+	               std::size_t width,
+	               std::size_t height,
+	               std::size_t x,
+	               std::size_t y,
+	               std::uint8_t* pixel) const noexcept;
+
+private:
+	// Macropixel rows processed by a thread at a time.
+	static constexpr std::size_t kRowsPerBlock = 16;
+
+	/// How a band is computed from the photosites.
+	struct Band
+	{
+		// Photosites of the band in the macropixel, as indices in the pattern.
+		std::vector<std::size_t> photosites;
+		// Photosite interpolated in bilinear mode, and direction of its neighbors.
+		std::size_t photosite{};
+		int dx{};
+		int dy{};
+		// Weights of the photosite, its horizontal, vertical and diagonal neighbors, out of 256.
+		std::uint16_t weights[4]{};
+	};
+
+	MosaicPattern m_pattern;
+	EDemosaic m_mode;
+	std::vector<Band> m_bands;
+	EKernel m_kernel;
+	BlockPool m_pool;
+};
+
+} // namespace neurala::plug::cms
+
+#endif // NEURALA_CMS_DEMOSAIC_H
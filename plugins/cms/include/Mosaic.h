@@ -0,0 +1,56 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_CMS_MOSAIC_H
+#define NEURALA_CMS_MOSAIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace neurala::plug::cms
+{
+/**
+ * @brief Layout of the spectral filters over the sensor of a CMS camera.
+ *
+ * The sensor is tiled with macropixels of width by height photosites, each behind the filter of
+ * one band.
+ */
+struct MosaicPattern
+{
+	std::size_t width = 0;
+	std::size_t height = 0;
+	/// Band of each photosite of a macropixel, in row-major order.
+	std::vector<std::uint8_t> bands;
+
+	/// Returns the band of the photosite at (@p x, @p y) of the sensor.
+	std::uint8_t band(std::size_t x, std::size_t y) const noexcept
+	{
+		return bands[(y % height) * width + x % width];
+	}
+};
+
+/**
+ * @brief Returns a 4x4 macropixel pattern covering @p bandCount bands in order, the first bands
+ *        being repeated over the remaining photosites.
+ */
+MosaicPattern defaultMosaicPattern(std::size_t bandCount);
+
+} // namespace neurala::plug::cms
+
+#endif // NEURALA_CMS_MOSAIC_H
@@ -0,0 +1,52 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_CMS_SIMD_H
+#define NEURALA_CMS_SIMD_H
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NEURALA_CMS_X86 1
+#include <immintrin.h>
+#endif
+
+// Lets a function use an instruction set the rest of the translation unit is not compiled for.
+#if defined(__GNUC__)
+#define NEURALA_CMS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NEURALA_CMS_TARGET(isa)
+#endif
+
+namespace neurala::plug::cms
+{
+/// Implementation of a kernel.
+enum class EKernel : unsigned char
+{
+	scalar,
+	sse2,
+	avx2
+};
+
+/// Returns the fastest kernel supported by the processor.
+EKernel bestKernel() noexcept;
+
+/// Returns the name of @p kernel.
+const char* kernelName(EKernel kernel) noexcept;
+
+} // namespace neurala::plug::cms
+
+#endif // NEURALA_CMS_SIMD_H
@@ -0,0 +1,129 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_CMS_SIMULATED_BACKEND_H
+#define NEURALA_CMS_SIMULATED_BACKEND_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CameraBackend.h"
+#include "Mosaic.h"
+
+namespace neurala::plug::cms
+{
+struct SimulatorSettings
+{
+	/// Size of the sensor in photosites.
+	std::size_t width = 2048;
+	std::size_t height = 2048;
+	/// Frames acquired per second.
+	double frameRate = 30.0;
+	std::size_t bands = 10;
+	std::string serialNumber = "Toucan-T4";
+	/// Number of cameras connected.
+	std::size_t cameras = 1;
+
+	/**
+	 * @brief Returns the default settings, overridden by the NEURALA_CMS_SIMULATOR_WIDTH,
+	 *        NEURALA_CMS_SIMULATOR_HEIGHT, NEURALA_CMS_SIMULATOR_FRAME_RATE and
+	 *        NEURALA_CMS_SIMULATOR_CAMERAS environment variables.
+	 *
+	 * @throw std::invalid_argument if a variable is not a positive number
+	 */
+	static SimulatorSettings fromEnvironment();
+};
+
+/**
+ * @brief Camera backend acquiring synthetic raw frames at a fixed rate, without any device.
+ *
+ * Each macropixel of a frame holds a value per band which changes with the sequence number of the
+ * frame, see photosite(). Its cube is computed by averaging the photosites of each band over the
+ * macropixels, and its display image is made of three of its bands.
+ */
+class SimulatedBackend : public CameraBackend
+{
+public:
+	/**
+	 * @brief Connects to the camera @p index of the simulator.
+	 *
+	 * @throw std::invalid_argument if the settings are invalid
+	 */
+	explicit SimulatedBackend(const SimulatorSettings& settings = {}, std::size_t index = 0);
+
+	~SimulatedBackend() override;
+
+	std::string serialNumber() const override;
+
+	std::string cameraType() const override;
+
+	void setEventHandler(EventHandler handler) override;
+
+	void latchFrame() override;
+
+	BackendImage raw() override;
+
+	BackendImage cube() override;
+
+	BackendImage display() override;
+
+	/// Returns the sequence number of the latched frame, counted from 1, or 0 if none was latched.
+	std::uint64_t latchedSequence() const noexcept { return m_latchedSequence; }
+
+	const MosaicPattern& pattern() const noexcept { return m_pattern; }
+
+	/// Returns the value of the photosites of @p band in the macropixel (@p x, @p y) of a frame.
+	static std::uint8_t photosite(std::size_t x, std::size_t y, std::size_t band, std::uint64_t sequence) noexcept;
+
+private:
+	void acquire();
+
+	SimulatorSettings m_settings;
+	std::size_t m_index;
+	MosaicPattern m_pattern;
+
+	// Held while the event handler is set or called.
+	std::mutex m_handlerMutex;
+	EventHandler m_handler;
+
+	// Guards the members below, which are shared with the acquisition thread.
+	std::mutex m_mutex;
+	std::condition_variable m_stopCV;
+	bool m_stop = false;
+	std::vector<std::uint8_t> m_acquired;
+	std::uint64_t m_acquiredSequence = 0;
+
+	// Frame being written by the acquisition thread.
+	std::vector<std::uint8_t> m_sensor;
+
+	std::vector<std::uint8_t> m_latched;
+	std::uint64_t m_latchedSequence = 0;
+	std::vector<std::uint8_t> m_cube;
+	std::vector<std::uint8_t> m_display;
+
+	std::thread m_thread;
+};
+
+} // namespace neurala::plug::cms
+
+#endif // NEURALA_CMS_SIMULATED_BACKEND_H
@@ -0,0 +1,87 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_CMS_SPECTRAL_PLANES_H
+#define NEURALA_CMS_SPECTRAL_PLANES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace neurala::plug::cms
+{
+/**
+ * @brief Normalized difference (a - b) / (a + b) between two bands, such as the NDVI computed from
+ *        a near-infrared and a red band.
+ *
+ * Its value in [-1, 1] is mapped to [0, 255].
+ */
+struct NormalizedDifference
+{
+	std::size_t first;
+	std::size_t second;
+};
+
+/**
+ * @brief Planes of a multispectral frame: the selected bands, followed by the derived indices.
+ */
+struct PlaneSelection
+{
+	std::vector<std::size_t> bands;
+	std::vector<NormalizedDifference> indices;
+
+	/// Returns the number of planes of a frame.
+	std::size_t planes() const noexcept { return bands.size() + indices.size(); }
+};
+
+/**
+ * @brief Parses the planes of a multispectral frame.
+ *
+ * @param bands     comma-separated band numbers, all bands if empty
+ * @param indices   comma-separated pairs of band numbers "a:b", each giving a normalized difference
+ * @param bandCount number of bands of the camera
+ *
+ * @throw std::invalid_argument if a band number is invalid or out of range
+ */
+PlaneSelection parsePlaneSelection(const std::string& bands,
+                                   const std::string& indices,
+                                   std::size_t bandCount);
+
+/**
+ * @brief Writes the planes of @p selection to @p output, in a single pass over a cube.
+ *
+ * @param cube      band-interleaved cube of @p bandCount bands
+ * @param width     width of the cube in pixels
+ * @param height    height of the cube in pixels
+ * @param rowStride distance between two rows of the cube in bytes
+ * @param bandCount number of bands of the cube
+ * @param selection planes to write
+ * @param output    planar frame of selection.planes() planes of @p width by @p height bytes
+ */
+void extractPlanes(const std::uint8_t* cube,
+                   std::size_t width,
+                   std::size_t height,
+                   std::size_t rowStride,
+                   std::size_t bandCount,
+                   const PlaneSelection& selection,
+                   std::uint8_t* output) noexcept;
+
+} // namespace neurala::plug::cms
+
+#endif // NEURALA_CMS_SPECTRAL_PLANES_H
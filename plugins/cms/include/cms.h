@@ -19,8 +19,15 @@
 #ifndef NEURALA_CMS_PLUGIN_H
 #define NEURALA_CMS_PLUGIN_H
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
 #include "neurala/plugin/PluginBindings.h"
 
+#include "neurala/utils/Options.h"
 #include "neurala/video/CameraDiscoverer.h"
 #include "neurala/video/VideoSource.h"
 #include "neurala/video/VideoSourceStatus.h"
@@ -32,6 +39,12 @@ class PluginErrorCallback;
 
 namespace plug::cms
 {
+struct CMSCamera;
+struct CMSFrame;
+
+/**
+ * @brief Discoverer reporting each CMS camera, with its index as connection.
+ */
 class PLUGIN_API CMSDiscoverer : public CameraDiscoverer
 {
 public:
@@ -41,10 +54,44 @@ public:
 	static void destroy(void* p);
 };
 
+/**
+ * @brief Video source streaming from a CMS camera.
+ *
+ * By default, frames are the BGR display image computed by the CMS library. Setting the "output"
+ * option to "bands" streams planar frames made of the spectral bands listed by the "bands" option
+ * (all bands if it is not set), followed by the normalized differences listed by the "indices"
+ * option as pairs of bands (e.g. "8:5").
+ *
+ * Each camera is computed by its own worker thread, free running at the rate of the camera, so
+ * sources of different cameras stream in parallel. nextFrame() returns the newest computed frame
+ * not handed out yet, and only waits, for up to the "timeout" option in milliseconds (30 s by
+ * default), when there is none. Only one source can stream from a camera at a time.
+ *
+ * The "stats" action writes the number of frames computed, delivered and dropped, as a JSON line,
+ * to the file named by the "statsFile" option or to the standard log. The "resetStats" action
+ * clears them.
+ */
 class PLUGIN_API CMSSource : public VideoSource
 {
+private:
+	std::shared_ptr<CMSCamera> m_camera;
+	// Frame handed out by the last call to nextFrame(), in use by the SDK.
+	const CMSFrame* m_frame = nullptr;
+	// Configuration of the camera set by this source, that of the frames it hands out.
+	std::uint64_t m_generation = 0;
+	dto::ImageMetadata m_metadata;
+	std::chrono::milliseconds m_timeout;
+	std::string m_statsFile;
+	std::uint64_t m_deliveredFrames = 0;
+
+	void writeStatistics(std::ostream& os) const;
+
 public:
-	explicit CMSSource();
+	/// @throw std::invalid_argument if no camera is connected at cameraInfo.connection(), or if it is
+	///        already streaming
+	explicit CMSSource(const dto::CameraInfo& cameraInfo, const Options& cameraOptions = {});
+
+	~CMSSource() noexcept override;
 
 	[[nodiscard]] dto::ImageMetadata metadata() const noexcept override;
 
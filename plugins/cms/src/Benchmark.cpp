@@ -0,0 +1,264 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Measures the throughput of the CMS kernels on synthetic cubes and raw frames, and writes the
+// results as JSON.
+//
+// Usage: cms_benchmark [--iterations count] [--output file]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CMSDescription.h"
+#include "Crosstalk.h"
+#include "Demosaic.h"
+
+namespace
+{
+using namespace neurala::plug::cms;
+
+struct Size
+{
+	std::size_t width;
+	std::size_t height;
+};
+
+constexpr Size kSizes[] = {{512, 512}, {1024, 1024}, {2048, 2048}};
+
+constexpr std::size_t kBands = 10;
+
+// Raw frames, in photosites.
+constexpr Size kRawSizes[] = {{1024, 1024}, {2048, 2048}};
+
+/// Returns the average duration of a call to @p f in seconds, after a warm up call.
+template<class F>
+double
+measure(int iterations, F f)
+{
+	f();
+
+	const auto start = std::chrono::steady_clock::now();
+	for (auto i = 0; i < iterations; ++i)
+	{
+		f();
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return elapsed.count() / iterations;
+}
+
+/**
+ * @brief Averages the photosites of each band one macropixel at a time, as the simulated camera
+ *        does, which is the baseline of the demosaic kernels.
+ */
+void
+demosaicPerMacropixel(const MosaicPattern& pattern,
+                      const std::uint8_t* raw,
+                      const Size& size,
+                      std::uint8_t* cube) noexcept
+{
+	unsigned sums[256];
+	unsigned counts[256];
+
+	for (std::size_t my = 0; my < size.height / pattern.height; ++my)
+	{
+		for (std::size_t mx = 0; mx < size.width / pattern.width; ++mx)
+		{
+			std::fill_n(sums, kBands, 0u);
+			std::fill_n(counts, kBands, 0u);
+
+			for (std::size_t j = 0; j < pattern.height; ++j)
+			{
+				for (std::size_t i = 0; i < pattern.width; ++i)
+				{
+					const auto band = pattern.band(i, j);
+					sums[band] += raw[(my * pattern.height + j) * size.width + mx * pattern.width + i];
+					++counts[band];
+				}
+			}
+
+			for (std::size_t b = 0; b < kBands; ++b)
+			{
+				*cube++ = static_cast<std::uint8_t>((sums[b] + counts[b] / 2) / counts[b]);
+			}
+		}
+	}
+}
+
+/// Returns the crosstalk matrix of the Toucan T4, or a synthetic one if it cannot be read.
+std::vector<double>
+coefficients()
+{
+	CMSDescription description;
+	if (loadDescription(NEURALA_CMS_RESOURCES_DIR "/Toucan_T4.xml", description)
+	    && description.bands() == kBands)
+	{
+		return description.crosstalkCorrectionCoefficients;
+	}
+
+	std::vector<double> matrix(kBands * kBands, -0.02);
+	for (std::size_t i = 0; i < kBands; ++i)
+	{
+		matrix[i * kBands + i] = 1.1;
+	}
+	return matrix;
+}
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+	int iterations = 20;
+	std::string output;
+
+	for (auto i = 1; i + 1 < argc; i += 2)
+	{
+		const std::string argument = argv[i];
+
+		if (argument == "--iterations")
+		{
+			iterations = std::max(1, std::atoi(argv[i + 1]));
+		}
+		else if (argument == "--output")
+		{
+			output = argv[i + 1];
+		}
+	}
+
+	std::ofstream file;
+	if (!output.empty())
+	{
+		file.open(output);
+	}
+	auto& os = output.empty() ? std::cout : file;
+
+	const auto matrix = coefficients();
+	const auto hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::mt19937 generator(0);
+	std::uniform_int_distribution<int> value(0, 255);
+	auto first = true;
+
+	os << "{\"iterations\":" << iterations << ",\"crosstalk\":[";
+
+	for (const auto& size : kSizes)
+	{
+		std::vector<std::uint8_t> cube(size.width * size.height * kBands);
+		std::generate(cube.begin(), cube.end(), [&] { return static_cast<std::uint8_t>(value(generator)); });
+		std::vector<std::uint8_t> corrected(cube.size());
+
+		for (const auto threads : {1u, hardwareThreads})
+		{
+			for (const auto kernel : {CrosstalkCorrection::EKernel::scalar,
+			                          CrosstalkCorrection::EKernel::sse2,
+			                          CrosstalkCorrection::EKernel::avx2})
+			{
+				CrosstalkCorrection correction(matrix, kBands, threads);
+				correction.kernel(kernel);
+
+				// Unsupported kernels fall back to slower ones, which are measured on their own.
+				if (correction.kernel() != kernel)
+				{
+					continue;
+				}
+
+				const auto stride = size.width * kBands;
+				const auto seconds = measure(iterations, [&] {
+					correction(cube.data(), stride, corrected.data(), stride, size.width, size.height);
+				});
+				os << (first ? "" : ",") << "{\"width\":" << size.width << ",\"height\":" << size.height
+				   << ",\"bands\":" << kBands << ",\"kernel\":\"" << kernelName(kernel)
+				   << "\",\"threads\":" << threads << ",\"milliseconds\":" << seconds * 1e3
+				   << ",\"megapixelsPerSecond\":" << size.width * size.height / seconds / 1e6 << '}';
+				first = false;
+			}
+
+			if (hardwareThreads == 1)
+			{
+				break;
+			}
+		}
+	}
+
+	os << "],\"demosaic\":[";
+	first = true;
+
+	const auto pattern = defaultMosaicPattern(kBands);
+
+	for (const auto& size : kRawSizes)
+	{
+		std::vector<std::uint8_t> raw(size.width * size.height);
+		std::generate(
+		  raw.begin(), raw.end(), [&] { return static_cast<std::uint8_t>(value(generator)); });
+
+		const auto cubeWidth = size.width / pattern.width;
+		const auto cubeHeight = size.height / pattern.height;
+		std::vector<std::uint8_t> cube(cubeWidth * cubeHeight * kBands);
+
+		const auto write = [&](const char* mode, const char* kernel, unsigned threads, double seconds) {
+			os << (first ? "" : ",") << "{\"width\":" << size.width << ",\"height\":" << size.height
+			   << ",\"bands\":" << kBands << ",\"mode\":\"" << mode << "\",\"kernel\":\"" << kernel
+			   << "\",\"threads\":" << threads << ",\"milliseconds\":" << seconds * 1e3
+			   << ",\"megapixelsPerSecond\":" << size.width * size.height / seconds / 1e6 << '}';
+			first = false;
+		};
+
+		write("nearest", "perMacropixel", 1, measure(iterations, [&] {
+			      demosaicPerMacropixel(pattern, raw.data(), size, cube.data());
+		      }));
+
+		for (const auto mode : {EDemosaic::nearest, EDemosaic::bilinear})
+		{
+			for (const auto threads : {1u, hardwareThreads})
+			{
+				for (const auto kernel : {EKernel::scalar, EKernel::sse2, EKernel::avx2})
+				{
+					Demosaic demosaic(pattern, mode, threads);
+					demosaic.kernel(kernel);
+
+					if (demosaic.kernel() != kernel)
+					{
+						continue;
+					}
+
+					const auto seconds = measure(iterations, [&] {
+						demosaic(
+						  raw.data(), size.width, size.width, size.height, cube.data(), cubeWidth * kBands);
+					});
+					const auto name = mode == EDemosaic::nearest ? "nearest" : "bilinear";
+					write(name, kernelName(kernel), threads, seconds);
+				}
+
+				if (hardwareThreads == 1)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	os << "]}\n";
+	return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "CMSDescription.h"
+
+namespace neurala::plug::cms
+{
+namespace
+{
+/// Returns the text between the first <tag> and </tag> of @p xml, or an empty string.
+std::string
+element(const std::string& xml, const std::string& tag)
+{
+	const auto open = "<" + tag + ">";
+	const auto begin = xml.find(open);
+
+	if (begin == std::string::npos)
+	{
+		return {};
+	}
+
+	const auto end = xml.find("</" + tag + ">", begin);
+	if (end == std::string::npos)
+	{
+		return {};
+	}
+
+	return xml.substr(begin + open.size(), end - begin - open.size());
+}
+
+/**
+ * @brief Parses the numbers of @p text, separated by @p separator.
+ *
+ * Returns an empty vector if any field is not a number.
+ */
+std::vector<double>
+numbers(const std::string& text, char separator)
+{
+	std::vector<double> values;
+	const char* p = text.c_str();
+
+	while (*p)
+	{
+		char* end = nullptr;
+		const auto value = std::strtod(p, &end);
+
+		if (end == p)
+		{
+			return {};
+		}
+
+		values.push_back(value);
+		p = end;
+
+		if (*p == separator)
+		{
+			++p;
+		}
+		else if (*p && *p != '\n' && *p != '\r' && *p != ' ' && *p != '\t')
+		{
+			return {};
+		}
+		else
+		{
+			while (*p == '\n' || *p == '\r' || *p == ' ' || *p == '\t')
+			{
+				++p;
+			}
+		}
+	}
+
+	return values;
+}
+} // namespace
+
+bool
+loadDescription(const std::string& path, CMSDescription& description)
+{
+	std::ifstream file(path);
+	std::ostringstream contents;
+
+	if (!(contents << file.rdbuf()))
+	{
+		return false;
+	}
+
+	const auto xml = contents.str();
+
+	description.siliosSN = element(xml, "siliosSN");
+	description.filterCentering = numbers(element(xml, "filterCentering"), '-');
+	description.filterFWHM = numbers(element(xml, "filterFWHM"), '-');
+	description.crosstalkCorrectionCoefficients =
+	  numbers(element(xml, "crosstalkCorrectionCoefficients"), '*');
+
+	return description.bands() > 0;
+}
+
+std::string
+descriptionPath(const std::string& serialNumber)
+{
+	// Files are named after the serial number, with dashes replaced by underscores.
+	auto name = serialNumber;
+	std::replace(name.begin(), name.end(), '-', '_');
+	return "ResourcesCMS/" + name + ".xml";
+}
+
+} // namespace neurala::plug::cms
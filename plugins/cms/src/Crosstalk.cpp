@@ -0,0 +1,225 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+#include "Crosstalk.h"
+
+namespace neurala::plug::cms
+{
+namespace
+{
+std::uint8_t
+saturate(float value) noexcept
+{
+	// Rounds half to even, as the SIMD conversions do.
+	const auto rounded = std::nearbyint(value);
+	return rounded <= 0.0f ? 0 : rounded >= 255.0f ? 255 : static_cast<std::uint8_t>(rounded);
+}
+
+/// Converts a row of band-interleaved pixels to one row of floats per band.
+void
+deinterleave(const std::uint8_t* row, std::size_t width, std::size_t bands, float* planes) noexcept
+{
+	for (std::size_t x = 0; x < width; ++x)
+	{
+		for (std::size_t band = 0; band < bands; ++band)
+		{
+			planes[band * width + x] = row[x * bands + band];
+		}
+	}
+}
+
+void
+correctRowScalar(const float* coefficients,
+                 std::size_t bands,
+                 const float* planes,
+                 std::size_t width,
+                 std::size_t begin,
+                 std::uint8_t* output) noexcept
+{
+	for (auto x = begin; x < width; ++x)
+	{
+		for (std::size_t i = 0; i < bands; ++i)
+		{
+			auto sum = 0.0f;
+			for (std::size_t j = 0; j < bands; ++j)
+			{
+				sum += coefficients[i * bands + j] * planes[j * width + x];
+			}
+			output[x * bands + i] = saturate(sum);
+		}
+	}
+}
+
+#ifdef NEURALA_CMS_X86
+/// Corrects groups of 4 pixels of a row, returns the number of pixels corrected.
+NEURALA_CMS_TARGET("sse2")
+std::size_t
+correctRowSse2(const float* coefficients,
+               std::size_t bands,
+               const float* planes,
+               std::size_t width,
+               std::uint8_t* output) noexcept
+{
+	std::size_t x = 0;
+
+	for (; x + 4 <= width; x += 4)
+	{
+		for (std::size_t i = 0; i < bands; ++i)
+		{
+			auto sum = _mm_setzero_ps();
+			for (std::size_t j = 0; j < bands; ++j)
+			{
+				const auto product = _mm_mul_ps(_mm_set1_ps(coefficients[i * bands + j]),
+				                                _mm_loadu_ps(planes + j * width + x));
+				sum = _mm_add_ps(sum, product);
+			}
+
+			auto values = _mm_cvtps_epi32(sum);
+			values = _mm_packs_epi32(values, values);
+			values = _mm_packus_epi16(values, values);
+
+			const auto bytes = static_cast<std::uint32_t>(_mm_cvtsi128_si32(values));
+			for (std::size_t k = 0; k < 4; ++k)
+			{
+				output[(x + k) * bands + i] = static_cast<std::uint8_t>(bytes >> (8 * k));
+			}
+		}
+	}
+
+	return x;
+}
+
+/// Corrects groups of 8 pixels of a row, returns the number of pixels corrected.
+NEURALA_CMS_TARGET("avx2")
+std::size_t
+correctRowAvx2(const float* coefficients,
+               std::size_t bands,
+               const float* planes,
+               std::size_t width,
+               std::uint8_t* output) noexcept
+{
+	std::size_t x = 0;
+	alignas(16) std::uint8_t bytes[16];
+
+	for (; x + 8 <= width; x += 8)
+	{
+		for (std::size_t i = 0; i < bands; ++i)
+		{
+			// Products and sums are not fused, so that results match the other kernels.
+			auto sum = _mm256_setzero_ps();
+			for (std::size_t j = 0; j < bands; ++j)
+			{
+				const auto product = _mm256_mul_ps(_mm256_set1_ps(coefficients[i * bands + j]),
+				                                   _mm256_loadu_ps(planes + j * width + x));
+				sum = _mm256_add_ps(sum, product);
+			}
+
+			const auto values = _mm256_cvtps_epi32(sum);
+			auto packed = _mm_packs_epi32(_mm256_castsi256_si128(values),
+			                              _mm256_extracti128_si256(values, 1));
+			packed = _mm_packus_epi16(packed, packed);
+			_mm_store_si128(reinterpret_cast<__m128i*>(bytes), packed);
+
+			for (std::size_t k = 0; k < 8; ++k)
+			{
+				output[(x + k) * bands + i] = bytes[k];
+			}
+		}
+	}
+
+	return x;
+}
+#endif // NEURALA_CMS_X86
+
+} // namespace
+
+void
+correctPixel(const float* coefficients, std::size_t bands, const std::uint8_t* input, std::uint8_t* output) noexcept
+{
+	for (std::size_t i = 0; i < bands; ++i)
+	{
+		auto sum = 0.0f;
+		for (std::size_t j = 0; j < bands; ++j)
+		{
+			sum += coefficients[i * bands + j] * static_cast<float>(input[j]);
+		}
+		output[i] = saturate(sum);
+	}
+}
+
+CrosstalkCorrection::CrosstalkCorrection(const std::vector<double>& coefficients,
+                                         std::size_t bands,
+                                         std::size_t threads)
+ : m_coefficients(coefficients.begin(), coefficients.end()), m_bands(bands), m_kernel(bestKernel()), m_pool(threads)
+{
+	if (bands == 0 || coefficients.size() != bands * bands)
+	{
+		throw std::invalid_argument("The crosstalk correction matrix does not match the number of bands");
+	}
+}
+
+void
+CrosstalkCorrection::kernel(EKernel kernel) noexcept
+{
+	m_kernel = std::min(kernel, bestKernel());
+}
+
+void
+CrosstalkCorrection::operator()(const std::uint8_t* input,
+                                std::size_t inputStride,
+                                std::uint8_t* output,
+                                std::size_t outputStride,
+                                std::size_t width,
+                                std::size_t height)
+{
+	const std::function<void(std::size_t)> correctBlock = [=](std::size_t block) {
+		thread_local std::vector<float> planes;
+		planes.resize(m_bands * width);
+
+		const auto end = std::min(height, (block + 1) * kRowsPerBlock);
+		for (auto y = block * kRowsPerBlock; y < end; ++y)
+		{
+			const auto target = output + y * outputStride;
+			std::size_t x = 0;
+
+			deinterleave(input + y * inputStride, width, m_bands, planes.data());
+
+#ifdef NEURALA_CMS_X86
+			if (m_kernel == EKernel::avx2)
+			{
+				x = correctRowAvx2(m_coefficients.data(), m_bands, planes.data(), width, target);
+			}
+			else if (m_kernel == EKernel::sse2)
+			{
+				x = correctRowSse2(m_coefficients.data(), m_bands, planes.data(), width, target);
+			}
+#endif
+
+			correctRowScalar(m_coefficients.data(), m_bands, planes.data(), width, x, target);
+		}
+	};
+
+	m_pool.run((height + kRowsPerBlock - 1) / kRowsPerBlock, correctBlock);
+}
+
+} // namespace neurala::plug::cms
@@ -0,0 +1,633 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+
+#include "Demosaic.h"
+
+namespace neurala::plug::cms
+{
+namespace
+{
+/// Copies photosite i of each macropixel of a raw row, from macropixel @p begin, to planes[i].
+void
+splitRowScalar(const std::uint8_t* row,
+               std::size_t macropixelWidth,
+               std::size_t width,
+               std::size_t begin,
+               std::uint8_t* const* planes) noexcept
+{
+	for (auto x = begin; x < width; ++x)
+	{
+		for (std::size_t i = 0; i < macropixelWidth; ++i)
+		{
+			planes[i][x] = row[x * macropixelWidth + i];
+		}
+	}
+}
+
+void
+averageRowScalar(const std::uint8_t* a,
+                 const std::uint8_t* b,
+                 std::size_t begin,
+                 std::size_t width,
+                 std::uint8_t* output) noexcept
+{
+	for (auto x = begin; x < width; ++x)
+	{
+		output[x] = static_cast<std::uint8_t>((a[x] + b[x] + 1) >> 1);
+	}
+}
+
+void
+bilinearRowScalar(const std::uint8_t* row,
+                  const std::uint8_t* neighborRow,
+                  int dx,
+                  const std::uint16_t* weights,
+                  std::size_t begin,
+                  std::size_t width,
+                  std::uint8_t* output) noexcept
+{
+	for (auto x = begin; x < width; ++x)
+	{
+		const unsigned sum = weights[0] * row[x] + weights[1] * row[x + dx] + weights[2] * neighborRow[x]
+		                     + weights[3] * neighborRow[x + dx] + 128;
+		output[x] = static_cast<std::uint8_t>(sum >> 8);
+	}
+}
+
+#ifdef NEURALA_CMS_X86
+/// Even bytes of a then b.
+NEURALA_CMS_TARGET("sse2")
+inline __m128i
+evenBytes(__m128i a, __m128i b) noexcept
+{
+	const auto mask = _mm_set1_epi16(0xff);
+	return _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+}
+
+/// Odd bytes of a then b.
+NEURALA_CMS_TARGET("sse2")
+inline __m128i
+oddBytes(__m128i a, __m128i b) noexcept
+{
+	return _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+}
+
+NEURALA_CMS_TARGET("sse2")
+inline __m128i
+loadBytes(const std::uint8_t* p) noexcept
+{
+	return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+/// Splits groups of 16 macropixels of 4 photosites, returns the number of macropixels split.
+NEURALA_CMS_TARGET("sse2")
+std::size_t
+splitRow4Sse2(const std::uint8_t* row, std::size_t width, std::uint8_t* const* planes) noexcept
+{
+	std::size_t x = 0;
+
+	for (; x + 16 <= width; x += 16)
+	{
+		const auto source = reinterpret_cast<const __m128i*>(row + x * 4);
+		const auto a0 = _mm_loadu_si128(source);
+		const auto a1 = _mm_loadu_si128(source + 1);
+		const auto a2 = _mm_loadu_si128(source + 2);
+		const auto a3 = _mm_loadu_si128(source + 3);
+
+		// Photosites 0 and 2, then 1 and 3, then each of them.
+		const auto even01 = evenBytes(a0, a1);
+		const auto even23 = evenBytes(a2, a3);
+		const auto odd01 = oddBytes(a0, a1);
+		const auto odd23 = oddBytes(a2, a3);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(planes[0] + x), evenBytes(even01, even23));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(planes[1] + x), evenBytes(odd01, odd23));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(planes[2] + x), oddBytes(even01, even23));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(planes[3] + x), oddBytes(odd01, odd23));
+	}
+
+	return x;
+}
+
+NEURALA_CMS_TARGET("sse2")
+std::size_t
+averageRowSse2(const std::uint8_t* a,
+               const std::uint8_t* b,
+               std::size_t width,
+               std::uint8_t* output) noexcept
+{
+	std::size_t x = 0;
+
+	for (; x + 16 <= width; x += 16)
+	{
+		const auto average = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x)),
+		                                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), average);
+	}
+
+	return x;
+}
+
+NEURALA_CMS_TARGET("sse2")
+std::size_t
+bilinearRowSse2(const std::uint8_t* row,
+                const std::uint8_t* neighborRow,
+                int dx,
+                const std::uint16_t* weights,
+                std::size_t width,
+                std::uint8_t* output) noexcept
+{
+	const auto zero = _mm_setzero_si128();
+	const auto rounding = _mm_set1_epi16(128);
+	const __m128i w[] = {_mm_set1_epi16(static_cast<short>(weights[0])),
+	                     _mm_set1_epi16(static_cast<short>(weights[1])),
+	                     _mm_set1_epi16(static_cast<short>(weights[2])),
+	                     _mm_set1_epi16(static_cast<short>(weights[3]))};
+
+	std::size_t x = 0;
+
+	for (; x + 16 <= width; x += 16)
+	{
+		const __m128i samples[] = {loadBytes(row + x),
+		                           loadBytes(row + x + dx),
+		                           loadBytes(neighborRow + x),
+		                           loadBytes(neighborRow + x + dx)};
+
+		// Sums of at most 255 * 256 + 128 fit in unsigned 16-bit lanes.
+		auto low = rounding;
+		auto high = rounding;
+		for (auto i = 0; i < 4; ++i)
+		{
+			low = _mm_add_epi16(low, _mm_mullo_epi16(_mm_unpacklo_epi8(samples[i], zero), w[i]));
+			high = _mm_add_epi16(high, _mm_mullo_epi16(_mm_unpackhi_epi8(samples[i], zero), w[i]));
+		}
+
+		const auto values = _mm_packus_epi16(_mm_srli_epi16(low, 8), _mm_srli_epi16(high, 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), values);
+	}
+
+	return x;
+}
+
+/// Even bytes of a then b. Packing works within 128-bit lanes, so the 64-bit quarters are put
+/// back in order.
+NEURALA_CMS_TARGET("avx2")
+inline __m256i
+evenBytes(__m256i a, __m256i b) noexcept
+{
+	const auto mask = _mm256_set1_epi16(0xff);
+	const auto packed = _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+	return _mm256_permute4x64_epi64(packed, 0xd8);
+}
+
+/// Odd bytes of a then b.
+NEURALA_CMS_TARGET("avx2")
+inline __m256i
+oddBytes(__m256i a, __m256i b) noexcept
+{
+	const auto packed = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+	return _mm256_permute4x64_epi64(packed, 0xd8);
+}
+
+/// Splits groups of 32 macropixels of 4 photosites, returns the number of macropixels split.
+NEURALA_CMS_TARGET("avx2")
+std::size_t
+splitRow4Avx2(const std::uint8_t* row, std::size_t width, std::uint8_t* const* planes) noexcept
+{
+	std::size_t x = 0;
+
+	for (; x + 32 <= width; x += 32)
+	{
+		const auto source = reinterpret_cast<const __m256i*>(row + x * 4);
+		const auto a0 = _mm256_loadu_si256(source);
+		const auto a1 = _mm256_loadu_si256(source + 1);
+		const auto a2 = _mm256_loadu_si256(source + 2);
+		const auto a3 = _mm256_loadu_si256(source + 3);
+
+		const auto even01 = evenBytes(a0, a1);
+		const auto even23 = evenBytes(a2, a3);
+		const auto odd01 = oddBytes(a0, a1);
+		const auto odd23 = oddBytes(a2, a3);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(planes[0] + x), evenBytes(even01, even23));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(planes[1] + x), evenBytes(odd01, odd23));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(planes[2] + x), oddBytes(even01, even23));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(planes[3] + x), oddBytes(odd01, odd23));
+	}
+
+	return x;
+}
+
+NEURALA_CMS_TARGET("avx2")
+std::size_t
+averageRowAvx2(const std::uint8_t* a,
+               const std::uint8_t* b,
+               std::size_t width,
+               std::uint8_t* output) noexcept
+{
+	std::size_t x = 0;
+
+	for (; x + 32 <= width; x += 32)
+	{
+		const auto average = _mm256_avg_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + x)),
+		                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + x)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + x), average);
+	}
+
+	return x;
+}
+
+NEURALA_CMS_TARGET("avx2")
+std::size_t
+bilinearRowAvx2(const std::uint8_t* row,
+                const std::uint8_t* neighborRow,
+                int dx,
+                const std::uint16_t* weights,
+                std::size_t width,
+                std::uint8_t* output) noexcept
+{
+	const auto rounding = _mm256_set1_epi16(128);
+	const __m256i w[] = {_mm256_set1_epi16(static_cast<short>(weights[0])),
+	                     _mm256_set1_epi16(static_cast<short>(weights[1])),
+	                     _mm256_set1_epi16(static_cast<short>(weights[2])),
+	                     _mm256_set1_epi16(static_cast<short>(weights[3]))};
+	const std::uint8_t* rows[] = {row, row + dx, neighborRow, neighborRow + dx};
+
+	std::size_t x = 0;
+
+	for (; x + 32 <= width; x += 32)
+	{
+		auto low = rounding;
+		auto high = rounding;
+		for (auto i = 0; i < 4; ++i)
+		{
+			const auto source = reinterpret_cast<const __m128i*>(rows[i] + x);
+			const auto lowSamples = _mm256_cvtepu8_epi16(_mm_loadu_si128(source));
+			const auto highSamples = _mm256_cvtepu8_epi16(_mm_loadu_si128(source + 1));
+			low = _mm256_add_epi16(low, _mm256_mullo_epi16(lowSamples, w[i]));
+			high = _mm256_add_epi16(high, _mm256_mullo_epi16(highSamples, w[i]));
+		}
+
+		const auto values = _mm256_permute4x64_epi64(
+		  _mm256_packus_epi16(_mm256_srli_epi16(low, 8), _mm256_srli_epi16(high, 8)), 0xd8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + x), values);
+	}
+
+	return x;
+}
+#endif // NEURALA_CMS_X86
+
+bool
+valid(const MosaicPattern& pattern) noexcept
+{
+	return pattern.width > 0 && pattern.height > 0
+	       && pattern.bands.size() == pattern.width * pattern.height;
+}
+
+std::vector<std::string>
+split(const std::string& text, char separator)
+{
+	std::vector<std::string> fields(1);
+	for (const auto c : text)
+	{
+		if (c == separator)
+		{
+			fields.emplace_back();
+		}
+		else
+		{
+			fields.back() += c;
+		}
+	}
+	return fields;
+}
+
+std::size_t
+parseNumber(const std::string& text, const std::string& pattern)
+{
+	char* end = nullptr;
+	const auto value = std::strtoul(text.c_str(), &end, 10);
+	if (text.empty() || *end != '\0' || text.find('-') != std::string::npos)
+	{
+		throw std::invalid_argument("Invalid CMS mosaic pattern " + pattern);
+	}
+	return value;
+}
+} // namespace
+
+MosaicPattern
+parseMosaicPattern(const std::string& text)
+{
+	const auto colon = text.find(':');
+	const auto x = text.find('x');
+	if (colon == std::string::npos || x == std::string::npos || x > colon)
+	{
+		throw std::invalid_argument("Invalid CMS mosaic pattern " + text);
+	}
+
+	MosaicPattern pattern;
+	pattern.width = parseNumber(text.substr(0, x), text);
+	pattern.height = parseNumber(text.substr(x + 1, colon - x - 1), text);
+
+	for (const auto& band : split(text.substr(colon + 1), ','))
+	{
+		const auto value = parseNumber(band, text);
+		if (value > 255)
+		{
+			throw std::invalid_argument("Invalid CMS mosaic pattern " + text);
+		}
+		pattern.bands.push_back(static_cast<std::uint8_t>(value));
+	}
+
+	if (!valid(pattern))
+	{
+		throw std::invalid_argument("Invalid CMS mosaic pattern " + text);
+	}
+
+	return pattern;
+}
+
+Demosaic::Demosaic(const MosaicPattern& pattern, EDemosaic mode, std::size_t threads)
+ : m_pattern(pattern), m_mode(mode), m_kernel(bestKernel()), m_pool(threads)
+{
+	if (!valid(pattern))
+	{
+		throw std::invalid_argument("Invalid CMS mosaic pattern");
+	}
+
+	m_bands.resize(*std::max_element(pattern.bands.begin(), pattern.bands.end()) + std::size_t{1});
+
+	for (std::size_t p = 0; p < pattern.bands.size(); ++p)
+	{
+		m_bands[pattern.bands[p]].photosites.push_back(p);
+	}
+
+	const auto centerX = (pattern.width - 1) / 2.0;
+	const auto centerY = (pattern.height - 1) / 2.0;
+	const auto distance = [&](std::size_t p) {
+		return std::hypot(p % pattern.width - centerX, p / pattern.width - centerY);
+	};
+
+	for (auto& band : m_bands)
+	{
+		if (band.photosites.empty())
+		{
+			throw std::invalid_argument("A band is missing from the CMS mosaic pattern");
+		}
+
+		band.photosite = *std::min_element(band.photosites.begin(),
+		                                   band.photosites.end(),
+		                                   [&](auto a, auto b) { return distance(a) < distance(b); });
+
+		// Offset of the center from the photosite, in macropixels.
+		const auto x = static_cast<double>(band.photosite % pattern.width);
+		const auto y = static_cast<double>(band.photosite / pattern.width);
+		const auto offsetX = (centerX - x) / pattern.width;
+		const auto offsetY = (centerY - y) / pattern.height;
+		band.dx = offsetX > 0.0 ? 1 : offsetX < 0.0 ? -1 : 0;
+		band.dy = offsetY > 0.0 ? 1 : offsetY < 0.0 ? -1 : 0;
+
+		const auto ax = std::abs(offsetX);
+		const auto ay = std::abs(offsetY);
+		band.weights[1] = static_cast<std::uint16_t>(std::lround(ax * (1.0 - ay) * 256.0));
+		band.weights[2] = static_cast<std::uint16_t>(std::lround((1.0 - ax) * ay * 256.0));
+		band.weights[3] = static_cast<std::uint16_t>(std::lround(ax * ay * 256.0));
+		band.weights[0] =
+		  static_cast<std::uint16_t>(256 - band.weights[1] - band.weights[2] - band.weights[3]);
+	}
+}
+
+void
+Demosaic::kernel(EKernel kernel) noexcept
+{
+	m_kernel = std::min(kernel, bestKernel());
+}
+
+void
+Demosaic::operator()(const std::uint8_t* raw,
+                     std::size_t rawStride,
+                     std::size_t width,
+                     std::size_t height,
+                     std::uint8_t* cube,
+                     std::size_t cubeStride)
+{
+	const auto cubeWidth = width / m_pattern.width;
+	const auto cubeHeight = height / m_pattern.height;
+	const auto photosites = m_pattern.bands.size();
+	const auto bands = m_bands.size();
+
+	if (cubeWidth == 0 || cubeHeight == 0)
+	{
+		return;
+	}
+
+	// Bilinear interpolation reads the macropixel rows around each block.
+	const std::size_t margin = m_mode == EDemosaic::bilinear ? 1 : 0;
+	// Planes have one photosite of padding on each side, replicating the edges.
+	const auto planeStride = cubeWidth + 2;
+
+	const std::function<void(std::size_t)> demosaicBlock = [&](std::size_t block) {
+		thread_local std::vector<std::uint8_t> planes;
+		thread_local std::vector<std::uint8_t> scratch;
+		thread_local std::vector<std::uint8_t*> destinations;
+		thread_local std::vector<const std::uint8_t*> bandRows;
+
+		const auto begin = block * kRowsPerBlock;
+		const auto end = std::min(cubeHeight, begin + kRowsPerBlock);
+		const auto rows = end - begin + 2 * margin;
+
+		planes.resize(photosites * rows * planeStride);
+		scratch.resize(bands * cubeWidth);
+		destinations.resize(m_pattern.width);
+		bandRows.resize(bands);
+
+		const auto planeRow = [&](std::size_t photosite, std::size_t row) {
+			return planes.data() + (photosite * rows + row) * planeStride + 1;
+		};
+
+		for (std::size_t row = 0; row < rows; ++row)
+		{
+			const auto y = static_cast<std::size_t>(std::clamp<std::ptrdiff_t>(
+			  static_cast<std::ptrdiff_t>(begin + row) - static_cast<std::ptrdiff_t>(margin),
+			  0,
+			  static_cast<std::ptrdiff_t>(cubeHeight - 1)));
+
+			for (std::size_t j = 0; j < m_pattern.height; ++j)
+			{
+				const auto source = raw + (y * m_pattern.height + j) * rawStride;
+				for (std::size_t i = 0; i < m_pattern.width; ++i)
+				{
+					destinations[i] = planeRow(j * m_pattern.width + i, row);
+				}
+
+				std::size_t x = 0;
+#ifdef NEURALA_CMS_X86
+				if (m_pattern.width == 4 && m_kernel == EKernel::avx2)
+				{
+					x = splitRow4Avx2(source, cubeWidth, destinations.data());
+				}
+				else if (m_pattern.width == 4 && m_kernel == EKernel::sse2)
+				{
+					x = splitRow4Sse2(source, cubeWidth, destinations.data());
+				}
+#endif
+				splitRowScalar(source, m_pattern.width, cubeWidth, x, destinations.data());
+
+				for (const auto destination : destinations)
+				{
+					destination[-1] = destination[0];
+					destination[cubeWidth] = destination[cubeWidth - 1];
+				}
+			}
+		}
+
+		for (auto y = begin; y < end; ++y)
+		{
+			const auto row = y - begin + margin;
+
+			for (std::size_t b = 0; b < bands; ++b)
+			{
+				const auto& band = m_bands[b];
+				const auto output = scratch.data() + b * cubeWidth;
+				std::size_t x = 0;
+
+				if (m_mode == EDemosaic::bilinear)
+				{
+					const auto center = planeRow(band.photosite, row);
+					const auto neighbor = planeRow(band.photosite, row + band.dy);
+#ifdef NEURALA_CMS_X86
+					if (m_kernel == EKernel::avx2)
+					{
+						x = bilinearRowAvx2(center, neighbor, band.dx, band.weights, cubeWidth, output);
+					}
+					else if (m_kernel == EKernel::sse2)
+					{
+						x = bilinearRowSse2(center, neighbor, band.dx, band.weights, cubeWidth, output);
+					}
+#endif
+					bilinearRowScalar(center, neighbor, band.dx, band.weights, x, cubeWidth, output);
+					bandRows[b] = output;
+				}
+				else if (band.photosites.size() == 1)
+				{
+					bandRows[b] = planeRow(band.photosites[0], row);
+				}
+				else if (band.photosites.size() == 2)
+				{
+					const auto first = planeRow(band.photosites[0], row);
+					const auto second = planeRow(band.photosites[1], row);
+#ifdef NEURALA_CMS_X86
+					if (m_kernel == EKernel::avx2)
+					{
+						x = averageRowAvx2(first, second, cubeWidth, output);
+					}
+					else if (m_kernel == EKernel::sse2)
+					{
+						x = averageRowSse2(first, second, cubeWidth, output);
+					}
+#endif
+					averageRowScalar(first, second, x, cubeWidth, output);
+					bandRows[b] = output;
+				}
+				else
+				{
+					const auto count = static_cast<unsigned>(band.photosites.size());
+					for (; x < cubeWidth; ++x)
+					{
+						auto sum = count / 2;
+						for (const auto p : band.photosites)
+						{
+							sum += planeRow(p, row)[x];
+						}
+						output[x] = static_cast<std::uint8_t>(sum / count);
+					}
+					bandRows[b] = output;
+				}
+			}
+
+			auto pixel = cube + y * cubeStride;
+			for (std::size_t x = 0; x < cubeWidth; ++x)
+			{
+				for (std::size_t b = 0; b < bands; ++b)
+				{
+					*pixel++ = bandRows[b][x];
+				}
+			}
+		}
+	};
+
+	m_pool.run((cubeHeight + kRowsPerBlock - 1) / kRowsPerBlock, demosaicBlock);
+}
+
+void
+Demosaic::reference(const std::uint8_t* raw,
+                    std::size_t rawStride,
+                    std::size_t width,
+                    std::size_t height,
+                    std::size_t x,
+                    std::size_t y,
+                    std::uint8_t* pixel) const noexcept
+{
+	const auto cubeWidth = static_cast<std::ptrdiff_t>(width / m_pattern.width);
+	const auto cubeHeight = static_cast<std::ptrdiff_t>(height / m_pattern.height);
+
+	// Photosite p of the macropixel (mx, my), clamped to the frame.
+	const auto sample = [&](std::size_t p, std::ptrdiff_t mx, std::ptrdiff_t my) -> unsigned {
+		mx = std::clamp<std::ptrdiff_t>(mx, 0, cubeWidth - 1);
+		my = std::clamp<std::ptrdiff_t>(my, 0, cubeHeight - 1);
+		return raw[(my * m_pattern.height + p / m_pattern.width) * rawStride + mx * m_pattern.width
+		           + p % m_pattern.width];
+	};
+
+	const auto mx = static_cast<std::ptrdiff_t>(x);
+	const auto my = static_cast<std::ptrdiff_t>(y);
+
+	for (std::size_t b = 0; b < m_bands.size(); ++b)
+	{
+		const auto& band = m_bands[b];
+
+		if (m_mode == EDemosaic::bilinear)
+		{
+			const auto p = band.photosite;
+			const auto sum = band.weights[0] * sample(p, mx, my)
+			                 + band.weights[1] * sample(p, mx + band.dx, my)
+			                 + band.weights[2] * sample(p, mx, my + band.dy)
+			                 + band.weights[3] * sample(p, mx + band.dx, my + band.dy) + 128;
+			pixel[b] = static_cast<std::uint8_t>(sum >> 8);
+		}
+		else
+		{
+			const auto count = static_cast<unsigned>(band.photosites.size());
+			auto sum = count / 2;
+			for (const auto p : band.photosites)
+			{
+				sum += sample(p, mx, my);
+			}
+			pixel[b] = static_cast<std::uint8_t>(sum / count);
+		}
+	}
+}
+
+} // namespace neurala::plug::cms
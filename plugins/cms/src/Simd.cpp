@@ -0,0 +1,96 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "Simd.h"
+
+#if defined(NEURALA_CMS_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace neurala::plug::cms
+{
+namespace
+{
+bool
+supportsAvx2() noexcept
+{
+#if defined(NEURALA_CMS_X86) && defined(__GNUC__)
+	return __builtin_cpu_supports("avx2");
+#elif defined(NEURALA_CMS_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+	{
+		return false;
+	}
+
+	// The operating system must also save the AVX registers on context switches.
+	__cpuid(info, 1);
+	if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return false;
+#endif
+}
+
+bool
+supportsSse2() noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64)
+	return true;
+#elif defined(NEURALA_CMS_X86) && defined(__GNUC__)
+	return __builtin_cpu_supports("sse2");
+#elif defined(NEURALA_CMS_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[3] & (1 << 26)) != 0;
+#else
+	return false;
+#endif
+}
+} // namespace
+
+EKernel
+bestKernel() noexcept
+{
+	static const auto kernel = supportsAvx2() ? EKernel::avx2
+	                           : supportsSse2() ? EKernel::sse2
+	                                            : EKernel::scalar;
+	return kernel;
+}
+
+const char*
+kernelName(EKernel kernel) noexcept
+{
+	switch (kernel)
+	{
+		case EKernel::avx2:
+			return "avx2";
+		case EKernel::sse2:
+			return "sse2";
+		default:
+			return "scalar";
+	}
+}
+
+} // namespace neurala::plug::cms
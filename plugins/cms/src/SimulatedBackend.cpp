@@ -0,0 +1,258 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+#include "SimulatedBackend.h"
+
+namespace neurala::plug::cms
+{
+namespace
+{
+/// Reads a positive number from the environment variable @p name, if it is set.
+template<class Type>
+void
+readSetting(const char* name, Type& value)
+{
+	const auto text = std::getenv(name);
+	if (!text)
+	{
+		return;
+	}
+
+	char* end = nullptr;
+	const auto number = std::strtod(text, &end);
+	if (end == text || *end != '\0' || !(number > 0.0))
+	{
+		throw std::invalid_argument(std::string("Invalid ") + name + ": " + text);
+	}
+
+	value = static_cast<Type>(number);
+}
+} // namespace
+
+SimulatorSettings
+SimulatorSettings::fromEnvironment()
+{
+	SimulatorSettings settings;
+	readSetting("NEURALA_CMS_SIMULATOR_WIDTH", settings.width);
+	readSetting("NEURALA_CMS_SIMULATOR_HEIGHT", settings.height);
+	readSetting("NEURALA_CMS_SIMULATOR_FRAME_RATE", settings.frameRate);
+	readSetting("NEURALA_CMS_SIMULATOR_CAMERAS", settings.cameras);
+	return settings;
+}
+
+SimulatedBackend::SimulatedBackend(const SimulatorSettings& settings, std::size_t index)
+ : m_settings(settings), m_index(index), m_pattern(defaultMosaicPattern(settings.bands))
+{
+	if (settings.bands == 0 || settings.bands > 16 || !(settings.frameRate > 0.0))
+	{
+		throw std::invalid_argument("Invalid CMS simulator settings");
+	}
+
+	// Only whole macropixels are acquired.
+	m_settings.width -= m_settings.width % m_pattern.width;
+	m_settings.height -= m_settings.height % m_pattern.height;
+
+	if (m_settings.width == 0 || m_settings.height == 0)
+	{
+		throw std::invalid_argument("The CMS simulator sensor is smaller than a macropixel");
+	}
+
+	const auto size = m_settings.width * m_settings.height;
+	m_sensor.resize(size);
+	m_acquired.resize(size);
+	m_latched.resize(size);
+
+	m_thread = std::thread(&SimulatedBackend::acquire, this);
+}
+
+SimulatedBackend::~SimulatedBackend()
+{
+	{
+		std::scoped_lock guard(m_mutex);
+		m_stop = true;
+	}
+	m_stopCV.notify_one();
+	m_thread.join();
+}
+
+std::string
+SimulatedBackend::serialNumber() const
+{
+	return m_settings.serialNumber;
+}
+
+std::string
+SimulatedBackend::cameraType() const
+{
+	return "Simulated CMS " + std::to_string(m_index);
+}
+
+void
+SimulatedBackend::setEventHandler(EventHandler handler)
+{
+	std::scoped_lock guard(m_handlerMutex);
+	m_handler = std::move(handler);
+}
+
+void
+SimulatedBackend::latchFrame()
+{
+	std::scoped_lock guard(m_mutex);
+
+	if (m_acquiredSequence != m_latchedSequence)
+	{
+		std::swap(m_acquired, m_latched);
+		m_latchedSequence = m_acquiredSequence;
+	}
+}
+
+BackendImage
+SimulatedBackend::cube()
+{
+	const auto width = m_settings.width / m_pattern.width;
+	const auto height = m_settings.height / m_pattern.height;
+	const auto bands = m_settings.bands;
+
+	std::vector<unsigned> count(bands);
+	for (const auto band : m_pattern.bands)
+	{
+		++count[band];
+	}
+
+	m_cube.resize(width * height * bands);
+	std::vector<unsigned> sum(bands);
+
+	for (std::size_t y = 0; y < height; ++y)
+	{
+		for (std::size_t x = 0; x < width; ++x)
+		{
+			std::fill(sum.begin(), sum.end(), 0);
+
+			for (std::size_t j = 0; j < m_pattern.height; ++j)
+			{
+				const auto row = m_latched.data() + (y * m_pattern.height + j) * m_settings.width
+				                 + x * m_pattern.width;
+				for (std::size_t i = 0; i < m_pattern.width; ++i)
+				{
+					sum[m_pattern.bands[j * m_pattern.width + i]] += row[i];
+				}
+			}
+
+			const auto pixel = m_cube.data() + (y * width + x) * bands;
+			for (std::size_t b = 0; b < bands; ++b)
+			{
+				pixel[b] = static_cast<std::uint8_t>(count[b] ? (sum[b] + count[b] / 2) / count[b] : 0);
+			}
+		}
+	}
+
+	return {m_cube.data(), width, height, width * bands, bands};
+}
+
+BackendImage
+SimulatedBackend::display()
+{
+	const auto bands = m_settings.bands;
+	const auto width = m_settings.width / m_pattern.width;
+	const auto height = m_settings.height / m_pattern.height;
+
+	// The bands closest to blue, green and red on the Toucan T4.
+	const std::size_t bgr[] = {bands > 5 ? 1u : 0u, bands > 5 ? 3u : bands / 2, bands > 5 ? 5u : bands - 1};
+
+	m_display.resize(width * height * 3);
+
+	for (std::size_t i = 0; i < width * height; ++i)
+	{
+		for (std::size_t c = 0; c < 3; ++c)
+		{
+			m_display[i * 3 + c] = m_cube[i * bands + bgr[c]];
+		}
+	}
+
+	return {m_display.data(), width, height, width * 3, 3};
+}
+
+BackendImage
+SimulatedBackend::raw()
+{
+	return {m_latched.data(), m_settings.width, m_settings.height, m_settings.width, 1};
+}
+
+std::uint8_t
+SimulatedBackend::photosite(std::size_t x, std::size_t y, std::size_t band, std::uint64_t sequence) noexcept
+{
+	return static_cast<std::uint8_t>(16 * band + ((x + y + sequence) & 15));
+}
+
+void
+SimulatedBackend::acquire()
+{
+	using Clock = std::chrono::steady_clock;
+
+	const auto period = std::chrono::duration_cast<Clock::duration>(
+	  std::chrono::duration<double>(1.0 / m_settings.frameRate));
+	auto deadline = Clock::now();
+
+	for (std::uint64_t sequence = 1;; ++sequence)
+	{
+		for (std::size_t y = 0; y < m_settings.height; ++y)
+		{
+			auto row = m_sensor.data() + y * m_settings.width;
+			const auto bands = m_pattern.bands.data() + (y % m_pattern.height) * m_pattern.width;
+
+			for (std::size_t x = 0; x < m_settings.width / m_pattern.width; ++x)
+			{
+				for (std::size_t i = 0; i < m_pattern.width; ++i)
+				{
+					*row++ = photosite(x, y / m_pattern.height, bands[i], sequence);
+				}
+			}
+		}
+
+		{
+			std::scoped_lock guard(m_mutex);
+			std::swap(m_sensor, m_acquired);
+			m_acquiredSequence = sequence;
+		}
+
+		{
+			std::scoped_lock guard(m_handlerMutex);
+			if (m_handler)
+			{
+				m_handler();
+			}
+		}
+
+		// Restart from now, rather than catching up with a burst of frames, after falling behind.
+		deadline = std::max(deadline + period, Clock::now());
+
+		std::unique_lock lock(m_mutex);
+		if (m_stopCV.wait_until(lock, deadline, [this] { return m_stop; }))
+		{
+			return;
+		}
+	}
+}
+
+} // namespace neurala::plug::cms
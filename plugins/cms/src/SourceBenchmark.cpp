@@ -0,0 +1,287 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Measures the frame path of CMSSource, from the acquisition of a raw frame to its copy out of the
+// source, for each output mode, and writes the results as JSON. Unless NEURALA_CMS_BACKEND selects
+// the CMS library, frames come from the simulated camera configured by the NEURALA_CMS_SIMULATOR_*
+// environment variables. When several cameras are connected, they are also streamed in parallel.
+//
+// Usage: cms_source_benchmark [--duration seconds] [--output file]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cms.h"
+
+namespace
+{
+struct Mode
+{
+	const char* name;
+	const char* bands;
+	const char* indices;
+	// Computation of the cube from the raw frame, by the camera backend if "camera".
+	const char* demosaic;
+	// Bytes per pixel of a frame.
+	std::size_t planes;
+};
+
+// Display image, all bands computed by the camera backend or demosaiced by the plugin, then three
+// bands with an NDVI-like index, on a Toucan T4.
+constexpr Mode kModes[] = {{"display", nullptr, nullptr, nullptr, 3},
+                           {"bands", "", "", "camera", 10},
+                           {"bands-nearest", "", "", "nearest", 10},
+                           {"bands-bilinear", "", "", "bilinear", 10},
+                           {"indices", "0,4,8", "8:4", "camera", 4}};
+
+// Frames handed out before measurements start, which lets the worker reach its steady state.
+constexpr int kWarmUpFrames = 5;
+
+struct Settings
+{
+	double duration = 5.0;
+	std::string output;
+};
+
+bool
+parseSettings(int argc, char** argv, Settings& settings)
+{
+	for (auto i = 1; i < argc; ++i)
+	{
+		const std::string argument = argv[i];
+
+		if (i + 1 == argc)
+		{
+			std::cerr << "Missing value for " << argument << '\n';
+			return false;
+		}
+
+		if (argument == "--duration")
+		{
+			settings.duration = std::atof(argv[++i]);
+		}
+		else if (argument == "--output")
+		{
+			settings.output = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Unknown option " << argument << '\n';
+			return false;
+		}
+	}
+
+	return settings.duration > 0.0;
+}
+
+std::uint64_t
+elapsed(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+/// Writes the statistics of @p latencies, in nanoseconds, as a JSON object.
+void
+writeLatency(std::ostream& os, std::vector<std::uint64_t>& latencies)
+{
+	std::sort(latencies.begin(), latencies.end());
+
+	const auto percentile = [&](double p) {
+		return latencies.empty() ? 0 : latencies[static_cast<std::size_t>(p / 100.0 * (latencies.size() - 1))];
+	};
+
+	os << "{\"count\":" << latencies.size() << ",\"p50\":" << percentile(50.0)
+	   << ",\"p90\":" << percentile(90.0) << ",\"p99\":" << percentile(99.0)
+	   << ",\"max\":" << percentile(100.0) << '}';
+}
+
+/// Runs a single output mode and writes its results as a JSON object.
+void
+run(const Settings& settings, const neurala::dto::CameraInfo& camera, const Mode& mode, std::ostream& os)
+{
+	neurala::Options options;
+	if (mode.bands)
+	{
+		options.add("output", std::string("bands"));
+		options.add("bands", std::string(mode.bands));
+		options.add("indices", std::string(mode.indices));
+		options.add("demosaic", std::string(mode.demosaic));
+	}
+
+	std::cerr << mode.name << "...\n";
+
+	neurala::plug::cms::CMSSource source(camera, options);
+	std::vector<std::byte> buffer;
+	std::vector<std::uint64_t> nextFrameLatency;
+	std::vector<std::uint64_t> copyLatency;
+	std::uint64_t failures = 0;
+
+	for (auto i = 0; i < kWarmUpFrames; ++i)
+	{
+		failures += source.nextFrame() ? 1 : 0;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto end = start + std::chrono::duration<double>(settings.duration);
+	auto now = start;
+
+	while (now < end)
+	{
+		const auto status = source.nextFrame();
+		const auto ready = std::chrono::steady_clock::now();
+		nextFrameLatency.push_back(elapsed(now, ready));
+
+		if (status)
+		{
+			++failures;
+			now = ready;
+			continue;
+		}
+
+		const auto metadata = source.metadata();
+		buffer.resize(metadata.width() * metadata.height() * mode.planes);
+		const auto view = source.frame(buffer.data(), buffer.size());
+		now = std::chrono::steady_clock::now();
+
+		if (!view.data())
+		{
+			++failures;
+			continue;
+		}
+
+		copyLatency.push_back(elapsed(ready, now));
+	}
+
+	const auto seconds = elapsed(start, now) / 1e9;
+	const auto metadata = source.metadata();
+
+	os << "{\"mode\":\"" << mode.name << "\",\"width\":" << metadata.width()
+	   << ",\"height\":" << metadata.height() << ",\"frameBytes\":" << buffer.size()
+	   << ",\"frames\":" << copyLatency.size() << ",\"failures\":" << failures
+	   << ",\"fps\":" << copyLatency.size() / seconds << ",\"nextFrame\":";
+	writeLatency(os, nextFrameLatency);
+	os << ",\"copy\":";
+	writeLatency(os, copyLatency);
+	os << '}';
+}
+
+/// Streams the display image of all @p cameras in parallel and writes their frame rates as a JSON object.
+void
+runParallel(const Settings& settings, const std::vector<neurala::dto::CameraInfo>& cameras, std::ostream& os)
+{
+	std::cerr << "parallel...\n";
+
+	std::vector<double> fps(cameras.size());
+	std::vector<std::thread> threads;
+
+	for (std::size_t i = 0; i < cameras.size(); ++i)
+	{
+		threads.emplace_back([&, i] {
+			neurala::plug::cms::CMSSource source(cameras[i]);
+
+			for (auto n = 0; n < kWarmUpFrames; ++n)
+			{
+				(void)source.nextFrame();
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			const auto end = start + std::chrono::duration<double>(settings.duration);
+			auto now = start;
+			std::uint64_t frames = 0;
+
+			while (now < end)
+			{
+				frames += source.nextFrame() ? 0 : 1;
+				now = std::chrono::steady_clock::now();
+			}
+
+			fps[i] = frames / (elapsed(start, now) / 1e9);
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	os << "{\"mode\":\"parallel\",\"cameras\":" << cameras.size() << ",\"fps\":[";
+	for (std::size_t i = 0; i < fps.size(); ++i)
+	{
+		os << (i == 0 ? "" : ",") << fps[i];
+	}
+	os << "]}";
+}
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+	Settings settings;
+
+	if (!parseSettings(argc, argv, settings))
+	{
+		std::cerr << "Usage: " << argv[0] << " [--duration seconds] [--output file]\n";
+		return 1;
+	}
+
+	const auto cameras = neurala::plug::cms::CMSDiscoverer()();
+	if (cameras.empty())
+	{
+		std::cerr << "No CMS camera found\n";
+		return 1;
+	}
+
+	std::ofstream file;
+	if (!settings.output.empty())
+	{
+		file.open(settings.output);
+		if (!file)
+		{
+			std::cerr << "Could not open " << settings.output << '\n';
+			return 1;
+		}
+	}
+
+	auto& os = settings.output.empty() ? std::cout : file;
+
+	os << "{\"duration\":" << settings.duration << ",\"camera\":\"" << cameras.front().id()
+	   << "\",\"results\":[";
+
+	for (const auto& mode : kModes)
+	{
+		os << (&mode == kModes ? "" : ",");
+		run(settings, cameras.front(), mode, os);
+	}
+
+	if (cameras.size() > 1)
+	{
+		os << ',';
+		runParallel(settings, cameras, os);
+	}
+
+	os << "]}\n";
+	return 0;
+}
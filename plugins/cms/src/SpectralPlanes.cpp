@@ -0,0 +1,171 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <array>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include "SpectralPlanes.h"
+
+namespace neurala::plug::cms
+{
+namespace
+{
+std::size_t
+bandNumber(const std::string& text, std::size_t bandCount)
+{
+	std::size_t parsed = 0;
+	unsigned long band = 0;
+
+	try
+	{
+		band = std::stoul(text, &parsed);
+	}
+	catch (const std::logic_error&)
+	{
+		parsed = 0;
+	}
+
+	if (parsed == 0 || parsed != text.size() || band >= bandCount)
+	{
+		throw std::invalid_argument("Invalid CMS band " + text);
+	}
+
+	return band;
+}
+
+std::vector<std::string>
+split(const std::string& text, char separator)
+{
+	std::vector<std::string> fields;
+	std::istringstream stream(text);
+
+	for (std::string field; std::getline(stream, field, separator);)
+	{
+		fields.push_back(field);
+	}
+
+	// std::getline() does not report an empty last field.
+	if (!text.empty() && text.back() == separator)
+	{
+		fields.emplace_back();
+	}
+
+	return fields;
+}
+
+/// Normalized differences of every pair of 8-bit values, indexed by (a << 8) | b.
+const std::array<std::uint8_t, 65536>&
+normalizedDifferences() noexcept
+{
+	static const auto table = [] {
+		std::array<std::uint8_t, 65536> values{};
+
+		for (int a = 0; a < 256; ++a)
+		{
+			for (int b = 0; b < 256; ++b)
+			{
+				const auto difference = a + b == 0 ? 0.0 : double(a - b) / (a + b);
+				values[(a << 8) | b] = static_cast<std::uint8_t>(std::lround((difference + 1.0) * 127.5));
+			}
+		}
+
+		return values;
+	}();
+
+	return table;
+}
+} // namespace
+
+PlaneSelection
+parsePlaneSelection(const std::string& bands, const std::string& indices, std::size_t bandCount)
+{
+	PlaneSelection selection;
+
+	if (bands.empty())
+	{
+		for (std::size_t band = 0; band < bandCount; ++band)
+		{
+			selection.bands.push_back(band);
+		}
+	}
+	else
+	{
+		for (const auto& band : split(bands, ','))
+		{
+			selection.bands.push_back(bandNumber(band, bandCount));
+		}
+	}
+
+	if (!indices.empty())
+	{
+		for (const auto& index : split(indices, ','))
+		{
+			const auto pair = split(index, ':');
+
+			if (pair.size() != 2)
+			{
+				throw std::invalid_argument("Invalid CMS index " + index);
+			}
+
+			selection.indices.push_back({bandNumber(pair[0], bandCount), bandNumber(pair[1], bandCount)});
+		}
+	}
+
+	return selection;
+}
+
+void
+extractPlanes(const std::uint8_t* cube,
+              std::size_t width,
+              std::size_t height,
+              std::size_t rowStride,
+              std::size_t bandCount,
+              const PlaneSelection& selection,
+              std::uint8_t* output) noexcept
+{
+	const auto& differences = normalizedDifferences();
+	const auto planeSize = width * height;
+	const auto bands = selection.bands.size();
+
+	for (std::size_t y = 0; y < height; ++y)
+	{
+		const auto row = cube + y * rowStride;
+		const auto target = output + y * width;
+
+		for (std::size_t x = 0; x < width; ++x)
+		{
+			const auto pixel = row + x * bandCount;
+
+			for (std::size_t i = 0; i < bands; ++i)
+			{
+				target[i * planeSize + x] = pixel[selection.bands[i]];
+			}
+
+			for (std::size_t i = 0; i < selection.indices.size(); ++i)
+			{
+				const auto& index = selection.indices[i];
+				target[(bands + i) * planeSize + x] =
+				  differences[(pixel[index.first] << 8) | pixel[index.second]];
+			}
+		}
+	}
+}
+
+} // namespace neurala::plug::cms
@@ -0,0 +1,142 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "CameraBackend.h"
+#include "cmsMultispectralLink.h"
+
+#include <cereal/archives/json.hpp>
+#include <cereal/cereal.hpp>
+
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace neurala::plug::cms
+{
+namespace
+{
+template<class Type, class Archive>
+auto deserialize(Archive& archive, const char* property) {
+	Type value;
+	archive(cereal::make_nvp(property, value));
+	return value;
+}
+
+template<class Archive>
+void load(Archive& archive, cmsMultiSpectralLink& cms)
+{
+	cms.getCmsCamera()->setFrameRate(deserialize<double>(archive, "frameRate"));
+	cms.getCmsCamera()->setGain(deserialize<double>(archive, "gain"));
+}
+
+BackendImage
+view(const IplImage* image)
+{
+	if (!image || image->depth != 8)
+	{
+		return {};
+	}
+
+	return {reinterpret_cast<const std::uint8_t*>(image->imageData),
+	        static_cast<std::size_t>(image->width),
+	        static_cast<std::size_t>(image->height),
+	        static_cast<std::size_t>(image->widthStep),
+	        static_cast<std::size_t>(image->nChannels)};
+}
+
+// The CMS library takes a plain function as event handler, which forwards to this one.
+std::mutex handlerLock;
+CameraBackend::EventHandler eventHandler;
+
+void
+cmsEventHandler()
+{
+	std::scoped_lock guard(handlerLock);
+	if (eventHandler)
+	{
+		eventHandler();
+	}
+}
+
+class VendorBackend : public CameraBackend
+{
+private:
+	cmsMultiSpectralLink m_link;
+
+public:
+	VendorBackend()
+	{
+		// m_link.getCmsCamera()->setFrameRate(10.0);
+		// m_link.getCmsCamera()->setGain(31.0);
+		// m_link.getCmsCamera()->setBlackLevel(-35);
+		m_link.getCmsCamera()->setEvent(cmsEventHandler);
+
+		std::ifstream file("NeuralaCMSOverrides.json");
+		cereal::JSONInputArchive archive(file);
+		load(archive, m_link);
+	}
+
+	~VendorBackend() override { setEventHandler(nullptr); }
+
+	std::string serialNumber() const override
+	{
+		return const_cast<cmsMultiSpectralLink&>(m_link).getCmsInfos()->getSNCMS();
+	}
+
+	std::string cameraType() const override
+	{
+		return const_cast<cmsMultiSpectralLink&>(m_link).getCmsInfos()->getTypeCamera();
+	}
+
+	void setEventHandler(EventHandler handler) override
+	{
+		std::scoped_lock guard(handlerLock);
+		eventHandler = std::move(handler);
+	}
+
+	void latchFrame() override
+	{
+		m_link.getCmsImages(0)->setImageRaw(); //set the image raw
+	}
+
+	BackendImage raw() override { return view(m_link.getCmsImages(0)->getImageRaw()); }
+
+	BackendImage cube() override
+	{
+		const auto images = m_link.getCmsImages(0);
+		images->calcImageMultisprectralCube(); //computing the multispectral cube
+		return view(images->getImageMultisprectralCube());
+	}
+
+	BackendImage display() override
+	{
+		const auto images = m_link.getCmsImages(0);
+		images->calcImageColor(); //computing of the RGB and BGR images
+		return view(images->getImageBGRDisplay());
+	}
+};
+} // namespace
+
+std::unique_ptr<CameraBackend>
+openVendorBackend()
+{
+	return std::make_unique<VendorBackend>();
+}
+
+} // namespace neurala::plug::cms
@@ -17,82 +17,360 @@
  */
 
 #include "cms.h"
-#include "cmsMultispectralLink.h"
-
-#include <cereal/archives/json.hpp>
-#include <cereal/cereal.hpp>
-
+#include "CameraBackend.h"
+#include "CMSDescription.h"
+#include "Demosaic.h"
+#include "SimulatedBackend.h"
+#include "SpectralPlanes.h"
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <string>
 #include <system_error>
+#include <thread>
 #include <utility>
+#include <vector>
 
+#include "neurala/error/B4BError.h"
+#include "neurala/image/FramePool.h"
+#include "neurala/image/PixelFormat.h"
+#include "neurala/image/views/StridedImageView.h"
 #include "neurala/plugin/PluginArguments.h"
 #include "neurala/plugin/PluginBindings.h"
 #include "neurala/plugin/PluginErrorCallback.h"
 #include "neurala/plugin/PluginManager.h"
 #include "neurala/plugin/PluginStatus.h"
+#include "neurala/utils/EventCount.h"
+#include "neurala/utils/TripleBuffer.h"
 #include "neurala/utils/Version.h"
 #include "neurala/video/dto/CameraInfo.h"
 
-namespace
+namespace neurala::plug::cms
 {
-int
-exitHere()
+/// Image computed from a raw frame, in a slot of the triple buffer of its camera.
+struct CMSFrame
 {
-	return 0;
+	// Frame of FramePool::shared(), which outputs keep rather than copy.
+	SharedFrame data;
+	dto::ImageMetadata metadata;
+	PixelFormat format;
+	// Configuration of the camera the frame was computed with.
+	std::uint64_t generation = 0;
+};
+
+/**
+ * @brief State of a connected camera, shared by the sources streaming from it.
+ *
+ * A worker thread computes the multispectral cube and the output image of the frames signaled by
+ * the backend, free running at the rate of the camera. Events raised while a frame is being
+ * computed are merged, so that the newest raw image is always the next one computed. Computed
+ * frames are published through a triple buffer, which lets the source take the newest one without
+ * waiting on the worker, while the SDK runs inference on it.
+ */
+struct CMSCamera
+{
+	std::unique_ptr<CameraBackend> backend;
+	CMSDescription description;
+
+	// Written by the worker, read by the source streaming from the camera.
+	TripleBuffer<CMSFrame> frames;
+	std::atomic<std::uint64_t> computedFrames{0};
+	// Frames computed but replaced by a newer one before being read.
+	std::atomic<std::uint64_t> droppedFrames{0};
+
+	// Signaled when a new frame is published, which wakes the source only if it waits for one.
+	EventCount frameEvent;
+
+	// Guards the members below.
+	std::mutex lock;
+	// Planes streamed in multispectral mode, none when streaming the display image.
+	PlaneSelection planeSelection;
+	// Computes the cube from the raw frame in multispectral mode, the backend computes it if null.
+	std::shared_ptr<Demosaic> demosaic;
+	// Set while a source streams from the camera.
+	bool streaming = false;
+	// Incremented by each source, so that it skips the frames computed for the previous one.
+	std::uint64_t generation = 0;
+
+	// Events signaled by the backend and not handled by the worker yet.
+	std::atomic<std::uint64_t> pendingEvents{0};
+	// Raw frames never computed because the worker fell behind.
+	std::atomic<std::uint64_t> skippedEvents{0};
+	std::atomic<bool> stopWorker{false};
+	// Signaled along with the members above, which wakes the worker only if it waits.
+	EventCount workerEvent;
+
+	// Cube computed by the demosaic, only used by the worker.
+	std::vector<std::uint8_t> cube;
+
+	std::thread worker;
+
+	explicit CMSCamera(std::unique_ptr<CameraBackend> cameraBackend);
+
+	~CMSCamera();
+
+	/**
+	 * @brief Called by the backend on its own thread when a frame has been acquired.
+	 *
+	 * It only records the event, so that the backend can go on acquiring the next frame while the
+	 * worker computes the multispectral cube of this one.
+	 */
+	void onEvent();
+
+	void computeFrames();
+
+	bool copyDisplay(const BackendImage& display, CMSFrame& frame) const;
+
+	/// Computes the cube of the latched frame from its raw mosaic with @p demosaic.
+	BackendImage demosaicRaw(Demosaic& demosaic);
+
+	/// Writes the planes of @p selection, taken from the band-interleaved @p cube, to @p frame.
+	bool extractCube(const BackendImage& cube, const PlaneSelection& selection, CMSFrame& frame) const;
+};
+
+CMSCamera::CMSCamera(std::unique_ptr<CameraBackend> cameraBackend) : backend(std::move(cameraBackend))
+{
+	// Only needed to stream the spectral bands.
+	loadDescription(descriptionPath(backend->serialNumber()), description);
+
+	backend->setEventHandler([this] { onEvent(); });
+	worker = std::thread(&CMSCamera::computeFrames, this);
+}
+
+CMSCamera::~CMSCamera()
+{
+	backend->setEventHandler(nullptr);
+
+	stopWorker = true;
+	workerEvent.notifyAll();
+
+	worker.join();
+}
+
+void
+CMSCamera::onEvent()
+{
+	++pendingEvents;
+	workerEvent.notifyAll();
+}
+
+bool
+CMSCamera::copyDisplay(const BackendImage& display, CMSFrame& frame) const
+{
+	if (!display.data || display.channels != 3)
+	{
+		puts("Unsupported CMS display image format");
+		return false;
+	}
+
+	frame.format = kBGR8;
+	frame.metadata = frame.format.metadata(display.width, display.height);
+
+	// The previous frame of the slot goes back to the pool first, so that its buffer is reused
+	// unless an output still holds it.
+	const auto rowSize = display.width * 3;
+	frame.data = {};
+	frame.data = FramePool::shared().allocate(frame.metadata, rowSize * display.height);
+	const auto data = frame.data.write();
+
+	for (std::size_t y = 0; y < display.height; ++y)
+	{
+		std::memcpy(data + y * rowSize, display.data + y * display.stride, rowSize);
+	}
+
+	return true;
+}
+
+BackendImage
+CMSCamera::demosaicRaw(Demosaic& demosaic)
+{
+	const auto raw = backend->raw();
+	const auto& pattern = demosaic.pattern();
+	if (!raw.data || raw.channels != 1 || raw.width < pattern.width || raw.height < pattern.height)
+	{
+		return {};
+	}
+
+	BackendImage image;
+	image.width = raw.width / pattern.width;
+	image.height = raw.height / pattern.height;
+	image.channels = demosaic.bands();
+	image.stride = image.width * image.channels;
+
+	cube.resize(image.stride * image.height);
+	demosaic(raw.data, raw.stride, raw.width, raw.height, cube.data(), image.stride);
+
+	image.data = cube.data();
+	return image;
 }
 
-std::unique_ptr<cmsMultiSpectralLink> multiSpectralLink;
-std::mutex cmsLock;
-std::condition_variable cmsCV;
+bool
+CMSCamera::extractCube(const BackendImage& cube, const PlaneSelection& selection, CMSFrame& frame) const
+{
+	if (!cube.data || cube.channels != description.bands())
+	{
+		puts("Unsupported CMS multispectral cube format");
+		return false;
+	}
+
+	frame.format = PixelFormat(EDatatype::uint8,
+	                           EColorSpace::multispectral,
+	                           ELayout::planar,
+	                           EOrientation::topLeft,
+	                           selection.planes());
+	frame.metadata = frame.format.metadata(cube.width, cube.height);
 
-neurala::dto::ImageMetadata cmsMetadata;
-neurala::dto::ImageView cmsFrame;
+	frame.data = {};
+	frame.data = FramePool::shared().allocate(frame.metadata, cube.width * cube.height * selection.planes());
+	const auto data = reinterpret_cast<std::uint8_t*>(frame.data.write());
 
-bool waitingForFrame;
+	extractPlanes(cube.data, cube.width, cube.height, cube.stride, description.bands(), selection, data);
+	return true;
+}
 
 void
-cmsEventHandler()
+CMSCamera::computeFrames()
 {
+	for (;;)
 	{
-		std::scoped_lock guard(cmsLock);
+		workerEvent.wait([this] { return stopWorker || pendingEvents > 0; });
 
-		if (waitingForFrame)
+		if (stopWorker)
 		{
-			waitingForFrame = false;
-			multiSpectralLink->getCmsImages(0)->setImageRaw(); //set the image raw
-			multiSpectralLink->getCmsImages(0)->calcImageMultisprectralCube(); //computing the multispectral cube
-			multiSpectralLink->getCmsImages(0)->calcImageColor(); //computing of the RGB and BGR images
+			return;
+		}
 
-			const auto display = multiSpectralLink->getCmsImages(0)->getImageBGRDisplay();
+		skippedEvents += pendingEvents.exchange(0) - 1;
 
-			cmsMetadata = neurala::dto::ImageMetadata("uint8", display->width, display->height, "BGR", "interleaved", "topLeft");
-			cmsFrame = neurala::dto::ImageView(cmsMetadata, display->imageData);
+		try
+		{
+			PlaneSelection selection;
+			std::shared_ptr<Demosaic> demosaic;
+			std::uint64_t configuration = 0;
+			{
+				std::scoped_lock guard(lock);
+				if (!streaming)
+				{
+					continue;
+				}
+
+				selection = planeSelection;
+				demosaic = this->demosaic;
+				configuration = generation;
+			}
+
+			auto& frame = frames.back();
+			frame.generation = configuration;
+			backend->latchFrame();
+
+			if (selection.planes() == 0)
+			{
+				// The display image is computed from the cube of the backend.
+				backend->cube();
+				if (!copyDisplay(backend->display(), frame))
+				{
+					continue;
+				}
+			}
+			else if (!extractCube(demosaic ? demosaicRaw(*demosaic) : backend->cube(), selection, frame))
+			{
+				continue;
+			}
+
+			++computedFrames;
+			if (frames.publish())
+			{
+				++droppedFrames;
+			}
+
+			frameEvent.notifyAll();
+		}
+		catch (const std::exception& e)
+		{
+			puts(e.what());
 		}
 	}
+}
+} // namespace neurala::plug::cms
+
+namespace
+{
+using neurala::plug::cms::CMSCamera;
+
+// Guards the cameras below.
+std::mutex camerasLock;
+// Cameras opened by the discoverer, by connection.
+std::map<std::string, std::shared_ptr<CMSCamera>> cameras;
 
-	cmsCV.notify_all();
+/// Opens the camera at @p connection unless it is already open. camerasLock must be held.
+template<class Open>
+void
+openCamera(const std::string& connection, Open open)
+{
+	if (cameras.count(connection))
+	{
+		return;
+	}
+
+	auto backend = open();
+
+	if (backend->serialNumber() == "")
+	{
+		puts("XML File Missing in ResourcesCMS");
+		return;
+	}
+
+	cameras.emplace(connection, std::make_shared<CMSCamera>(std::move(backend)));
 }
 
-template<class Type, class Archive>
-auto deserialize(Archive& archive, const char* property) {
-	Type value;
-	archive(cereal::make_nvp(property, value));
-	return value;
+/// Opens the cameras which are not open yet. camerasLock must be held.
+void
+discoverCameras()
+{
+	using namespace neurala::plug::cms;
+
+#ifdef NEURALA_CMS_VENDOR_BACKEND
+	// The CMS library only gives access to the first camera.
+	const auto name = std::getenv("NEURALA_CMS_BACKEND");
+	if (!name || std::string(name) != "simulator")
+	{
+		openCamera("0", openVendorBackend);
+		return;
+	}
+#endif
+
+	const auto settings = SimulatorSettings::fromEnvironment();
+
+	for (std::size_t i = 0; i < settings.cameras; ++i)
+	{
+		openCamera(std::to_string(i), [&] { return std::make_unique<SimulatedBackend>(settings, i); });
+	}
 }
 
-template<class Archive>
-void load(Archive& archive, cmsMultiSpectralLink& cms)
+int
+exitHere()
 {
-	cms.getCmsCamera()->setFrameRate(deserialize<double>(archive, "frameRate"));
-	cms.getCmsCamera()->setGain(deserialize<double>(archive, "gain"));
+	std::scoped_lock guard(camerasLock);
+	cameras.clear();
+	return 0;
 }
+
+/// Stops the cameras when the plugin is unloaded without calling exitHere(), as in tests.
+struct Shutdown
+{
+	~Shutdown() { exitHere(); }
+} shutdown;
 } // namespace
 
 extern "C" PLUGIN_API NeuralaPluginExitFunction
@@ -120,38 +398,25 @@ namespace neurala::plug::cms
 std::vector<dto::CameraInfo>
 CMSDiscoverer::operator()() const noexcept
 {
-	if (!multiSpectralLink)
-	{
-		multiSpectralLink = std::make_unique<cmsMultiSpectralLink>();
-		// multiSpectralLink->getCmsCamera()->setFrameRate(10.0);
-		// multiSpectralLink->getCmsCamera()->setGain(31.0);
-		// multiSpectralLink->getCmsCamera()->setBlackLevel(-35);
-		multiSpectralLink->getCmsCamera()->setEvent(cmsEventHandler);
-
-		try
-		{
-			std::ifstream file("NeuralaCMSOverrides.json");
-			cereal::JSONInputArchive archive(file);
-			load(archive, *multiSpectralLink);
-		}
-		catch (const std::exception& e)
-		{
-			const auto error = e.what();
-			puts(error);
-			return std::vector<dto::CameraInfo>();
-		}
+	std::vector<dto::CameraInfo> cameraInformation;
+	std::scoped_lock guard(camerasLock);
 
-		if (multiSpectralLink->getCmsInfos()->getSNCMS() == "")
-		{
-			puts("XML File Missing in ResourcesCMS");
-			return std::vector<dto::CameraInfo>();
-		}
+	try
+	{
+		discoverCameras();
+	}
+	catch (const std::exception& e)
+	{
+		const auto error = e.what();
+		puts(error);
 	}
 
-	const auto id = multiSpectralLink->getCmsInfos()->getTypeCamera();
+	for (const auto& [connection, camera] : cameras)
+	{
+		const auto id = camera->backend->cameraType();
+		cameraInformation.emplace_back(id, "cmsVideoSource", "TOUCAN Multispectral Camera", connection);
+	}
 
-	std::vector<dto::CameraInfo> cameraInformation;
-	cameraInformation.emplace_back(id, "cmsVideoSource", "TOUCAN Multispectral Camera", "0");
 	return cameraInformation;
 }
 
@@ -175,63 +440,183 @@ CMSDiscoverer::destroy(void* p)
 	delete static_cast<CMSDiscoverer*>(p);
 }
 
-CMSSource::CMSSource()
+CMSSource::CMSSource(const dto::CameraInfo& cameraInfo, const Options& options)
+{
+	{
+		std::scoped_lock guard(camerasLock);
+
+		if (!cameras.count(cameraInfo.connection()))
+		{
+			discoverCameras();
+		}
+
+		const auto camera = cameras.find(cameraInfo.connection());
+		if (camera == cameras.end())
+		{
+			throw std::invalid_argument("No CMS camera at connection " + cameraInfo.connection());
+		}
+
+		m_camera = camera->second;
+	}
+
+	const auto timeout = options.asInt("timeout", 30000);
+	if (timeout < 0)
+	{
+		throw std::invalid_argument("Invalid CMS timeout " + std::to_string(timeout));
+	}
+	m_timeout = std::chrono::milliseconds(timeout);
+	m_statsFile = options.asString("statsFile", "");
+
+	const auto output = options.asString("output", "display");
+	PlaneSelection selection;
+	std::shared_ptr<Demosaic> demosaic;
+
+	if (output == "bands")
+	{
+		const auto bands = m_camera->description.bands();
+		if (bands == 0)
+		{
+			throw std::runtime_error("The CMS camera description could not be read from ResourcesCMS");
+		}
+
+		selection =
+		  parsePlaneSelection(options.asString("bands", ""), options.asString("indices", ""), bands);
+
+		const auto mode = options.asString("demosaic", "camera");
+		if (mode == "nearest" || mode == "bilinear")
+		{
+			const auto mosaic = options.asString("mosaic", "");
+			const auto pattern = mosaic.empty() ? defaultMosaicPattern(bands) : parseMosaicPattern(mosaic);
+			demosaic = std::make_shared<Demosaic>(
+			  pattern, mode == "nearest" ? EDemosaic::nearest : EDemosaic::bilinear);
+
+			if (demosaic->bands() != bands)
+			{
+				throw std::invalid_argument("The CMS mosaic pattern does not have " + std::to_string(bands)
+				                            + " bands");
+			}
+		}
+		else if (mode != "camera")
+		{
+			throw std::invalid_argument("Invalid CMS demosaic " + mode);
+		}
+	}
+	else if (output != "display")
+	{
+		throw std::invalid_argument("Invalid CMS output " + output);
+	}
+
+	std::scoped_lock guard(m_camera->lock);
+
+	// The frames of a camera can only be read by one source.
+	if (m_camera->streaming)
+	{
+		throw std::invalid_argument("The CMS camera at connection " + cameraInfo.connection()
+		                            + " is already streaming");
+	}
+
+	m_camera->streaming = true;
+	m_camera->planeSelection = std::move(selection);
+	m_camera->demosaic = std::move(demosaic);
+	m_generation = ++m_camera->generation;
+}
+
+CMSSource::~CMSSource() noexcept
 {
-	
+	std::scoped_lock guard(m_camera->lock);
+	m_camera->streaming = false;
 }
 
 dto::ImageMetadata
 CMSSource::metadata() const noexcept
 {
-	return cmsMetadata;
+	return m_metadata;
 }
 
 std::error_code
 CMSSource::nextFrame() noexcept
 {
-	using namespace std::chrono_literals;
+	auto& camera = *m_camera;
 
-	std::unique_lock<std::mutex> lock(cmsLock);
+	const auto deadline = std::chrono::steady_clock::now() + m_timeout;
 
-	waitingForFrame = true;
-
-	// Make this timeout configurable.
-	const auto deadline = std::chrono::steady_clock::now() + 30s;
-
-	while (true)
+	// The SDK is done with the previous frame, so its slot can be handed back to the worker.
+	// Frames computed for a previous source are skipped, as they may not have the same format.
+	for (auto fresh = camera.frames.read(); !fresh || camera.frames.front().generation != m_generation;
+	     fresh = camera.frames.read())
 	{
-		const auto status = cmsCV.wait_until(lock, deadline);
-
-		if (status == std::cv_status::no_timeout && !waitingForFrame)
-		{
-			break;
-		}
-		if (status == std::cv_status::timeout)
+		if (!camera.frameEvent.waitFor(deadline - std::chrono::steady_clock::now(),
+		                               [&camera] { return camera.frames.fresh(); }))
 		{
-			break;
+			return make_error_code(VideoSourceStatus::timeout());
 		}
 	}
 
-	const auto status = std::exchange(waitingForFrame, false) ? VideoSourceStatus::timeout() : VideoSourceStatus::success();
+	m_frame = &camera.frames.front();
+	m_metadata = m_frame->metadata;
+	++m_deliveredFrames;
 
-	return make_error_code(status);
+	return make_error_code(VideoSourceStatus::success());
 }
 
 dto::ImageView
 CMSSource::frame() const noexcept
 {
-	return cmsFrame;
+	return m_frame ? dto::ImageView(m_metadata, m_frame->data.data()) : dto::ImageView();
 }
 
 dto::ImageView
 CMSSource::frame(std::byte* data, std::size_t size) const noexcept
 {
-	return cmsFrame = dto::ImageView(metadata(), data);
+	if (!m_frame)
+	{
+		return {};
+	}
+
+	const StridedImageView view(m_metadata, m_frame->data.data(), 0, m_frame->format.channels());
+	return view.copyTo(data, size);
+}
+
+void
+CMSSource::writeStatistics(std::ostream& os) const
+{
+	os << "{\"computedFrames\":" << m_camera->computedFrames << ",\"deliveredFrames\":" << m_deliveredFrames
+	   << ",\"droppedFrames\":" << m_camera->droppedFrames << ",\"skippedRawFrames\":" << m_camera->skippedEvents
+	   << "}\n";
 }
 
 std::error_code
 CMSSource::execute(const std::string& action) noexcept
 {
+	if (action == "stats")
+	{
+		try
+		{
+			// Statistics go to the file named by the "statsFile" option, if any.
+			if (!m_statsFile.empty())
+			{
+				std::ofstream file(m_statsFile, std::ios::app);
+				writeStatistics(file);
+			}
+			else
+			{
+				writeStatistics(std::clog);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Error while writing CMS statistics: " << e.what() << '\n';
+			return B4BError::genericError();
+		}
+	}
+	else if (action == "resetStats")
+	{
+		m_deliveredFrames = 0;
+		m_camera->computedFrames = 0;
+		m_camera->droppedFrames = 0;
+		m_camera->skippedEvents = 0;
+	}
+
 	return std::error_code();
 }
 
@@ -242,7 +627,10 @@ CMSSource::create(PluginArguments& arguments, PluginErrorCallback& error)
 
 	try
 	{
-		p = new CMSSource();
+		const auto& cameraInfo = arguments.get<0, const dto::CameraInfo>();
+		const auto& cameraOptions = arguments.get<1, const Options>();
+
+		p = new CMSSource(cameraInfo, cameraOptions);
 	}
 	catch (const std::exception& e)
 	{
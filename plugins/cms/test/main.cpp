@@ -0,0 +1,439 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "CMSDescription.h"
+#include "Crosstalk.h"
+#include "Demosaic.h"
+#include "SimulatedBackend.h"
+#include "SpectralPlanes.h"
+
+#include "neurala/utils/TripleBuffer.h"
+
+namespace
+{
+using namespace neurala::plug::cms;
+using neurala::TripleBuffer;
+
+int failures = 0;
+
+void
+check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		std::cerr << "FAILED: " << what << '\n';
+		++failures;
+	}
+}
+
+std::vector<std::uint8_t>
+syntheticCube(std::size_t width, std::size_t height, std::size_t bands, unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<int> value(0, 255);
+	std::vector<std::uint8_t> cube(width * height * bands);
+
+	for (auto& v : cube)
+	{
+		v = static_cast<std::uint8_t>(value(generator));
+	}
+
+	return cube;
+}
+
+void
+testDescription()
+{
+	CMSDescription description;
+
+	check(loadDescription(NEURALA_CMS_RESOURCES_DIR "/Toucan_T4.xml", description),
+	      "Toucan T4 description is read");
+	check(description.siliosSN == "Toucan-T4", "serial number is read");
+	check(description.bands() == 10, "10 bands are described");
+	check(description.filterCentering.front() == 430.0 && description.filterCentering.back() == 870.0,
+	      "band centers are read");
+	check(description.crosstalkCorrectionCoefficients.size() == 100, "crosstalk matrix is 10x10");
+	check(description.crosstalkCorrectionCoefficients.front() == 0.9948
+	        && description.crosstalkCorrectionCoefficients[1] == -0.0966
+	        && description.crosstalkCorrectionCoefficients.back() == 1.7008,
+	      "crosstalk coefficients are read");
+
+	check(!loadDescription(NEURALA_CMS_RESOURCES_DIR "/missing.xml", description),
+	      "missing description is reported");
+	check(descriptionPath("Toucan-T4") == "ResourcesCMS/Toucan_T4.xml", "description path");
+}
+
+void
+testIdentity()
+{
+	const std::size_t bands = 10;
+	std::vector<double> identity(bands * bands);
+	for (std::size_t i = 0; i < bands; ++i)
+	{
+		identity[i * bands + i] = 1.0;
+	}
+
+	const auto cube = syntheticCube(33, 17, bands, 1);
+	std::vector<std::uint8_t> corrected(cube.size());
+
+	CrosstalkCorrection correction(identity, bands, 2);
+	correction(cube.data(), 33 * bands, corrected.data(), 33 * bands, 33, 17);
+
+	check(corrected == cube, "identity correction leaves the cube unchanged");
+}
+
+void
+testKernels(const std::vector<double>& coefficients)
+{
+	const std::size_t bands = 10;
+	// An odd width exercises the scalar tail of the SIMD kernels, a height over a block the threads.
+	const std::size_t width = 101;
+	const std::size_t height = 45;
+	const std::size_t stride = width * bands + 7;
+
+	std::vector<std::uint8_t> cube(stride * height);
+	const auto pixels = syntheticCube(width, height, bands, 2);
+	for (std::size_t y = 0; y < height; ++y)
+	{
+		std::copy_n(pixels.data() + y * width * bands, width * bands, cube.data() + y * stride);
+	}
+
+	const std::vector<float> matrix(coefficients.begin(), coefficients.end());
+	std::vector<std::uint8_t> expected(width * height * bands);
+	for (std::size_t y = 0; y < height; ++y)
+	{
+		for (std::size_t x = 0; x < width; ++x)
+		{
+			correctPixel(matrix.data(), bands, cube.data() + y * stride + x * bands,
+			             expected.data() + (y * width + x) * bands);
+		}
+	}
+
+	for (const auto threads : {1, 4})
+	{
+		for (const auto kernel : {CrosstalkCorrection::EKernel::scalar,
+		                          CrosstalkCorrection::EKernel::sse2,
+		                          CrosstalkCorrection::EKernel::avx2})
+		{
+			CrosstalkCorrection correction(coefficients, bands, threads);
+			correction.kernel(kernel);
+
+			std::vector<std::uint8_t> corrected(expected.size());
+			correction(cube.data(), stride, corrected.data(), width * bands, width, height);
+
+			auto maximumError = 0;
+			for (std::size_t i = 0; i < corrected.size(); ++i)
+			{
+				maximumError = std::max(maximumError, std::abs(corrected[i] - expected[i]));
+			}
+
+			// SIMD kernels sum in the same order, but may differ by one on rounding ties.
+			check(maximumError <= 1, "kernel matches the reference implementation");
+
+			// In place correction, with the input and output strides equal.
+			auto inPlace = pixels;
+			correction(inPlace.data(), width * bands, inPlace.data(), width * bands, width, height);
+			check(inPlace == corrected, "in place correction matches");
+		}
+	}
+}
+
+void
+testSaturation()
+{
+	const std::size_t bands = 2;
+	const std::vector<double> coefficients = {4.0, 0.0, -1.0, 0.0};
+	const std::vector<std::uint8_t> cube = {100, 0, 10, 0, 50, 0, 0, 0};
+	std::vector<std::uint8_t> corrected(cube.size());
+
+	CrosstalkCorrection correction(coefficients, bands, 1);
+	for (const auto kernel : {CrosstalkCorrection::EKernel::scalar,
+	                          CrosstalkCorrection::EKernel::sse2,
+	                          CrosstalkCorrection::EKernel::avx2})
+	{
+		correction.kernel(kernel);
+		correction(cube.data(), 8, corrected.data(), 8, 4, 1);
+		check(corrected == std::vector<std::uint8_t>{255, 0, 40, 0, 200, 0, 0, 0},
+		      "corrected values saturate to [0, 255]");
+	}
+
+	bool thrown = false;
+	try
+	{
+		CrosstalkCorrection invalid({1.0, 0.0, 0.0}, 2);
+	}
+	catch (const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	check(thrown, "mismatched matrix is rejected");
+}
+
+void
+testPlanes()
+{
+	const auto selection = parsePlaneSelection("2,0", "0:1,1:0", 3);
+	check(selection.planes() == 4, "selected planes are counted");
+
+	// Two pixels of three bands.
+	const std::vector<std::uint8_t> cube = {255, 0, 7, 40, 40, 9};
+	std::vector<std::uint8_t> planes(2 * selection.planes());
+	extractPlanes(cube.data(), 2, 1, cube.size(), 3, selection, planes.data());
+
+	check(planes == std::vector<std::uint8_t>{7, 9, 255, 40, 255, 128, 0, 128},
+	      "bands and normalized differences are extracted");
+
+	check(parsePlaneSelection("", "", 10).planes() == 10, "all bands are selected by default");
+
+	for (const auto* invalid : {"10", "x", "1,", "-1"})
+	{
+		bool thrown = false;
+		try
+		{
+			parsePlaneSelection(invalid, "", 10);
+		}
+		catch (const std::invalid_argument&)
+		{
+			thrown = true;
+		}
+		check(thrown, "invalid bands are rejected");
+	}
+}
+
+void
+testSimulator()
+{
+	SimulatorSettings settings;
+	settings.width = 66;
+	settings.height = 64;
+	settings.frameRate = 200.0;
+
+	SimulatedBackend backend(settings);
+	std::atomic<int> events{0};
+	backend.setEventHandler([&] { ++events; });
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	check(events > 5, "the simulator raises an event per frame");
+
+	backend.latchFrame();
+	const auto sequence = backend.latchedSequence();
+	check(sequence > 0, "a frame is latched");
+	check(backend.raw().width == 64 && backend.raw().height == 64, "only whole macropixels are acquired");
+
+	const auto cube = backend.cube();
+	check(cube.width == 16 && cube.height == 16 && cube.channels == 10, "cube size");
+
+	bool exact = true;
+	for (std::size_t y = 0; y < cube.height; ++y)
+	{
+		for (std::size_t x = 0; x < cube.width; ++x)
+		{
+			for (std::size_t b = 0; b < cube.channels; ++b)
+			{
+				exact &= cube.data[y * cube.stride + x * cube.channels + b]
+				         == SimulatedBackend::photosite(x, y, b, sequence);
+			}
+		}
+	}
+	check(exact, "the cube holds the photosites of the latched frame");
+
+	const auto raw = backend.raw();
+	Demosaic demosaic(backend.pattern(), EDemosaic::nearest);
+	std::vector<std::uint8_t> demosaiced(cube.stride * cube.height);
+	demosaic(raw.data, raw.stride, raw.width, raw.height, demosaiced.data(), cube.stride);
+	check(std::equal(demosaiced.begin(), demosaiced.end(), cube.data),
+	      "nearest demosaic matches the cube");
+
+	const auto display = backend.display();
+	check(display.channels == 3 && display.data[0] == cube.data[1] && display.data[2] == cube.data[5],
+	      "the display image is made of three bands");
+
+	backend.setEventHandler(nullptr);
+}
+
+void
+testDemosaic()
+{
+	check(parseMosaicPattern("2x2:0,1,1,2").bands == std::vector<std::uint8_t>{0, 1, 1, 2},
+	      "mosaic pattern is parsed");
+	for (const auto invalid :
+	     {"", "2x2", "2x2:0,1,1", "2x:0,1", "2x1:0,a", "0x0:", "1x1:256", "2x1:0,,1"})
+	{
+		auto rejected = false;
+		try
+		{
+			parseMosaicPattern(invalid);
+		}
+		catch (const std::invalid_argument&)
+		{
+			rejected = true;
+		}
+		check(rejected, "invalid mosaic pattern is rejected");
+	}
+
+	// Bands of 1, 2 and 3 photosites, and the vectorized 4 photosite wide pattern.
+	const MosaicPattern patterns[] = {defaultMosaicPattern(10), parseMosaicPattern("3x2:0,1,0,2,0,1")};
+
+	for (const auto& pattern : patterns)
+	{
+		// Partial macropixels are ignored, more than 32 macropixels exercise the SIMD kernels and
+		// their scalar tails, and more than 16 rows the threads.
+		const auto width = pattern.width * 37 + pattern.width - 1;
+		const auto height = pattern.height * 35 + 1;
+		const auto rawStride = width + 5;
+		const auto raw = syntheticCube(rawStride, height, 1, 3);
+		const auto cubeWidth = width / pattern.width;
+		const auto cubeHeight = height / pattern.height;
+
+		for (const auto mode : {EDemosaic::nearest, EDemosaic::bilinear})
+		{
+			Demosaic reference(pattern, mode, 1);
+			const auto bands = reference.bands();
+			const auto cubeStride = cubeWidth * bands + 3;
+
+			std::vector<std::uint8_t> expected(cubeStride * cubeHeight);
+			for (std::size_t y = 0; y < cubeHeight; ++y)
+			{
+				for (std::size_t x = 0; x < cubeWidth; ++x)
+				{
+					reference.reference(raw.data(), rawStride, width, height, x, y,
+					                    expected.data() + y * cubeStride + x * bands);
+				}
+			}
+
+			for (const auto threads : {1, 4})
+			{
+				for (const auto kernel :
+				     {Demosaic::EKernel::scalar, Demosaic::EKernel::sse2, Demosaic::EKernel::avx2})
+				{
+					Demosaic demosaic(pattern, mode, threads);
+					demosaic.kernel(kernel);
+
+					std::vector<std::uint8_t> cube(expected.size());
+					demosaic(raw.data(), rawStride, width, height, cube.data(), cubeStride);
+
+					auto exact = true;
+					for (std::size_t y = 0; y < cubeHeight; ++y)
+					{
+						const auto row = y * cubeStride;
+						exact &= std::equal(cube.begin() + row,
+						                    cube.begin() + row + cubeWidth * bands,
+						                    expected.begin() + row);
+					}
+					check(exact, "demosaic kernel matches the reference implementation");
+				}
+			}
+		}
+	}
+
+	// Interpolating a uniform band gives its value.
+	const auto pattern = defaultMosaicPattern(10);
+	std::vector<std::uint8_t> raw(64 * 64);
+	for (std::size_t i = 0; i < raw.size(); ++i)
+	{
+		raw[i] = static_cast<std::uint8_t>(20 * pattern.band(i % 64 % 4, i / 64 % 4));
+	}
+
+	Demosaic bilinear(pattern, EDemosaic::bilinear);
+	std::vector<std::uint8_t> cube(16 * 16 * 10);
+	bilinear(raw.data(), 64, 64, 64, cube.data(), 16 * 10);
+
+	auto uniform = true;
+	for (std::size_t i = 0; i < cube.size(); ++i)
+	{
+		uniform &= cube[i] == 20 * (i % 10);
+	}
+	check(uniform, "bilinear demosaic keeps uniform bands");
+}
+
+void
+testTripleBuffer()
+{
+	struct Value
+	{
+		std::uint64_t first = 0;
+		std::uint64_t second = 0;
+	};
+
+	TripleBuffer<Value> buffer;
+	check(!buffer.read(), "nothing is read before a value is published");
+
+	buffer.back() = {1, 1};
+	check(!buffer.publish(), "the first value is not dropped");
+	buffer.back() = {2, 2};
+	check(buffer.publish(), "an unread value is dropped");
+	check(buffer.read() && buffer.front().first == 2, "the latest value is read");
+	check(!buffer.read(), "a value is read once");
+
+	// The reader never sees torn or older values.
+	constexpr std::uint64_t kValues = 200000;
+	std::thread writer([&] {
+		for (std::uint64_t i = 3; i <= kValues; ++i)
+		{
+			buffer.back() = {i, i};
+			buffer.publish();
+		}
+	});
+
+	std::uint64_t last = 2;
+	bool consistent = true;
+	while (last < kValues)
+	{
+		if (buffer.read())
+		{
+			const auto value = buffer.front();
+			consistent &= value.first == value.second && value.first > last;
+			last = value.first;
+		}
+	}
+	writer.join();
+	check(consistent, "values are exchanged whole and in order");
+}
+} // namespace
+
+int
+main()
+{
+	testDescription();
+	testIdentity();
+	testSaturation();
+	testPlanes();
+	testSimulator();
+	testDemosaic();
+	testTripleBuffer();
+
+	CMSDescription description;
+	if (loadDescription(NEURALA_CMS_RESOURCES_DIR "/Toucan_T4.xml", description))
+	{
+		testKernels(description.crosstalkCorrectionCoefficients);
+	}
+
+	std::cout << (failures == 0 ? "All CMS tests passed\n" : "Some CMS tests failed\n");
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
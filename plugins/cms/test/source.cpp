@@ -0,0 +1,155 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "cms.h"
+#include "neurala/image/views/StridedImageView.h"
+
+namespace
+{
+int failures = 0;
+
+void
+check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		std::cerr << "FAILED: " << what << '\n';
+		++failures;
+	}
+}
+
+void
+setVariable(const char* name, const char* value)
+{
+#ifdef _WIN32
+	_putenv_s(name, value);
+#else
+	setenv(name, value, 1);
+#endif
+}
+} // namespace
+
+int
+main()
+{
+	using namespace neurala;
+
+	// The bands of the cameras are read from their description in ResourcesCMS.
+	std::filesystem::current_path(std::filesystem::path(NEURALA_CMS_RESOURCES_DIR).parent_path());
+
+	setVariable("NEURALA_CMS_BACKEND", "simulator");
+	setVariable("NEURALA_CMS_SIMULATOR_WIDTH", "256");
+	setVariable("NEURALA_CMS_SIMULATOR_HEIGHT", "128");
+	setVariable("NEURALA_CMS_SIMULATOR_FRAME_RATE", "100");
+	setVariable("NEURALA_CMS_SIMULATOR_CAMERAS", "2");
+
+	const auto cameras = plug::cms::CMSDiscoverer()();
+	check(cameras.size() == 2, "every simulated camera is discovered");
+	check(cameras.size() == 2 && cameras[0].connection() != cameras[1].connection()
+	        && cameras[0].id() != cameras[1].id(),
+	      "cameras have their own connection and id");
+
+	// Stream from both cameras in parallel.
+	std::vector<int> frames(cameras.size());
+	std::vector<std::thread> threads;
+
+	for (std::size_t i = 0; i < cameras.size(); ++i)
+	{
+		threads.emplace_back([&, i] {
+			plug::cms::CMSSource source(cameras[i]);
+			for (auto n = 0; n < 5; ++n)
+			{
+				if (!source.nextFrame() && source.frame().data())
+				{
+					++frames[i];
+				}
+			}
+
+			const auto metadata = source.metadata();
+			check(metadata.width() == 64 && metadata.height() == 32 && metadata.colorSpace() == "BGR",
+			      "frames are the display image of the cube");
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	check(frames == std::vector<int>{5, 5}, "each camera streams its frames");
+
+	const auto rejected = [](const dto::CameraInfo& camera, const Options& options) {
+		try
+		{
+			plug::cms::CMSSource source(camera, options);
+		}
+		catch (const std::invalid_argument&)
+		{
+			return true;
+		}
+		return false;
+	};
+
+	check(rejected(dto::CameraInfo("cms", "cmsVideoSource", "cms", "2"), {}),
+	      "unknown connections are rejected");
+	check(rejected(cameras[0], Options("timeout", -1)), "negative timeouts are rejected");
+
+	{
+		plug::cms::CMSSource source(cameras[0], Options("timeout", 1000));
+		check(rejected(cameras[0], {}), "a camera streams to a single source");
+		check(!source.nextFrame(), "the source streams with a timeout");
+
+		std::vector<std::byte> buffer(requiredBytes(source.metadata()));
+		check(!buffer.empty() && source.frame(buffer.data(), buffer.size()).data() == buffer.data(),
+		      "frames are copied to buffers of the required size");
+		check(!source.frame(buffer.data(), buffer.size() - 1).data(), "smaller buffers are rejected");
+		check(!source.execute("stats") && !source.execute("resetStats"), "statistics are written");
+	}
+	check(!rejected(cameras[0], {}), "a camera can stream again once its source is destroyed");
+
+	{
+		// The camera keeps computing frames for the display while the next source is created.
+		{
+			plug::cms::CMSSource source(cameras[1]);
+			check(!source.nextFrame(), "the display is streamed");
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		}
+
+		plug::cms::CMSSource source(cameras[1], Options("output", "bands").add("bands", "0,2"));
+		check(!source.nextFrame(), "the bands are streamed");
+
+		const auto metadata = source.metadata();
+		std::vector<std::byte> buffer(64 * 32 * 2);
+		check(metadata.colorSpace() == "multispectral" && metadata.layout() == "planar"
+		        && metadata.width() == 64 && metadata.height() == 32
+		        && source.frame(buffer.data(), buffer.size()).data()
+		        && !source.frame(buffer.data(), buffer.size() - 1).data(),
+		      "the first frame of a source has its own format");
+	}
+
+	std::cout << (failures == 0 ? "All CMS source tests passed\n" : "Some CMS source tests failed\n");
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -20,7 +20,11 @@
 #define NEURALA_DUMMY_PLUGIN_H
 
 #include <cstdint>
+#include <vector>
 
+#include "neurala/image/FramePool.h"
+#include "neurala/image/PixelConversion.h"
+#include "neurala/image/views/StridedImageView.h"
 #include "neurala/plugin/PluginBindings.h"
 
 #include "neurala/utils/ResultsOutput.h"
@@ -46,6 +50,9 @@ public:
 
 /**
  * @brief Dummy plugin video input based on VideoInputOCV
+ *
+ * It simulates a 12-bit sensor with a plane per channel, whose frames are handed out as 8-bit
+ * interleaved RGB.
  */
 class PLUGIN_API Source : public VideoSource
 {
@@ -54,7 +61,7 @@ public:
 
 	[[nodiscard]] dto::ImageMetadata metadata() const noexcept override
 	{
-		return {"uint8", 200, 200, "RGB", "planar", "topLeft"};
+		return {"uint8", 200, 200, "RGB", "interleaved", "topLeft"};
 	}
 
 	[[nodiscard]] std::error_code nextFrame() noexcept override
@@ -64,7 +71,7 @@ public:
 
 	[[nodiscard]] dto::ImageView frame() const noexcept override
 	{
-		return {metadata(), m_frame.get()};
+		return m_frame.view();
 	}
 
 	[[nodiscard]] dto::ImageView frame(std::byte* data, std::size_t size) const noexcept override;
@@ -75,7 +82,13 @@ public:
 	static void destroy(void*);
 
 private:
-	std::unique_ptr<std::uint8_t[]> m_frame;
+	/// Returns the frame of the sensor.
+	StridedImageView sensorFrame() const noexcept;
+
+	std::vector<std::uint16_t> m_sensor;
+	PixelConverter m_converter;
+	// Frame of FramePool::shared(), which outputs keep rather than copy.
+	SharedFrame m_frame;
 };
 
 class PLUGIN_API Output : public ResultsOutput
@@ -19,10 +19,10 @@
 #include "dummy.h"
 
 #include <iostream>
-#include <numeric>
 #include <system_error>
 #include <utility>
 
+#include "neurala/image/views/StridedImageView.h"
 #include "neurala/plugin/PluginArguments.h"
 #include "neurala/plugin/PluginBindings.h"
 #include "neurala/plugin/PluginErrorCallback.h"
@@ -34,7 +34,11 @@
 namespace
 {
 constexpr auto kSourceTypeName = "dummyVideoSource";
-}
+
+constexpr unsigned kSensorBits = 12;
+constexpr neurala::PixelFormat kSensorFormat{
+  neurala::EDatatype::uint16, neurala::EColorSpace::RGB, neurala::ELayout::planar};
+} // namespace
 
 extern "C" PLUGIN_API NeuralaPluginExitFunction
 initMe(NeuralaPluginManager* pluginManager, std::error_code* status)
@@ -100,23 +104,36 @@ Discoverer::destroy(void* p)
 }
 
 Source::Source(const dto::CameraInfo& cameraInfo, const Options& options)
+ : m_converter(ELayout::interleaved, WindowLevel::fullRange(kSensorBits))
 {
 	std::cout << "Initiating VideoSource connection with " << cameraInfo << '\n';
 	std::cout << "With options: " << options << '\n';
 
-	const dto::ImageMetadata md{metadata()};
-	const auto frameBufferSize{md.width() * md.height() * 3};
-	m_frame = std::make_unique<std::uint8_t[]>(frameBufferSize);
-	std::iota(&(m_frame[0]), &(m_frame[frameBufferSize]), 0);
+	const auto size = metadata();
+	m_sensor.resize(kSensorFormat.frameBytes(size.width(), size.height()) / sizeof(std::uint16_t));
+	for (std::size_t i = 0; i < m_sensor.size(); ++i)
+	{
+		m_sensor[i] = static_cast<std::uint16_t>(i % (1u << kSensorBits));
+	}
+
+	const auto frameBufferSize{requiredBytes(size)};
+	m_frame = FramePool::shared().allocate(size, frameBufferSize);
+	m_converter(sensorFrame(), m_frame.write(), frameBufferSize);
+}
+
+StridedImageView
+Source::sensorFrame() const noexcept
+{
+	const auto size = metadata();
+	return {kSensorFormat.metadata(size.width(), size.height()), m_sensor.data()};
 }
 
 dto::ImageView
 Source::frame(std::byte* data, std::size_t size) const noexcept
 {
-	std::cout << "Copying frame to [" << data << "]\n";
-	dto::ImageMetadata md{metadata()};
-	std::copy_n(reinterpret_cast<const std::byte*>(m_frame.get()), md.width() * md.height() * 3, data);
-	return {std::move(metadata()), data};
+	std::cout << "Converting frame to [" << data << "]\n";
+	// The sensor frame is converted straight into the buffer of the caller.
+	return m_converter(sensorFrame(), data, size);
 }
 
 std::error_code
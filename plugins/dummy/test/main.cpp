@@ -18,8 +18,10 @@
 
 #include <iostream>
 #include <numeric>
+#include <vector>
 
 #include "dummy.h"
+#include "neurala/image/views/StridedImageView.h"
 
 int
 main()
@@ -42,5 +44,10 @@ main()
 		// Retrieve and print the image view's metadata
 		const dto::ImageView view{dummyVideoSource.frame()};
 		std::cout << "Image view metadata: " << view.metadata() << std::endl;
+
+		// Copy the frame into a buffer of the size required by its metadata
+		std::vector<std::byte> buffer(requiredBytes(metadata));
+		const dto::ImageView copy{dummyVideoSource.frame(buffer.data(), buffer.size())};
+		std::cout << "Copied " << buffer.size() << " bytes: " << (copy.data() ? "yes" : "no") << std::endl;
 	}
 }
@@ -0,0 +1,178 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_GSTREAMER_FRAME_STATISTICS_H
+#define NEURALA_GSTREAMER_FRAME_STATISTICS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace neurala::plug::gst
+{
+/// Marks an unknown timestamp, same value as GST_CLOCK_TIME_NONE.
+inline constexpr std::uint64_t kInvalidTime = ~std::uint64_t{0};
+
+/**
+ * @brief Log-linear histogram of latencies expressed in nanoseconds.
+ *
+ * Values below 16 us are counted with a 1 us resolution, larger values with a resolution of an
+ * eighth of an octave, up to roughly an hour.
+ */
+class LatencyHistogram
+{
+public:
+	/// Adds a sample to the histogram.
+	void record(std::uint64_t nanoseconds) noexcept;
+
+	/// Removes all samples.
+	void reset() noexcept;
+
+	/// Returns the number of samples.
+	std::uint64_t count() const noexcept { return m_count; }
+
+	/// Returns the smallest sample in nanoseconds, 0 if there are none.
+	std::uint64_t min() const noexcept { return m_count == 0 ? 0 : m_min; }
+
+	/// Returns the largest sample in nanoseconds.
+	std::uint64_t max() const noexcept { return m_max; }
+
+	/// Returns the average of the samples in nanoseconds.
+	std::uint64_t mean() const noexcept { return m_count == 0 ? 0 : m_sum / m_count; }
+
+	/**
+	 * @brief Returns the upper bound, in nanoseconds, of the bucket containing the @p p -th
+	 *        percentile.
+	 *
+	 * @param p percentile in the range [0, 100]
+	 */
+	std::uint64_t percentile(double p) const noexcept;
+
+	/// Writes the summary of the histogram as a JSON object.
+	void write(std::ostream& os) const;
+
+private:
+	static constexpr std::size_t kLinearBuckets = 16;
+	static constexpr std::size_t kSubBuckets = 8;
+	static constexpr std::size_t kOctaves = 28;
+
+	static std::size_t bucket(std::uint64_t microseconds) noexcept;
+	static std::uint64_t upperBound(std::size_t bucket) noexcept;
+
+	std::array<std::uint64_t, kLinearBuckets + kOctaves * kSubBuckets> m_buckets{};
+	std::uint64_t m_count{};
+	std::uint64_t m_sum{};
+	std::uint64_t m_min{};
+	std::uint64_t m_max{};
+};
+
+/**
+ * @brief Timing information of a sample pulled from the appsink.
+ *
+ * All clock times are expressed in the pipeline clock domain, in nanoseconds.
+ */
+struct FrameTiming
+{
+	/// Number of samples pulled from the appsink before this one.
+	std::uint64_t sequence{};
+	/// Buffer offset as set by the source element (frame number for most video sources).
+	std::uint64_t offset{kInvalidTime};
+	std::uint64_t pts{kInvalidTime};
+	std::uint64_t dts{kInvalidTime};
+	/// Running time of the buffer presentation timestamp.
+	std::uint64_t runningTime{kInvalidTime};
+	/// Clock time at which the frame was captured (base time + running time).
+	std::uint64_t captureTime{kInvalidTime};
+	/// Clock time at which the sample reached the appsink.
+	std::uint64_t sinkTime{kInvalidTime};
+	/// Pipeline that produced the sample, a new one being built by each reload.
+	std::uint64_t generation{};
+};
+
+/**
+ * @brief Thread-safe accumulator of per-frame timestamps and latencies.
+ *
+ * Three latencies are tracked from the capture time of each frame:
+ * - to the appsink, which covers decoding and conversion within the pipeline;
+ * - to nextFrame(), which adds the time spent queueing in the plugin;
+ * - to frame(), which adds the time the SDK took before consuming the frame.
+ */
+class FrameStatistics
+{
+public:
+	/// Records a sample that was just pulled from the appsink.
+	void onSample(const FrameTiming& timing) noexcept;
+
+	/// Records a frame being handed out through nextFrame() at clock time @p now.
+	void onNextFrame(const FrameTiming& timing, std::uint64_t now) noexcept;
+
+	/// Records a frame being read through frame() at clock time @p now.
+	void onFrame(const FrameTiming& timing, std::uint64_t now) noexcept;
+
+	/// Records a state transition of the pipeline.
+	void onStateChanged(const char* state) noexcept;
+
+	/// Records an error reported by the pipeline.
+	void onError(const char* message) noexcept;
+
+	/// Records a restart of the pipeline following an error or the end of a live stream.
+	void onRestart() noexcept;
+
+	/// Records the pipeline looping back to the start of a file.
+	void onLoop() noexcept;
+
+	/// Removes all records.
+	void reset() noexcept;
+
+	/**
+	 * @brief Writes the statistics as a JSON object.
+	 *
+	 * @param os                 output stream
+	 * @param droppedAtSink      number of samples dropped by the appsink
+	 */
+	void write(std::ostream& os, std::uint64_t droppedAtSink) const;
+
+private:
+	static constexpr std::size_t kRecentFrames = 32;
+
+	mutable std::mutex m_mutex;
+
+	LatencyHistogram m_sinkLatency;
+	LatencyHistogram m_nextFrameLatency;
+	LatencyHistogram m_frameLatency;
+
+	std::array<FrameTiming, kRecentFrames> m_recent{};
+	std::uint64_t m_samples{};
+	std::uint64_t m_sequenceGaps{};
+	std::uint64_t m_lastOffset{kInvalidTime};
+	std::uint64_t m_lastGeneration{};
+
+	std::string m_state{"NULL"};
+	std::string m_lastError;
+	std::uint64_t m_stateChanges{};
+	std::uint64_t m_errors{};
+	std::uint64_t m_restarts{};
+	std::uint64_t m_loops{};
+};
+
+} // namespace neurala::plug::gst
+
+#endif // NEURALA_GSTREAMER_FRAME_STATISTICS_H
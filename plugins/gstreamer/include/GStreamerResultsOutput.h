@@ -0,0 +1,76 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_GSTREAMER_RESULTS_OUTPUT_H
+#define NEURALA_GSTREAMER_RESULTS_OUTPUT_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "neurala/image/views/dto/ImageView.h"
+#include "neurala/plugin/PluginArguments.h"
+#include "neurala/plugin/PluginBindings.h"
+#include "neurala/plugin/PluginErrorCallback.h"
+
+#include "neurala/utils/AsyncResultsOutput.h"
+#include "neurala/utils/ResultsOutput.h"
+
+namespace neurala
+{
+/**
+ * @brief Output feeding the frames, annotated with their results, to a user-defined pipeline.
+ *
+ * Frames are queued by a ResultsOutputWorker, which shares them through FramePool::share(). Its
+ * thread copies each frame into a pipeline buffer, draws the detection boxes and labels found in
+ * the result on it, then pushes it to the appsrc of the pipeline, so encoding never blocks the SDK.
+ * When the queue is full, frames are dropped according to the configured policy.
+ */
+class GStreamerResultsOutput : public ResultsOutput
+{
+private:
+	struct Implementation;
+
+	std::unique_ptr<Implementation> m_implementation;
+	// Runs the implementation, and is destroyed first.
+	std::unique_ptr<ResultsOutputWorker> m_worker;
+	// Result handed to the worker, with the time it was received.
+	std::string m_result;
+	std::atomic<bool> m_unsupportedLogged{false};
+
+public:
+	static void* create(PluginArguments&, PluginErrorCallback&);
+	static void destroy(void* p);
+
+	explicit GStreamerResultsOutput();
+
+	~GStreamerResultsOutput() noexcept;
+
+	// Queues the start of a pipeline job
+	void onStart(std::string_view id) noexcept override;
+
+	// Flushes the queued frames and ends the stream at the end of a pipeline job
+	void onStop(std::string_view id, ResultsOutputStatus status) noexcept override;
+
+	// Queues a frame and its result for encoding
+	void operator()(const std::string& metadata, const dto::ImageView* image) noexcept override;
+};
+} // namespace neurala
+
+#endif // NEURALA_GSTREAMER_RESULTS_OUTPUT_H
@@ -20,9 +20,10 @@
 #define NEURALA_GSTREAMER_PLUGIN_H
 
 #include <atomic>
-#include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <string>
 
 #include "neurala/image/views/dto/ImageView.h"
 #include "neurala/plugin/PluginArguments.h"
@@ -39,16 +40,15 @@ private:
 	enum class EStreamState : unsigned char
 	{
 		waitingForFrame,
-		frameReady,
 		endOfStream
 	};
 
 	struct Implementation;
+	struct Stream;
 
 	std::unique_ptr<Implementation> m_implementation;
-	std::mutex m_mutex;
-	std::condition_variable m_bufferReadyCondition;
-	std::condition_variable m_frameReadyCondition;
+	// Guards the state of the streams and the last error, while samples are handed out without it.
+	mutable std::mutex m_mutex;
 
 	dto::ImageView m_frame;
 	B4BError m_lastError;
@@ -56,15 +56,19 @@ private:
 	unsigned int m_width;
 	unsigned int m_height;
 
-	EStreamState m_streamState;
+	std::atomic<EStreamState> m_streamState;
 
-	bool m_bufferReady;
+	static int grabFrame(void* sink, Stream* stream);
 
-	bool bufferReady() const noexcept { return m_bufferReady; }
-	bool frameReady() const noexcept { return static_cast<int>(m_streamState) != 0; }
+	// Builds the pipeline anew and swaps it in once it delivers its first frame, starting it
+	// alongside the current one, or once the current one is stopped if that fails.
+	std::error_code reload() noexcept;
+	std::error_code swapStream(bool stopFirst) noexcept;
+	void closeStream(std::unique_ptr<Stream> stream) noexcept;
+	void watchPipelineFile(std::string path) noexcept;
 
-	static int preroll(void* sink, GStreamerVideoSource* self);
-	static int grabFrame(void* sink, GStreamerVideoSource* self);
+	// Clock time of the pipeline of the frame handed out, read without the mutex.
+	std::uint64_t currentClockTime() const noexcept;
 
 public:
 	static void* create(PluginArguments&, PluginErrorCallback&);
@@ -0,0 +1,291 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Measures the throughput of GStreamerVideoSource fed by videotestsrc, over a matrix of
+// resolutions, pixel formats and appsink settings, and writes the results as JSON.
+//
+// Usage: gstreamer_benchmark [--duration seconds] [--pattern videotestsrc-pattern] [--output file]
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <gst/gst.h>
+
+#include "FrameStatistics.h"
+#include "GStreamerVideoSource.h"
+
+namespace
+{
+struct Resolution
+{
+	const char* name;
+	std::size_t width;
+	std::size_t height;
+};
+
+struct Format
+{
+	const char* name;
+	// Size of a frame in bytes, as a fraction of the number of pixels.
+	std::size_t numerator;
+	std::size_t denominator;
+};
+
+struct AppSinkSettings
+{
+	const char* name;
+	const char* properties;
+};
+
+constexpr Resolution kResolutions[] = {{"VGA", 640, 480},
+                                       {"HD", 1280, 720},
+                                       {"FullHD", 1920, 1080},
+                                       {"4K", 3840, 2160}};
+
+constexpr Format kFormats[] = {{"RGB", 3, 1}, {"GRAY8", 1, 1}, {"NV12", 3, 2}};
+
+constexpr AppSinkSettings kAppSinkSettings[] = {{"unbounded", ""},
+                                                {"queue4", "max-buffers=4"},
+                                                {"latest", "max-buffers=1 drop=true"}};
+
+// Frames handed out before measurements start, which lets the pipeline reach its steady state.
+constexpr int kWarmUpFrames = 10;
+
+// Consecutive nextFrame() failures after which a configuration is abandoned.
+constexpr int kMaximumFailures = 3;
+
+struct Options
+{
+	double duration = 5.0;
+	std::string pattern = "black";
+	std::string output;
+};
+
+bool
+parseOptions(int argc, char** argv, Options& options)
+{
+	for (auto i = 1; i < argc; ++i)
+	{
+		const std::string argument = argv[i];
+
+		if (i + 1 == argc)
+		{
+			std::cerr << "Missing value for " << argument << '\n';
+			return false;
+		}
+
+		if (argument == "--duration")
+		{
+			options.duration = std::atof(argv[++i]);
+		}
+		else if (argument == "--pattern")
+		{
+			options.pattern = argv[++i];
+		}
+		else if (argument == "--output")
+		{
+			options.output = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Unknown option " << argument << '\n';
+			return false;
+		}
+	}
+
+	return options.duration > 0.0;
+}
+
+/// Returns the CPU time consumed by the process, all threads included, in nanoseconds.
+std::uint64_t
+cpuTime() noexcept
+{
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+
+	const auto nanoseconds = [](const timeval& t) {
+		return std::uint64_t(t.tv_sec) * 1000000000 + std::uint64_t(t.tv_usec) * 1000;
+	};
+
+	return nanoseconds(usage.ru_utime) + nanoseconds(usage.ru_stime);
+}
+
+/// Returns how many times the threads of the process gave up the CPU to wait, e.g. on a lock.
+std::uint64_t
+voluntarySwitches() noexcept
+{
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_nvcsw;
+}
+
+std::uint64_t
+elapsed(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+/// Runs a single configuration of the matrix and writes its results as a JSON object.
+void
+run(const Options& options,
+    const Resolution& resolution,
+    const Format& format,
+    const AppSinkSettings& settings,
+    std::ostream& os)
+{
+	const auto pipeline = "videotestsrc pattern=" + options.pattern + " ! video/x-raw,format="
+	                      + format.name + ",width=" + std::to_string(resolution.width)
+	                      + ",height=" + std::to_string(resolution.height)
+	                      + " ! appsink name=neurala_appsink sync=false " + settings.properties;
+	setenv("NEURALA_GSTREAMER_PIPELINE", pipeline.c_str(), 1);
+
+	const auto frameBytes = resolution.width * resolution.height * format.numerator / format.denominator;
+	std::vector<std::byte> buffer(frameBytes);
+
+	neurala::plug::gst::LatencyHistogram nextFrameLatency;
+	neurala::plug::gst::LatencyHistogram copyLatency;
+	std::uint64_t frames = 0;
+	std::uint64_t failures = 0;
+	std::uint64_t copyTime = 0;
+	std::uint64_t wallTime = 0;
+	std::uint64_t cpuPerFrame = 0;
+	double switchesPerFrame = 0.0;
+
+	std::cerr << resolution.name << ' ' << format.name << ' ' << settings.name << "...\n";
+
+	{
+		neurala::GStreamerVideoSource source;
+		auto consecutiveFailures = 0;
+
+		for (auto i = 0; i < kWarmUpFrames && consecutiveFailures < kMaximumFailures; ++i)
+		{
+			consecutiveFailures = source.nextFrame() ? consecutiveFailures + 1 : 0;
+		}
+
+		const auto startCpu = cpuTime();
+		const auto startSwitches = voluntarySwitches();
+		const auto start = std::chrono::steady_clock::now();
+		const auto end = start + std::chrono::duration<double>(options.duration);
+		auto now = start;
+
+		while (now < end && consecutiveFailures < kMaximumFailures)
+		{
+			const auto requested = now;
+			const auto status = source.nextFrame();
+			const auto ready = std::chrono::steady_clock::now();
+
+			nextFrameLatency.record(elapsed(requested, ready));
+
+			if (status)
+			{
+				++failures;
+				++consecutiveFailures;
+				now = ready;
+				continue;
+			}
+
+			consecutiveFailures = 0;
+
+			const auto view = source.frame(buffer.data(), buffer.size());
+			now = std::chrono::steady_clock::now();
+
+			if (view.data())
+			{
+				copyLatency.record(elapsed(ready, now));
+				copyTime += elapsed(ready, now);
+				++frames;
+			}
+		}
+
+		wallTime = elapsed(start, now);
+		cpuPerFrame = frames ? (cpuTime() - startCpu) / frames : 0;
+		switchesPerFrame = frames ? double(voluntarySwitches() - startSwitches) / frames : 0.0;
+	}
+
+	const auto seconds = wallTime / 1e9;
+	const auto copiedBytes = static_cast<double>(frames) * frameBytes;
+
+	os << "{\"resolution\":\"" << resolution.name << "\",\"width\":" << resolution.width
+	   << ",\"height\":" << resolution.height << ",\"format\":\"" << format.name
+	   << "\",\"appsink\":\"" << settings.name << "\",\"frameBytes\":" << frameBytes
+	   << ",\"frames\":" << frames << ",\"failures\":" << failures
+	   << ",\"fps\":" << (seconds > 0.0 ? frames / seconds : 0.0) << ",\"nextFrame\":";
+	nextFrameLatency.write(os);
+	os << ",\"copy\":{\"bandwidthMBps\":"
+	   << (copyTime > 0 ? copiedBytes / (copyTime / 1e9) / 1e6 : 0.0) << ",\"latency\":";
+	copyLatency.write(os);
+	os << "},\"cpuPerFrameNs\":" << cpuPerFrame << ",\"switchesPerFrame\":" << switchesPerFrame
+	   << '}';
+}
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+	Options options;
+
+	if (!parseOptions(argc, argv, options))
+	{
+		std::cerr << "Usage: " << argv[0]
+		          << " [--duration seconds] [--pattern videotestsrc-pattern] [--output file]\n";
+		return 1;
+	}
+
+	gst_init(&argc, &argv);
+
+	std::ofstream file;
+	if (!options.output.empty())
+	{
+		file.open(options.output);
+		if (!file)
+		{
+			std::cerr << "Could not open " << options.output << '\n';
+			return 1;
+		}
+	}
+
+	auto& os = options.output.empty() ? std::cout : file;
+	auto first = true;
+
+	os << "{\"duration\":" << options.duration << ",\"pattern\":\"" << options.pattern
+	   << "\",\"results\":[";
+
+	for (const auto& resolution : kResolutions)
+	{
+		for (const auto& format : kFormats)
+		{
+			for (const auto& settings : kAppSinkSettings)
+			{
+				os << (first ? "" : ",");
+				run(options, resolution, format, settings, os);
+				first = false;
+			}
+		}
+	}
+
+	os << "]}\n";
+	return 0;
+}
@@ -0,0 +1,319 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "FrameStatistics.h"
+
+namespace neurala::plug::gst
+{
+namespace
+{
+std::uint64_t
+elapsed(std::uint64_t from, std::uint64_t to) noexcept
+{
+	if (from == kInvalidTime || to == kInvalidTime || to < from)
+	{
+		return 0;
+	}
+	return to - from;
+}
+
+void
+writeTime(std::ostream& os, std::uint64_t time)
+{
+	if (time == kInvalidTime)
+	{
+		os << "null";
+	}
+	else
+	{
+		os << time;
+	}
+}
+
+void
+writeString(std::ostream& os, const std::string& s)
+{
+	os << '"';
+	for (const auto c : s)
+	{
+		switch (c)
+		{
+			case '"':
+				os << "\\\"";
+				break;
+			case '\\':
+				os << "\\\\";
+				break;
+			case '\n':
+				os << "\\n";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) >= 0x20)
+				{
+					os << c;
+				}
+				break;
+		}
+	}
+	os << '"';
+}
+} // namespace
+
+std::size_t
+LatencyHistogram::bucket(std::uint64_t microseconds) noexcept
+{
+	if (microseconds < kLinearBuckets)
+	{
+		return static_cast<std::size_t>(microseconds);
+	}
+
+	std::size_t msb = 0;
+	for (auto v = microseconds; v > 1; v >>= 1)
+	{
+		++msb;
+	}
+
+	const auto octave = msb - 4;
+	if (octave >= kOctaves)
+	{
+		return kLinearBuckets + kOctaves * kSubBuckets - 1;
+	}
+
+	const auto sub = static_cast<std::size_t>(microseconds >> (msb - 3)) & (kSubBuckets - 1);
+	return kLinearBuckets + octave * kSubBuckets + sub;
+}
+
+std::uint64_t
+LatencyHistogram::upperBound(std::size_t bucket) noexcept
+{
+	if (bucket < kLinearBuckets)
+	{
+		return (bucket + 1) * 1000;
+	}
+
+	const auto octave = (bucket - kLinearBuckets) / kSubBuckets;
+	const auto sub = (bucket - kLinearBuckets) % kSubBuckets;
+	return (std::uint64_t{kSubBuckets + sub + 1} << (octave + 1)) * 1000;
+}
+
+void
+LatencyHistogram::record(std::uint64_t nanoseconds) noexcept
+{
+	++m_buckets[bucket(nanoseconds / 1000)];
+	m_min = m_count == 0 ? nanoseconds : std::min(m_min, nanoseconds);
+	m_max = std::max(m_max, nanoseconds);
+	m_sum += nanoseconds;
+	++m_count;
+}
+
+void
+LatencyHistogram::reset() noexcept
+{
+	*this = LatencyHistogram();
+}
+
+std::uint64_t
+LatencyHistogram::percentile(double p) const noexcept
+{
+	if (m_count == 0)
+	{
+		return 0;
+	}
+
+	const auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * m_count));
+	std::uint64_t cumulative = 0;
+
+	for (std::size_t i = 0; i < m_buckets.size(); ++i)
+	{
+		cumulative += m_buckets[i];
+		if (cumulative >= std::max<std::uint64_t>(rank, 1))
+		{
+			return std::min(upperBound(i), m_max);
+		}
+	}
+
+	return m_max;
+}
+
+void
+LatencyHistogram::write(std::ostream& os) const
+{
+	os << "{\"count\":" << count() << ",\"min\":" << min() << ",\"mean\":" << mean()
+	   << ",\"p50\":" << percentile(50.0) << ",\"p90\":" << percentile(90.0)
+	   << ",\"p99\":" << percentile(99.0) << ",\"max\":" << max() << '}';
+}
+
+void
+FrameStatistics::onSample(const FrameTiming& timing) noexcept
+{
+	std::scoped_lock lock(m_mutex);
+
+	// Offsets start over with each pipeline, and those of two pipelines interleave while a reloaded
+	// one is swapped in.
+	if (timing.generation != m_lastGeneration)
+	{
+		m_lastOffset = kInvalidTime;
+		m_lastGeneration = timing.generation;
+	}
+
+	if (timing.offset != kInvalidTime && m_lastOffset != kInvalidTime && timing.offset > m_lastOffset + 1)
+	{
+		m_sequenceGaps += timing.offset - m_lastOffset - 1;
+	}
+
+	m_lastOffset = timing.offset;
+	m_recent[m_samples % kRecentFrames] = timing;
+	++m_samples;
+
+	if (timing.captureTime != kInvalidTime)
+	{
+		m_sinkLatency.record(elapsed(timing.captureTime, timing.sinkTime));
+	}
+}
+
+void
+FrameStatistics::onNextFrame(const FrameTiming& timing, std::uint64_t now) noexcept
+{
+	if (timing.captureTime == kInvalidTime)
+	{
+		return;
+	}
+
+	std::scoped_lock lock(m_mutex);
+	m_nextFrameLatency.record(elapsed(timing.captureTime, now));
+}
+
+void
+FrameStatistics::onFrame(const FrameTiming& timing, std::uint64_t now) noexcept
+{
+	if (timing.captureTime == kInvalidTime)
+	{
+		return;
+	}
+
+	std::scoped_lock lock(m_mutex);
+	m_frameLatency.record(elapsed(timing.captureTime, now));
+}
+
+void
+FrameStatistics::onStateChanged(const char* state) noexcept
+{
+	std::scoped_lock lock(m_mutex);
+
+	try
+	{
+		m_state = state;
+	}
+	catch (...)
+	{
+		// keep the previous state if the string cannot be allocated
+	}
+	++m_stateChanges;
+}
+
+void
+FrameStatistics::onError(const char* message) noexcept
+{
+	std::scoped_lock lock(m_mutex);
+
+	try
+	{
+		m_lastError = message;
+	}
+	catch (...)
+	{
+		// keep the previous message if the string cannot be allocated
+	}
+	++m_errors;
+}
+
+void
+FrameStatistics::onRestart() noexcept
+{
+	std::scoped_lock lock(m_mutex);
+	++m_restarts;
+}
+
+void
+FrameStatistics::onLoop() noexcept
+{
+	std::scoped_lock lock(m_mutex);
+	++m_loops;
+}
+
+void
+FrameStatistics::reset() noexcept
+{
+	std::scoped_lock lock(m_mutex);
+
+	m_sinkLatency.reset();
+	m_nextFrameLatency.reset();
+	m_frameLatency.reset();
+	m_recent = {};
+	m_samples = 0;
+	m_sequenceGaps = 0;
+	m_lastOffset = kInvalidTime;
+	m_lastError.clear();
+	m_stateChanges = 0;
+	m_errors = 0;
+	m_restarts = 0;
+	m_loops = 0;
+}
+
+void
+FrameStatistics::write(std::ostream& os, std::uint64_t droppedAtSink) const
+{
+	std::scoped_lock lock(m_mutex);
+
+	os << "{\"samples\":" << m_samples << ",\"droppedAtSink\":" << droppedAtSink
+	   << ",\"sequenceGaps\":" << m_sequenceGaps << ",\"pipeline\":{\"state\":";
+	writeString(os, m_state);
+	os << ",\"stateChanges\":" << m_stateChanges << ",\"errors\":" << m_errors
+	   << ",\"lastError\":";
+	writeString(os, m_lastError);
+	os << ",\"restarts\":" << m_restarts << ",\"loops\":" << m_loops << "},\"latency\":{\"sink\":";
+	m_sinkLatency.write(os);
+	os << ",\"nextFrame\":";
+	m_nextFrameLatency.write(os);
+	os << ",\"frame\":";
+	m_frameLatency.write(os);
+	os << "},\"recent\":[";
+
+	const auto recent = std::min<std::uint64_t>(m_samples, kRecentFrames);
+	for (std::uint64_t i = 0; i < recent; ++i)
+	{
+		const auto& timing = m_recent[(m_samples - recent + i) % kRecentFrames];
+
+		os << (i == 0 ? "" : ",") << "{\"sequence\":" << timing.sequence << ",\"offset\":";
+		writeTime(os, timing.offset);
+		os << ",\"pts\":";
+		writeTime(os, timing.pts);
+		os << ",\"dts\":";
+		writeTime(os, timing.dts);
+		os << ",\"runningTime\":";
+		writeTime(os, timing.runningTime);
+		os << '}';
+	}
+
+	os << "]}";
+}
+
+} // namespace neurala::plug::gst
@@ -0,0 +1,699 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string_view>
+
+#include <cairo.h>
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include <json-glib/json-glib.h>
+#include <pango/pangocairo.h>
+
+#include <neurala/image/PixelFormat.h>
+
+#include "GStreamerResultsOutput.h"
+
+namespace neurala
+{
+namespace
+{
+// Name of the element of the output pipeline the annotated frames are pushed to.
+constexpr const char* kAppSrcName = "neurala_appsrc";
+
+// Time given to the output pipeline to flush its data once the stream has ended.
+constexpr GstClockTime kEndOfStreamTimeout = 5 * GST_SECOND;
+
+/**
+ * @brief Returns the number of frames waiting to be encoded before frames are dropped, from
+ *        NEURALA_GSTREAMER_OUTPUT_QUEUE, at least 2.
+ */
+std::size_t
+queueCapacity() noexcept
+{
+	const auto capacity = getenv("NEURALA_GSTREAMER_OUTPUT_QUEUE");
+	const auto frames = capacity ? std::atoi(capacity) : 0;
+	return frames > 0 ? std::max<std::size_t>(frames, 2) : 4;
+}
+
+/**
+ * @brief Returns what is done with a frame when the queue is full, from
+ *        NEURALA_GSTREAMER_OUTPUT_DROP.
+ *
+ * The last queued frame is replaced by default, which keeps the output as recent as possible.
+ * Setting the variable to "newest" drops the incoming frame instead, which keeps the frames queued
+ * so far, and to "none" waits for room in the queue, which holds up the SDK.
+ */
+EOverflowPolicy
+overflowPolicy() noexcept
+{
+	const auto policy = getenv("NEURALA_GSTREAMER_OUTPUT_DROP");
+	const auto name = policy ? std::string_view(policy) : std::string_view();
+	return name == "newest" ? EOverflowPolicy::drop
+	       : name == "none" ? EOverflowPolicy::block
+	                        : EOverflowPolicy::coalesce;
+}
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Appends @p time to @p metadata, for the worker to carry it with the result.
+ */
+void
+appendTime(std::string& metadata, Clock::time_point time)
+{
+	const auto ticks = time.time_since_epoch().count();
+	metadata.append(reinterpret_cast<const char*>(&ticks), sizeof(ticks));
+}
+
+/**
+ * @brief Returns the time appended to @p metadata by appendTime(), and removes it from @p metadata.
+ */
+Clock::time_point
+takeTime(std::string_view& metadata) noexcept
+{
+	Clock::rep ticks{};
+	if (metadata.size() >= sizeof(ticks))
+	{
+		std::memcpy(&ticks, metadata.data() + metadata.size() - sizeof(ticks), sizeof(ticks));
+		metadata.remove_suffix(sizeof(ticks));
+	}
+	return Clock::time_point(Clock::duration(ticks));
+}
+
+/// Returns if the frames of @p format can be copied by copyFrame().
+bool
+isSupported(const PixelFormat& format) noexcept
+{
+	return format.datatype() == EDatatype::uint8
+	       && (format.colorSpace() == EColorSpace::RGB || format.colorSpace() == EColorSpace::BGR)
+	       && (format.layout() == ELayout::interleaved || format.layout() == ELayout::planar)
+	       && (format.orientation() == EOrientation::topLeft
+	           || format.orientation() == EOrientation::bottomLeft);
+}
+
+/**
+ * @brief Copies @p image to @p data, laid out as a CAIRO_FORMAT_RGB24 surface.
+ *
+ * Pixels are stored as native-endian 32-bit words, which matches the BGRx video format on
+ * little-endian hosts and xRGB on big-endian ones.
+ */
+void
+copyFrame(const dto::ImageView& image,
+          const PixelFormat& format,
+          guint8* data,
+          std::size_t stride) noexcept
+{
+	const auto width = image.width();
+	const auto height = image.height();
+	const auto source = image.dataAs<std::uint8_t>();
+	const auto planar = format.layout() == ELayout::planar;
+	const auto bgr = format.colorSpace() == EColorSpace::BGR;
+	const auto bottomUp = format.orientation() == EOrientation::bottomLeft;
+
+	const std::size_t pixelStep = planar ? 1 : 3;
+	const std::size_t channelStep = planar ? width * height : 1;
+	const std::size_t first = bgr ? 2 * channelStep : 0;
+	const std::size_t last = bgr ? 0 : 2 * channelStep;
+
+	for (std::size_t y = 0; y < height; ++y)
+	{
+		const auto row = source + (bottomUp ? height - 1 - y : y) * width * pixelStep;
+		const auto target = reinterpret_cast<std::uint32_t*>(data + y * stride);
+
+		for (std::size_t x = 0; x < width; ++x)
+		{
+			const auto pixel = row + x * pixelStep;
+			target[x] = (std::uint32_t{pixel[first]} << 16) | (std::uint32_t{pixel[channelStep]} << 8)
+			            | std::uint32_t{pixel[last]};
+		}
+	}
+}
+
+/// Returns the value of @p member as text, whether it holds a string or a number.
+std::string
+memberText(JsonObject* object, const char* member)
+{
+	if (!json_object_has_member(object, member))
+	{
+		return {};
+	}
+
+	const auto node = json_object_get_member(object, member);
+	if (JSON_NODE_TYPE(node) != JSON_NODE_VALUE)
+	{
+		return {};
+	}
+
+	if (json_node_get_value_type(node) == G_TYPE_STRING)
+	{
+		return json_node_get_string(node);
+	}
+
+	std::ostringstream text;
+	text << json_node_get_int(node);
+	return text.str();
+}
+
+double
+memberNumber(JsonObject* object, const char* member) noexcept
+{
+	return json_object_has_member(object, member) ? json_object_get_double_member(object, member)
+	                                              : 0.0;
+}
+
+/// Picks a color for @p label, so that every class keeps the same color throughout the stream.
+void
+setLabelColor(cairo_t* cr, const std::string& label) noexcept
+{
+	static constexpr double kPalette[][3] = {{0.90, 0.10, 0.29}, {0.24, 0.71, 0.29},
+	                                         {1.00, 0.88, 0.10}, {0.00, 0.51, 0.78},
+	                                         {0.96, 0.51, 0.19}, {0.57, 0.12, 0.71},
+	                                         {0.27, 0.94, 0.94}, {0.94, 0.20, 0.90}};
+
+	const auto& color = kPalette[std::hash<std::string>{}(label) % std::size(kPalette)];
+	cairo_set_source_rgb(cr, color[0], color[1], color[2]);
+}
+
+/// Draws @p text with its top left corner at (@p x, @p y), over a background of the current color.
+void
+drawLabel(cairo_t* cr, PangoLayout* layout, const std::string& text, double x, double y) noexcept
+{
+	int textWidth = 0;
+	int textHeight = 0;
+
+	pango_layout_set_text(layout, text.c_str(), static_cast<int>(text.size()));
+	pango_layout_get_pixel_size(layout, &textWidth, &textHeight);
+
+	cairo_rectangle(cr, x, y, textWidth + 4, textHeight);
+	cairo_fill(cr);
+
+	cairo_save(cr);
+	cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+	cairo_move_to(cr, x + 2, y);
+	pango_cairo_show_layout(cr, layout);
+	cairo_restore(cr);
+}
+
+std::string
+labelText(const std::string& label, double confidence)
+{
+	std::ostringstream text;
+	text.precision(2);
+	text << label << ' ' << std::fixed << confidence;
+	return text.str();
+}
+
+/**
+ * @brief Draws the results found in @p metadata on a frame of @p width by @p height pixels.
+ *
+ * Detection results are drawn as boxes, whose coordinates are either normalized or in pixels, with
+ * their class and confidence. Classification results are listed in the top left corner.
+ */
+void
+drawResults(cairo_t* cr, std::string_view metadata, int width, int height) noexcept
+{
+	const auto parser = json_parser_new();
+	GError* error = nullptr;
+
+	if (!json_parser_load_from_data(parser, metadata.data(), static_cast<gssize>(metadata.size()), &error))
+	{
+		g_error_free(error);
+		g_object_unref(parser);
+		return;
+	}
+
+	const auto root = json_parser_get_root(parser);
+	JsonArray* results = nullptr;
+
+	if (root && JSON_NODE_HOLDS_OBJECT(root))
+	{
+		const auto document = json_node_get_object(root);
+		const auto inference = json_object_has_member(document, "inferenceResult")
+		                         ? json_object_get_member(document, "inferenceResult")
+		                         : nullptr;
+
+		if (inference && JSON_NODE_HOLDS_OBJECT(inference))
+		{
+			const auto result = json_node_get_object(inference);
+			const auto array = json_object_has_member(result, "results")
+			                     ? json_object_get_member(result, "results")
+			                     : nullptr;
+			results = array && JSON_NODE_HOLDS_ARRAY(array) ? json_node_get_array(array) : nullptr;
+		}
+	}
+
+	if (results)
+	{
+		const auto layout = pango_cairo_create_layout(cr);
+		const auto font = pango_font_description_from_string("Sans Bold");
+		pango_font_description_set_absolute_size(font, std::max(10, height / 40) * PANGO_SCALE);
+		pango_layout_set_font_description(layout, font);
+		pango_font_description_free(font);
+
+		cairo_set_line_width(cr, std::max(2.0, height / 240.0));
+		double classificationY = 0.0;
+
+		for (guint i = 0; i < json_array_get_length(results); ++i)
+		{
+			const auto node = json_array_get_element(results, i);
+			if (!JSON_NODE_HOLDS_OBJECT(node))
+			{
+				continue;
+			}
+
+			try
+			{
+				const auto result = json_node_get_object(node);
+				const auto confidence = memberNumber(result, "confidence");
+
+				if (json_object_has_member(result, "x1"))
+				{
+					auto x1 = memberNumber(result, "x1");
+					auto y1 = memberNumber(result, "y1");
+					auto x2 = memberNumber(result, "x2");
+					auto y2 = memberNumber(result, "y2");
+
+					if (std::max({x1, y1, x2, y2}) <= 1.0)
+					{
+						x1 *= width;
+						x2 *= width;
+						y1 *= height;
+						y2 *= height;
+					}
+
+					const auto label = memberText(result, "id");
+					setLabelColor(cr, label);
+					cairo_rectangle(cr, x1, y1, x2 - x1, y2 - y1);
+					cairo_stroke(cr);
+					drawLabel(cr, layout, labelText(label, confidence), x1, y1);
+				}
+				else
+				{
+					const auto label = memberText(result, "label");
+					int textHeight = 0;
+
+					setLabelColor(cr, label);
+					drawLabel(cr, layout, labelText(label, confidence), 0.0, classificationY);
+					pango_layout_get_pixel_size(layout, nullptr, &textHeight);
+					classificationY += textHeight;
+				}
+			}
+			catch (...)
+			{
+				// skip the result if its label cannot be allocated
+			}
+		}
+
+		g_object_unref(layout);
+	}
+
+	g_object_unref(parser);
+}
+
+GstCaps*
+frameCaps(int width, int height) noexcept
+{
+	return gst_caps_new_simple("video/x-raw",
+	                           "format", G_TYPE_STRING, G_BYTE_ORDER == G_LITTLE_ENDIAN ? "BGRx" : "xRGB",
+	                           "width", G_TYPE_INT, width,
+	                           "height", G_TYPE_INT, height,
+	                           "framerate", GST_TYPE_FRACTION, 0, 1,
+	                           nullptr);
+}
+} // namespace
+
+/**
+ * @brief Draws the results on their frames and pushes them to the output pipeline, on the thread of
+ *        the ResultsOutputWorker running it.
+ */
+struct GStreamerResultsOutput::Implementation : ResultsOutput
+{
+	GstElement* pipeline{};
+	GstElement* appsrc{};
+	int width{};
+	int height{};
+	Clock::time_point start;
+	std::uint64_t encoded{};
+
+	~Implementation() noexcept override { close(true); }
+
+	// The pipeline is started with the first frame, once the size of the frames is known.
+	void onStop(std::string_view, ResultsOutputStatus) noexcept override { close(true); }
+
+	void operator()(const std::string& metadata, const dto::ImageView* image) noexcept override;
+
+	bool open(int width, int height) noexcept;
+	void push(GstBuffer* buffer, std::string_view metadata, int width, int height, Clock::time_point time) noexcept;
+	void close(bool drain) noexcept;
+	void checkBus() noexcept;
+};
+
+void
+GStreamerResultsOutput::Implementation::operator()(const std::string& metadata,
+                                                   const dto::ImageView* image) noexcept
+{
+	std::string_view result = metadata;
+	const auto time = takeTime(result);
+
+	// Frames that could not be shared by the worker are handed out as null images.
+	if (!image)
+	{
+		return;
+	}
+
+	// The frame is copied into a buffer handed over to the pipeline as is.
+	const auto width = static_cast<int>(image->width());
+	const auto height = static_cast<int>(image->height());
+	const auto stride = static_cast<std::size_t>(cairo_format_stride_for_width(CAIRO_FORMAT_RGB24, width));
+	const auto buffer = gst_buffer_new_allocate(nullptr, stride * height, nullptr);
+
+	if (!buffer)
+	{
+		return;
+	}
+
+	GstMapInfo map;
+	if (!gst_buffer_map(buffer, &map, GST_MAP_WRITE))
+	{
+		gst_buffer_unref(buffer);
+		return;
+	}
+	copyFrame(*image, PixelFormat::fromMetadata(image->metadata()), map.data, stride);
+	gst_buffer_unmap(buffer, &map);
+
+	push(buffer, result, width, height, time);
+}
+/**
+ * @brief Starts the output pipeline for frames of @p width by @p height pixels, or updates its
+ *        caps if the size of the frames changed.
+ */
+bool
+GStreamerResultsOutput::Implementation::open(int width, int height) noexcept
+{
+	if (pipeline && width == this->width && height == this->height)
+	{
+		return true;
+	}
+
+	if (pipeline)
+	{
+		const auto caps = frameCaps(width, height);
+		g_object_set(appsrc, "caps", caps, nullptr);
+		gst_caps_unref(caps);
+		this->width = width;
+		this->height = height;
+		return true;
+	}
+
+	const auto description = getenv("NEURALA_GSTREAMER_OUTPUT_PIPELINE");
+	if (!description)
+	{
+		std::cerr << "NEURALA_GSTREAMER_OUTPUT_PIPELINE is not defined\n";
+		return false;
+	}
+
+	GError* error = nullptr;
+	pipeline = gst_parse_launch(description, &error);
+
+	if (error)
+	{
+		std::cerr << "Could not parse the GStreamer output pipeline: " << error->message << '\n';
+		g_error_free(error);
+	}
+
+	if (!pipeline)
+	{
+		return false;
+	}
+
+	appsrc = gst_bin_get_by_name(GST_BIN(pipeline), kAppSrcName);
+	if (!appsrc)
+	{
+		std::cerr << "The GStreamer output pipeline has no element named " << kAppSrcName << '\n';
+		gst_object_unref(pipeline);
+		pipeline = nullptr;
+		return false;
+	}
+
+	// Blocking the worker when the pipeline lags behind lets frames pile up in the queue, where the
+	// drop policy applies.
+	const auto caps = frameCaps(width, height);
+	g_object_set(appsrc,
+	             "caps", caps,
+	             "format", GST_FORMAT_TIME,
+	             "is-live", FALSE,
+	             "block", TRUE,
+	             "max-bytes", static_cast<guint64>(2 * 4 * width * height),
+	             nullptr);
+	gst_caps_unref(caps);
+
+	if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+	{
+		std::cerr << "Could not start the GStreamer output pipeline\n";
+		close(false);
+		return false;
+	}
+
+	this->width = width;
+	this->height = height;
+	encoded = 0;
+	return true;
+}
+
+void
+GStreamerResultsOutput::Implementation::push(GstBuffer* buffer,
+                                             std::string_view metadata,
+                                             int width,
+                                             int height,
+                                             Clock::time_point time) noexcept
+{
+	if (!open(width, height))
+	{
+		gst_buffer_unref(buffer);
+		return;
+	}
+
+	GstMapInfo map;
+	if (gst_buffer_map(buffer, &map, GST_MAP_WRITE))
+	{
+		const auto stride = cairo_format_stride_for_width(CAIRO_FORMAT_RGB24, width);
+		const auto surface = cairo_image_surface_create_for_data(
+		  map.data, CAIRO_FORMAT_RGB24, width, height, stride);
+		const auto cr = cairo_create(surface);
+
+		drawResults(cr, metadata, width, height);
+
+		cairo_destroy(cr);
+		cairo_surface_flush(surface);
+		cairo_surface_destroy(surface);
+		gst_buffer_unmap(buffer, &map);
+	}
+
+	if (encoded == 0)
+	{
+		start = time;
+	}
+
+	GST_BUFFER_PTS(buffer) = static_cast<GstClockTime>(
+	  std::chrono::duration_cast<std::chrono::nanoseconds>(time - start).count());
+
+	// gst_app_src_push_buffer() takes ownership of the buffer.
+	const auto flow = gst_app_src_push_buffer(GST_APP_SRC(appsrc), buffer);
+	++encoded;
+
+	if (flow != GST_FLOW_OK)
+	{
+		std::cerr << "The GStreamer output pipeline stopped accepting frames\n";
+		close(false);
+		return;
+	}
+
+	checkBus();
+}
+
+/// Tears down the pipeline if it reported an error, it is started again with the next frame.
+void
+GStreamerResultsOutput::Implementation::checkBus() noexcept
+{
+	const auto bus = gst_element_get_bus(pipeline);
+	const auto message = gst_bus_timed_pop_filtered(bus, 0, GST_MESSAGE_ERROR);
+	gst_object_unref(bus);
+
+	if (!message)
+	{
+		return;
+	}
+
+	GError* error = nullptr;
+	gchar* debug = nullptr;
+	gst_message_parse_error(message, &error, &debug);
+	std::cerr << "GStreamer output pipeline error: " << (error ? error->message : "unknown") << '\n';
+
+	if (error)
+	{
+		g_error_free(error);
+	}
+	g_free(debug);
+	gst_message_unref(message);
+
+	close(false);
+}
+
+/**
+ * @brief Stops the output pipeline.
+ *
+ * @param drain if true, the end of the stream is signaled first and the pipeline is given some
+ *              time to flush its data, so that files are properly finalized
+ */
+void
+GStreamerResultsOutput::Implementation::close(bool drain) noexcept
+{
+	if (!pipeline)
+	{
+		return;
+	}
+
+	if (drain)
+	{
+		gst_app_src_end_of_stream(GST_APP_SRC(appsrc));
+
+		const auto bus = gst_element_get_bus(pipeline);
+		const auto message = gst_bus_timed_pop_filtered(
+		  bus, kEndOfStreamTimeout, static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+
+		if (!message)
+		{
+			std::cerr << "The GStreamer output pipeline did not finish within 5 seconds\n";
+		}
+		else
+		{
+			gst_message_unref(message);
+		}
+		gst_object_unref(bus);
+	}
+
+	gst_element_set_state(pipeline, GST_STATE_NULL);
+	gst_object_unref(appsrc);
+	gst_object_unref(pipeline);
+	appsrc = nullptr;
+	pipeline = nullptr;
+	width = 0;
+	height = 0;
+}
+
+void*
+GStreamerResultsOutput::create(PluginArguments&, PluginErrorCallback& error)
+{
+	if (!gst_is_initialized())
+	{
+		gst_init(0, NULL);
+	}
+
+	GStreamerResultsOutput* p = nullptr;
+
+	try
+	{
+		p = new GStreamerResultsOutput();
+	}
+	catch (const std::exception& e)
+	{
+		error(e.what());
+	}
+
+	return p;
+}
+
+void
+GStreamerResultsOutput::destroy(void* p)
+{
+	delete static_cast<GStreamerResultsOutput*>(p);
+}
+
+GStreamerResultsOutput::GStreamerResultsOutput()
+ : m_implementation(std::make_unique<Implementation>())
+ , m_worker(std::make_unique<ResultsOutputWorker>(*m_implementation, queueCapacity(), overflowPolicy()))
+{ }
+
+GStreamerResultsOutput::~GStreamerResultsOutput() noexcept
+{
+	// Queued frames are still encoded, so that nothing is lost on shutdown.
+	const auto dropped = m_worker->dropped() + m_worker->coalesced();
+	m_worker.reset();
+
+	if (dropped > 0)
+	{
+		std::clog << "GStreamer output dropped " << dropped << " frames\n";
+	}
+}
+
+void
+GStreamerResultsOutput::onStart(std::string_view id) noexcept
+{
+	m_worker->onStart(id);
+}
+
+void
+GStreamerResultsOutput::onStop(std::string_view id, ResultsOutputStatus status) noexcept
+{
+	m_worker->onStop(id, status);
+}
+
+void
+GStreamerResultsOutput::operator()(const std::string& metadata, const dto::ImageView* image) noexcept
+{
+	if (!image || image->empty() || !image->data())
+	{
+		return;
+	}
+
+	if (!isSupported(PixelFormat::fromMetadata(image->metadata())))
+	{
+		if (!m_unsupportedLogged.exchange(true, std::memory_order_relaxed))
+		{
+			std::cerr << "GStreamer output does not support " << image->datatype() << ' '
+			          << image->colorSpace() << ' ' << image->layout() << " frames\n";
+		}
+		return;
+	}
+
+	// Frames are timestamped when they are received, so the output plays at the rate of the results
+	// however long they waited in the queue.
+	try
+	{
+		m_result.assign(metadata);
+		appendTime(m_result, Clock::now());
+	}
+	catch (...)
+	{
+		m_worker->countDropped();
+		return;
+	}
+
+	(*m_worker)(m_result, image);
+}
+
+} // namespace neurala
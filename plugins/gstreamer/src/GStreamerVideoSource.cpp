@@ -16,16 +16,36 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <charconv>
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <thread>
 
 #include <gst/gst.h>
 #include <gst/app/gstappsink.h>
+#include <gst/video/video.h>
 
+#include <neurala/image/ColorConversion.h>
+#include <neurala/image/FramePool.h>
+#include <neurala/image/PixelFormat.h>
+#include <neurala/image/views/StridedImageView.h>
 #include <neurala/plugin/PluginBindings.h>
 #include <neurala/plugin/PluginManager.h>
 #include <neurala/plugin/PluginStatus.h>
+#include <neurala/utils/EventCount.h>
+#include <neurala/utils/SpscRing.h>
+#include <neurala/video/VideoSourceStatus.h>
 
+#include "FrameStatistics.h"
+#include "GStreamerResultsOutput.h"
 #include "GStreamerVideoSource.h"
 
 extern "C" PLUGIN_API NeuralaPluginExitFunction
@@ -38,6 +58,12 @@ initMe(NeuralaPluginManager* pluginManager, std::error_code* status)
 	{
 		return nullptr;
 	}
+	*status = pm.registerPlugin<neurala::GStreamerResultsOutput>("GStreamerResultsOutput",
+	                                                             neurala::Version(1, 0));
+	if (*status != neurala::PluginStatus::success())
+	{
+		return nullptr;
+	}
 	return [] { return 0; };
 }
 
@@ -45,6 +71,35 @@ namespace neurala
 {
 namespace
 {
+/// Returns the format of frames in the GStreamer video format @p format, unknown if it has none.
+PixelFormat
+pixelFormat(GstVideoFormat format) noexcept
+{
+	switch (format)
+	{
+	case GST_VIDEO_FORMAT_RGB:
+		return kRGB8;
+	case GST_VIDEO_FORMAT_BGR:
+		return kBGR8;
+	case GST_VIDEO_FORMAT_RGBA:
+		return {EDatatype::uint8, EColorSpace::RGBA, ELayout::interleaved};
+	case GST_VIDEO_FORMAT_BGRA:
+		return {EDatatype::uint8, EColorSpace::BGRA, ELayout::interleaved};
+	case GST_VIDEO_FORMAT_GRAY8:
+		return {EDatatype::uint8, EColorSpace::grayscale, ELayout::interleaved};
+	case GST_VIDEO_FORMAT_I420:
+		return {EDatatype::uint8, EColorSpace::YUV420, ELayout::planar};
+	case GST_VIDEO_FORMAT_NV12:
+		return {EDatatype::uint8, EColorSpace::NV12, ELayout::semiplanar};
+	case GST_VIDEO_FORMAT_NV21:
+		return {EDatatype::uint8, EColorSpace::NV21, ELayout::semiplanar};
+	case GST_VIDEO_FORMAT_YUY2:
+		return {EDatatype::uint8, EColorSpace::YUV422, ELayout::interleaved};
+	default:
+		return {};
+	}
+}
+
 class Sample
 {
 	GstSample* sample;
@@ -64,9 +119,60 @@ public:
 		gst_sample_unref(sample);
 	}
 
-	dto::ImageView imageView(std::size_t width, std::size_t height) const noexcept
+	/**
+	 * @brief Returns a view of the frame, with the planes and row strides given by the caps of the
+	 *        sample and the video meta of its buffer.
+	 *
+	 * Frames whose format cannot be described are viewed as packed RGB of @p width by @p height
+	 * pixels. Either way, they are described as stored in @p orientation.
+	 */
+	StridedImageView view(std::size_t width, std::size_t height, EOrientation orientation) const
+	  noexcept
 	{
-		return dto::ImageView(dto::ImageMetadata("uint8", width, height, "RGB", "interleaved", "topLeft"), map.data);
+		GstVideoInfo info;
+		const auto caps = gst_sample_get_caps(sample);
+		const auto negotiated = caps && gst_video_info_from_caps(&info, caps)
+		                          ? pixelFormat(GST_VIDEO_INFO_FORMAT(&info))
+		                          : PixelFormat();
+
+		if (!negotiated.known())
+		{
+			const PixelFormat rgb(kRGB8.datatype(), kRGB8.colorSpace(), kRGB8.layout(), orientation);
+			return StridedImageView(rgb.metadata(width, height), map.data);
+		}
+
+		const PixelFormat format(negotiated.datatype(),
+		                         negotiated.colorSpace(),
+		                         negotiated.layout(),
+		                         orientation,
+		                         negotiated.channels());
+
+		width = GST_VIDEO_INFO_WIDTH(&info);
+		height = GST_VIDEO_INFO_HEIGHT(&info);
+
+		// Upstream elements may lay out the planes differently than the caps imply.
+		const auto meta = gst_buffer_get_video_meta(buffer);
+		const auto planeCount = std::min(format.planes(), StridedImageView::kMaxPlanes);
+		ImagePlane planes[StridedImageView::kMaxPlanes];
+
+		for (std::size_t i = 0; i < planeCount; ++i)
+		{
+			const auto offset = meta ? meta->offset[i] : GST_VIDEO_INFO_PLANE_OFFSET(&info, i);
+			const auto stride = meta ? meta->stride[i] : GST_VIDEO_INFO_PLANE_STRIDE(&info, i);
+			const auto size = format.planeSize(i, width, height);
+
+			planes[i] = {reinterpret_cast<const std::byte*>(map.data) + offset,
+			             static_cast<std::size_t>(stride),
+			             size.rowBytes,
+			             size.rows};
+
+			if (stride < 0 || offset + planes[i].size() > map.size)
+			{
+				return {};
+			}
+		}
+
+		return StridedImageView(format.metadata(width, height), planes, planeCount);
 	}
 
 	Sample(const Sample&) = delete;
@@ -75,69 +181,441 @@ public:
 	Sample& operator=(const Sample&) = delete;
 	Sample& operator=(Sample&&) = delete;
 };
+
+/**
+ * @brief Reference to a clock, released when destroyed.
+ */
+struct ClockDeleter
+{
+	void operator()(GstClock* clock) const noexcept { gst_object_unref(clock); }
+};
+
+using ClockPtr = std::unique_ptr<GstClock, ClockDeleter>;
+
+ClockPtr
+shareClock(const ClockPtr& clock) noexcept
+{
+	return ClockPtr(clock ? static_cast<GstClock*>(gst_object_ref(clock.get())) : nullptr);
 }
 
-struct GStreamerVideoSource::Implementation
+std::uint64_t
+clockTime(GstClock* clock) noexcept
 {
-	GstElement* pipeline;
-	GstElement* userPipeline;
-	GstElement* sink;
+	return clock ? gst_clock_get_time(clock) : plug::gst::kInvalidTime;
+}
 
-	std::unique_ptr<Sample> sample;
-};
+std::uint64_t
+droppedSamples(GstElement* sink) noexcept
+{
+	// GstBaseSink only exposes its statistics since GStreamer 1.18.
+	if (!g_object_class_find_property(G_OBJECT_GET_CLASS(sink), "stats"))
+	{
+		return 0;
+	}
 
-void*
-GStreamerVideoSource::create(PluginArguments&, PluginErrorCallback&)
+	GstStructure* stats = nullptr;
+	guint64 dropped = 0;
+
+	g_object_get(sink, "stats", &stats, nullptr);
+
+	if (stats)
+	{
+		gst_structure_get_uint64(stats, "dropped", &dropped);
+		gst_structure_free(stats);
+	}
+
+	return dropped;
+}
+
+/**
+ * @brief Returns the user pipeline description.
+ *
+ * The description is read from the file named by NEURALA_GSTREAMER_PIPELINE_FILE if it is defined,
+ * from NEURALA_GSTREAMER_PIPELINE otherwise.
+ */
+bool
+pipelineDescription(std::string& description)
 {
-	if(!gst_is_initialized())
+	if (const auto path = getenv("NEURALA_GSTREAMER_PIPELINE_FILE"))
 	{
-		gst_init(0, NULL);
+		std::ifstream file(path);
+		std::ostringstream contents;
+
+		if (!(contents << file.rdbuf()))
+		{
+			std::cerr << "Could not read GStreamer pipeline file " << path << '\n';
+			return false;
+		}
+
+		description = contents.str();
+		return description.find_first_not_of(" \t\r\n") != std::string::npos;
 	}
-	return new GStreamerVideoSource();
+
+	if (const auto userPipeline = getenv("NEURALA_GSTREAMER_PIPELINE"))
+	{
+		description = userPipeline;
+		return true;
+	}
+
+	return false;
 }
 
-void
-GStreamerVideoSource::destroy(void* p)
+// Time given to a reloaded pipeline to produce its first sample before giving up on it.
+constexpr auto kPrerollTimeout = std::chrono::seconds(10);
+
+// Interval at which the pipeline file is checked for modifications.
+constexpr auto kWatchInterval = std::chrono::seconds(1);
+
+// Delays between successive restarts of a failing pipeline.
+constexpr auto kInitialBackoff = std::chrono::milliseconds(500);
+constexpr auto kMaximumBackoff = std::chrono::seconds(30);
+
+// Interval at which the bus watcher checks whether it should stop.
+constexpr GstClockTime kBusPollInterval = 100 * GST_MSECOND;
+
+/**
+ * @brief Returns how long nextFrame() waits for a frame, from NEURALA_GSTREAMER_TIMEOUT_MS.
+ */
+std::chrono::milliseconds
+frameTimeout() noexcept
 {
-	delete static_cast<GStreamerVideoSource*>(p);
+	const auto timeout = getenv("NEURALA_GSTREAMER_TIMEOUT_MS");
+	const auto milliseconds = timeout ? std::atoi(timeout) : 0;
+	return std::chrono::milliseconds(milliseconds > 0 ? milliseconds : 5000);
 }
 
-GStreamerVideoSource::GStreamerVideoSource()
- : m_implementation(std::make_unique<Implementation>()),
-   m_bufferReady(false),
-   m_streamState(EStreamState::waitingForFrame)
+/**
+ * @brief Returns the color space frames are converted to by the plugin, from
+ *        NEURALA_GSTREAMER_COLOR_SPACE, or unknown if they are handed out as negotiated.
+ */
+EColorSpace
+outputColorSpace() noexcept
 {
-	m_implementation->pipeline = gst_pipeline_new("Neurala GStreamer Video Source");
+	const auto name = getenv("NEURALA_GSTREAMER_COLOR_SPACE");
+	if (!name || !*name)
+	{
+		return EColorSpace::unknown;
+	}
 
+	const auto colorSpace = parseColorSpace(name);
+	if (colorSpace != EColorSpace::RGB && colorSpace != EColorSpace::BGR
+	    && colorSpace != EColorSpace::RGBA && colorSpace != EColorSpace::BGRA)
 	{
-		const auto parser = gst_parse_context_new();
-		const auto userPipeline = getenv("NEURALA_GSTREAMER_PIPELINE");
+		std::cerr << "Unsupported NEURALA_GSTREAMER_COLOR_SPACE " << name
+		          << ", frames are not converted\n";
+		return EColorSpace::unknown;
+	}
 
-		if (!userPipeline)
-		{
-			m_lastError = B4BError::invalidParameter();
-			return;
-		}
+	return colorSpace;
+}
+
+/**
+ * @brief Returns the orientation frames are stored in, from NEURALA_GSTREAMER_ORIENTATION, or
+ *        topLeft if it is not set.
+ *
+ * Cameras mounted sideways or upside down report it there, rather than turning their frames in
+ * the pipeline, which costs a copy per frame.
+ */
+EOrientation
+inputOrientation() noexcept
+{
+	const auto name = getenv("NEURALA_GSTREAMER_ORIENTATION");
+	if (!name || !*name)
+	{
+		return EOrientation::topLeft;
+	}
+
+	const auto orientation = parseOrientation(name);
+	if (orientation == EOrientation::unknown)
+	{
+		std::cerr << "Unsupported NEURALA_GSTREAMER_ORIENTATION " << name
+		          << ", frames are described as topLeft\n";
+		return EOrientation::topLeft;
+	}
+
+	return orientation;
+}
+
+/**
+ * @brief Returns if seekable sources are looped when they reach their end, which can be disabled
+ *        by setting NEURALA_GSTREAMER_LOOP to 0.
+ */
+bool
+loopEnabled() noexcept
+{
+	const auto loop = getenv("NEURALA_GSTREAMER_LOOP");
+	return !loop || std::string(loop) != "0";
+}
+
+/**
+ * @brief Returns if reloaded pipelines are only started once the current one is stopped, rather
+ *        than alongside it, which is asked for by setting NEURALA_GSTREAMER_RELOAD to restart.
+ */
+bool
+reloadRestarts() noexcept
+{
+	const auto mode = getenv("NEURALA_GSTREAMER_RELOAD");
+	return mode && std::string(mode) == "restart";
+}
+
+bool
+isSeekable(GstElement* pipeline) noexcept
+{
+	const auto query = gst_query_new_seeking(GST_FORMAT_TIME);
+	gboolean seekable = FALSE;
+
+	if (gst_element_query(pipeline, query))
+	{
+		gst_query_parse_seeking(query, nullptr, &seekable, nullptr, nullptr);
+	}
+
+	gst_query_unref(query);
+	return seekable;
+}
+}
+
+/**
+ * @brief User pipeline feeding samples to the video source through its appsink.
+ *
+ * While the pipeline is being reloaded, two streams exist at once: the active one keeps delivering
+ * frames while the new one waits in standby, holding its first sample, until it is swapped in.
+ */
+struct GStreamerVideoSource::Stream
+{
+	enum class EState : unsigned char
+	{
+		standby,
+		active,
+		closing
+	};
+
+	GStreamerVideoSource* owner;
+	// Tags the samples of the stream, so that those of a stream swapped out are skipped.
+	const std::uint64_t generation;
+	GstElement* pipeline = nullptr;
+	GstElement* sink = nullptr;
+
+	// Set by the caps probe, read by grabFrame().
+	std::atomic<unsigned int> width = 0;
+	std::atomic<unsigned int> height = 0;
+
+	// Changed under the owner's mutex, and read without it by the streaming thread.
+	std::atomic<EState> state = EState::standby;
+	std::atomic<bool> prerolled = false;
+	std::atomic<bool> flushing = false;
+
+	// Guarded by the owner's mutex.
+	bool failed = false;
+	bool suspended = false;
+
+	// Serializes the state changes of restart(), suspend() and resume().
+	std::mutex stateMutex;
+
+	// Set when a sample reaches the appsink, to reset the restart backoff.
+	std::atomic<bool> delivered = false;
+
+	// Clock of the pipeline, taken by its streaming thread at its first sample since it started.
+	ClockPtr clock;
+
+	std::thread busWatcher;
+	std::mutex busMutex;
+	std::condition_variable busCondition;
+	bool stopping = false;
 
-		m_implementation->userPipeline = gst_parse_launch(userPipeline, nullptr);
+	Stream(GStreamerVideoSource* owner, const std::string& description);
+	~Stream() noexcept;
 
-		gst_parse_context_free(parser);
+	bool valid() const noexcept { return sink != nullptr; }
+
+	bool active() const noexcept
+	{
+		std::unique_lock<decltype(owner->m_mutex)> lock(owner->m_mutex);
+		return state == EState::active;
 	}
 
+	// Handles errors, end of stream, latency and state change messages posted by the pipeline.
+	void watchBus() noexcept;
+
+	// Waits for @p delay, returns false if the stream is stopped in the meantime.
+	bool wait(std::chrono::milliseconds delay) noexcept;
+
+	// Stops and restarts the pipeline, releasing the streaming thread if it waits for the SDK.
+	void restart() noexcept;
+
+	// Stops the pipeline, releasing its source, until resume() is called.
+	void suspend() noexcept;
+
+	// Restarts the pipeline stopped by suspend().
+	void resume() noexcept;
+
+	Stream(const Stream&) = delete;
+	Stream(Stream&&) = delete;
+
+	Stream& operator=(const Stream&) = delete;
+	Stream& operator=(Stream&&) = delete;
+};
+
+struct GStreamerVideoSource::Implementation
+{
+	std::unique_ptr<Stream> stream;
+
+	// Sample queued by the streaming thread of a stream, to be handed out by nextFrame().
+	struct QueuedSample
 	{
-		GstBin* bin;
+		std::unique_ptr<Sample> sample;
+		plug::gst::FrameTiming timing;
+		unsigned int width = 0;
+		unsigned int height = 0;
+		std::uint64_t generation = 0;
+		ClockPtr clock;
+	};
+
+	// Samples are handed out without locking: the streaming thread waits for the SDK to take the
+	// queued sample before queuing the next one, and for an active stream before queuing any.
+	SpscRing<QueuedSample, 1> queue;
+	// Serializes the streaming threads, two of which run while a reloaded pipeline is swapped in.
+	std::mutex queueMutex;
+	// Signaled when a sample is queued, or the active stream ends.
+	EventCount sampleQueued;
+	// Signaled when a sample is taken, or a stream is swapped in, flushed or closed.
+	EventCount sampleTaken;
+
+	// Number of streams created so far, and generation of the active one.
+	std::atomic<std::uint64_t> streams{0};
+	std::atomic<std::uint64_t> generation{0};
+
+	// Sample handed out by the last call to nextFrame(), in use by the SDK.
+	std::unique_ptr<Sample> sample;
+	plug::gst::FrameTiming timing;
+	// Clock of the pipeline of the sample, read by the statistics without the owner's mutex.
+	ClockPtr clock;
+	StridedImageView view;
+	// Color space the sample is converted to, unknown if it is handed out as is.
+	EColorSpace conversion = EColorSpace::unknown;
+
+	// Copy of the sample without row padding, or conversion, made on demand by frame() to a frame of
+	// FramePool::shared(), which outputs keep rather than copy.
+	SharedFrame packed;
+	dto::ImageView packedFrame;
+
+	const EColorSpace colorSpace = outputColorSpace();
+
+	const EOrientation orientation = inputOrientation();
+
+	// Incremented by the streaming threads of both pipelines while one replaces the other.
+	std::atomic<std::uint64_t> sequence{0};
+
+	plug::gst::FrameStatistics statistics;
+
+	const std::chrono::milliseconds frameTimeout = neurala::frameTimeout();
+
+	// Signaled, under the owner's mutex, when a stream in standby holds its first sample.
+	std::condition_variable prerollCondition;
 
-		// g_object_get(m_implementation->userPipeline, "video-sink", &bin, nullptr);
+	// Serializes reloads between execute() and the pipeline file watcher.
+	std::mutex reloadMutex;
 
-		m_implementation->sink = gst_bin_get_by_name(GST_BIN(m_implementation->userPipeline), "neurala_appsink");
+	const bool reloadRestarts = neurala::reloadRestarts();
+
+	std::thread watcher;
+	std::mutex watcherMutex;
+	std::condition_variable watcherCondition;
+	bool stopWatching = false;
+
+	/// Copies or converts the sample to @p bytes.
+	dto::ImageView copy(std::byte* bytes, std::size_t size) const noexcept
+	{
+		return conversion == EColorSpace::unknown ? view.copyTo(bytes, size)
+		                                          : convertColor(view, conversion, bytes, size);
+	}
+
+	/// Returns the metadata of the sample once copied or converted.
+	dto::ImageMetadata copyMetadata() const
+	{
+		return conversion == EColorSpace::unknown
+		         ? view.metadata()
+		         : convertedFormat(view.format(), conversion).metadata(view.width(), view.height());
+	}
 
-		if (!m_implementation->sink)
+	/// Returns the size of the sample once copied or converted.
+	std::size_t copySize() const noexcept
+	{
+		return conversion == EColorSpace::unknown
+		         ? view.requiredBytes()
+		         : requiredBytes(convertedFormat(view.format(), conversion), view.width(), view.height());
+	}
+
+	plug::gst::FrameTiming sampleTiming(Stream& stream, GstSample* sample) noexcept
+	{
+		plug::gst::FrameTiming timing;
+
+		const auto buffer = gst_sample_get_buffer(sample);
+		const auto segment = gst_sample_get_segment(sample);
+
+		if (!stream.clock)
 		{
-			m_lastError = B4BError::genericError();
-			return;
+			stream.clock.reset(gst_element_get_clock(stream.pipeline));
+		}
+
+		timing.sequence = sequence.fetch_add(1, std::memory_order_relaxed);
+		timing.sinkTime = clockTime(stream.clock.get());
+		timing.generation = stream.generation;
+
+		if (GST_BUFFER_OFFSET_IS_VALID(buffer))
+		{
+			timing.offset = GST_BUFFER_OFFSET(buffer);
+		}
+
+		timing.pts = GST_BUFFER_PTS(buffer);
+		timing.dts = GST_BUFFER_DTS(buffer);
+
+		if (segment && GST_CLOCK_TIME_IS_VALID(timing.pts))
+		{
+			timing.runningTime = gst_segment_to_running_time(segment, GST_FORMAT_TIME, timing.pts);
 		}
 
-		gst_element_set_state(m_implementation->userPipeline, GST_STATE_PLAYING);
+		if (GST_CLOCK_TIME_IS_VALID(timing.runningTime))
+		{
+			timing.captureTime = gst_element_get_base_time(stream.pipeline) + timing.runningTime;
+		}
+
+		return timing;
+	}
+
+	void writeStatistics(std::ostream& os) const
+	{
+		statistics.write(os, stream ? droppedSamples(stream->sink) : 0);
+		os << '\n';
+	}
+};
+
+GStreamerVideoSource::Stream::Stream(GStreamerVideoSource* owner, const std::string& description)
+ : owner(owner), generation(owner->m_implementation->streams.fetch_add(1) + 1)
+{
+	GError* error = nullptr;
+
+	pipeline = gst_parse_launch(description.c_str(), &error);
+
+	if (error)
+	{
+		std::cerr << "Error while parsing GStreamer pipeline: " << error->message << '\n';
+		g_error_free(error);
+	}
+
+	if (!pipeline)
+	{
+		return;
+	}
+
+	if (GST_IS_BIN(pipeline))
+	{
+		sink = gst_bin_get_by_name(GST_BIN(pipeline), "neurala_appsink");
+	}
+
+	if (!sink)
+	{
+		std::cerr << "No element named neurala_appsink in GStreamer pipeline\n";
+		return;
 	}
 
 	{
@@ -147,7 +625,7 @@ GStreamerVideoSource::GStreamerVideoSource()
 			if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
 				GstCaps* caps;
 
-				const auto self = static_cast<GStreamerVideoSource*>(user_data);
+				const auto self = static_cast<Stream*>(user_data);
 
 				gst_event_parse_caps(event, &caps);
 
@@ -159,123 +637,640 @@ GStreamerVideoSource::GStreamerVideoSource()
 				gst_structure_get_int(s, "width", &width);
 				gst_structure_get_int(s, "height", &height);
 
-				self->m_width = static_cast<unsigned int>(width);
-				self->m_height = static_cast<unsigned int>(height);
+				self->width.store(static_cast<unsigned int>(width), std::memory_order_relaxed);
+				self->height.store(static_cast<unsigned int>(height), std::memory_order_relaxed);
 			}
 
 			return GST_PAD_PROBE_OK;
 		};
 
-		const auto pad = gst_element_get_static_pad(m_implementation->sink, "sink");
+		const auto pad = gst_element_get_static_pad(sink, "sink");
 
 		gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_EVENT_BOTH, probeStreamSize, this, nullptr);
 		gst_object_unref(pad);
 	}
 
-	const auto prerollCallback = [](auto sink, auto data) { return (GstFlowReturn) preroll(sink, static_cast<GStreamerVideoSource*>(data)); };
-	const auto grabFrameCallback = [](auto sink, auto data) { return (GstFlowReturn) grabFrame(sink, static_cast<GStreamerVideoSource*>(data)); };
+	const auto grabFrameCallback = [](auto sink, auto data) { return (GstFlowReturn) grabFrame(sink, static_cast<Stream*>(data)); };
+
+	GstAppSinkCallbacks callbacks = {nullptr, nullptr, grabFrameCallback};
+
+	gst_app_sink_set_callbacks(GST_APP_SINK(sink), &callbacks, this, nullptr);
+
+	busWatcher = std::thread(&Stream::watchBus, this);
+}
+
+GStreamerVideoSource::Stream::~Stream() noexcept
+{
+	if (busWatcher.joinable())
+	{
+		{
+			std::scoped_lock lock(busMutex);
+			stopping = true;
+		}
+		busCondition.notify_all();
+		busWatcher.join();
+	}
+	if (pipeline)
+	{
+		gst_element_set_state(pipeline, GST_STATE_NULL);
+	}
+	if (sink)
+	{
+		gst_object_unref(sink);
+	}
+	if (pipeline)
+	{
+		gst_object_unref(pipeline);
+	}
+}
+
+bool
+GStreamerVideoSource::Stream::wait(std::chrono::milliseconds delay) noexcept
+{
+	std::unique_lock<std::mutex> lock(busMutex);
+	return !busCondition.wait_for(lock, delay, [this]() { return stopping; });
+}
+
+void
+GStreamerVideoSource::Stream::restart() noexcept
+{
+	std::scoped_lock stateLock(stateMutex);
+
+	{
+		std::unique_lock<decltype(owner->m_mutex)> lock(owner->m_mutex);
+		flushing = true;
+	}
+
+	owner->m_implementation->sampleTaken.notifyAll();
+	gst_element_set_state(pipeline, GST_STATE_NULL);
+
+	// The streaming thread is stopped, and may run with another clock once restarted.
+	clock.reset();
+
+	{
+		std::unique_lock<decltype(owner->m_mutex)> lock(owner->m_mutex);
+
+		// A suspended pipeline is only restarted by resume().
+		if (suspended)
+		{
+			return;
+		}
+
+		flushing = false;
+
+		if (state == EState::active)
+		{
+			owner->m_lastError = B4BError::ok();
+			if (owner->m_streamState == EStreamState::endOfStream)
+			{
+				owner->m_streamState = EStreamState::waitingForFrame;
+			}
+		}
+	}
+
+	gst_element_set_state(pipeline, GST_STATE_PLAYING);
+}
+
+void
+GStreamerVideoSource::Stream::suspend() noexcept
+{
+	std::scoped_lock stateLock(stateMutex);
+
+	{
+		std::unique_lock<decltype(owner->m_mutex)> lock(owner->m_mutex);
+		suspended = true;
+		flushing = true;
+	}
+
+	owner->m_implementation->sampleTaken.notifyAll();
+	gst_element_set_state(pipeline, GST_STATE_NULL);
+	clock.reset();
+}
+
+void
+GStreamerVideoSource::Stream::resume() noexcept
+{
+	std::scoped_lock stateLock(stateMutex);
+
+	{
+		std::unique_lock<decltype(owner->m_mutex)> lock(owner->m_mutex);
+		suspended = false;
+		flushing = false;
+	}
+
+	gst_element_set_state(pipeline, GST_STATE_PLAYING);
+}
+
+void
+GStreamerVideoSource::Stream::watchBus() noexcept
+{
+	const auto bus = gst_element_get_bus(pipeline);
+	const auto types = static_cast<GstMessageType>(GST_MESSAGE_ERROR | GST_MESSAGE_EOS | GST_MESSAGE_LATENCY
+	                                               | GST_MESSAGE_STATE_CHANGED);
+	const auto loop = loopEnabled();
+
+	auto& statistics = owner->m_implementation->statistics;
+	std::chrono::milliseconds backoff = kInitialBackoff;
+
+	while (wait(std::chrono::milliseconds::zero()))
+	{
+		const auto message = gst_bus_timed_pop_filtered(bus, kBusPollInterval, types);
 
-	GstAppSinkCallbacks callbacks = {nullptr, prerollCallback, grabFrameCallback};
+		if (!message)
+		{
+			continue;
+		}
+
+		bool restartNeeded = false;
+
+		switch (GST_MESSAGE_TYPE(message))
+		{
+			case GST_MESSAGE_STATE_CHANGED:
+				if (GST_MESSAGE_SRC(message) == GST_OBJECT(pipeline) && active())
+				{
+					GstState newState;
+					gst_message_parse_state_changed(message, nullptr, &newState, nullptr);
+					statistics.onStateChanged(gst_element_state_get_name(newState));
+				}
+				break;
+			case GST_MESSAGE_LATENCY:
+				gst_bin_recalculate_latency(GST_BIN(pipeline));
+				break;
+			case GST_MESSAGE_EOS:
+				if (!isSeekable(pipeline))
+				{
+					// Live sources only end when they lose their connection.
+					restartNeeded = true;
+				}
+				else if (loop)
+				{
+					// Rewind without tearing down the pipeline.
+					if (gst_element_seek_simple(pipeline, GST_FORMAT_TIME, static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT), 0))
+					{
+						statistics.onLoop();
+					}
+					else
+					{
+						restartNeeded = true;
+					}
+				}
+				else
+				{
+					{
+						std::unique_lock<decltype(owner->m_mutex)> lock(owner->m_mutex);
+						if (state == EState::active)
+						{
+							owner->m_streamState = EStreamState::endOfStream;
+						}
+					}
+					owner->m_implementation->sampleQueued.notifyAll();
+				}
+				break;
+			case GST_MESSAGE_ERROR:
+			{
+				GError* error = nullptr;
+				gchar* debug = nullptr;
+
+				gst_message_parse_error(message, &error, &debug);
+				std::cerr << "GStreamer error from " << GST_OBJECT_NAME(GST_MESSAGE_SRC(message)) << ": "
+				          << (error ? error->message : "unknown") << '\n';
+				statistics.onError(error ? error->message : "unknown");
+				g_clear_error(&error);
+				g_free(debug);
+
+				restartNeeded = true;
+				break;
+			}
+			default:
+				break;
+		}
 
-	gst_app_sink_set_callbacks(GST_APP_SINK(m_implementation->sink), &callbacks, this, nullptr);
-	gst_element_set_state(m_implementation->pipeline, GST_STATE_PLAYING);
+		gst_message_unref(message);
+
+		if (!restartNeeded)
+		{
+			continue;
+		}
+
+		{
+			std::unique_lock<decltype(owner->m_mutex)> lock(owner->m_mutex);
+
+			// A pipeline that fails before being swapped in is discarded by reload().
+			if (state == EState::standby)
+			{
+				failed = true;
+				owner->m_implementation->prerollCondition.notify_all();
+				continue;
+			}
+		}
+
+		if (delivered.exchange(false))
+		{
+			backoff = kInitialBackoff;
+		}
+
+		if (!wait(backoff))
+		{
+			break;
+		}
+
+		backoff = std::min<std::chrono::milliseconds>(backoff * 2, kMaximumBackoff);
+
+		restart();
+		statistics.onRestart();
+	}
+
+	gst_object_unref(bus);
+}
+
+void*
+GStreamerVideoSource::create(PluginArguments&, PluginErrorCallback&)
+{
+	if(!gst_is_initialized())
+	{
+		gst_init(0, NULL);
+	}
+	return new GStreamerVideoSource();
+}
+
+void
+GStreamerVideoSource::destroy(void* p)
+{
+	delete static_cast<GStreamerVideoSource*>(p);
+}
 
+GStreamerVideoSource::GStreamerVideoSource()
+ : m_implementation(std::make_unique<Implementation>()), m_streamState(EStreamState::waitingForFrame)
+{
+	std::string description;
+
+	if (!pipelineDescription(description))
+	{
+		m_lastError = B4BError::invalidParameter();
+		return;
+	}
+
+	auto stream = std::make_unique<Stream>(this, description);
+
+	if (!stream->valid())
+	{
+		m_lastError = B4BError::genericError();
+		return;
+	}
+
+	// Set before the pipeline plays, as its streaming thread reports the errors of the samples.
 	m_lastError = B4BError::ok();
+
+	m_implementation->generation = stream->generation;
+	stream->state = Stream::EState::active;
+	gst_element_set_state(stream->pipeline, GST_STATE_PLAYING);
+	m_implementation->stream = std::move(stream);
+
+	if (const auto path = getenv("NEURALA_GSTREAMER_PIPELINE_FILE"))
+	{
+		m_implementation->watcher = std::thread(&GStreamerVideoSource::watchPipelineFile, this, std::string(path));
+	}
 }
 
 GStreamerVideoSource::~GStreamerVideoSource() noexcept
 {
-	gst_element_set_state(GST_ELEMENT(m_implementation->pipeline), GST_STATE_NULL);
-	gst_object_unref(m_implementation->sink);
-	gst_object_unref(m_implementation->userPipeline);
-	gst_object_unref(m_implementation->pipeline);
+	if (m_implementation->watcher.joinable())
+	{
+		{
+			std::scoped_lock lock(m_implementation->watcherMutex);
+			m_implementation->stopWatching = true;
+		}
+		m_implementation->watcherCondition.notify_all();
+		m_implementation->watcher.join();
+	}
+
+	closeStream(std::move(m_implementation->stream));
 }
 
-dto::ImageMetadata
-GStreamerVideoSource::metadata() const noexcept
+void
+GStreamerVideoSource::closeStream(std::unique_ptr<Stream> stream) noexcept
 {
-	return m_frame.metadata();
+	if (!stream)
+	{
+		return;
+	}
+
+	{
+		std::unique_lock<decltype(m_mutex)> lock(m_mutex);
+		stream->state = Stream::EState::closing;
+	}
+
+	// Release the streaming thread if it is waiting for the SDK, then stop the pipeline.
+	m_implementation->sampleTaken.notifyAll();
+	stream.reset();
 }
 
 std::error_code
-GStreamerVideoSource::nextFrame() noexcept
+GStreamerVideoSource::reload() noexcept
 {
-	if (B4BError::ok() != m_lastError)
+	std::scoped_lock reloadLock(m_implementation->reloadMutex);
+
+	if (m_implementation->reloadRestarts || !m_implementation->stream)
 	{
-		return m_lastError;
+		return swapStream(true);
 	}
 
-	const auto predicate = [this]() {
-		return frameReady();
-	};
+	const auto status = swapStream(false);
+
+	// Sources a single pipeline can open at once, such as cameras, fail in the new pipeline while
+	// the current one holds them.
+	if (status != VideoSourceStatus::timeout())
+	{
+		return status;
+	}
+
+	std::cerr << "Starting reloaded GStreamer pipeline again, once the current one is stopped\n";
+	return swapStream(true);
+}
+
+std::error_code
+GStreamerVideoSource::swapStream(bool stopFirst) noexcept
+{
+	std::unique_ptr<Stream> stream;
+
+	try
+	{
+		std::string description;
+
+		if (!pipelineDescription(description))
+		{
+			return B4BError::invalidParameter();
+		}
+
+		stream = std::make_unique<Stream>(this, description);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error while reloading GStreamer pipeline: " << e.what() << '\n';
+		return B4BError::genericError();
+	}
+
+	if (!stream->valid())
+	{
+		return B4BError::genericError();
+	}
+
+	// Only reload() swaps the current stream, so it can be used without the mutex.
+	const auto current = m_implementation->stream.get();
+
+	if (stopFirst && current)
+	{
+		current->suspend();
+	}
+
+	// Preroll the new pipeline, while the current one keeps delivering frames unless it was stopped.
+	gst_element_set_state(stream->pipeline, GST_STATE_PLAYING);
+
+	std::unique_ptr<Stream> previous;
 
 	{
 		std::unique_lock<decltype(m_mutex)> lock(m_mutex);
 
-		m_frameReadyCondition.wait(lock, predicate);
+		const auto prerolled = m_implementation->prerollCondition.wait_for(lock, kPrerollTimeout, [&stream]() {
+			return stream->prerolled || stream->failed;
+		});
 
-		if (m_streamState != EStreamState::frameReady)
+		if (!prerolled || stream->failed)
 		{
-			// Not exactly an error, but not sure what to return here
-			return B4BError::genericError();
+			lock.unlock();
+			std::cerr << "Reloaded GStreamer pipeline did not produce any frame, keeping the current one\n";
+			closeStream(std::move(stream));
+
+			if (stopFirst && current)
+			{
+				current->resume();
+			}
+
+			return make_error_code(VideoSourceStatus::timeout());
 		}
 
+		previous = std::exchange(m_implementation->stream, std::move(stream));
+
+		if (previous)
+		{
+			previous->state = Stream::EState::closing;
+		}
+
+		// A frame of the previous pipeline that was not handed out yet is skipped by nextFrame().
+		m_implementation->generation = m_implementation->stream->generation;
+		m_implementation->stream->state = Stream::EState::active;
+
 		m_streamState = EStreamState::waitingForFrame;
-		m_bufferReady = true;
+		m_lastError = B4BError::ok();
 	}
 
-	m_bufferReadyCondition.notify_all();
+	m_implementation->sampleTaken.notifyAll();
+	previous.reset();
 
 	return B4BError::ok();
 }
 
-dto::ImageView
-GStreamerVideoSource::frame() const noexcept
+void
+GStreamerVideoSource::watchPipelineFile(std::string path) noexcept
 {
-	return m_frame;
+	std::error_code ec;
+	auto lastWrite = std::filesystem::last_write_time(path, ec);
+
+	std::unique_lock<std::mutex> lock(m_implementation->watcherMutex);
+
+	while (!m_implementation->watcherCondition.wait_for(lock, kWatchInterval, [this]() {
+		return m_implementation->stopWatching;
+	}))
+	{
+		const auto write = std::filesystem::last_write_time(path, ec);
+
+		if (ec || write == lastWrite)
+		{
+			continue;
+		}
+
+		lastWrite = write;
+		lock.unlock();
+
+		const auto status = reload();
+
+		if (status)
+		{
+			std::cerr << "Could not reload GStreamer pipeline from " << path << ": " << status.message() << '\n';
+		}
+		else
+		{
+			std::clog << "Reloaded GStreamer pipeline from " << path << '\n';
+		}
+
+		lock.lock();
+	}
 }
 
-dto::ImageView
-GStreamerVideoSource::frame(std::byte* bytes, std::size_t size) const noexcept
+dto::ImageMetadata
+GStreamerVideoSource::metadata() const noexcept
 {
-	const auto width = m_frame.width();
-	const auto height = m_frame.height();
-	size = std::min(width * height, size);
-	memcpy(bytes, m_frame.data(), size);
-	return dto::ImageView(m_frame.metadata(), bytes);
+	return m_frame.metadata();
 }
 
 std::error_code
-GStreamerVideoSource::execute(const std::string&) noexcept
+GStreamerVideoSource::nextFrame() noexcept
 {
+	{
+		// Written by the streaming and watcher threads.
+		std::unique_lock<decltype(m_mutex)> lock(m_mutex);
+		if (B4BError::ok() != m_lastError)
+		{
+			return m_lastError;
+		}
+	}
+
+	auto& implementation = *m_implementation;
+	Implementation::QueuedSample queued;
+
+	const auto ready = [&]() {
+		while (implementation.queue.pop(queued))
+		{
+			if (queued.generation == implementation.generation.load())
+			{
+				return true;
+			}
+
+			// A frame of a pipeline swapped out by reload() is skipped.
+			queued = {};
+			implementation.sampleTaken.notifyAll();
+		}
+
+		return m_streamState == EStreamState::endOfStream;
+	};
+
+	if (!implementation.sampleQueued.waitFor(implementation.frameTimeout, ready))
+	{
+		return make_error_code(VideoSourceStatus::timeout());
+	}
+
+	if (!queued.sample)
+	{
+		// Not exactly an error, but not sure what to return here
+		return B4BError::genericError();
+	}
+
+	// The previous sample can be released, the SDK is done with it. The streaming thread is only
+	// woken afterwards, so that the pipeline gets its buffer back before producing the next one.
+	implementation.sample = std::move(queued.sample);
+	implementation.sampleTaken.notifyAll();
+	implementation.timing = queued.timing;
+	implementation.clock = std::move(queued.clock);
+	m_width = queued.width;
+	m_height = queued.height;
+	implementation.view = implementation.sample->view(m_width, m_height, implementation.orientation);
+	implementation.packedFrame = {};
+	implementation.packed = {};
+
+	// Frames are handed out as is unless their rows are padded, or they are converted.
+	const auto& view = implementation.view;
+	const auto converted = convertedFormat(view.format(), implementation.colorSpace);
+	if (implementation.colorSpace != view.format().colorSpace()
+	    && converted.colorSpace() != EColorSpace::unknown)
+	{
+		implementation.conversion = implementation.colorSpace;
+		m_frame = dto::ImageView(converted.metadata(view.width(), view.height()), nullptr);
+	}
+	else
+	{
+		implementation.conversion = EColorSpace::unknown;
+		m_frame = dto::ImageView(view.metadata(), view.imageView().data());
+	}
+
+	m_implementation->statistics.onNextFrame(m_implementation->timing, currentClockTime());
+
 	return B4BError::ok();
 }
 
-int
-GStreamerVideoSource::preroll(void*, GStreamerVideoSource* self)
+dto::ImageView
+GStreamerVideoSource::frame() const noexcept
 {
+	m_implementation->statistics.onFrame(m_implementation->timing, currentClockTime());
+
+	auto& implementation = *m_implementation;
+	if (m_frame.data() || implementation.view.empty())
 	{
-		std::unique_lock<decltype(self->m_mutex)> lock(self->m_mutex);
-		self->m_bufferReady = true;
+		return m_frame;
 	}
 
-	self->m_bufferReadyCondition.notify_all();
+	if (!implementation.packedFrame.data())
+	{
+		try
+		{
+			implementation.packed = FramePool::shared().allocate(implementation.copyMetadata(),
+			                                                     implementation.copySize());
+			implementation.packedFrame =
+			  implementation.copy(implementation.packed.write(), implementation.packed.size());
+		}
+		catch (const std::bad_alloc&)
+		{
+			return {};
+		}
+	}
 
-	return GST_FLOW_OK;
+	return implementation.packedFrame;
 }
 
-int
-GStreamerVideoSource::grabFrame(void* sink, GStreamerVideoSource* self)
+dto::ImageView
+GStreamerVideoSource::frame(std::byte* bytes, std::size_t size) const noexcept
 {
-	const auto predicate = [self]() {
-		return self->bufferReady();
-	};
+	m_implementation->statistics.onFrame(m_implementation->timing, currentClockTime());
+	return m_implementation->copy(bytes, size);
+}
+
+std::error_code
+GStreamerVideoSource::execute(const std::string& action) noexcept
+{
+	if (action == "reload")
+	{
+		return reload();
+	}
+	else if (action == "stats")
+	{
+		try
+		{
+			std::unique_lock<decltype(m_mutex)> lock(m_mutex);
 
+			// Statistics go to the file named by NEURALA_GSTREAMER_STATS_FILE, if any.
+			if (const auto path = getenv("NEURALA_GSTREAMER_STATS_FILE"))
+			{
+				std::ofstream file(path, std::ios::app);
+				m_implementation->writeStatistics(file);
+			}
+			else
+			{
+				m_implementation->writeStatistics(std::clog);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Error while writing GStreamer statistics: " << e.what() << '\n';
+			return B4BError::genericError();
+		}
+	}
+	else if (action == "resetStats")
 	{
-		std::unique_lock<decltype(self->m_mutex)> lock(self->m_mutex);
-		self->m_bufferReadyCondition.wait(lock, predicate);
+		m_implementation->statistics.reset();
 	}
 
+	return B4BError::ok();
+}
+
+std::uint64_t
+GStreamerVideoSource::currentClockTime() const noexcept
+{
+	return clockTime(m_implementation->clock.get());
+}
+
+int
+GStreamerVideoSource::grabFrame(void* sink, Stream* stream)
+{
+	const auto self = stream->owner;
 	const auto appsink = static_cast<GstAppSink*>(sink);
 	const auto sample = gst_app_sink_pull_sample(appsink);
 
@@ -285,31 +1280,71 @@ GStreamerVideoSource::grabFrame(void* sink, GStreamerVideoSource* self)
 		{
 			{
 				std::unique_lock<decltype(self->m_mutex)> lock(self->m_mutex);
-				self->m_streamState = EStreamState::endOfStream;
+				if (stream->state == Stream::EState::active)
+				{
+					self->m_streamState = EStreamState::endOfStream;
+				}
 			}
-			self->m_frameReadyCondition.notify_all();
+			self->m_implementation->sampleQueued.notifyAll();
 			return GST_FLOW_OK;
 		}
 		else
 		{
+			std::unique_lock<decltype(self->m_mutex)> lock(self->m_mutex);
 			self->m_lastError = B4BError::genericError();
 			return GST_FLOW_ERROR;
 		}
 	}
 
-	const auto caps = gst_sample_get_caps(sample);
-	const auto structure = gst_caps_get_structure(caps, 0);
+	auto held = std::make_unique<Sample>(sample);
+	const auto timing = self->m_implementation->sampleTiming(*stream, sample);
 
+	self->m_implementation->statistics.onSample(timing);
+
+	auto& implementation = *self->m_implementation;
+	const auto released = [stream]() {
+		return stream->state == Stream::EState::closing || stream->flushing;
+	};
+
+	stream->delivered = true;
+
+	if (!stream->prerolled)
 	{
 		std::unique_lock<decltype(m_mutex)> lock(self->m_mutex);
+		stream->prerolled = true;
+		implementation.prerollCondition.notify_all();
+	}
+
+	Implementation::QueuedSample queued{std::move(held),
+	                                    timing,
+	                                    stream->width.load(std::memory_order_relaxed),
+	                                    stream->height.load(std::memory_order_relaxed),
+	                                    stream->generation,
+	                                    shareClock(stream->clock)};
+
+	for (;;)
+	{
+		// Wait for the SDK to take the queued sample, and for a stream in standby to be swapped in.
+		implementation.sampleTaken.wait([&]() {
+			return released() || (stream->state == Stream::EState::active && !implementation.queue.full());
+		});
+
+		std::scoped_lock lock(implementation.queueMutex);
 
-		self->m_implementation->sample = std::make_unique<Sample>(sample);
-		self->m_frame = self->m_implementation->sample->imageView(self->m_width, self->m_height);
-		self->m_streamState = EStreamState::frameReady;
-		self->m_bufferReady = false;
+		if (released())
+		{
+			return GST_FLOW_FLUSHING;
+		}
+
+		// The queue is only full if a stream swapped out meanwhile queued a sample, which nextFrame()
+		// skips.
+		if (implementation.queue.push(std::move(queued)))
+		{
+			break;
+		}
 	}
 
-	self->m_frameReadyCondition.notify_all();
+	implementation.sampleQueued.notifyAll();
 
 	return GST_FLOW_OK;
 }
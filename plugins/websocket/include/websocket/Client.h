@@ -24,12 +24,12 @@
 #include <string>
 #include <string_view>
 #include <system_error>
-#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 #include <boost/config.hpp>
 #include <boost/json.hpp>
+#include <neurala/image/FramePool.h>
 #include <neurala/image/dto/ImageMetadata.h>
 #include <neurala/image/views/dto/ImageView.h>
 #include <neurala/plugin/PluginBindings.h>
@@ -71,13 +71,13 @@ public:
 	 */
 	const dto::ImageView frame() const noexcept
 	{
-		return {m_frameCache.metadata, m_frameCache.data.data()};
+		return {m_frameCache.metadata, m_frameCache.frame.data()};
 	}
 
 	/**
 	 * @brief Returns the size of the last retrieved frame.
 	 */
-	const std::size_t frameSize() const noexcept { return m_frameCache.data.size(); }
+	const std::size_t frameSize() const noexcept { return m_frameCache.frame.size(); }
 
 	/**
 	 * @brief Executes an arbitrary action on the video source.
@@ -113,7 +113,8 @@ private:
 	{
 		std::string format;
 		dto::ImageMetadata metadata;
-		std::vector<std::byte> data;
+		// Frame of FramePool::shared(), which outputs keep rather than copy.
+		SharedFrame frame;
 	} m_frameCache;
 };
 
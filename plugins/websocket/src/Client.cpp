@@ -17,8 +17,9 @@
  */
 
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <iterator>
+#include <new>
 #include <tuple>
 #include <utility>
 
@@ -122,10 +123,21 @@ Client::nextFrame() noexcept
 	}
 	if (m_frameCache.format.empty())
 	{
-		m_frameCache.data.resize(buffer.size());
-		std::copy_n(reinterpret_cast<const std::byte*>(buffer.data()),
-		            buffer.size(),
-		            begin(m_frameCache.data));
+		// The previous frame goes back to the pool first, so that its buffer is reused unless an
+		// output still holds it.
+		m_frameCache.frame = {};
+		try
+		{
+			m_frameCache.frame = FramePool::shared().allocate(m_frameCache.metadata, buffer.size());
+		}
+		catch (const std::bad_alloc&)
+		{
+			return std::make_error_code(std::errc::not_enough_memory);
+		}
+		if (m_frameCache.frame)
+		{
+			std::memcpy(m_frameCache.frame.write(), buffer.data(), buffer.size());
+		}
 		return make_error_code(VideoSourceStatus::success());
 	}
 	return make_error_code(VideoSourceStatus::pixelFormatNotSupported());
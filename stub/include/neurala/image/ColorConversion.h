@@ -0,0 +1,66 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_IMAGE_COLOR_CONVERSION_H
+#define NEURALA_IMAGE_COLOR_CONVERSION_H
+
+#include <cstddef>
+
+#include "neurala/image/PixelFormat.h"
+#include "neurala/image/Simd.h"
+#include "neurala/image/views/StridedImageView.h"
+#include "neurala/image/views/dto/ImageView.h"
+
+namespace neurala
+{
+/**
+ * @brief Returns the format of the images converted from @p from to @p colorSpace, which is
+ *        unknown if the conversion is not supported.
+ *
+ * 8-bit images are converted to interleaved RGB, BGR, RGBA or BGRA, keeping their orientation:
+ * - RGB and BGR, from RGB, BGR, RGBA, BGRA and grayscale;
+ * - RGBA and BGRA, from RGBA and BGRA;
+ * - RGB and BGR, from YUV420 (I420), NV12, NV21 and YUV422 (YUY2), using the BT.601 limited range
+ *   matrix, each chroma sample being used for all the pixels it covers;
+ * - RGB and BGR, from the Bayer mosaics, by bilinear interpolation.
+ */
+PixelFormat convertedFormat(const PixelFormat& from, EColorSpace colorSpace) noexcept;
+
+/**
+ * @brief Converts @p source to @p colorSpace, writing the packed result to @p data.
+ *
+ * All instruction sets give the same results.
+ *
+ * @param source     image to convert
+ * @param colorSpace color space of the result
+ * @param data       destination buffer
+ * @param size       size of @p data in bytes
+ * @param simd       instruction set to use, or the fastest slower one if it is not supported
+ *
+ * @return view of the converted image in @p data, which is empty if the conversion is not
+ *         supported or @p size is smaller than requiredBytes() of the result
+ */
+dto::ImageView convertColor(const StridedImageView& source,
+                            EColorSpace colorSpace,
+                            std::byte* data,
+                            std::size_t size,
+                            ESimd simd = bestSimd()) noexcept;
+
+} // namespace neurala
+
+#endif // NEURALA_IMAGE_COLOR_CONVERSION_H
@@ -0,0 +1,254 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_IMAGE_FRAME_POOL_H
+#define NEURALA_IMAGE_FRAME_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "neurala/image/dto/ImageMetadata.h"
+#include "neurala/image/views/dto/ImageView.h"
+
+namespace neurala
+{
+class FramePool;
+
+/**
+ * @brief Reference-counted handle to a frame held in a FramePool.
+ *
+ * Copies of a handle refer to the same frame, which goes back to its pool once the last of them is
+ * gone. Frames are written through write(), which copies a frame referred to by other handles to
+ * one of its own first, so that they never see it change.
+ */
+class SharedFrame
+{
+public:
+	/// Creates a null handle.
+	SharedFrame() noexcept = default;
+
+	SharedFrame(const SharedFrame& other) noexcept;
+
+	SharedFrame(SharedFrame&& other) noexcept : m_block{other.m_block} { other.m_block = nullptr; }
+
+	SharedFrame& operator=(SharedFrame other) noexcept
+	{
+		std::swap(m_block, other.m_block);
+		return *this;
+	}
+
+	~SharedFrame() noexcept;
+
+	explicit operator bool() const noexcept { return m_block; }
+
+	/// Returns the metadata of the frame, empty for a null handle.
+	const dto::ImageMetadata& metadata() const noexcept;
+
+	/// Returns the frame, or null for a null handle.
+	const std::byte* data() const noexcept;
+
+	/// Returns the size of the frame in bytes.
+	std::size_t size() const noexcept;
+
+	/// Returns the size of the buffer holding the frame in bytes, which may be written in full.
+	std::size_t capacity() const noexcept;
+
+	/// Returns a view of the frame, valid as long as the handle refers to it.
+	dto::ImageView view() const noexcept { return {metadata(), data()}; }
+
+	/// Returns the number of handles referring to the frame, 0 for a null handle.
+	std::size_t useCount() const noexcept;
+
+	/**
+	 * @brief Returns the frame for writing, copying it first to a frame of its own if other handles
+	 *        refer to it.
+	 *
+	 * A handle FramePool::find() takes meanwhile is not seen, and sees the frame change: frames are
+	 * looked up from the views they are handed out in, which must only be once they are written.
+	 *
+	 * @throw std::bad_alloc if the frame cannot be copied
+	 */
+	std::byte* write();
+
+	/**
+	 * @brief Describes the frame by @p metadata and @p bytes, as found once it was written, copying
+	 *        it first to a frame of its own if other handles refer to it.
+	 *
+	 * @return false, leaving the frame as it was, if @p bytes is 0 or exceeds capacity()
+	 *
+	 * @throw std::bad_alloc if the frame or @p metadata cannot be copied
+	 */
+	bool describe(const dto::ImageMetadata& metadata, std::size_t bytes);
+
+private:
+	friend class FramePool;
+
+	struct Block;
+
+	explicit SharedFrame(Block* block) noexcept : m_block{block} { }
+
+	Block* m_block = nullptr;
+};
+
+/**
+ * @brief Thread-safe pool of aligned frames, reused once no handle refers to them.
+ *
+ * Video sources allocating their frames from a pool let the outputs of the same plugin keep them,
+ * from the views they are given, rather than copy them.
+ *
+ * Buffers come in size classes, four per power of two, and the buffers of frames gone back to the
+ * pool are kept in lock-free lists, one per class, from which the next frames of the class are
+ * taken: once a stream runs, frames are no longer allocated, and no lock is taken but the one
+ * find() shares. Buffers of 64 KiB or more are aligned on pages, and may be backed by huge pages,
+ * which relieves the TLB of large frames.
+ */
+class FramePool
+{
+public:
+	/// Alignment of the frames, that of a cache line and of the widest vector registers.
+	static constexpr std::size_t kAlignment = 64;
+
+	/// Alignment of the buffers of 64 KiB or more, that of a page.
+	static constexpr std::size_t kPageAlignment = 4096;
+
+	/// Alignment of the buffers of 2 MiB or more when huge pages are asked for.
+	static constexpr std::size_t kHugePageAlignment = 2 * 1024 * 1024;
+
+	/// Settings of a pool.
+	struct Settings
+	{
+		/**
+		 * @brief Whether buffers of 2 MiB or more are rounded to huge pages, and the kernel asked to
+		 *        back them with transparent huge pages (Linux only).
+		 */
+		bool hugePages = false;
+
+		/**
+		 * @brief Whether buffers are locked in memory, so that frames are never paged out (POSIX
+		 *        only; buffers past the limit of locked memory stay unlocked).
+		 */
+		bool lock = false;
+
+		/// Number of buffers kept in each size class; those released past it are freed.
+		std::size_t retained = 16;
+	};
+
+	/// @throw std::bad_alloc if the lists of the pool cannot be allocated
+	FramePool();
+
+	/// @throw std::bad_alloc if the lists of the pool cannot be allocated
+	explicit FramePool(const Settings& settings);
+
+	/// Frees the buffers of the pool, none of whose frames may be referred to anymore.
+	~FramePool() noexcept;
+
+	FramePool(const FramePool&) = delete;
+	FramePool& operator=(const FramePool&) = delete;
+
+	/**
+	 * @brief Returns the pool shared by the video sources and outputs of a plugin.
+	 *
+	 * It is never destroyed, so that frames may be kept by static objects. Huge pages and locked
+	 * buffers are asked for by setting NEURALA_FRAME_POOL_HUGE_PAGES and NEURALA_FRAME_POOL_LOCK to
+	 * 1, and the number of buffers kept in each size class by NEURALA_FRAME_POOL_RETAINED.
+	 */
+	static FramePool& shared() noexcept;
+
+	const Settings& settings() const noexcept { return m_settings; }
+
+	/**
+	 * @brief Allocates a frame described by @p metadata, whose content is undefined.
+	 *
+	 * @return handle to the frame, null if its size cannot be computed from its metadata
+	 *
+	 * @throw std::bad_alloc if the frame cannot be allocated
+	 */
+	SharedFrame allocate(const dto::ImageMetadata& metadata);
+
+	/**
+	 * @brief Allocates a frame of @p bytes bytes described by @p metadata, for frames whose size is
+	 *        not given by their metadata, such as multispectral or encoded ones.
+	 *
+	 * @return handle to the frame, null if @p bytes is 0
+	 *
+	 * @throw std::bad_alloc if the frame cannot be allocated
+	 */
+	SharedFrame allocate(const dto::ImageMetadata& metadata, std::size_t bytes);
+
+	/**
+	 * @brief Returns a handle to the frame of the pool starting at @p data, or a null handle.
+	 *
+	 * The frame must not be written through SharedFrame::write() meanwhile, which only copies the
+	 * frames that handles already refer to.
+	 */
+	SharedFrame find(const void* data) const noexcept;
+
+	/**
+	 * @brief Returns a handle to the frame @p view refers to if it is held in the pool, or to a copy
+	 *        of it otherwise.
+	 *
+	 * @return handle to the frame, null if its size cannot be computed from its metadata
+	 *
+	 * @throw std::bad_alloc if the frame cannot be copied
+	 */
+	SharedFrame share(const dto::ImageView& view);
+
+	/// Returns the size of the buffers holding frames of @p bytes bytes, that of their size class.
+	std::size_t capacity(std::size_t bytes) const noexcept;
+
+	/// Returns the number of buffers of the pool, those of the frames referred to included.
+	std::size_t buffers() const;
+
+	/// Returns the number of buffers allocated so far, those freed since included.
+	std::uint64_t allocations() const noexcept
+	{
+		return m_allocations.load(std::memory_order_relaxed);
+	}
+
+private:
+	friend class SharedFrame;
+
+	class FreeList;
+
+	/// Puts @p block back in its list, or frees it if the list is full.
+	void recycle(SharedFrame::Block& block) noexcept;
+
+	/// Allocates a buffer for size class @p sizeClass, and registers it.
+	SharedFrame::Block* create(std::size_t sizeClass);
+
+	/// Unregisters @p block, and frees it.
+	void destroy(SharedFrame::Block* block) noexcept;
+
+	const Settings m_settings;
+	// Buffers no handle refers to, by size class.
+	std::unique_ptr<FreeList[]> m_free;
+	std::atomic<std::uint64_t> m_allocations{0};
+
+	// Blocks by the address of their buffer, changed only when buffers are allocated or freed.
+	mutable std::shared_mutex m_mutex;
+	std::unordered_map<const void*, SharedFrame::Block*> m_data;
+};
+
+} // namespace neurala
+
+#endif // NEURALA_IMAGE_FRAME_POOL_H
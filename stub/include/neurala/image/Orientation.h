@@ -0,0 +1,78 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_IMAGE_ORIENTATION_H
+#define NEURALA_IMAGE_ORIENTATION_H
+
+#include <cstddef>
+
+#include "neurala/image/PixelFormat.h"
+#include "neurala/image/Simd.h"
+#include "neurala/image/views/StridedImageView.h"
+#include "neurala/image/views/dto/ImageView.h"
+
+namespace neurala
+{
+/**
+ * @brief Returns if the rows of images in @p orientation are columns of the scene, so that their
+ *        width and height are swapped once normalized.
+ */
+constexpr bool
+isTransposed(EOrientation orientation) noexcept
+{
+	return orientation >= EOrientation::leftTop;
+}
+
+/**
+ * @brief Returns the format of the images of @p from normalized to EOrientation::topLeft, which is
+ *        unknown if it is not supported.
+ *
+ * Images whose planes are made of whole pixels are supported, whatever their data type, planar,
+ * interleaved or semiplanar, YUV 4:2:0 included. Bayer mosaics, whose pattern depends on the
+ * orientation, packed YUV 4:2:2 and RGB565 are not.
+ */
+PixelFormat normalizedFormat(const PixelFormat& from) noexcept;
+
+/**
+ * @brief Normalizes @p source to EOrientation::topLeft, writing the packed result to @p data.
+ *
+ * Orientations follow TIFF and EXIF: the first row of the image in memory is the side of the scene
+ * named first, and its first column the side named second. A camera mounted a quarter turn
+ * clockwise, whose frames must be turned clockwise to be upright, gives rightTop images. The
+ * width and height of the result are those of the upright image, swapped for the transposed
+ * orientations.
+ *
+ * Flips are done a row at a time, and transpositions by blocks that stay in the cache.
+ *
+ * @param source image to normalize
+ * @param data   destination buffer
+ * @param size   size of @p data in bytes
+ * @param simd   instruction set to use, or the fastest slower one if it is not supported
+ *
+ * @return view of the normalized image in @p data, which is empty if the orientation or the
+ *         format of @p source is not supported, or @p size is smaller than requiredBytes() of the
+ *         result
+ */
+dto::ImageView normalizeOrientation(const StridedImageView& source,
+                                    std::byte* data,
+                                    std::size_t size,
+                                    ESimd simd = bestSimd()) noexcept;
+
+} // namespace neurala
+
+#endif // NEURALA_IMAGE_ORIENTATION_H
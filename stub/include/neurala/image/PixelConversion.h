@@ -0,0 +1,137 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_IMAGE_PIXEL_CONVERSION_H
+#define NEURALA_IMAGE_PIXEL_CONVERSION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "neurala/image/PixelFormat.h"
+#include "neurala/image/Simd.h"
+#include "neurala/image/views/StridedImageView.h"
+#include "neurala/image/views/dto/ImageView.h"
+
+namespace neurala
+{
+/**
+ * @brief Mapping of samples to 8 bits, such as the 12 or 16-bit samples of machine vision sensors.
+ *
+ * Samples are clamped to [low, high], mapped linearly to [0, 1], raised to the power 1 / gamma and
+ * scaled to [0, 255].
+ */
+struct WindowLevel
+{
+	/// Sample mapped to 0.
+	double low = 0.0;
+	/// Sample mapped to 255, or 0 for the largest sample of the data type: 255 for uint8, 65535 for
+	/// uint16 and 1 for the floating point types.
+	double high = 0.0;
+	double gamma = 1.0;
+
+	/// Returns the mapping of the @p window samples centered on @p level.
+	static constexpr WindowLevel
+	centered(double level, double window, double gamma = 1.0) noexcept
+	{
+		return {level - window / 2, level + window / 2, gamma};
+	}
+
+	/// Returns the mapping of the samples of a sensor of @p bits bits, such as 12.
+	static constexpr WindowLevel fullRange(unsigned bits, double gamma = 1.0) noexcept
+	{
+		return {0.0, static_cast<double>((std::uint64_t{1} << bits) - 1), gamma};
+	}
+};
+
+/**
+ * @brief Returns the format of the images converted from @p from to 8 bits in @p layout, which is
+ *        unknown if the conversion is not supported.
+ *
+ * Images with a plane per channel or a single interleaved plane, and uint8, uint16, binary16,
+ * binary32 or binary64 samples, are converted to planar or interleaved uint8, keeping their color
+ * space, channels and orientation. Subsampled and packed color spaces, such as NV12 or RGB565, are
+ * not supported.
+ */
+PixelFormat convertedFormat(const PixelFormat& from, ELayout layout) noexcept;
+
+/**
+ * @brief Converts images to 8 bits and to a planar or interleaved layout.
+ *
+ * Samples are mapped and laid out in a single pass, a row at a time, so that a frame is read once
+ * from the buffer of the camera and written once to the one of the SDK.
+ *
+ * Samples are mapped with integer arithmetic for uint8 and uint16, and in single precision for the
+ * floating point types. With a gamma other than 1, uint16 and floating point samples are quantized
+ * to 12 bits before the gamma is applied. All instruction sets give the same results.
+ */
+class PixelConverter
+{
+public:
+	/**
+	 * @param layout layout of the converted images, planar or interleaved
+	 * @param window mapping of the samples to 8 bits
+	 * @param simd   instruction set to use, or the fastest slower one if it is not supported
+	 *
+	 * @throw std::invalid_argument if @p layout is neither planar nor interleaved, the window is
+	 *        empty, or the gamma is not positive
+	 */
+	explicit PixelConverter(ELayout layout = ELayout::interleaved,
+	                        const WindowLevel& window = {},
+	                        ESimd simd = bestSimd());
+
+	ELayout layout() const noexcept { return m_layout; }
+
+	const WindowLevel& window() const noexcept { return m_window; }
+
+	ESimd simd() const noexcept { return m_simd; }
+
+	/// Returns the format of the images converted from @p from, unknown if it is not supported.
+	PixelFormat format(const PixelFormat& from) const noexcept
+	{
+		return convertedFormat(from, m_layout);
+	}
+
+	/**
+	 * @brief Converts @p source, writing the packed result to @p data.
+	 *
+	 * @param source image to convert
+	 * @param data   destination buffer
+	 * @param size   size of @p data in bytes
+	 *
+	 * @return view of the converted image in @p data, which is empty if the conversion is not
+	 *         supported, the window is empty for the data type of @p source, or @p size is smaller
+	 *         than requiredBytes() of the result
+	 */
+	dto::ImageView
+	operator()(const StridedImageView& source, std::byte* data, std::size_t size) const noexcept;
+
+private:
+	ELayout m_layout;
+	WindowLevel m_window;
+	ESimd m_simd;
+	// Mapping of the uint8 samples.
+	std::array<std::uint8_t, 256> m_bytes{};
+	// Gamma correction of the samples quantized to 12 bits, empty if the gamma is 1.
+	std::vector<std::uint8_t> m_gamma;
+};
+
+} // namespace neurala
+
+#endif // NEURALA_IMAGE_PIXEL_CONVERSION_H
@@ -0,0 +1,431 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_IMAGE_PIXEL_FORMAT_H
+#define NEURALA_IMAGE_PIXEL_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "neurala/image/dto/ImageMetadata.h"
+
+namespace neurala
+{
+/// Data type of the elements of an image.
+enum class EDatatype : unsigned char
+{
+	unknown,
+	boolean,
+	uint8,
+	uint16,
+	binary16,
+	binary32,
+	binary64
+};
+
+/// Color space of an image.
+enum class EColorSpace : unsigned char
+{
+	unknown,
+	grayscale,
+	RGB,
+	RGBA,
+	BGR,
+	BGRA,
+	RGB565,
+	HSV,
+	bayerRG,
+	bayerGR,
+	bayerBG,
+	bayerGB,
+	YUV420,
+	NV12,
+	NV21,
+	YUV422,
+	/// Any number of spectral bands.
+	multispectral
+};
+
+/// Layout of the channels of an image in memory.
+enum class ELayout : unsigned char
+{
+	unknown,
+	planar,
+	interleaved,
+	semiplanar
+};
+
+/// Position of the first pixel of an image in memory, and direction of its rows.
+enum class EOrientation : unsigned char
+{
+	unknown,
+	topLeft,
+	topRight,
+	bottomRight,
+	bottomLeft,
+	leftTop,
+	rightTop,
+	rightBottom,
+	leftBottom
+};
+
+namespace detail
+{
+struct DatatypeTraits
+{
+	std::string_view name;
+	std::size_t bytes;
+};
+
+struct ColorSpaceTraits
+{
+	std::string_view name;
+	/// Number of channels, 0 if it is not fixed.
+	std::size_t channels;
+	/// Number of planes in planar layout, equal to the number of channels if 0.
+	std::size_t planes;
+	/// Elements per pixel in interleaved layout, equal to the number of channels if 0.
+	std::size_t elements;
+	/// Horizontal and vertical subsampling of the chroma channels.
+	std::size_t subsampleX;
+	std::size_t subsampleY;
+};
+
+// Indexed by the enumerators, with the names used in ImageMetadata.
+inline constexpr DatatypeTraits kDatatypes[] = {{"", 0},
+                                                {"boolean", 1},
+                                                {"uint8", 1},
+                                                {"uint16", 2},
+                                                {"binary16", 2},
+                                                {"binary32", 4},
+                                                {"binary64", 8}};
+
+inline constexpr ColorSpaceTraits kColorSpaces[] = {{"", 0, 0, 0, 1, 1},
+                                                    {"grayscale", 1, 1, 1, 1, 1},
+                                                    {"RGB", 3, 3, 3, 1, 1},
+                                                    {"RGBA", 4, 4, 4, 1, 1},
+                                                    {"BGR", 3, 3, 3, 1, 1},
+                                                    {"BGRA", 4, 4, 4, 1, 1},
+                                                    {"RGB565", 3, 1, 1, 1, 1},
+                                                    {"HSV", 3, 3, 3, 1, 1},
+                                                    {"bayerRG", 1, 1, 1, 1, 1},
+                                                    {"bayerGR", 1, 1, 1, 1, 1},
+                                                    {"bayerBG", 1, 1, 1, 1, 1},
+                                                    {"bayerGB", 1, 1, 1, 1, 1},
+                                                    {"YUV420", 3, 3, 3, 2, 2},
+                                                    {"NV12", 3, 3, 3, 2, 2},
+                                                    {"NV21", 3, 3, 3, 2, 2},
+                                                    {"YUV422", 3, 3, 2, 2, 1},
+                                                    {"multispectral", 0, 0, 0, 1, 1}};
+
+inline constexpr std::string_view kLayouts[] = {"", "planar", "interleaved", "semiplanar"};
+
+inline constexpr std::string_view kOrientations[] = {"",
+                                                     "topLeft",
+                                                     "topRight",
+                                                     "bottomRight",
+                                                     "bottomLeft",
+                                                     "leftTop",
+                                                     "rightTop",
+                                                     "rightBottom",
+                                                     "leftBottom"};
+
+/// Returns the enumerator whose name is @p name in @p names, or the unknown one.
+template<class Enum, class Names, class Name>
+constexpr Enum
+parse(const Names& names, std::string_view name, Name nameOf) noexcept
+{
+	for (std::size_t i = 1; i < std::size(names); ++i)
+	{
+		if (nameOf(names[i]) == name)
+		{
+			return static_cast<Enum>(i);
+		}
+	}
+	return Enum::unknown;
+}
+} // namespace detail
+
+/// Returns the name of @p datatype in ImageMetadata, empty if unknown.
+constexpr std::string_view
+toString(EDatatype datatype) noexcept
+{
+	return detail::kDatatypes[static_cast<std::size_t>(datatype)].name;
+}
+
+/// Returns the name of @p colorSpace in ImageMetadata, empty if unknown.
+constexpr std::string_view
+toString(EColorSpace colorSpace) noexcept
+{
+	return detail::kColorSpaces[static_cast<std::size_t>(colorSpace)].name;
+}
+
+/// Returns the name of @p layout in ImageMetadata, empty if unknown.
+constexpr std::string_view
+toString(ELayout layout) noexcept
+{
+	return detail::kLayouts[static_cast<std::size_t>(layout)];
+}
+
+/// Returns the name of @p orientation in ImageMetadata, empty if unknown.
+constexpr std::string_view
+toString(EOrientation orientation) noexcept
+{
+	return detail::kOrientations[static_cast<std::size_t>(orientation)];
+}
+
+/// Returns the data type named @p name in ImageMetadata, or EDatatype::unknown.
+constexpr EDatatype
+parseDatatype(std::string_view name) noexcept
+{
+	return detail::parse<EDatatype>(detail::kDatatypes, name, [](const auto& t) { return t.name; });
+}
+
+/// Returns the color space named @p name in ImageMetadata, or EColorSpace::unknown.
+constexpr EColorSpace
+parseColorSpace(std::string_view name) noexcept
+{
+	return detail::parse<EColorSpace>(
+	  detail::kColorSpaces, name, [](const auto& t) { return t.name; });
+}
+
+/// Returns the layout named @p name in ImageMetadata, or ELayout::unknown.
+constexpr ELayout
+parseLayout(std::string_view name) noexcept
+{
+	return detail::parse<ELayout>(detail::kLayouts, name, [](std::string_view n) { return n; });
+}
+
+/// Returns the orientation named @p name in ImageMetadata, or EOrientation::unknown.
+constexpr EOrientation
+parseOrientation(std::string_view name) noexcept
+{
+	return detail::parse<EOrientation>(
+	  detail::kOrientations, name, [](std::string_view n) { return n; });
+}
+
+/// Returns the size of an element of @p datatype in bytes, 0 if unknown.
+constexpr std::size_t
+bytesPerElement(EDatatype datatype) noexcept
+{
+	return detail::kDatatypes[static_cast<std::size_t>(datatype)].bytes;
+}
+
+/// Size of a plane of an image.
+struct PlaneSize
+{
+	/// Bytes of pixel data in a row.
+	std::size_t rowBytes{};
+	std::size_t rows{};
+
+	constexpr std::size_t bytes() const noexcept { return rowBytes * rows; }
+};
+
+/**
+ * @brief Compact description of the pixels of an image: the datatype, color space, layout and
+ *        orientation of dto::ImageMetadata, without its strings.
+ *
+ * It converts to and from dto::ImageMetadata, and is cheap to copy and compare, so that sources
+ * and outputs can check and build the metadata of each frame without comparing or allocating
+ * strings.
+ */
+class PixelFormat
+{
+public:
+	constexpr PixelFormat() noexcept = default;
+
+	/**
+	 * @param channels number of channels, only used if it is not fixed by @p colorSpace, as for
+	 *                 multispectral images
+	 */
+	constexpr PixelFormat(EDatatype datatype,
+	                      EColorSpace colorSpace,
+	                      ELayout layout,
+	                      EOrientation orientation = EOrientation::topLeft,
+	                      std::size_t channels = 0) noexcept
+	 : m_datatype{datatype},
+	   m_colorSpace{colorSpace},
+	   m_layout{layout},
+	   m_orientation{orientation},
+	   m_channels{static_cast<std::uint16_t>(traits().channels ? traits().channels : channels)}
+	{ }
+
+	/**
+	 * @brief Returns the format of @p metadata, whose members are unknown if they are not valid
+	 *        names.
+	 *
+	 * @param channels number of channels, only used if it is not fixed by the color space
+	 */
+	static PixelFormat fromMetadata(const dto::ImageMetadata& metadata,
+	                                std::size_t channels = 0) noexcept
+	{
+		return {parseDatatype(metadata.datatype()),
+		        parseColorSpace(metadata.colorSpace()),
+		        parseLayout(metadata.layout()),
+		        parseOrientation(metadata.orientation()),
+		        channels};
+	}
+
+	/**
+	 * @brief Returns the metadata of an image of @p width by @p height pixels in this format.
+	 *
+	 * The names are short enough for the small string optimization, so nothing is allocated.
+	 */
+	dto::ImageMetadata metadata(std::size_t width, std::size_t height) const
+	{
+		return {std::string(toString(m_datatype)),
+		        width,
+		        height,
+		        std::string(toString(m_colorSpace)),
+		        std::string(toString(m_layout)),
+		        std::string(toString(m_orientation))};
+	}
+
+	constexpr EDatatype datatype() const noexcept { return m_datatype; }
+
+	constexpr EColorSpace colorSpace() const noexcept { return m_colorSpace; }
+
+	constexpr ELayout layout() const noexcept { return m_layout; }
+
+	constexpr EOrientation orientation() const noexcept { return m_orientation; }
+
+	/// Returns if all members of the format are known.
+	constexpr bool known() const noexcept
+	{
+		return m_datatype != EDatatype::unknown && m_colorSpace != EColorSpace::unknown
+		       && m_layout != ELayout::unknown && m_orientation != EOrientation::unknown
+		       && m_channels > 0;
+	}
+
+	/// Returns the size of an element in bytes, 0 if unknown.
+	constexpr std::size_t bytesPerElement() const noexcept
+	{
+		return neurala::bytesPerElement(m_datatype);
+	}
+
+	/// Returns the number of channels, 0 if unknown.
+	constexpr std::size_t channels() const noexcept { return m_channels; }
+
+	/// Returns the number of planes, 0 if unknown.
+	constexpr std::size_t planes() const noexcept
+	{
+		switch (m_layout)
+		{
+		case ELayout::interleaved:
+			return 1;
+		case ELayout::semiplanar:
+			return 2;
+		case ELayout::planar:
+			return traits().planes ? traits().planes : m_channels;
+		default:
+			return 0;
+		}
+	}
+
+	/**
+	 * @brief Returns the size of the plane @p plane of an image of @p width by @p height pixels,
+	 *        empty if unknown.
+	 *
+	 * Subsampled chroma planes are rounded up to whole samples, and a row of a packed 4:2:2 image to
+	 * a whole pair of pixels.
+	 */
+	constexpr PlaneSize
+	planeSize(std::size_t plane, std::size_t width, std::size_t height) const noexcept
+	{
+		const auto& t = traits();
+		const auto bytes = bytesPerElement();
+		const auto chromaWidth = (width + t.subsampleX - 1) / t.subsampleX;
+		const auto chromaHeight = (height + t.subsampleY - 1) / t.subsampleY;
+		const auto subsampled = t.subsampleX > 1 || t.subsampleY > 1;
+
+		if (plane >= planes() || bytes == 0 || m_channels == 0)
+		{
+			return {};
+		}
+
+		switch (m_layout)
+		{
+		case ELayout::interleaved:
+			if (!subsampled)
+			{
+				return {width * (t.elements ? t.elements : m_channels) * bytes, height};
+			}
+			// Only 4:2:2 is packed, as two luma and two chroma samples per pair of pixels.
+			return t.subsampleY == 1 ? PlaneSize{chromaWidth * 4 * bytes, height} : PlaneSize{};
+		case ELayout::planar:
+			return plane == 0 || !subsampled ? PlaneSize{width * bytes, height}
+			                                 : PlaneSize{chromaWidth * bytes, chromaHeight};
+		case ELayout::semiplanar:
+			return plane == 0 ? PlaneSize{width * bytes, height}
+			                  : PlaneSize{chromaWidth * (m_channels - 1) * bytes, chromaHeight};
+		default:
+			return {};
+		}
+	}
+
+	/**
+	 * @brief Returns the size of a tightly packed image of @p width by @p height pixels in bytes,
+	 *        with its planes one after the other, 0 if unknown.
+	 */
+	constexpr std::size_t frameBytes(std::size_t width, std::size_t height) const noexcept
+	{
+		std::size_t bytes = 0;
+		for (std::size_t plane = 0; plane < planes(); ++plane)
+		{
+			bytes += planeSize(plane, width, height).bytes();
+		}
+		return bytes;
+	}
+
+	friend constexpr bool operator==(const PixelFormat& x, const PixelFormat& y) noexcept
+	{
+		return x.m_datatype == y.m_datatype && x.m_colorSpace == y.m_colorSpace
+		       && x.m_layout == y.m_layout && x.m_orientation == y.m_orientation
+		       && x.m_channels == y.m_channels;
+	}
+
+	friend constexpr bool operator!=(const PixelFormat& x, const PixelFormat& y) noexcept
+	{
+		return !(x == y);
+	}
+
+private:
+	constexpr const detail::ColorSpaceTraits& traits() const noexcept
+	{
+		return detail::kColorSpaces[static_cast<std::size_t>(m_colorSpace)];
+	}
+
+	EDatatype m_datatype{};
+	EColorSpace m_colorSpace{};
+	ELayout m_layout{};
+	EOrientation m_orientation{};
+	std::uint16_t m_channels{};
+};
+
+/// Interleaved 8-bit RGB, the usual format of the frames given to the SDK.
+inline constexpr PixelFormat kRGB8{EDatatype::uint8, EColorSpace::RGB, ELayout::interleaved};
+
+/// Interleaved 8-bit BGR.
+inline constexpr PixelFormat kBGR8{EDatatype::uint8, EColorSpace::BGR, ELayout::interleaved};
+
+} // namespace neurala
+
+#endif // NEURALA_IMAGE_PIXEL_FORMAT_H
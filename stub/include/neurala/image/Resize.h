@@ -0,0 +1,148 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_IMAGE_RESIZE_H
+#define NEURALA_IMAGE_RESIZE_H
+
+#include <cstddef>
+
+#include "neurala/image/PixelFormat.h"
+#include "neurala/image/Simd.h"
+#include "neurala/image/dto/ImageMetadata.h"
+#include "neurala/image/views/StridedImageView.h"
+#include "neurala/image/views/dto/ImageView.h"
+#include "neurala/utils/BlockPool.h"
+
+namespace neurala
+{
+/// Rectangle of an image in pixels, as stored in memory.
+struct Region
+{
+	std::size_t x = 0;
+	std::size_t y = 0;
+	/// Width of the region, or 0 up to the right edge of the image.
+	std::size_t width = 0;
+	/// Height of the region, or 0 up to the bottom edge of the image.
+	std::size_t height = 0;
+};
+
+/// Interpolation of the pixels of resized images.
+enum class EInterpolation : unsigned char
+{
+	/// Average of the pixels each pixel covers, which does not alias when images are reduced.
+	area,
+	/// Bilinear interpolation of the 4 nearest pixels, suited to enlargements and reductions by less
+	/// than 2.
+	bilinear
+};
+
+/**
+ * @brief Returns the format of the images resized from @p from, which is unknown if resizing is not
+ *        supported.
+ *
+ * 8-bit images are supported, interleaved, planar or semiplanar, with YUV 4:2:0 chroma planes
+ * resized along with their luma plane. Bayer mosaics, packed YUV 4:2:2 and RGB565 are not.
+ */
+PixelFormat resizedFormat(const PixelFormat& from) noexcept;
+
+/**
+ * @brief Crops images to a region and resizes them.
+ *
+ * Images are resized in two separable passes, a row of the result at a time, with integer
+ * arithmetic. The area interpolation sums the rows each row covers with vector instructions, then
+ * its columns. The bilinear one interpolates the 2 rows each row needs, then blends them with
+ * vector instructions. Rows are processed in blocks spread over the workers of the shared
+ * Executor. All instruction sets give the same results.
+ */
+class Resizer
+{
+public:
+	/**
+	 * @param region        region of the images to keep, within their stored orientation
+	 * @param width         width of the resized images, or 0 for the one of the region
+	 * @param height        height of the resized images, or 0 for the one of the region
+	 * @param interpolation interpolation of the resized pixels
+	 * @param threads       number of threads resizing an image, the number of workers of the
+	 *                      shared executor if 0
+	 * @param simd          instruction set to use, or the fastest slower one if it is not supported
+	 */
+	explicit Resizer(const Region& region = {},
+	                 std::size_t width = 0,
+	                 std::size_t height = 0,
+	                 EInterpolation interpolation = EInterpolation::area,
+	                 std::size_t threads = 0,
+	                 ESimd simd = bestSimd());
+
+	const Region& region() const noexcept { return m_region; }
+
+	/// Returns the width of the resized images, 0 for the one of the region.
+	std::size_t width() const noexcept { return m_width; }
+
+	/// Returns the height of the resized images, 0 for the one of the region.
+	std::size_t height() const noexcept { return m_height; }
+
+	EInterpolation interpolation() const noexcept { return m_interpolation; }
+
+	std::size_t threads() const noexcept { return m_pool.threads(); }
+
+	ESimd simd() const noexcept { return m_simd; }
+
+	/**
+	 * @brief Returns the region kept from images of @p width by @p height pixels, clipped to them,
+	 *        which is empty if it lies outside.
+	 */
+	Region region(std::size_t width, std::size_t height) const noexcept;
+
+	/**
+	 * @brief Returns the metadata of the images resized from images described by @p from, which is
+	 *        empty if they cannot be resized.
+	 *
+	 * Images in YUV 4:2:0 formats can only be resized when the region and the result have even
+	 * sizes and the region starts on even coordinates, which keeps the chroma samples aligned.
+	 *
+	 * @param channels number of channels, only used if it is not fixed by the color space
+	 */
+	dto::ImageMetadata metadata(const dto::ImageMetadata& from, std::size_t channels = 0) const;
+
+	/**
+	 * @brief Crops and resizes @p source, writing the packed result to @p data.
+	 *
+	 * Images must not be resized concurrently by the same object.
+	 *
+	 * @param source image to resize
+	 * @param data   destination buffer
+	 * @param size   size of @p data in bytes
+	 *
+	 * @return view of the resized image in @p data, which is empty if @p source cannot be resized
+	 *         or @p size is smaller than requiredBytes() of the result
+	 */
+	dto::ImageView
+	operator()(const StridedImageView& source, std::byte* data, std::size_t size) noexcept;
+
+private:
+	Region m_region;
+	std::size_t m_width;
+	std::size_t m_height;
+	EInterpolation m_interpolation;
+	ESimd m_simd;
+	BlockPool m_pool;
+};
+
+} // namespace neurala
+
+#endif // NEURALA_IMAGE_RESIZE_H
@@ -0,0 +1,52 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_IMAGE_SIMD_H
+#define NEURALA_IMAGE_SIMD_H
+
+#include <string_view>
+
+namespace neurala
+{
+/// Instruction set used by the image processing kernels.
+enum class ESimd : unsigned char
+{
+	scalar,
+	sse41,
+	/// AVX2 with the F16C half precision conversions.
+	avx2,
+	neon
+};
+
+/// Returns the fastest instruction set supported by the processor.
+ESimd bestSimd() noexcept;
+
+/// Returns if the kernels for @p simd are built and supported by the processor.
+bool isSupported(ESimd simd) noexcept;
+
+/**
+ * @brief Returns the instruction set used in place of @p simd, which is @p simd itself if it is
+ *        supported, and the fastest supported one that is slower otherwise.
+ */
+ESimd supportedSimd(ESimd simd) noexcept;
+
+std::string_view toString(ESimd simd) noexcept;
+
+} // namespace neurala
+
+#endif // NEURALA_IMAGE_SIMD_H
@@ -0,0 +1,280 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_IMAGE_VIEWS_STRIDED_IMAGE_VIEW_H
+#define NEURALA_IMAGE_VIEWS_STRIDED_IMAGE_VIEW_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "neurala/image/PixelFormat.h"
+#include "neurala/image/dto/ImageMetadata.h"
+#include "neurala/image/views/dto/ImageView.h"
+
+namespace neurala
+{
+/// Plane of an image, whose rows may be padded.
+struct ImagePlane
+{
+	const std::byte* data{};
+	/// Distance between the first bytes of two consecutive rows.
+	std::size_t pitch{};
+	/// Bytes of pixel data in a row, at most the pitch.
+	std::size_t rowBytes{};
+	std::size_t rows{};
+
+	/// Returns the number of bytes spanned by the plane, without the padding of its last row.
+	constexpr std::size_t size() const noexcept { return rows ? pitch * (rows - 1) + rowBytes : 0; }
+
+	/// Returns if the rows are not padded.
+	constexpr bool packed() const noexcept { return pitch == rowBytes; }
+
+	const std::byte* row(std::size_t y) const noexcept { return data + y * pitch; }
+};
+
+/**
+ * @brief Returns the size of a tightly packed image of @p width by @p height pixels in @p format,
+ *        which is the capacity needed to copy it, 0 if the format is unknown.
+ */
+constexpr std::size_t
+requiredBytes(const PixelFormat& format, std::size_t width, std::size_t height) noexcept
+{
+	return format.frameBytes(width, height);
+}
+
+/**
+ * @brief Returns the size of a tightly packed image described by @p metadata, 0 if its format is
+ *        unknown.
+ *
+ * @param channels number of channels, only used if it is not fixed by the color space
+ */
+inline std::size_t
+requiredBytes(const dto::ImageMetadata& metadata, std::size_t channels = 0) noexcept
+{
+	return requiredBytes(
+	  PixelFormat::fromMetadata(metadata, channels), metadata.width(), metadata.height());
+}
+
+/**
+ * @brief View over an image made of planes whose rows may be padded, such as the buffers of
+ *        cameras and decoders.
+ *
+ * It lets a source hand out such buffers as they are, and only pack them in the layout of
+ * dto::ImageView, which has neither row pitch nor planes, when a copy is made anyway.
+ *
+ * Up to kMaxPlanes planes are described independently. Planar images with more planes, such as
+ * multispectral ones, have planes of the same size at a fixed distance from each other.
+ *
+ * @warning It is the user's responsibility that the data given to the view remains valid for the
+ *          lifetime of the view.
+ */
+class StridedImageView
+{
+public:
+	static constexpr std::size_t kMaxPlanes = 4;
+
+	StridedImageView() = default;
+
+	/**
+	 * @brief Constructs a view over the planes of an image, one after the other at @p data.
+	 *
+	 * @param metadata image metadata
+	 * @param data     image data
+	 * @param pitch    distance between two rows of each plane in bytes, or 0 if they are not padded
+	 * @param channels number of channels, only used if it is not fixed by the color space
+	 */
+	StridedImageView(const dto::ImageMetadata& metadata,
+	                 const void* data,
+	                 std::size_t pitch = 0,
+	                 std::size_t channels = 0) noexcept
+	 : m_metadata{metadata}, m_format{PixelFormat::fromMetadata(metadata, channels)}
+	{
+		m_planeCount = m_format.planes();
+		m_storedPlanes = std::min(m_planeCount, kMaxPlanes);
+		auto next = static_cast<const std::byte*>(data);
+
+		for (std::size_t i = 0; i < m_planeCount; ++i)
+		{
+			const auto size = m_format.planeSize(i, metadata.width(), metadata.height());
+			const ImagePlane plane{next, pitch ? pitch : size.rowBytes, size.rowBytes, size.rows};
+
+			if (i < kMaxPlanes)
+			{
+				m_planes[i] = plane;
+			}
+
+			m_planeStep = plane.pitch * plane.rows;
+			next += m_planeStep;
+		}
+	}
+
+	/**
+	 * @brief Constructs a view over the planes @p planes of an image.
+	 *
+	 * Planes after the last one given, up to the number of planes of the format, follow it at the
+	 * distance between the last two, or right after it if only one is given.
+	 *
+	 * @param metadata image metadata
+	 * @param planes   planes of the image
+	 * @param count    number of planes given, at most kMaxPlanes
+	 * @param channels number of channels, only used if it is not fixed by the color space
+	 */
+	StridedImageView(const dto::ImageMetadata& metadata,
+	                 const ImagePlane* planes,
+	                 std::size_t count,
+	                 std::size_t channels = 0) noexcept
+	 : m_metadata{metadata}, m_format{PixelFormat::fromMetadata(metadata, channels)}
+	{
+		m_storedPlanes = std::min(count, kMaxPlanes);
+		std::copy_n(planes, m_storedPlanes, m_planes.begin());
+
+		m_planeCount = m_storedPlanes ? std::max(m_storedPlanes, m_format.planes()) : 0;
+		if (m_storedPlanes == 0)
+		{
+			return;
+		}
+
+		const auto& last = m_planes[m_storedPlanes - 1];
+		m_planeStep = m_storedPlanes > 1
+		                ? static_cast<std::size_t>(last.data - m_planes[m_storedPlanes - 2].data)
+		                : last.pitch * last.rows;
+	}
+
+	/// Constructs a view over the packed image of @p view.
+	explicit StridedImageView(const dto::ImageView& view, std::size_t channels = 0) noexcept
+	 : StridedImageView(view.metadata(), view.data(), 0, channels)
+	{ }
+
+	const dto::ImageMetadata& metadata() const noexcept { return m_metadata; }
+
+	const PixelFormat& format() const noexcept { return m_format; }
+
+	std::size_t width() const noexcept { return m_metadata.width(); }
+
+	std::size_t height() const noexcept { return m_metadata.height(); }
+
+	/// Returns if the view has no pixels.
+	bool empty() const noexcept { return m_metadata.empty() || m_planeCount == 0; }
+
+	std::size_t planes() const noexcept { return m_planeCount; }
+
+	/// Returns the plane @p i, which is empty if the image has no such plane.
+	ImagePlane plane(std::size_t i) const noexcept
+	{
+		if (i < m_storedPlanes)
+		{
+			return m_planes[i];
+		}
+
+		// Planes past the stored ones follow the last of them, which images with planes have.
+		if (i >= m_planeCount || m_storedPlanes == 0)
+		{
+			return {};
+		}
+
+		auto plane = m_planes[m_storedPlanes - 1];
+		plane.data += (i - (m_storedPlanes - 1)) * m_planeStep;
+		return plane;
+	}
+
+	/// Returns the size of the image once packed by copyTo(), 0 if its format is unknown.
+	std::size_t requiredBytes() const noexcept
+	{
+		std::size_t bytes = 0;
+		for (std::size_t i = 0; i < m_planeCount; ++i)
+		{
+			const auto p = plane(i);
+			bytes += p.rowBytes * p.rows;
+		}
+		return bytes;
+	}
+
+	/// Returns if the image is laid out as in dto::ImageView, with unpadded planes one after another.
+	bool packed() const noexcept
+	{
+		for (std::size_t i = 0; i < m_planeCount; ++i)
+		{
+			const auto p = plane(i);
+			if (!p.packed() || (i > 0 && plane(i - 1).data + plane(i - 1).size() != p.data))
+			{
+				return false;
+			}
+		}
+		return m_planeCount > 0;
+	}
+
+	/// Returns the image as a dto::ImageView if it is packed(), an empty view otherwise.
+	dto::ImageView imageView() const noexcept
+	{
+		return packed() ? dto::ImageView(m_metadata, m_planes[0].data) : dto::ImageView();
+	}
+
+	/**
+	 * @brief Copies the image, packed, to @p data.
+	 *
+	 * @param data destination of the copy
+	 * @param size capacity of @p data in bytes
+	 *
+	 * @return a view of the copy, or an empty view if @p size is less than requiredBytes() or the
+	 *         format is unknown
+	 */
+	dto::ImageView copyTo(std::byte* data, std::size_t size) const noexcept
+	{
+		const auto bytes = requiredBytes();
+		if (bytes == 0 || size < bytes)
+		{
+			return {};
+		}
+
+		auto target = data;
+		for (std::size_t i = 0; i < m_planeCount; ++i)
+		{
+			const auto p = plane(i);
+
+			if (p.packed())
+			{
+				std::memcpy(target, p.data, p.rowBytes * p.rows);
+				target += p.rowBytes * p.rows;
+				continue;
+			}
+
+			for (std::size_t y = 0; y < p.rows; ++y)
+			{
+				std::memcpy(target, p.row(y), p.rowBytes);
+				target += p.rowBytes;
+			}
+		}
+
+		return dto::ImageView(m_metadata, data);
+	}
+
+private:
+	dto::ImageMetadata m_metadata;
+	PixelFormat m_format;
+	std::array<ImagePlane, kMaxPlanes> m_planes{};
+	std::size_t m_planeCount{};
+	std::size_t m_storedPlanes{};
+	// Distance between the planes after the last one stored.
+	std::size_t m_planeStep{};
+};
+
+} // namespace neurala
+
+#endif // NEURALA_IMAGE_VIEWS_STRIDED_IMAGE_VIEW_H
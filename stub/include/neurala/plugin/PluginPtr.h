@@ -0,0 +1,61 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_PLUGIN_PLUGIN_PTR_H
+#define NEURALA_PLUGIN_PLUGIN_PTR_H
+
+#include <memory>
+
+#include "neurala/plugin/PluginArguments.h"
+#include "neurala/plugin/PluginErrorCallback.h"
+
+namespace neurala
+{
+/**
+ * @brief Owning pointer to an object of a plugin type @p T, freed by the function it was given:
+ *        T::destroy() for those made by T::create(), delete for the others.
+ */
+template<class T>
+using PluginPtr = std::unique_ptr<T, void (*)(T*)>;
+
+/// Returns an owning pointer to @p object, freed with delete.
+template<class T>
+PluginPtr<T>
+makePluginPtr(std::unique_ptr<T> object) noexcept
+{
+	return PluginPtr<T>(object.release(), [](T* p) { delete p; });
+}
+
+/**
+ * @brief Creates an object of plugin type @p T with T::create(), as the plugin manager does.
+ *
+ * @tparam Base interface the object is created and destroyed as, such as VideoSource
+ *
+ * @return owning pointer freeing the object with T::destroy(), null if it could not be created
+ */
+template<class T, class Base>
+PluginPtr<T>
+createPluginPtr(PluginArguments& arguments, PluginErrorCallback& error)
+{
+	return PluginPtr<T>(static_cast<T*>(static_cast<Base*>(T::create(arguments, error))),
+	                    [](T* p) { T::destroy(static_cast<Base*>(p)); });
+}
+
+} // namespace neurala
+
+#endif // NEURALA_PLUGIN_PLUGIN_PTR_H
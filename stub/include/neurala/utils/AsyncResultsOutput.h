@@ -0,0 +1,302 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_UTILS_ASYNC_RESULTS_OUTPUT_H
+#define NEURALA_UTILS_ASYNC_RESULTS_OUTPUT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "neurala/image/FramePool.h"
+#include "neurala/image/views/dto/ImageView.h"
+#include "neurala/plugin/PluginArguments.h"
+#include "neurala/plugin/PluginErrorCallback.h"
+#include "neurala/plugin/PluginPtr.h"
+#include "neurala/utils/ResultsOutput.h"
+
+namespace neurala
+{
+/**
+ * @brief What is done with a result when the queue of a ResultsOutputWorker is full.
+ */
+enum class EOverflowPolicy
+{
+	/// The result is dropped.
+	drop,
+	/// The caller waits for the output to make room for the result.
+	block,
+	/// The result replaces the last one queued, which is dropped, unless that one is the start or
+	/// the stop of a job, in which case the result is dropped.
+	coalesce
+};
+
+/**
+ * @brief Result copied once for several ResultsOutputWorker, each of which releases it once its
+ *        output is done with it, or once it drops it.
+ */
+class SharedResult
+{
+public:
+	/// Claims the result if it is not held anymore, to be released @p references times.
+	bool claim(std::size_t references) noexcept
+	{
+		std::size_t expected = 0;
+		return m_references.compare_exchange_strong(expected, references,
+		                                            std::memory_order_acquire,
+		                                            std::memory_order_relaxed);
+	}
+
+	/// Copies a result, and shares its frame with FramePool::share() if @p frames.
+	void assign(const std::string& metadata, const dto::ImageView* image, bool frames);
+
+	/// Releases the result, and its frame once it is released by everyone.
+	void release() noexcept;
+
+	const std::string& metadata() const noexcept { return m_metadata; }
+
+	/// Returns the frame of the result, or null if it has none.
+	const dto::ImageView* image() const noexcept { return m_frame ? &m_view : nullptr; }
+
+private:
+	std::atomic<std::size_t> m_references{0};
+	std::string m_metadata;
+	SharedFrame m_frame;
+	dto::ImageView m_view;
+};
+
+/**
+ * @brief Runs a results output on a thread of its own, fed by a bounded queue, so that slow outputs
+ *        do not hold up the pipeline thread of the SDK.
+ *
+ * Results are copied into the slots of a lock-free queue that several threads may feed. Their
+ * frames are shared with FramePool::share(): frames of the pool, such as those of a
+ * PrefetchingVideoSource of the same plugin, are kept rather than copied, and other ones are copied
+ * once to the pool. Frames whose size cannot be computed from their metadata, such as multispectral
+ * ones, are handed out as null images.
+ * The start and the stop of jobs are never dropped: they wait for room in the queue, and reach the
+ * output in order with the results.
+ */
+class ResultsOutputWorker
+{
+public:
+	/**
+	 * @brief Starts the thread running @p output, which must outlive the object.
+	 *
+	 * @param capacity number of results queued, at least 2
+	 * @param policy   what is done with a result when the queue is full
+	 * @param frames   whether frames are handed out to the output, or null images
+	 */
+	ResultsOutputWorker(ResultsOutput& output,
+	                    std::size_t capacity,
+	                    EOverflowPolicy policy,
+	                    bool frames = true);
+
+	/// Stops the thread, once the output has been given everything queued.
+	~ResultsOutputWorker() noexcept;
+
+	ResultsOutputWorker(const ResultsOutputWorker&) = delete;
+	ResultsOutputWorker& operator=(const ResultsOutputWorker&) = delete;
+
+	/// Queues the start of job @p id.
+	void onStart(std::string_view id) noexcept;
+
+	/// Queues the stop of job @p id.
+	void onStop(std::string_view id, ResultsOutputStatus status) noexcept;
+
+	/// Queues a result, or drops it according to the policy if the queue is full.
+	void operator()(const std::string& metadata, const dto::ImageView* image) noexcept;
+
+	/// Queues a shared result, or drops it according to the policy if the queue is full.
+	void operator()(SharedResult& result) noexcept;
+
+	/// Counts a result dropped before it could be queued, such as one that could not be copied.
+	void countDropped() noexcept { m_dropped.fetch_add(1, std::memory_order_relaxed); }
+
+	std::size_t capacity() const noexcept { return m_capacity; }
+
+	EOverflowPolicy policy() const noexcept { return m_policy; }
+
+	/// Returns the number of results dropped so far, coalesced ones excluded.
+	std::uint64_t dropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+	/// Returns the number of results replaced by the next one so far.
+	std::uint64_t coalesced() const noexcept { return m_coalesced.load(std::memory_order_relaxed); }
+
+private:
+	enum class EKind
+	{
+		// A slot whose result could not be copied.
+		none,
+		start,
+		result,
+		shared,
+		stop,
+		quit
+	};
+
+	struct Slot
+	{
+		// Position of the result the slot expects next, plus one once it holds it.
+		std::atomic<std::size_t> sequence{0};
+		EKind kind = EKind::none;
+		std::string text;
+		ResultsOutputStatus status = ResultsOutputStatus::stopped();
+		SharedFrame frame;
+		SharedResult* shared = nullptr;
+	};
+
+	enum class ECoalesced
+	{
+		replaced,
+		dropped,
+		// The last entry was handed out or was still being written.
+		retry
+	};
+
+	/**
+	 * @brief Queues an entry of kind @p kind written by @p write, or drops it according to
+	 *        @p policy.
+	 *
+	 * @return whether the entry was queued, or replaced the last one
+	 */
+	template<class Write>
+	bool push(EKind kind, EOverflowPolicy policy, const Write& write) noexcept;
+
+	/// Replaces the last entry queued, before @p position, if it is a result.
+	template<class Write>
+	ECoalesced coalesce(std::size_t position, EKind kind, const Write& write) noexcept;
+
+	/// Writes an entry of kind @p kind to @p slot, dropping it if it cannot be copied.
+	template<class Write>
+	void fill(Slot& slot, EKind kind, const Write& write) noexcept;
+
+	/// Copies a result to @p slot.
+	void copy(Slot& slot, const std::string& metadata, const dto::ImageView* image);
+
+	void run() noexcept;
+
+	ResultsOutput& m_output;
+	const std::size_t m_capacity;
+	const EOverflowPolicy m_policy;
+	const bool m_frames;
+	std::unique_ptr<Slot[]> m_slots;
+
+	// Position of the next entry, shared by the threads queuing results.
+	alignas(64) std::atomic<std::size_t> m_enqueuePosition{0};
+	alignas(64) std::atomic<std::uint64_t> m_dropped{0};
+	std::atomic<std::uint64_t> m_coalesced{0};
+
+	std::thread m_thread;
+};
+
+/**
+ * @brief Results output running a plugin output of type @p T on a thread of its own, with a
+ *        ResultsOutputWorker.
+ *
+ * The plugin output needs no change: registering AsyncResultsOutput<Output> rather than Output with
+ * the plugin manager creates it with Output::create(), and wraps it.
+ *
+ * @tparam T        type of the wrapped results output
+ * @tparam policy   what is done with a result when the queue is full
+ * @tparam capacity number of results queued
+ * @tparam frames   whether frames are handed out to the wrapped output, or null images
+ */
+template<class T,
+         EOverflowPolicy policy = EOverflowPolicy::drop,
+         std::size_t capacity = 8,
+         bool frames = true>
+class AsyncResultsOutput : public ResultsOutput
+{
+	static_assert(std::is_base_of_v<ResultsOutput, T>, "Only results outputs can be wrapped");
+	static_assert(capacity >= 2, "Results can only be queued with a capacity of at least 2");
+
+public:
+	/// Wraps @p output, which is given the results from now on.
+	explicit AsyncResultsOutput(PluginPtr<T> output)
+	 : m_output{std::move(output)}, m_worker{*m_output, capacity, policy, frames}
+	{ }
+
+	/// Wraps @p output, which is given the results from now on.
+	explicit AsyncResultsOutput(std::unique_ptr<T> output)
+	 : AsyncResultsOutput(makePluginPtr(std::move(output)))
+	{ }
+
+	/// Wraps an output constructed from @p arguments.
+	template<class... Args>
+	explicit AsyncResultsOutput(std::in_place_t, Args&&... arguments)
+	 : AsyncResultsOutput(std::make_unique<T>(std::forward<Args>(arguments)...))
+	{ }
+
+	void onStart(std::string_view id) noexcept override { m_worker.onStart(id); }
+
+	void onStop(std::string_view id, ResultsOutputStatus status) noexcept override
+	{
+		m_worker.onStop(id, status);
+	}
+
+	void operator()(const std::string& metadata, const dto::ImageView* image) noexcept override
+	{
+		m_worker(metadata, image);
+	}
+
+	/// Returns the number of results dropped so far, coalesced ones excluded.
+	std::uint64_t dropped() const noexcept { return m_worker.dropped(); }
+
+	/// Returns the number of results replaced by the next one so far.
+	std::uint64_t coalesced() const noexcept { return m_worker.coalesced(); }
+
+	static void* create(PluginArguments& arguments, PluginErrorCallback& error)
+	{
+		auto output = createPluginPtr<T, ResultsOutput>(arguments, error);
+		if (!output)
+		{
+			return nullptr;
+		}
+
+		ResultsOutput* p = nullptr;
+
+		try
+		{
+			p = new AsyncResultsOutput(std::move(output));
+		}
+		catch (const std::exception& e)
+		{
+			error(e.what());
+		}
+
+		return p;
+	}
+
+	static void destroy(void* p) { delete static_cast<ResultsOutput*>(p); }
+
+private:
+	PluginPtr<T> m_output;
+	ResultsOutputWorker m_worker;
+};
+
+} // namespace neurala
+
+#endif // NEURALA_UTILS_ASYNC_RESULTS_OUTPUT_H
@@ -0,0 +1,69 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_UTILS_BLOCK_POOL_H
+#define NEURALA_UTILS_BLOCK_POOL_H
+
+#include <cstddef>
+#include <functional>
+
+#include "neurala/utils/Executor.h"
+
+namespace neurala
+{
+/**
+ * @brief Processes the blocks of a job over the workers of an Executor and the calling thread.
+ *
+ * The thread running a job processes blocks as well, without waiting for workers busy with other
+ * tasks, so a pool of one thread uses none.
+ */
+class BlockPool
+{
+public:
+	/**
+	 * @param threads  number of threads processing the blocks of a job, at most the number of
+	 *                 workers of @p executor plus one, that number of workers if 0
+	 * @param executor executor whose workers process blocks, which must outlive the object
+	 * @param priority lane of the tasks processing blocks
+	 */
+	explicit BlockPool(std::size_t threads = 0,
+	                   Executor& executor = Executor::shared(),
+	                   ETaskPriority priority = ETaskPriority::conversion) noexcept;
+
+	BlockPool(const BlockPool&) = delete;
+	BlockPool& operator=(const BlockPool&) = delete;
+
+	/// Returns the number of threads processing the blocks, including the calling one.
+	std::size_t threads() const noexcept { return m_threads; }
+
+	/**
+	 * @brief Calls @p job for each block in [0, @p blocks), and returns once all are processed.
+	 *
+	 * @throw std::bad_alloc if the job cannot be allocated
+	 */
+	void run(std::size_t blocks, const std::function<void(std::size_t)>& job);
+
+private:
+	Executor& m_executor;
+	const std::size_t m_threads;
+	const ETaskPriority m_priority;
+};
+
+} // namespace neurala
+
+#endif // NEURALA_UTILS_BLOCK_POOL_H
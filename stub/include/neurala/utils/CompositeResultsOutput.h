@@ -0,0 +1,186 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_UTILS_COMPOSITE_RESULTS_OUTPUT_H
+#define NEURALA_UTILS_COMPOSITE_RESULTS_OUTPUT_H
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "neurala/image/views/dto/ImageView.h"
+#include "neurala/plugin/PluginArguments.h"
+#include "neurala/plugin/PluginErrorCallback.h"
+#include "neurala/plugin/PluginPtr.h"
+#include "neurala/utils/AsyncResultsOutput.h"
+#include "neurala/utils/ResultsOutput.h"
+
+namespace neurala
+{
+/**
+ * @brief Hands out results to several outputs at once, each run by a ResultsOutputWorker of its
+ *        own.
+ *
+ * Each result is copied once into a SharedResult that the queues of all outputs refer to, along
+ * with its frame, shared with FramePool::share(), so that the outputs are given the same string
+ * and frame. Results are reused once every output is done with them, so that they are no longer
+ * allocated once results keep their size.
+ * Each output has its own queue and thread: a slow or stalled output only loses its own results,
+ * according to the policy, and never delays the others.
+ */
+class ResultsBroadcaster
+{
+public:
+	/**
+	 * @brief Starts the threads running @p outputs, which must outlive the object.
+	 *
+	 * @param capacity number of results queued for each output, at least 2
+	 * @param policy   what is done with a result when the queue of an output is full
+	 * @param frames   whether frames are handed out to the outputs, or null images
+	 */
+	ResultsBroadcaster(const std::vector<std::reference_wrapper<ResultsOutput>>& outputs,
+	                   std::size_t capacity,
+	                   EOverflowPolicy policy,
+	                   bool frames = true);
+
+	/// Queues the start of job @p id for every output.
+	void onStart(std::string_view id) noexcept;
+
+	/// Queues the stop of job @p id for every output.
+	void onStop(std::string_view id, ResultsOutputStatus status) noexcept;
+
+	/// Queues a result for every output. Results are given by a single thread at a time.
+	void operator()(const std::string& metadata, const dto::ImageView* image) noexcept;
+
+	/// Returns the number of outputs.
+	std::size_t size() const noexcept { return m_workers.size(); }
+
+	/// Returns the worker running output @p i, whose counters tell the results it lost.
+	const ResultsOutputWorker& worker(std::size_t i) const noexcept { return *m_workers[i]; }
+
+private:
+	const bool m_frames;
+	// Results held by the outputs, enough for each of them to fill its queue with different ones.
+	std::vector<SharedResult> m_results;
+	// Destroyed first, so that the outputs are given everything queued before the results go.
+	std::vector<std::unique_ptr<ResultsOutputWorker>> m_workers;
+};
+
+/**
+ * @brief Results output handing out each result to plugin outputs of types @p Outputs at once,
+ *        with a ResultsBroadcaster.
+ *
+ * The plugin outputs need no change: registering CompositeResultsOutput<First, Second> with the
+ * plugin manager creates a single output, which creates each of them with their create(), given
+ * the same arguments.
+ *
+ * @tparam policy   what is done with a result when the queue of an output is full
+ * @tparam capacity number of results queued for each output
+ * @tparam Outputs  types of the wrapped results outputs
+ */
+template<EOverflowPolicy policy, std::size_t capacity, class... Outputs>
+class BasicCompositeResultsOutput : public ResultsOutput
+{
+	static_assert(sizeof...(Outputs) > 0, "Results can only be handed out to some outputs");
+	static_assert((std::is_base_of_v<ResultsOutput, Outputs> && ...),
+	              "Only results outputs can be composed");
+	static_assert(capacity >= 2, "Results can only be queued with a capacity of at least 2");
+
+public:
+	/// Wraps @p outputs, which are given the results from now on.
+	explicit BasicCompositeResultsOutput(PluginPtr<Outputs>... outputs)
+	 : m_outputs{std::move(outputs)...}
+	 , m_broadcaster{std::apply(
+	                   [](auto&... output) {
+		                   return std::vector<std::reference_wrapper<ResultsOutput>>{*output...};
+	                   },
+	                   m_outputs),
+	                 capacity,
+	                 policy}
+	{ }
+
+	/// Wraps @p outputs, which are given the results from now on.
+	explicit BasicCompositeResultsOutput(std::unique_ptr<Outputs>... outputs)
+	 : BasicCompositeResultsOutput(makePluginPtr(std::move(outputs))...)
+	{ }
+
+	void onStart(std::string_view id) noexcept override { m_broadcaster.onStart(id); }
+
+	void onStop(std::string_view id, ResultsOutputStatus status) noexcept override
+	{
+		m_broadcaster.onStop(id, status);
+	}
+
+	void operator()(const std::string& metadata, const dto::ImageView* image) noexcept override
+	{
+		m_broadcaster(metadata, image);
+	}
+
+	/// Returns the broadcaster, whose workers tell the results each output lost.
+	const ResultsBroadcaster& broadcaster() const noexcept { return m_broadcaster; }
+
+	static void* create(PluginArguments& arguments, PluginErrorCallback& error)
+	{
+		// Braced initialization creates the outputs in order.
+		std::tuple<PluginPtr<Outputs>...> outputs{
+		  createPluginPtr<Outputs, ResultsOutput>(arguments, error)...};
+
+		const auto created = std::apply([](auto&... output) { return (output && ...); }, outputs);
+		if (!created)
+		{
+			return nullptr;
+		}
+
+		ResultsOutput* p = nullptr;
+
+		try
+		{
+			p = std::apply(
+			  [](auto&... output) { return new BasicCompositeResultsOutput(std::move(output)...); },
+			  outputs);
+		}
+		catch (const std::exception& e)
+		{
+			error(e.what());
+		}
+
+		return p;
+	}
+
+	static void destroy(void* p) { delete static_cast<ResultsOutput*>(p); }
+
+private:
+	std::tuple<PluginPtr<Outputs>...> m_outputs;
+	ResultsBroadcaster m_broadcaster;
+};
+
+/// Results output handing out each result to plugin outputs at once, dropping the results of the
+/// outputs that fall behind.
+template<class... Outputs>
+using CompositeResultsOutput = BasicCompositeResultsOutput<EOverflowPolicy::drop, 8, Outputs...>;
+
+} // namespace neurala
+
+#endif // NEURALA_UTILS_COMPOSITE_RESULTS_OUTPUT_H
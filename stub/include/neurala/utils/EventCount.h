@@ -0,0 +1,226 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_UTILS_EVENT_COUNT_H
+#define NEURALA_UTILS_EVENT_COUNT_H
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+
+#include "neurala/config/os.h"
+
+#if defined(NEURALA_OS_LINUX)
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace neurala
+{
+/**
+ * @brief Blocking wait on a condition of lock-free state, such as that of an SpscRing or a
+ *        TripleBuffer.
+ *
+ * Threads changing the state call notifyAll() afterwards, which only costs an atomic increment
+ * unless a thread waits, and only then a system call. Waiting threads sleep on a futex on Linux,
+ * and on a condition variable elsewhere. Unlike with a condition variable, the state itself is not
+ * guarded by any lock: the conditions are evaluated again after each wake-up.
+ */
+class EventCount
+{
+public:
+	/// Wakes the threads waiting, after the state they wait on changed.
+	void notifyAll() noexcept
+	{
+		m_epoch.fetch_add(1, std::memory_order_seq_cst);
+		if (m_waiters.load(std::memory_order_seq_cst) != 0)
+		{
+			wake(INT_MAX);
+		}
+	}
+
+	/**
+	 * @brief Wakes one of the threads waiting, after the state they wait on changed.
+	 *
+	 * Only suits threads waiting for the same condition, any of which may act on the change, such
+	 * as workers waiting for tasks.
+	 */
+	void notifyOne() noexcept
+	{
+		m_epoch.fetch_add(1, std::memory_order_seq_cst);
+		if (m_waiters.load(std::memory_order_seq_cst) != 0)
+		{
+			wake(1);
+		}
+	}
+
+	/**
+	 * @brief Waits until @p ready returns true.
+	 *
+	 * @p ready is not called again once it returned true, so that it may take what it waits for,
+	 * such as a value of a ring.
+	 */
+	template<class Predicate>
+	void wait(Predicate ready)
+	{
+		while (!ready())
+		{
+			const auto epoch = prepareWait();
+			if (ready())
+			{
+				m_waiters.fetch_sub(1, std::memory_order_relaxed);
+				return;
+			}
+
+			sleep(epoch, nullptr);
+			m_waiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * @brief Waits until @p ready returns true, or @p timeout elapses.
+	 *
+	 * @p ready is not called again once it returned true.
+	 *
+	 * @return if @p ready returned true
+	 */
+	template<class Rep, class Period, class Predicate>
+	bool waitFor(const std::chrono::duration<Rep, Period>& timeout, Predicate ready)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+		while (!ready())
+		{
+			const auto epoch = prepareWait();
+			if (ready())
+			{
+				m_waiters.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+
+			const auto remaining = deadline - std::chrono::steady_clock::now();
+			if (remaining <= remaining.zero())
+			{
+				m_waiters.fetch_sub(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			const auto delay = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining);
+			sleep(epoch, &delay);
+			m_waiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		return true;
+	}
+
+private:
+	/// Registers a waiting thread, and returns the epoch it sleeps on unless it changes.
+	std::uint32_t prepareWait() noexcept
+	{
+		m_waiters.fetch_add(1, std::memory_order_seq_cst);
+		return m_epoch.load(std::memory_order_seq_cst);
+	}
+
+#if defined(NEURALA_OS_LINUX)
+	static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+	              "Futexes are 32-bit words");
+
+	void sleep(std::uint32_t epoch, const std::chrono::nanoseconds* timeout) noexcept
+	{
+		timespec delay{};
+		if (timeout)
+		{
+			delay.tv_sec = static_cast<std::time_t>(timeout->count() / 1000000000);
+			delay.tv_nsec = static_cast<long>(timeout->count() % 1000000000);
+		}
+
+		// Returns at once if the epoch changed since it was read.
+		syscall(SYS_futex,
+		        reinterpret_cast<std::uint32_t*>(&m_epoch),
+		        FUTEX_WAIT_PRIVATE,
+		        epoch,
+		        timeout ? &delay : nullptr,
+		        nullptr,
+		        0);
+	}
+
+	void wake(int threads) noexcept
+	{
+		syscall(SYS_futex,
+		        reinterpret_cast<std::uint32_t*>(&m_epoch),
+		        FUTEX_WAKE_PRIVATE,
+		        threads,
+		        nullptr,
+		        nullptr,
+		        0);
+	}
+#else
+	void sleep(std::uint32_t epoch, const std::chrono::nanoseconds* timeout) noexcept
+	{
+		std::unique_lock lock(m_mutex);
+		if (m_epoch.load(std::memory_order_seq_cst) != epoch)
+		{
+			return;
+		}
+
+		if (timeout)
+		{
+			m_condition.wait_for(lock, *timeout);
+		}
+		else
+		{
+			m_condition.wait(lock);
+		}
+	}
+
+	void wake(int threads) noexcept
+	{
+		// Taking the lock orders the change of epoch before a thread starts sleeping.
+		{
+			std::scoped_lock lock(m_mutex);
+		}
+
+		if (threads == 1)
+		{
+			m_condition.notify_one();
+		}
+		else
+		{
+			m_condition.notify_all();
+		}
+	}
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+#endif
+
+	// Incremented by each notification.
+	std::atomic<std::uint32_t> m_epoch{0};
+	std::atomic<std::uint32_t> m_waiters{0};
+};
+
+} // namespace neurala
+
+#endif // NEURALA_UTILS_EVENT_COUNT_H
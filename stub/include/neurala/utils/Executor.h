@@ -0,0 +1,141 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_UTILS_EXECUTOR_H
+#define NEURALA_UTILS_EXECUTOR_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "neurala/utils/EventCount.h"
+
+namespace neurala
+{
+/**
+ * @brief Lanes of the tasks of an Executor, from the most to the least urgent.
+ */
+enum class ETaskPriority
+{
+	/// Acquiring frames, such as reading them from a device or a network stream.
+	capture,
+	/// Converting frames, such as decoding, resizing or demosaicing them.
+	conversion,
+	/// Handing out results, such as encoding or writing them.
+	output
+};
+
+/**
+ * @brief Set of threads running the background tasks of the video sources and results outputs of a
+ *        plugin, so that parallelism is sized once per host rather than by each of them.
+ *
+ * Each worker queues the tasks submitted from its own tasks, and runs the last of them first,
+ * while they are still in cache. Tasks submitted from other threads are queued for all workers.
+ * Idle workers take the oldest tasks of the others. Tasks of a more urgent lane are always taken
+ * first, so a lane kept busy holds up the less urgent ones.
+ */
+class Executor
+{
+public:
+	struct Settings
+	{
+		/// Number of workers, the number of hardware threads if 0.
+		std::size_t threads = 0;
+		/// CPUs the workers are pinned to in turn, on Linux, or none to let them run on any.
+		std::vector<unsigned> cpus;
+	};
+
+	/// Starts an executor with the default settings.
+	Executor();
+
+	explicit Executor(Settings settings);
+
+	/// Stops the workers, once they have run all the tasks submitted.
+	~Executor() noexcept;
+
+	Executor(const Executor&) = delete;
+	Executor& operator=(const Executor&) = delete;
+
+	/**
+	 * @brief Returns the executor shared by the video sources and outputs of a plugin.
+	 *
+	 * The executor is shared within a plugin only: the library is linked statically into each
+	 * plugin, so each plugin loaded by the SDK starts workers of its own, on the first call. They
+	 * default to half the hardware threads, leaving room for inference and for other plugins.
+	 * It is never destroyed, so that tasks may be submitted by static objects. Its settings are
+	 * read from the environment:
+	 * - NEURALA_EXECUTOR_THREADS: number of workers of each plugin
+	 * - NEURALA_EXECUTOR_CPUS: CPUs the workers are pinned to, such as "0-3,8"
+	 */
+	static Executor& shared() noexcept;
+
+	const Settings& settings() const noexcept { return m_settings; }
+
+	/// Returns the number of workers.
+	std::size_t threads() const noexcept { return m_workers; }
+
+	/**
+	 * @brief Queues @p task, to be run by a worker after the tasks of more urgent lanes.
+	 *
+	 * Tasks must not throw, nor wait for tasks queued after them, which may be queued for the
+	 * same worker.
+	 *
+	 * @throw std::bad_alloc if the task cannot be queued
+	 */
+	void submit(ETaskPriority priority, std::function<void()> task);
+
+	/// Returns if the calling thread is a worker of the executor.
+	bool isWorker() const noexcept;
+
+private:
+	static constexpr std::size_t kLanes = 3;
+
+	// Tasks of a worker, or those submitted from other threads.
+	struct alignas(64) Queue
+	{
+		std::mutex mutex;
+		std::array<std::deque<std::function<void()>>, kLanes> lanes;
+		// Sizes of the lanes, read without the lock to skip empty ones.
+		std::array<std::atomic<std::size_t>, kLanes> sizes{};
+	};
+
+	void run(std::size_t index) noexcept;
+
+	/// Takes the most urgent task for worker @p index.
+	bool take(std::size_t index, std::function<void()>& task) noexcept;
+
+	const Settings m_settings;
+	const std::size_t m_workers;
+	std::unique_ptr<Queue[]> m_queues;
+	Queue m_submitted;
+	// Number of tasks queued, in any queue.
+	alignas(64) std::atomic<std::size_t> m_queued{0};
+	std::atomic<bool> m_stopping{false};
+	EventCount m_work;
+	std::vector<std::thread> m_threads;
+};
+
+} // namespace neurala
+
+#endif // NEURALA_UTILS_EXECUTOR_H
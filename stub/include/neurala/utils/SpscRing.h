@@ -0,0 +1,127 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_UTILS_SPSC_RING_H
+#define NEURALA_UTILS_SPSC_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace neurala
+{
+/**
+ * @brief Lock-free bounded queue between one producer thread and one consumer thread.
+ *
+ * Each side owns a cache line holding its position and the last position of the other side it
+ * read, so that it only reads the line of the other side when the ring looks full or empty.
+ * Values are moved in and out of default-constructed slots.
+ *
+ * @tparam T        type of the values, default constructible and move assignable
+ * @tparam Capacity number of values queued, a power of two
+ */
+template<class T, std::size_t Capacity>
+class SpscRing
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+	              "The capacity of a ring must be a power of two");
+
+public:
+	static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+	/**
+	 * @brief Queues @p value, from the producer thread.
+	 *
+	 * @return false if the ring is full, in which case @p value is left untouched
+	 */
+	template<class U>
+	bool push(U&& value)
+	{
+		const auto tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_cachedHead == Capacity)
+		{
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (tail - m_cachedHead == Capacity)
+			{
+				return false;
+			}
+		}
+
+		m_slots[tail & (Capacity - 1)] = std::forward<U>(value);
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Moves the oldest value to @p value, from the consumer thread.
+	 *
+	 * @return false if the ring is empty
+	 */
+	bool pop(T& value)
+	{
+		const auto head = m_head.load(std::memory_order_relaxed);
+		if (head == m_cachedTail)
+		{
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if (head == m_cachedTail)
+			{
+				return false;
+			}
+		}
+
+		value = std::move(m_slots[head & (Capacity - 1)]);
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Returns if the ring is full, from the producer thread.
+	bool full() const noexcept
+	{
+		return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_acquire)
+		       == Capacity;
+	}
+
+	/// Returns if the ring is empty, from the consumer thread.
+	bool empty() const noexcept
+	{
+		return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire);
+	}
+
+	/// Returns the number of values queued, which may have changed by the time it is returned.
+	std::size_t size() const noexcept
+	{
+		const auto head = m_head.load(std::memory_order_acquire);
+		return m_tail.load(std::memory_order_acquire) - head;
+	}
+
+private:
+	// Written by the consumer.
+	alignas(64) std::atomic<std::size_t> m_head{0};
+	std::size_t m_cachedTail = 0;
+
+	// Written by the producer.
+	alignas(64) std::atomic<std::size_t> m_tail{0};
+	std::size_t m_cachedHead = 0;
+
+	alignas(64) std::array<T, Capacity> m_slots{};
+};
+
+} // namespace neurala
+
+#endif // NEURALA_UTILS_SPSC_RING_H
@@ -0,0 +1,90 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_UTILS_TRIPLE_BUFFER_H
+#define NEURALA_UTILS_TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+
+namespace neurala
+{
+/**
+ * @brief Lock-free exchange of the latest value between one writer and one reader.
+ *
+ * The writer fills the back slot and publishes it, which swaps it with the middle slot. The reader
+ * takes the middle slot as its front slot if it was published since its last read. Neither side
+ * ever waits on the other, and unread values are overwritten by newer ones. The index each side
+ * owns lies on a cache line of its own, apart from the middle one they exchange.
+ */
+template<class T>
+class TripleBuffer
+{
+private:
+	static constexpr unsigned kIndex = 3;
+	// Set in m_middle when it holds a value not read yet.
+	static constexpr unsigned kFresh = 4;
+
+	std::array<T, 3> m_slots{};
+	alignas(64) std::atomic<unsigned> m_middle{1};
+	alignas(64) unsigned m_back = 0;
+	alignas(64) unsigned m_front = 2;
+
+public:
+	/// Returns the slot filled by the writer.
+	T& back() noexcept { return m_slots[m_back]; }
+
+	/**
+	 * @brief Publishes the back slot, which is then replaced by an unused one.
+	 *
+	 * @return true if the previously published value had not been read and is dropped
+	 */
+	bool publish() noexcept
+	{
+		const auto middle = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel);
+		m_back = middle & kIndex;
+		return (middle & kFresh) != 0;
+	}
+
+	/// Returns true if a value was published since the last read.
+	bool fresh() const noexcept { return (m_middle.load(std::memory_order_acquire) & kFresh) != 0; }
+
+	/**
+	 * @brief Makes the latest published value the front slot, if it was not read yet.
+	 *
+	 * @return true if the front slot holds a new value
+	 */
+	bool read() noexcept
+	{
+		if (!fresh())
+		{
+			return false;
+		}
+
+		const auto middle = m_middle.exchange(m_front, std::memory_order_acq_rel);
+		m_front = middle & kIndex;
+		return true;
+	}
+
+	/// Returns the slot read last by the reader.
+	T& front() noexcept { return m_slots[m_front]; }
+};
+
+} // namespace neurala
+
+#endif // NEURALA_UTILS_TRIPLE_BUFFER_H
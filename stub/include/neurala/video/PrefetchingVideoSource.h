@@ -0,0 +1,213 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_VIDEO_PREFETCHING_VIDEO_SOURCE_H
+#define NEURALA_VIDEO_PREFETCHING_VIDEO_SOURCE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "neurala/image/FramePool.h"
+#include "neurala/image/dto/ImageMetadata.h"
+#include "neurala/image/views/dto/ImageView.h"
+#include "neurala/plugin/PluginArguments.h"
+#include "neurala/plugin/PluginErrorCallback.h"
+#include "neurala/plugin/PluginPtr.h"
+#include "neurala/video/VideoSource.h"
+
+namespace neurala
+{
+/**
+ * @brief Acquires the frames of a video source on a thread of its own, ahead of their requests.
+ *
+ * The thread calls nextFrame() and frame(std::byte*, std::size_t) of the source into frames of
+ * FramePool::shared(), recycled once the SDK and the outputs are done with them, so that
+ * acquisition overlaps the processing of the previous frames. Outputs of the same plugin may keep
+ * the frames handed out with FramePool::share() rather than copy them. Frames and errors are
+ * handed out in the order the source gave them. When every buffer holds a frame not handed out
+ * yet, acquisition waits for one to be free.
+ *
+ * Buffers are sized from the metadata of the source, and sized again from it when a frame does not
+ * fit, as when its resolution changes; frames are then described by the metadata of the views the
+ * source returns. Frames of unknown formats, such as multispectral ones, are reported as
+ * VideoSourceStatus::pixelFormatNotSupported().
+ */
+class FramePrefetcher
+{
+public:
+	/// Alignment of the frames, that of a cache line and of the widest vector registers.
+	static constexpr std::size_t kAlignment = FramePool::kAlignment;
+
+	/**
+	 * @brief Starts acquiring the frames of @p source, which must outlive the object.
+	 *
+	 * @param buffers number of buffers, at least 2: the one of the frame handed out, and those
+	 *                acquired ahead
+	 */
+	FramePrefetcher(VideoSource& source, std::size_t buffers);
+
+	/// Stops acquiring frames, once the current call to the source returns.
+	~FramePrefetcher() noexcept;
+
+	FramePrefetcher(const FramePrefetcher&) = delete;
+	FramePrefetcher& operator=(const FramePrefetcher&) = delete;
+
+	/// Returns the metadata of the frame handed out, or of the source before the first one.
+	const dto::ImageMetadata& metadata() const noexcept;
+
+	/// Hands out the next frame acquired, waiting for it if needed, and frees the previous one.
+	std::error_code nextFrame() noexcept;
+
+	/// Returns the frame handed out, kept in its buffer until the next call to nextFrame().
+	dto::ImageView frame() const noexcept;
+
+	/// Copies the frame handed out to @p data.
+	dto::ImageView frame(std::byte* data, std::size_t capacity) const noexcept;
+
+	/// Executes @p action on the source, once the current call of the thread to the source returns.
+	std::error_code execute(const std::string& action) noexcept;
+
+private:
+	struct Buffer
+	{
+		SharedFrame frame;
+		std::error_code status;
+	};
+
+	static constexpr auto kNone = static_cast<std::size_t>(-1);
+
+	/// Acquires the next frame of the source into @p buffer.
+	void acquire(Buffer& buffer) noexcept;
+
+	void prefetch() noexcept;
+
+	VideoSource& m_source;
+	// Serializes the calls to the source.
+	std::mutex m_sourceMutex;
+	const dto::ImageMetadata m_metadata;
+
+	std::vector<Buffer> m_buffers;
+	std::mutex m_mutex;
+	std::condition_variable m_freeCondition;
+	std::condition_variable m_readyCondition;
+	// Buffers free to acquire a frame.
+	std::vector<std::size_t> m_free;
+	// Buffers holding frames not handed out yet, in order, as a ring.
+	std::vector<std::size_t> m_ready;
+	std::size_t m_readyFirst = 0;
+	std::size_t m_readyCount = 0;
+	// Buffer of the frame handed out.
+	std::size_t m_current = kNone;
+	bool m_stopping = false;
+
+	std::thread m_thread;
+};
+
+/**
+ * @brief Video source acquiring the frames of a plugin source of type @p T ahead of their
+ *        requests, with a FramePrefetcher.
+ *
+ * The plugin source needs no change: registering PrefetchingVideoSource<Source> rather than Source
+ * with the plugin manager creates it with Source::create(), and wraps it.
+ *
+ * @tparam T       type of the wrapped video source
+ * @tparam buffers number of buffers, that of the frame handed out and those acquired ahead
+ */
+template<class T, std::size_t buffers = 3>
+class PrefetchingVideoSource : public VideoSource
+{
+	static_assert(std::is_base_of_v<VideoSource, T>, "Only video sources can be prefetched");
+	static_assert(buffers >= 2, "Frames can only be prefetched with at least 2 buffers");
+
+public:
+	/// Wraps @p source, whose frames are acquired from now on.
+	explicit PrefetchingVideoSource(PluginPtr<T> source)
+	 : m_source{std::move(source)}, m_prefetcher{*m_source, buffers}
+	{ }
+
+	/// Wraps @p source, whose frames are acquired from now on.
+	explicit PrefetchingVideoSource(std::unique_ptr<T> source)
+	 : PrefetchingVideoSource(makePluginPtr(std::move(source)))
+	{ }
+
+	/// Wraps a source constructed from @p arguments.
+	template<class... Args>
+	explicit PrefetchingVideoSource(std::in_place_t, Args&&... arguments)
+	 : PrefetchingVideoSource(std::make_unique<T>(std::forward<Args>(arguments)...))
+	{ }
+
+	[[nodiscard]] dto::ImageMetadata metadata() const noexcept override
+	{
+		return m_prefetcher.metadata();
+	}
+
+	[[nodiscard]] std::error_code nextFrame() noexcept override { return m_prefetcher.nextFrame(); }
+
+	[[nodiscard]] dto::ImageView frame() const noexcept override { return m_prefetcher.frame(); }
+
+	[[nodiscard]] dto::ImageView frame(std::byte* data, std::size_t capacity) const noexcept override
+	{
+		return m_prefetcher.frame(data, capacity);
+	}
+
+	[[nodiscard]] std::error_code execute(const std::string& action) noexcept override
+	{
+		return m_prefetcher.execute(action);
+	}
+
+	static void* create(PluginArguments& arguments, PluginErrorCallback& error)
+	{
+		auto source = createPluginPtr<T, VideoSource>(arguments, error);
+		if (!source)
+		{
+			return nullptr;
+		}
+
+		VideoSource* p = nullptr;
+
+		try
+		{
+			p = new PrefetchingVideoSource(std::move(source));
+		}
+		catch (const std::exception& e)
+		{
+			error(e.what());
+		}
+
+		return p;
+	}
+
+	static void destroy(void* p) { delete static_cast<VideoSource*>(p); }
+
+private:
+	PluginPtr<T> m_source;
+	mutable FramePrefetcher m_prefetcher;
+};
+
+} // namespace neurala
+
+#endif // NEURALA_VIDEO_PREFETCHING_VIDEO_SOURCE_H
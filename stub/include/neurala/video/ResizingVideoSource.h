@@ -0,0 +1,84 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_VIDEO_RESIZING_VIDEO_SOURCE_H
+#define NEURALA_VIDEO_RESIZING_VIDEO_SOURCE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <system_error>
+
+#include "neurala/image/FramePool.h"
+#include "neurala/image/Resize.h"
+#include "neurala/video/VideoSource.h"
+
+namespace neurala
+{
+/**
+ * @brief Video source cropping and resizing the frames of another one.
+ *
+ * Frames of the wrapped source are read where it keeps them, with frame(), and resized straight
+ * into the buffer given to frame(std::byte*, std::size_t), so that the SDK copies and runs
+ * inference on the reduced frames only. Frames the resizer does not support are handed out as the
+ * wrapped source gives them.
+ */
+class ResizingVideoSource : public VideoSource
+{
+public:
+	/**
+	 * @param source        video source whose frames are resized
+	 * @param region        region of the frames to keep, within their stored orientation
+	 * @param width         width of the resized frames, or 0 for the one of the region
+	 * @param height        height of the resized frames, or 0 for the one of the region
+	 * @param interpolation interpolation of the resized pixels
+	 * @param threads       number of threads resizing a frame, the number of workers of the
+	 *                      shared executor if 0
+	 */
+	ResizingVideoSource(std::unique_ptr<VideoSource> source,
+	                    const Region& region,
+	                    std::size_t width = 0,
+	                    std::size_t height = 0,
+	                    EInterpolation interpolation = EInterpolation::area,
+	                    std::size_t threads = 0);
+
+	/// Returns the metadata of the resized frames.
+	[[nodiscard]] dto::ImageMetadata metadata() const noexcept override;
+
+	[[nodiscard]] std::error_code nextFrame() noexcept override;
+
+	/// Returns the resized frame, a frame of FramePool::shared() kept until the next one is resized.
+	[[nodiscard]] dto::ImageView frame() const noexcept override;
+
+	[[nodiscard]] dto::ImageView frame(std::byte* data, std::size_t capacity) const noexcept override;
+
+	[[nodiscard]] std::error_code execute(const std::string& action) noexcept override;
+
+	/// Returns the wrapped video source.
+	VideoSource& source() const noexcept { return *m_source; }
+
+private:
+	std::unique_ptr<VideoSource> m_source;
+	mutable Resizer m_resizer;
+	// Resized frame handed out by frame().
+	mutable SharedFrame m_frame;
+};
+
+} // namespace neurala
+
+#endif // NEURALA_VIDEO_RESIZING_VIDEO_SOURCE_H
@@ -0,0 +1,1081 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "neurala/image/ColorConversion.h"
+
+#include "SimdTarget.h"
+#include "Vector.h"
+
+namespace neurala
+{
+namespace
+{
+using namespace detail;
+
+/**
+ * @brief Converts a row of @p width pixels to @p output.
+ *
+ * @param rows  source rows the output row is computed from, as given by ERows
+ * @param phase color of the first pixel of a Bayer row, see bayerPhase()
+ */
+using Rows = const std::uint8_t* const*;
+using RowKernel = void (*)(Rows rows,
+                           std::size_t width,
+                           unsigned phase,
+                           std::uint8_t* output) noexcept;
+
+/// Source rows given to the kernels.
+enum class ERows : unsigned char
+{
+	/// The row of the only plane.
+	single,
+	/// The rows of the luma plane and of the two chroma planes of a 4:2:0 image.
+	planar420,
+	/// The rows of the luma plane and of the interleaved chroma plane of a 4:2:0 image.
+	semiplanar420,
+	/// The previous, current and next rows of the only plane, the borders being mirrored.
+	neighbors
+};
+
+// Fixed-point BT.601 limited range coefficients, out of 64. Intermediate values are computed on
+// saturated 16 bits so that all instruction sets give the same results.
+constexpr int kLuma = 75;
+constexpr int kRedV = 102;
+constexpr int kGreenU = 25;
+constexpr int kGreenV = 52;
+constexpr int kBlueU = 129;
+constexpr int kShift = 6;
+
+int
+saturate16(int value) noexcept
+{
+	return std::clamp(value, -32768, 32767);
+}
+
+std::uint8_t
+toByte(int value) noexcept
+{
+	const auto shifted = saturate16(value + (1 << (kShift - 1))) >> kShift;
+	return static_cast<std::uint8_t>(std::clamp(shifted, 0, 255));
+}
+
+template<bool bgr>
+void
+yuvPixel(int y, int u, int v, std::uint8_t* output) noexcept
+{
+	const auto luma = (y - 16) * kLuma;
+	u -= 128;
+	v -= 128;
+
+	output[bgr ? 2 : 0] = toByte(saturate16(luma + v * kRedV));
+	output[1] = toByte(saturate16(luma - (u * kGreenU + v * kGreenV)));
+	output[bgr ? 0 : 2] = toByte(saturate16(luma + u * kBlueU));
+}
+
+std::uint8_t
+average(std::uint8_t a, std::uint8_t b) noexcept
+{
+	return static_cast<std::uint8_t>((a + b + 1) >> 1);
+}
+
+// Swap of the first and third bytes of 4-byte pixels, and the same while dropping the fourth.
+constexpr ByteShuffle kSwap4{{2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15}};
+constexpr ByteShuffle kDrop4{{0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128}};
+constexpr ByteShuffle kSwapDrop4{{2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -128, -128, -128, -128}};
+
+// Duplicates the U, or the V, of 16-bit U V pairs.
+constexpr ByteShuffle kDuplicateU{{0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13}};
+constexpr ByteShuffle kDuplicateV{{2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15}};
+
+/// Alternating bytes, loaded at an offset of 0 or 1 to select the odd or the even pixels.
+alignas(32) constexpr std::uint8_t kAlternate[48] = {
+  0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255,
+  0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255};
+
+#ifdef NEURALA_IMAGE_X86
+NEURALA_IMAGE_TARGET("sse4.1")
+inline __m128i
+finish(__m128i value) noexcept
+{
+	return _mm_srai_epi16(_mm_adds_epi16(value, _mm_set1_epi16(1 << (kShift - 1))), kShift);
+}
+
+/// Converts 8 pixels given as 16-bit Y, U and V to 16-bit R, G and B.
+NEURALA_IMAGE_TARGET("sse4.1")
+inline void
+yuvToRgb(__m128i y, __m128i u, __m128i v, __m128i& r, __m128i& g, __m128i& b) noexcept
+{
+	const auto luma = _mm_mullo_epi16(_mm_sub_epi16(y, _mm_set1_epi16(16)), _mm_set1_epi16(kLuma));
+	u = _mm_sub_epi16(u, _mm_set1_epi16(128));
+	v = _mm_sub_epi16(v, _mm_set1_epi16(128));
+
+	r = finish(_mm_adds_epi16(luma, _mm_mullo_epi16(v, _mm_set1_epi16(kRedV))));
+	g = finish(_mm_subs_epi16(luma,
+	                          _mm_add_epi16(_mm_mullo_epi16(u, _mm_set1_epi16(kGreenU)),
+	                                        _mm_mullo_epi16(v, _mm_set1_epi16(kGreenV)))));
+	b = finish(_mm_adds_epi16(luma, _mm_mullo_epi16(u, _mm_set1_epi16(kBlueU))));
+}
+
+/// Converts 16 pixels given as 8-bit Y and 16-bit U and V for pairs of pixels, and stores them.
+template<bool bgr>
+NEURALA_IMAGE_TARGET("sse4.1")
+inline void
+storeYuv(__m128i y, __m128i u, __m128i v, std::uint8_t* output) noexcept
+{
+	const auto zero = _mm_setzero_si128();
+	__m128i r[2], g[2], b[2];
+	yuvToRgb(_mm_unpacklo_epi8(y, zero),
+	         _mm_unpacklo_epi16(u, u),
+	         _mm_unpacklo_epi16(v, v),
+	         r[0],
+	         g[0],
+	         b[0]);
+	yuvToRgb(_mm_unpackhi_epi8(y, zero),
+	         _mm_unpackhi_epi16(u, u),
+	         _mm_unpackhi_epi16(v, v),
+	         r[1],
+	         g[1],
+	         b[1]);
+
+	const auto red = _mm_packus_epi16(r[0], r[1]);
+	const auto blue = _mm_packus_epi16(b[0], b[1]);
+	store3(bgr ? blue : red, _mm_packus_epi16(g[0], g[1]), bgr ? red : blue, output);
+}
+
+NEURALA_IMAGE_TARGET("avx2")
+inline __m256i
+finish(__m256i value) noexcept
+{
+	return _mm256_srai_epi16(_mm256_adds_epi16(value, _mm256_set1_epi16(1 << (kShift - 1))), kShift);
+}
+
+NEURALA_IMAGE_TARGET("avx2")
+inline void
+yuvToRgb(__m256i y, __m256i u, __m256i v, __m256i& r, __m256i& g, __m256i& b) noexcept
+{
+	const auto luma =
+	  _mm256_mullo_epi16(_mm256_sub_epi16(y, _mm256_set1_epi16(16)), _mm256_set1_epi16(kLuma));
+	u = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+	v = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+
+	r = finish(_mm256_adds_epi16(luma, _mm256_mullo_epi16(v, _mm256_set1_epi16(kRedV))));
+	g = finish(_mm256_subs_epi16(luma,
+	                             _mm256_add_epi16(_mm256_mullo_epi16(u, _mm256_set1_epi16(kGreenU)),
+	                                              _mm256_mullo_epi16(v, _mm256_set1_epi16(kGreenV)))));
+	b = finish(_mm256_adds_epi16(luma, _mm256_mullo_epi16(u, _mm256_set1_epi16(kBlueU))));
+}
+
+/**
+ * @brief Converts 32 pixels given as 8-bit Y and 16-bit U and V for pairs of pixels, and stores
+ *        them.
+ *
+ * The U and V of the pixels in each lane of Y are in the same lane.
+ */
+template<bool bgr>
+NEURALA_IMAGE_TARGET("avx2")
+inline void
+storeYuv(__m256i y, __m256i u, __m256i v, std::uint8_t* output) noexcept
+{
+	const auto zero = _mm256_setzero_si256();
+	__m256i r[2], g[2], b[2];
+	yuvToRgb(_mm256_unpacklo_epi8(y, zero),
+	         _mm256_unpacklo_epi16(u, u),
+	         _mm256_unpacklo_epi16(v, v),
+	         r[0],
+	         g[0],
+	         b[0]);
+	yuvToRgb(_mm256_unpackhi_epi8(y, zero),
+	         _mm256_unpackhi_epi16(u, u),
+	         _mm256_unpackhi_epi16(v, v),
+	         r[1],
+	         g[1],
+	         b[1]);
+
+	const auto red = _mm256_packus_epi16(r[0], r[1]);
+	const auto blue = _mm256_packus_epi16(b[0], b[1]);
+	store3(bgr ? blue : red, _mm256_packus_epi16(g[0], g[1]), bgr ? red : blue, output);
+}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+inline uint8x8_t
+finish(int16x8_t value) noexcept
+{
+	return vqshrun_n_s16(vqaddq_s16(value, vdupq_n_s16(1 << (kShift - 1))), kShift);
+}
+
+/// Converts 8 pixels given as 8-bit Y, U and V to 8-bit R, G and B.
+inline void
+yuvToRgb(uint8x8_t y, uint8x8_t u, uint8x8_t v, uint8x8_t& r, uint8x8_t& g, uint8x8_t& b) noexcept
+{
+	const auto y16 = vreinterpretq_s16_u16(vmovl_u8(y));
+	const auto luma = vmulq_n_s16(vsubq_s16(y16, vdupq_n_s16(16)), kLuma);
+	const auto u16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u)), vdupq_n_s16(128));
+	const auto v16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v)), vdupq_n_s16(128));
+
+	r = finish(vqaddq_s16(luma, vmulq_n_s16(v16, kRedV)));
+	g = finish(vqsubq_s16(luma, vaddq_s16(vmulq_n_s16(u16, kGreenU), vmulq_n_s16(v16, kGreenV))));
+	b = finish(vqaddq_s16(luma, vmulq_n_s16(u16, kBlueU)));
+}
+
+/// Converts 16 pixels given as 8-bit Y and 8-bit U and V for pairs of pixels, and stores them.
+template<bool bgr>
+inline void
+storeYuv(uint8x16_t y, uint8x8_t u, uint8x8_t v, std::uint8_t* output) noexcept
+{
+	const auto us = vzip_u8(u, u);
+	const auto vs = vzip_u8(v, v);
+	uint8x8_t r[2], g[2], b[2];
+	yuvToRgb(vget_low_u8(y), us.val[0], vs.val[0], r[0], g[0], b[0]);
+	yuvToRgb(vget_high_u8(y), us.val[1], vs.val[1], r[1], g[1], b[1]);
+
+	const auto red = vcombine_u8(r[0], r[1]);
+	const auto blue = vcombine_u8(b[0], b[1]);
+	vst3q_u8(output, uint8x16x3_t{{bgr ? blue : red, vcombine_u8(g[0], g[1]), bgr ? red : blue}});
+}
+#endif
+
+/**
+ * @brief Row kernel of a conversion.
+ *
+ * Kernels provide a scalar implementation converting from any pixel, and vector implementations
+ * returning the number of pixels they converted, the rest being left to the scalar one. The
+ * instruction sets a build lacks fall back to the scalar implementation, and are never selected.
+ */
+template<class Kernel, ESimd simd>
+void
+convertRow(Rows rows, std::size_t width, unsigned phase, std::uint8_t* output) noexcept
+{
+	std::size_t x = 0;
+
+#ifdef NEURALA_IMAGE_X86
+	if constexpr (simd == ESimd::sse41)
+	{
+		x = Kernel::sse41(rows, width, phase, output);
+	}
+	else if constexpr (simd == ESimd::avx2)
+	{
+		x = Kernel::avx2(rows, width, phase, output);
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	if constexpr (simd == ESimd::neon)
+	{
+		x = Kernel::neon(rows, width, phase, output);
+	}
+#endif
+
+	Kernel::scalar(rows, x, width, phase, output);
+}
+
+/// Swaps the first and third channels of 3-channel pixels.
+struct Swap3
+{
+	static void
+	scalar(Rows rows, std::size_t x, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		const auto input = rows[0];
+		for (; x < width; ++x)
+		{
+			output[3 * x] = input[3 * x + 2];
+			output[3 * x + 1] = input[3 * x + 1];
+			output[3 * x + 2] = input[3 * x];
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto input = rows[0] + 3 * x;
+			__m128i bytes[3];
+			for (auto k = 0; k < 3; ++k)
+			{
+				bytes[k] = loadBytes(input + 16 * k);
+			}
+
+			store3(extract3(bytes[0], bytes[1], bytes[2], 2),
+			       extract3(bytes[0], bytes[1], bytes[2], 1),
+			       extract3(bytes[0], bytes[1], bytes[2], 0),
+			       output + 3 * x);
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2")
+	static std::size_t
+	avx2(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 32 <= width; x += 32)
+		{
+			__m256i a, b, c;
+			load3(rows[0] + 3 * x, a, b, c);
+			store3(c, b, a, output + 3 * x);
+		}
+		return x;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			auto pixels = vld3q_u8(rows[0] + 3 * x);
+			std::swap(pixels.val[0], pixels.val[2]);
+			vst3q_u8(output + 3 * x, pixels);
+		}
+		return x;
+	}
+#endif
+};
+
+/// Swaps the first and third channels of 4-channel pixels, keeping or dropping the fourth one.
+template<bool swap, bool keepAlpha>
+struct Convert4
+{
+	static constexpr std::size_t kChannels = keepAlpha ? 4 : 3;
+
+	static void
+	scalar(Rows rows, std::size_t x, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		const auto input = rows[0];
+		for (; x < width; ++x)
+		{
+			output[kChannels * x] = input[4 * x + (swap ? 2 : 0)];
+			output[kChannels * x + 1] = input[4 * x + 1];
+			output[kChannels * x + 2] = input[4 * x + (swap ? 0 : 2)];
+			if constexpr (keepAlpha)
+			{
+				output[kChannels * x + 3] = input[4 * x + 3];
+			}
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		const auto shuffle = load(keepAlpha ? kSwap4 : swap ? kSwapDrop4 : kDrop4);
+		// Without alpha, 4 bytes past the 12 of each step are overwritten by the next one.
+		const std::size_t margin = keepAlpha ? 0 : 2;
+
+		std::size_t x = 0;
+		for (; x + 4 + margin <= width; x += 4)
+		{
+			const auto pixels = loadBytes(rows[0] + 4 * x);
+			storeBytes(output + kChannels * x, _mm_shuffle_epi8(pixels, shuffle));
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2")
+	static std::size_t
+	avx2(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		const auto shuffle = load256(keepAlpha ? kSwap4 : swap ? kSwapDrop4 : kDrop4);
+		// Packs the 12 bytes kept in each lane.
+		const auto pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+		// Without alpha, 8 bytes past the 24 of each step are overwritten by the next one.
+		const std::size_t margin = keepAlpha ? 0 : 3;
+
+		std::size_t x = 0;
+		for (; x + 8 + margin <= width; x += 8)
+		{
+			auto pixels = _mm256_shuffle_epi8(loadBytes256(rows[0] + 4 * x),
+			                                  shuffle);
+			if constexpr (!keepAlpha)
+			{
+				pixels = _mm256_permutevar8x32_epi32(pixels, pack);
+			}
+			storeBytes256(output + kChannels * x, pixels);
+		}
+		return x;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			auto pixels = vld4q_u8(rows[0] + 4 * x);
+			if constexpr (swap)
+			{
+				std::swap(pixels.val[0], pixels.val[2]);
+			}
+
+			if constexpr (keepAlpha)
+			{
+				vst4q_u8(output + 4 * x, pixels);
+			}
+			else
+			{
+				vst3q_u8(output + 3 * x, uint8x16x3_t{{pixels.val[0], pixels.val[1], pixels.val[2]}});
+			}
+		}
+		return x;
+	}
+#endif
+};
+
+/// Replicates grayscale pixels to 3 channels.
+struct Gray
+{
+	static void
+	scalar(Rows rows, std::size_t x, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		const auto input = rows[0];
+		for (; x < width; ++x)
+		{
+			output[3 * x] = output[3 * x + 1] = output[3 * x + 2] = input[x];
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto gray = loadBytes(rows[0] + x);
+			store3(gray, gray, gray, output + 3 * x);
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2")
+	static std::size_t
+	avx2(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 32 <= width; x += 32)
+		{
+			const auto gray = loadBytes256(rows[0] + x);
+			store3(gray, gray, gray, output + 3 * x);
+		}
+		return x;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto gray = vld1q_u8(rows[0] + x);
+			vst3q_u8(output + 3 * x, uint8x16x3_t{{gray, gray, gray}});
+		}
+		return x;
+	}
+#endif
+};
+
+/// Converts YUV 4:2:0 with planar chroma (I420) to RGB or BGR.
+template<bool bgr>
+struct Planar
+{
+	static void
+	scalar(Rows rows, std::size_t x, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			yuvPixel<bgr>(rows[0][x], rows[1][x / 2], rows[2][x / 2], output + 3 * x);
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto y = loadBytes(rows[0] + x);
+			const auto u = _mm_cvtepu8_epi16(loadHalf(rows[1] + x / 2));
+			const auto v = _mm_cvtepu8_epi16(loadHalf(rows[2] + x / 2));
+			storeYuv<bgr>(y, u, v, output + 3 * x);
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2")
+	static std::size_t
+	avx2(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 32 <= width; x += 32)
+		{
+			const auto y = loadBytes256(rows[0] + x);
+			const auto u = _mm256_cvtepu8_epi16(loadBytes(rows[1] + x / 2));
+			const auto v = _mm256_cvtepu8_epi16(loadBytes(rows[2] + x / 2));
+			storeYuv<bgr>(y, u, v, output + 3 * x);
+		}
+		return x;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			storeYuv<bgr>(vld1q_u8(rows[0] + x),
+			              vld1_u8(rows[1] + x / 2),
+			              vld1_u8(rows[2] + x / 2),
+			              output + 3 * x);
+		}
+		return x;
+	}
+#endif
+};
+
+/// Converts YUV 4:2:0 with interleaved chroma, U first (NV12) or V first (NV21), to RGB or BGR.
+template<bool bgr, bool vFirst>
+struct Semiplanar
+{
+	static void
+	scalar(Rows rows, std::size_t x, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			const auto chroma = rows[1] + x / 2 * 2;
+			yuvPixel<bgr>(rows[0][x], chroma[vFirst ? 1 : 0], chroma[vFirst ? 0 : 1], output + 3 * x);
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		const auto low = _mm_set1_epi16(0xff);
+
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto y = loadBytes(rows[0] + x);
+			const auto chroma = loadBytes(rows[1] + x);
+			const auto first = _mm_and_si128(chroma, low);
+			const auto second = _mm_srli_epi16(chroma, 8);
+			storeYuv<bgr>(y, vFirst ? second : first, vFirst ? first : second, output + 3 * x);
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2")
+	static std::size_t
+	avx2(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		const auto low = _mm256_set1_epi16(0xff);
+
+		std::size_t x = 0;
+		for (; x + 32 <= width; x += 32)
+		{
+			const auto y = loadBytes256(rows[0] + x);
+			const auto chroma = loadBytes256(rows[1] + x);
+			const auto first = _mm256_and_si256(chroma, low);
+			const auto second = _mm256_srli_epi16(chroma, 8);
+			storeYuv<bgr>(y, vFirst ? second : first, vFirst ? first : second, output + 3 * x);
+		}
+		return x;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto chroma = vld2_u8(rows[1] + x);
+			storeYuv<bgr>(vld1q_u8(rows[0] + x),
+			              chroma.val[vFirst ? 1 : 0],
+			              chroma.val[vFirst ? 0 : 1],
+			              output + 3 * x);
+		}
+		return x;
+	}
+#endif
+};
+
+/// Converts packed YUV 4:2:2 (YUY2) to RGB or BGR.
+template<bool bgr>
+struct Packed
+{
+	static void
+	scalar(Rows rows, std::size_t x, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			const auto pair = rows[0] + x / 2 * 4;
+			yuvPixel<bgr>(rows[0][2 * x], pair[1], pair[3], output + 3 * x);
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		const auto low = _mm_set1_epi16(0xff);
+		const auto duplicateU = load(kDuplicateU);
+		const auto duplicateV = load(kDuplicateV);
+
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			__m128i r[2], g[2], b[2];
+			for (auto half = 0; half < 2; ++half)
+			{
+				const auto pixels = loadBytes(rows[0] + 2 * x + 16 * half);
+				const auto chroma = _mm_srli_epi16(pixels, 8);
+				yuvToRgb(_mm_and_si128(pixels, low),
+				         _mm_shuffle_epi8(chroma, duplicateU),
+				         _mm_shuffle_epi8(chroma, duplicateV),
+				         r[half],
+				         g[half],
+				         b[half]);
+			}
+
+			const auto red = _mm_packus_epi16(r[0], r[1]);
+			const auto blue = _mm_packus_epi16(b[0], b[1]);
+			store3(bgr ? blue : red, _mm_packus_epi16(g[0], g[1]), bgr ? red : blue, output + 3 * x);
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2")
+	static std::size_t
+	avx2(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		const auto low = _mm256_set1_epi16(0xff);
+		const auto duplicateU = load256(kDuplicateU);
+		const auto duplicateV = load256(kDuplicateV);
+
+		std::size_t x = 0;
+		for (; x + 32 <= width; x += 32)
+		{
+			__m256i r[2], g[2], b[2];
+			for (auto half = 0; half < 2; ++half)
+			{
+				const auto pixels = loadBytes256(rows[0] + 2 * x + 32 * half);
+				const auto chroma = _mm256_srli_epi16(pixels, 8);
+				yuvToRgb(_mm256_and_si256(pixels, low),
+				         _mm256_shuffle_epi8(chroma, duplicateU),
+				         _mm256_shuffle_epi8(chroma, duplicateV),
+				         r[half],
+				         g[half],
+				         b[half]);
+			}
+
+			const auto red = packInOrder(r[0], r[1]);
+			const auto blue = packInOrder(b[0], b[1]);
+			store3(bgr ? blue : red, packInOrder(g[0], g[1]), bgr ? red : blue, output + 3 * x);
+		}
+		return x;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(Rows rows, std::size_t width, unsigned, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			// Even luma, U, odd luma and V.
+			const auto pixels = vld4_u8(rows[0] + 2 * x);
+			uint8x8x2_t r, g, b;
+			yuvToRgb(pixels.val[0], pixels.val[1], pixels.val[3], r.val[0], g.val[0], b.val[0]);
+			yuvToRgb(pixels.val[2], pixels.val[1], pixels.val[3], r.val[1], g.val[1], b.val[1]);
+
+			const auto interleave = [](uint8x8x2_t channel) {
+				const auto pixels = vzip_u8(channel.val[0], channel.val[1]);
+				return vcombine_u8(pixels.val[0], pixels.val[1]);
+			};
+			const auto red = interleave(r);
+			const auto blue = interleave(b);
+			vst3q_u8(output + 3 * x, uint8x16x3_t{{bgr ? blue : red, interleave(g), bgr ? red : blue}});
+		}
+		return x;
+	}
+#endif
+};
+
+/**
+ * @brief Interpolates Bayer mosaics to RGB or BGR, bilinearly.
+ *
+ * Each row is computed from the previous and next ones, the borders being mirrored so that the
+ * neighbors of a photosite keep their colors. Averages of 4 photosites are rounded as averages of
+ * averages of 2, as vector instructions do.
+ */
+template<bool bgr>
+struct Bayer
+{
+	/// Computes a pixel of a row whose phase tells if it has red photosites and where green is.
+	static void
+	pixel(Rows rows, std::size_t x, std::size_t width, unsigned phase, std::uint8_t* output) noexcept
+	{
+		const auto up = rows[0];
+		const auto row = rows[1];
+		const auto down = rows[2];
+		const auto left = x ? x - 1 : 1;
+		const auto right = x + 1 < width ? x + 1 : x - 1;
+
+		const auto horizontal = average(row[left], row[right]);
+		const auto vertical = average(up[x], down[x]);
+		const auto diagonal = average(average(up[left], up[right]), average(down[left], down[right]));
+		const auto cross = average(horizontal, vertical);
+
+		const auto green = (x & 1) == (phase & 1);
+		// Red on rows of red photosites, blue otherwise.
+		const auto first = green ? horizontal : row[x];
+		const auto second = green ? vertical : diagonal;
+		const auto red = phase & 2 ? first : second;
+		const auto blue = phase & 2 ? second : first;
+
+		output[3 * x + (bgr ? 2 : 0)] = red;
+		output[3 * x + 1] = green ? row[x] : cross;
+		output[3 * x + (bgr ? 0 : 2)] = blue;
+	}
+
+	static void
+	scalar(Rows rows, std::size_t x, std::size_t width, unsigned phase, std::uint8_t* output) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			pixel(rows, x, width, phase, output);
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(Rows rows, std::size_t width, unsigned phase, std::uint8_t* output) noexcept
+	{
+		pixel(rows, 0, width, phase, output);
+
+		// Vectors start at an odd pixel.
+		const auto green = loadBytes(kAlternate + (phase & 1));
+
+		std::size_t x = 1;
+		for (; x + 17 <= width; x += 16)
+		{
+			const auto up = rows[0] + x;
+			const auto row = rows[1] + x;
+			const auto down = rows[2] + x;
+
+			const auto center = loadBytes(row);
+			const auto horizontal = _mm_avg_epu8(loadBytes(row - 1), loadBytes(row + 1));
+			const auto vertical = _mm_avg_epu8(loadBytes(up), loadBytes(down));
+			const auto diagonal = _mm_avg_epu8(_mm_avg_epu8(loadBytes(up - 1), loadBytes(up + 1)),
+			                                   _mm_avg_epu8(loadBytes(down - 1), loadBytes(down + 1)));
+			const auto cross = _mm_avg_epu8(horizontal, vertical);
+
+			const auto first = _mm_blendv_epi8(center, horizontal, green);
+			const auto second = _mm_blendv_epi8(diagonal, vertical, green);
+			const auto red = phase & 2 ? first : second;
+			const auto blue = phase & 2 ? second : first;
+			const auto middle = _mm_blendv_epi8(cross, center, green);
+			store3(bgr ? blue : red, middle, bgr ? red : blue, output + 3 * x);
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2")
+	static std::size_t
+	avx2(Rows rows, std::size_t width, unsigned phase, std::uint8_t* output) noexcept
+	{
+		pixel(rows, 0, width, phase, output);
+
+		const auto green = loadBytes256(kAlternate + (phase & 1));
+
+		std::size_t x = 1;
+		for (; x + 33 <= width; x += 32)
+		{
+			const auto up = rows[0] + x;
+			const auto row = rows[1] + x;
+			const auto down = rows[2] + x;
+
+			const auto center = loadBytes256(row);
+			const auto horizontal = _mm256_avg_epu8(loadBytes256(row - 1), loadBytes256(row + 1));
+			const auto vertical = _mm256_avg_epu8(loadBytes256(up), loadBytes256(down));
+			const auto diagonal =
+			  _mm256_avg_epu8(_mm256_avg_epu8(loadBytes256(up - 1), loadBytes256(up + 1)),
+			                  _mm256_avg_epu8(loadBytes256(down - 1), loadBytes256(down + 1)));
+			const auto cross = _mm256_avg_epu8(horizontal, vertical);
+
+			const auto first = _mm256_blendv_epi8(center, horizontal, green);
+			const auto second = _mm256_blendv_epi8(diagonal, vertical, green);
+			const auto red = phase & 2 ? first : second;
+			const auto blue = phase & 2 ? second : first;
+			const auto middle = _mm256_blendv_epi8(cross, center, green);
+			store3(bgr ? blue : red, middle, bgr ? red : blue, output + 3 * x);
+		}
+		return x;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(Rows rows, std::size_t width, unsigned phase, std::uint8_t* output) noexcept
+	{
+		pixel(rows, 0, width, phase, output);
+
+		const auto green = vld1q_u8(kAlternate + (phase & 1));
+
+		std::size_t x = 1;
+		for (; x + 17 <= width; x += 16)
+		{
+			const auto up = rows[0] + x;
+			const auto row = rows[1] + x;
+			const auto down = rows[2] + x;
+
+			const auto center = vld1q_u8(row);
+			const auto horizontal = vrhaddq_u8(vld1q_u8(row - 1), vld1q_u8(row + 1));
+			const auto vertical = vrhaddq_u8(vld1q_u8(up), vld1q_u8(down));
+			const auto diagonal = vrhaddq_u8(vrhaddq_u8(vld1q_u8(up - 1), vld1q_u8(up + 1)),
+			                                 vrhaddq_u8(vld1q_u8(down - 1), vld1q_u8(down + 1)));
+			const auto cross = vrhaddq_u8(horizontal, vertical);
+
+			const auto first = vbslq_u8(green, horizontal, center);
+			const auto second = vbslq_u8(green, vertical, diagonal);
+			const auto red = phase & 2 ? first : second;
+			const auto blue = phase & 2 ? second : first;
+			const auto middle = vbslq_u8(green, center, cross);
+			vst3q_u8(output + 3 * x, uint8x16x3_t{{bgr ? blue : red, middle, bgr ? red : blue}});
+		}
+		return x;
+	}
+#endif
+};
+
+/// Kernels of a conversion, indexed by instruction set.
+using Kernels = std::array<RowKernel, 4>;
+
+template<class Kernel>
+constexpr Kernels
+kernels() noexcept
+{
+	return {convertRow<Kernel, ESimd::scalar>,
+	        convertRow<Kernel, ESimd::sse41>,
+	        convertRow<Kernel, ESimd::avx2>,
+	        convertRow<Kernel, ESimd::neon>};
+}
+
+struct Conversion
+{
+	EColorSpace from;
+	EColorSpace to;
+	ERows rows;
+	Kernels kernels;
+};
+
+const Conversion kConversions[] = {
+  {EColorSpace::RGB, EColorSpace::BGR, ERows::single, kernels<Swap3>()},
+  {EColorSpace::BGR, EColorSpace::RGB, ERows::single, kernels<Swap3>()},
+  {EColorSpace::RGBA, EColorSpace::BGRA, ERows::single, kernels<Convert4<true, true>>()},
+  {EColorSpace::BGRA, EColorSpace::RGBA, ERows::single, kernels<Convert4<true, true>>()},
+  {EColorSpace::RGBA, EColorSpace::RGB, ERows::single, kernels<Convert4<false, false>>()},
+  {EColorSpace::RGBA, EColorSpace::BGR, ERows::single, kernels<Convert4<true, false>>()},
+  {EColorSpace::BGRA, EColorSpace::BGR, ERows::single, kernels<Convert4<false, false>>()},
+  {EColorSpace::BGRA, EColorSpace::RGB, ERows::single, kernels<Convert4<true, false>>()},
+  {EColorSpace::grayscale, EColorSpace::RGB, ERows::single, kernels<Gray>()},
+  {EColorSpace::grayscale, EColorSpace::BGR, ERows::single, kernels<Gray>()},
+  {EColorSpace::YUV420, EColorSpace::RGB, ERows::planar420, kernels<Planar<false>>()},
+  {EColorSpace::YUV420, EColorSpace::BGR, ERows::planar420, kernels<Planar<true>>()},
+  {EColorSpace::NV12, EColorSpace::RGB, ERows::semiplanar420, kernels<Semiplanar<false, false>>()},
+  {EColorSpace::NV12, EColorSpace::BGR, ERows::semiplanar420, kernels<Semiplanar<true, false>>()},
+  {EColorSpace::NV21, EColorSpace::RGB, ERows::semiplanar420, kernels<Semiplanar<false, true>>()},
+  {EColorSpace::NV21, EColorSpace::BGR, ERows::semiplanar420, kernels<Semiplanar<true, true>>()},
+  {EColorSpace::YUV422, EColorSpace::RGB, ERows::single, kernels<Packed<false>>()},
+  {EColorSpace::YUV422, EColorSpace::BGR, ERows::single, kernels<Packed<true>>()},
+  {EColorSpace::bayerRG, EColorSpace::RGB, ERows::neighbors, kernels<Bayer<false>>()},
+  {EColorSpace::bayerRG, EColorSpace::BGR, ERows::neighbors, kernels<Bayer<true>>()},
+  {EColorSpace::bayerGR, EColorSpace::RGB, ERows::neighbors, kernels<Bayer<false>>()},
+  {EColorSpace::bayerGR, EColorSpace::BGR, ERows::neighbors, kernels<Bayer<true>>()},
+  {EColorSpace::bayerBG, EColorSpace::RGB, ERows::neighbors, kernels<Bayer<false>>()},
+  {EColorSpace::bayerBG, EColorSpace::BGR, ERows::neighbors, kernels<Bayer<true>>()},
+  {EColorSpace::bayerGB, EColorSpace::RGB, ERows::neighbors, kernels<Bayer<false>>()},
+  {EColorSpace::bayerGB, EColorSpace::BGR, ERows::neighbors, kernels<Bayer<true>>()}};
+
+const Conversion*
+findConversion(const PixelFormat& from, EColorSpace to) noexcept
+{
+	if (from.datatype() != EDatatype::uint8)
+	{
+		return nullptr;
+	}
+
+	const auto matches = [&](const Conversion& conversion) {
+		return conversion.from == from.colorSpace() && conversion.to == to;
+	};
+	const auto conversion = std::find_if(std::begin(kConversions), std::end(kConversions), matches);
+	if (conversion == std::end(kConversions))
+	{
+		return nullptr;
+	}
+
+	// Planar RGB, or YUV 4:2:0 described with another layout, are not supported.
+	const std::size_t planes = conversion->rows == ERows::planar420       ? 3
+	                           : conversion->rows == ERows::semiplanar420 ? 2
+	                                                                      : 1;
+	return from.planes() == planes ? conversion : nullptr;
+}
+
+/**
+ * @brief Returns the phase of the first row of a Bayer mosaic: bit 0 is the parity of the
+ *        columns of its green photosites, bit 1 is set if its other photosites are red.
+ */
+unsigned
+bayerPhase(EColorSpace colorSpace) noexcept
+{
+	switch (colorSpace)
+	{
+		case EColorSpace::bayerRG:
+			return 3;
+		case EColorSpace::bayerGR:
+			return 2;
+		case EColorSpace::bayerBG:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+/// Returns if @p colorSpace has 4 channels, the only other output color spaces having 3.
+bool
+hasAlpha(EColorSpace colorSpace) noexcept
+{
+	return colorSpace == EColorSpace::RGBA || colorSpace == EColorSpace::BGRA;
+}
+} // namespace
+
+PixelFormat
+convertedFormat(const PixelFormat& from, EColorSpace colorSpace) noexcept
+{
+	const auto identity = from.datatype() == EDatatype::uint8 && from.colorSpace() == colorSpace
+	                      && from.planes() == 1
+	                      && (colorSpace == EColorSpace::RGB || colorSpace == EColorSpace::BGR
+	                          || hasAlpha(colorSpace));
+
+	if (!identity && !findConversion(from, colorSpace))
+	{
+		return {};
+	}
+
+	return {EDatatype::uint8, colorSpace, ELayout::interleaved, from.orientation()};
+}
+
+dto::ImageView
+convertColor(const StridedImageView& source,
+             EColorSpace colorSpace,
+             std::byte* data,
+             std::size_t size,
+             ESimd simd) noexcept
+{
+	const auto format = convertedFormat(source.format(), colorSpace);
+	const auto width = source.width();
+	const auto height = source.height();
+
+	if (format.colorSpace() == EColorSpace::unknown || source.empty() || !data
+	    || size < format.frameBytes(width, height))
+	{
+		return {};
+	}
+
+	if (source.format().colorSpace() == colorSpace)
+	{
+		return source.copyTo(data, size);
+	}
+
+	const auto conversion = findConversion(source.format(), colorSpace);
+	// Mirroring the borders of Bayer mosaics needs two rows and columns.
+	if (conversion->rows == ERows::neighbors && (width < 2 || height < 2))
+	{
+		return {};
+	}
+
+	const auto kernel = conversion->kernels[static_cast<std::size_t>(supportedSimd(simd))];
+	const auto rowBytes = width * (hasAlpha(colorSpace) ? 4 : 3);
+	const auto plane = [&](std::size_t i, std::size_t y) {
+		return reinterpret_cast<const std::uint8_t*>(source.plane(i).row(y));
+	};
+	const auto firstPhase = bayerPhase(source.format().colorSpace());
+	auto output = reinterpret_cast<std::uint8_t*>(data);
+
+	for (std::size_t y = 0; y < height; ++y, output += rowBytes)
+	{
+		const std::uint8_t* rows[3]{};
+		unsigned phase = 0;
+
+		switch (conversion->rows)
+		{
+			case ERows::single:
+				rows[0] = plane(0, y);
+				break;
+			case ERows::planar420:
+				rows[0] = plane(0, y);
+				rows[1] = plane(1, y / 2);
+				rows[2] = plane(2, y / 2);
+				break;
+			case ERows::semiplanar420:
+				rows[0] = plane(0, y);
+				rows[1] = plane(1, y / 2);
+				break;
+			case ERows::neighbors:
+				rows[0] = plane(0, y ? y - 1 : 1);
+				rows[1] = plane(0, y);
+				rows[2] = plane(0, y + 1 < height ? y + 1 : y - 1);
+				// Each row swaps the colors, and the parity of the green photosites.
+				phase = firstPhase ^ (y & 1 ? 3 : 0);
+				break;
+		}
+
+		kernel(rows, width, phase, output);
+	}
+
+	return {format.metadata(width, height), data};
+}
+
+} // namespace neurala
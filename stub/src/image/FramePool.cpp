@@ -0,0 +1,522 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <string_view>
+
+#include "neurala/config/os.h"
+#include "neurala/image/FramePool.h"
+#include "neurala/image/PixelFormat.h"
+
+#if defined(NEURALA_OS_LINUX) || defined(NEURALA_OS_APPLE)
+#include <sys/mman.h>
+#endif
+
+namespace neurala
+{
+namespace
+{
+// Buffers of up to 4 KiB are of the first class; classes go on by four per power of two.
+constexpr unsigned kMinimumShift = 12;
+constexpr unsigned kMaximumShift = 40;
+constexpr std::size_t kClasses = (kMaximumShift - kMinimumShift) * 4 + 1;
+constexpr std::size_t kLargeBuffer = 64 * 1024;
+
+/// Returns the size class of frames of @p bytes bytes, or kClasses if they are too large.
+std::size_t
+sizeClass(std::size_t bytes) noexcept
+{
+	if (bytes <= (std::size_t(1) << kMinimumShift))
+	{
+		return 0;
+	}
+
+	if (bytes > (std::size_t(1) << kMaximumShift))
+	{
+		return kClasses;
+	}
+
+	const auto shift = static_cast<unsigned>(std::bit_width(bytes - 1) - 1);
+	const auto quarter = (std::size_t(1) << shift) / 4;
+	const auto quarters = (bytes - (std::size_t(1) << shift) + quarter - 1) / quarter;
+	return (shift - kMinimumShift) * 4 + quarters;
+}
+
+/// Returns the size of the buffers of size class @p sizeClass.
+std::size_t
+classCapacity(std::size_t sizeClass) noexcept
+{
+	if (sizeClass == 0)
+	{
+		return std::size_t(1) << kMinimumShift;
+	}
+
+	const auto shift = kMinimumShift + static_cast<unsigned>((sizeClass - 1) / 4);
+	const auto quarters = (sizeClass - 1) % 4 + 1;
+	return (std::size_t(1) << shift) + quarters * ((std::size_t(1) << shift) / 4);
+}
+
+/// Returns if environment variable @p name is set to 1.
+bool
+isEnabled(const char* name) noexcept
+{
+	const auto value = std::getenv(name);
+	return value && std::string_view(value) == "1";
+}
+
+/// Returns the settings of the shared pool, from the environment.
+FramePool::Settings
+sharedSettings() noexcept
+{
+	FramePool::Settings settings;
+	settings.hugePages = isEnabled("NEURALA_FRAME_POOL_HUGE_PAGES");
+	settings.lock = isEnabled("NEURALA_FRAME_POOL_LOCK");
+
+	const auto retained = std::getenv("NEURALA_FRAME_POOL_RETAINED");
+	const auto buffers = retained ? std::atoi(retained) : 0;
+	if (buffers > 0)
+	{
+		settings.retained = static_cast<std::size_t>(buffers);
+	}
+
+	return settings;
+}
+
+const dto::ImageMetadata kNoMetadata;
+} // namespace
+
+struct SharedFrame::Block
+{
+	Block(FramePool& pool, std::size_t sizeClass, std::size_t capacity, std::size_t alignment)
+	 : pool{pool},
+	   sizeClass{sizeClass},
+	   capacity{capacity},
+	   alignment{alignment},
+	   data{static_cast<std::byte*>(::operator new(capacity, std::align_val_t{alignment}))}
+	{ }
+
+	~Block() noexcept
+	{
+#if defined(NEURALA_OS_LINUX) || defined(NEURALA_OS_APPLE)
+		if (locked)
+		{
+			::munlock(data, capacity);
+		}
+#endif
+		::operator delete(data, std::align_val_t{alignment});
+	}
+
+	Block(const Block&) = delete;
+	Block& operator=(const Block&) = delete;
+
+	FramePool& pool;
+	const std::size_t sizeClass;
+	const std::size_t capacity;
+	const std::size_t alignment;
+	std::byte* const data;
+	bool locked = false;
+	std::atomic<std::size_t> references{0};
+	std::size_t size = 0;
+	dto::ImageMetadata metadata;
+};
+
+/**
+ * @brief Bounded lock-free list of the free buffers of a size class, which several threads may
+ *        feed and empty.
+ */
+class FramePool::FreeList
+{
+public:
+	void reserve(std::size_t capacity)
+	{
+		m_slots = std::make_unique<Slot[]>(capacity);
+		m_capacity = capacity;
+		for (std::size_t i = 0; i < capacity; ++i)
+		{
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	/// Adds @p block to the list, and returns false if the list is full.
+	bool push(SharedFrame::Block* block) noexcept
+	{
+		auto position = m_pushPosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			auto& slot = m_slots[position % m_capacity];
+			const auto sequence = slot.sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+			if (difference < 0)
+			{
+				return false;
+			}
+
+			if (difference > 0)
+			{
+				position = m_pushPosition.load(std::memory_order_relaxed);
+			}
+			else if (m_pushPosition.compare_exchange_weak(position, position + 1,
+			                                              std::memory_order_relaxed))
+			{
+				slot.block = block;
+				slot.sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+	}
+
+	/// Takes a block from the list, or returns null if the list is empty.
+	SharedFrame::Block* pop() noexcept
+	{
+		auto position = m_popPosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			auto& slot = m_slots[position % m_capacity];
+			const auto sequence = slot.sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+			if (difference < 0)
+			{
+				return nullptr;
+			}
+
+			if (difference > 0)
+			{
+				position = m_popPosition.load(std::memory_order_relaxed);
+			}
+			else if (m_popPosition.compare_exchange_weak(position, position + 1,
+			                                             std::memory_order_relaxed))
+			{
+				const auto block = slot.block;
+				slot.sequence.store(position + m_capacity, std::memory_order_release);
+				return block;
+			}
+		}
+	}
+
+private:
+	struct Slot
+	{
+		// Position of the block the slot expects next, plus one once it holds it.
+		std::atomic<std::size_t> sequence{0};
+		SharedFrame::Block* block = nullptr;
+	};
+
+	std::unique_ptr<Slot[]> m_slots;
+	std::size_t m_capacity = 0;
+
+	alignas(64) std::atomic<std::size_t> m_pushPosition{0};
+	alignas(64) std::atomic<std::size_t> m_popPosition{0};
+};
+
+SharedFrame::SharedFrame(const SharedFrame& other) noexcept : m_block{other.m_block}
+{
+	if (m_block)
+	{
+		m_block->references.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+SharedFrame::~SharedFrame() noexcept
+{
+	if (m_block && m_block->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		m_block->pool.recycle(*m_block);
+	}
+}
+
+const dto::ImageMetadata&
+SharedFrame::metadata() const noexcept
+{
+	return m_block ? m_block->metadata : kNoMetadata;
+}
+
+const std::byte*
+SharedFrame::data() const noexcept
+{
+	return m_block ? m_block->data : nullptr;
+}
+
+std::size_t
+SharedFrame::size() const noexcept
+{
+	return m_block ? m_block->size : 0;
+}
+
+std::size_t
+SharedFrame::capacity() const noexcept
+{
+	return m_block ? m_block->capacity : 0;
+}
+
+std::size_t
+SharedFrame::useCount() const noexcept
+{
+	return m_block ? m_block->references.load(std::memory_order_acquire) : 0;
+}
+
+std::byte*
+SharedFrame::write()
+{
+	if (!m_block)
+	{
+		return nullptr;
+	}
+
+	if (m_block->references.load(std::memory_order_acquire) > 1)
+	{
+		auto copy = m_block->pool.allocate(m_block->metadata, m_block->size);
+		std::memcpy(copy.m_block->data, m_block->data, m_block->size);
+		*this = std::move(copy);
+	}
+
+	return m_block->data;
+}
+
+bool
+SharedFrame::describe(const dto::ImageMetadata& metadata, std::size_t bytes)
+{
+	if (!m_block || bytes == 0 || bytes > m_block->capacity)
+	{
+		return false;
+	}
+
+	// A copy of the frame may only have room for its current size.
+	write();
+	if (bytes > m_block->capacity)
+	{
+		return false;
+	}
+
+	m_block->metadata = metadata;
+	m_block->size = bytes;
+	return true;
+}
+
+FramePool::FramePool() : FramePool(Settings{}) { }
+
+FramePool::FramePool(const Settings& settings)
+ : m_settings{settings}, m_free{std::make_unique<FreeList[]>(kClasses)}
+{
+	for (std::size_t i = 0; i < kClasses; ++i)
+	{
+		m_free[i].reserve(std::max<std::size_t>(settings.retained, 1));
+	}
+}
+
+FramePool::~FramePool() noexcept
+{
+	for (const auto& [data, block] : m_data)
+	{
+		delete block;
+	}
+}
+
+FramePool&
+FramePool::shared() noexcept
+{
+	static auto* const pool = new FramePool(sharedSettings());
+	return *pool;
+}
+
+SharedFrame
+FramePool::allocate(const dto::ImageMetadata& metadata)
+{
+	const auto bytes =
+	  PixelFormat::fromMetadata(metadata).frameBytes(metadata.width(), metadata.height());
+	return allocate(metadata, bytes);
+}
+
+SharedFrame
+FramePool::allocate(const dto::ImageMetadata& metadata, std::size_t bytes)
+{
+	if (bytes == 0)
+	{
+		return {};
+	}
+
+	const auto index = sizeClass(bytes);
+	if (index == kClasses)
+	{
+		throw std::bad_alloc();
+	}
+
+	auto* block = m_free[index].pop();
+	if (!block)
+	{
+		block = create(index);
+	}
+
+	try
+	{
+		block->metadata = metadata;
+	}
+	catch (...)
+	{
+		recycle(*block);
+		throw;
+	}
+
+	block->size = bytes;
+	// Released for find(), which may take the frame as soon as its address is handed out.
+	block->references.store(1, std::memory_order_release);
+	return SharedFrame(block);
+}
+
+SharedFrame::Block*
+FramePool::create(std::size_t sizeClass)
+{
+	const auto bytes = capacity(classCapacity(sizeClass));
+	const auto alignment = m_settings.hugePages && bytes >= kHugePageAlignment ? kHugePageAlignment
+	                       : bytes >= kLargeBuffer                             ? kPageAlignment
+	                                                                           : kAlignment;
+
+	auto block = std::make_unique<SharedFrame::Block>(*this, sizeClass, bytes, alignment);
+
+#if defined(NEURALA_OS_LINUX) && defined(MADV_HUGEPAGE)
+	if (alignment == kHugePageAlignment)
+	{
+		// Only a hint: the kernel may not support transparent huge pages, or have them disabled.
+		::madvise(block->data, bytes, MADV_HUGEPAGE);
+	}
+#endif
+
+#if defined(NEURALA_OS_LINUX) || defined(NEURALA_OS_APPLE)
+	if (m_settings.lock)
+	{
+		block->locked = ::mlock(block->data, bytes) == 0;
+	}
+#endif
+
+	{
+		std::unique_lock lock(m_mutex);
+		m_data.emplace(block->data, block.get());
+	}
+
+	m_allocations.fetch_add(1, std::memory_order_relaxed);
+	return block.release();
+}
+
+void
+FramePool::destroy(SharedFrame::Block* block) noexcept
+{
+	{
+		std::unique_lock lock(m_mutex);
+		m_data.erase(block->data);
+	}
+
+	delete block;
+}
+
+SharedFrame
+FramePool::find(const void* data) const noexcept
+{
+	if (!data)
+	{
+		return {};
+	}
+
+	std::shared_lock lock(m_mutex);
+
+	const auto i = m_data.find(data);
+	if (i == m_data.end())
+	{
+		return {};
+	}
+
+	// Frames gone back to the pool are not referred to anymore, even if their buffer is still there.
+	auto& references = i->second->references;
+	auto count = references.load(std::memory_order_relaxed);
+	do
+	{
+		if (count == 0)
+		{
+			return {};
+		}
+	} while (!references.compare_exchange_weak(count, count + 1,
+	                                           std::memory_order_acquire,
+	                                           std::memory_order_relaxed));
+
+	return SharedFrame(i->second);
+}
+
+SharedFrame
+FramePool::share(const dto::ImageView& view)
+{
+	if (!view.data())
+	{
+		return {};
+	}
+
+	if (auto frame = find(view.data()); frame && frame.metadata() == view.metadata())
+	{
+		return frame;
+	}
+
+	auto frame = allocate(view.metadata());
+	if (frame)
+	{
+		std::memcpy(frame.write(), view.data(), frame.size());
+	}
+	return frame;
+}
+
+std::size_t
+FramePool::capacity(std::size_t bytes) const noexcept
+{
+	const auto index = sizeClass(bytes);
+	if (bytes == 0 || index == kClasses)
+	{
+		return 0;
+	}
+
+	// Buffers backed by huge pages are made of whole ones.
+	const auto size = classCapacity(index);
+	if (m_settings.hugePages && size >= kHugePageAlignment)
+	{
+		return (size + kHugePageAlignment - 1) / kHugePageAlignment * kHugePageAlignment;
+	}
+	return size;
+}
+
+std::size_t
+FramePool::buffers() const
+{
+	std::shared_lock lock(m_mutex);
+	return m_data.size();
+}
+
+void
+FramePool::recycle(SharedFrame::Block& block) noexcept
+{
+	if (!m_free[block.sizeClass].push(&block))
+	{
+		destroy(&block);
+	}
+}
+
+} // namespace neurala
@@ -0,0 +1,695 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "neurala/image/Orientation.h"
+
+#include "SimdTarget.h"
+#include "Vector.h"
+
+namespace neurala
+{
+namespace
+{
+using namespace detail;
+
+using Rows = const std::uint8_t* const*;
+using OutputRows = std::uint8_t* const*;
+
+using MirrorKernel = void (*)(std::size_t width, const std::uint8_t* input, std::uint8_t* output);
+using TransposeKernel = void (*)(Rows rows, OutputRows outputs);
+
+/// Side of the blocks of pixels transposed by the kernels.
+constexpr std::size_t kBlock = 8;
+
+/// Side of the tiles of pixels transposed together, whose rows stay in the L1 cache.
+constexpr std::size_t kTile = 32;
+
+/// Returns the shuffle reversing the order of the pixels of @p bytes bytes in a register.
+constexpr ByteShuffle
+reverse(int bytes) noexcept
+{
+	ByteShuffle shuffle{};
+	for (auto j = 0; j < 16; ++j)
+	{
+		shuffle.bytes[j] = static_cast<std::int8_t>((16 / bytes - 1 - j / bytes) * bytes + j % bytes);
+	}
+	return shuffle;
+}
+
+/**
+ * @brief Returns the shuffles reversing the order of 16 pixels of 3 bytes in 3 registers, building
+ *        the output register k from the input register m at 3 * k + m.
+ */
+constexpr std::array<ByteShuffle, 9>
+reverse3() noexcept
+{
+	std::array<ByteShuffle, 9> shuffles{};
+	for (auto k = 0; k < 3; ++k)
+	{
+		for (auto m = 0; m < 3; ++m)
+		{
+			for (auto j = 0; j < 16; ++j)
+			{
+				const auto byte = 16 * k + j;
+				const auto source = (15 - byte / 3) * 3 + byte % 3;
+				shuffles[3 * k + m].bytes[j] = static_cast<std::int8_t>(source / 16 == m ? source % 16 : -128);
+			}
+		}
+	}
+	return shuffles;
+}
+
+constexpr ByteShuffle kReverse[] = {reverse(1), reverse(2), reverse(4), reverse(8)};
+constexpr auto kReverse3 = reverse3();
+
+/// Reverses the order of the pixels of @p bytes bytes of a row.
+template<std::size_t bytes>
+struct Mirror
+{
+	static void
+	scalar(std::size_t x, std::size_t width, const std::uint8_t* input, std::uint8_t* output) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			std::memcpy(output + x * bytes, input + (width - 1 - x) * bytes, bytes);
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t width, const std::uint8_t* input, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+
+		if constexpr (bytes == 3)
+		{
+			for (; x + 16 <= width; x += 16)
+			{
+				const auto source = input + (width - x - 16) * 3;
+				const __m128i pixels[3] = {
+				  loadBytes(source), loadBytes(source + 16), loadBytes(source + 32)};
+
+				for (auto k = 0; k < 3; ++k)
+				{
+					auto reversed = _mm_setzero_si128();
+					for (auto m = 0; m < 3; ++m)
+					{
+						reversed = _mm_or_si128(reversed, _mm_shuffle_epi8(pixels[m], load(kReverse3[3 * k + m])));
+					}
+					storeBytes(output + 3 * x + 16 * k, reversed);
+				}
+			}
+		}
+		else if constexpr (bytes == 1 || bytes == 2 || bytes == 4 || bytes == 8)
+		{
+			constexpr auto n = 16 / bytes;
+			const auto shuffle = load(kReverse[bytes == 8 ? 3 : bytes / 2]);
+			for (; x + n <= width; x += n)
+			{
+				const auto pixels = loadBytes(input + (width - x - n) * bytes);
+				storeBytes(output + x * bytes, _mm_shuffle_epi8(pixels, shuffle));
+			}
+		}
+
+		return x;
+	}
+
+	// Flips are bound by memory accesses, AVX2 brings nothing over SSE4.1.
+	NEURALA_IMAGE_TARGET("avx2")
+	static std::size_t
+	avx2(std::size_t width, const std::uint8_t* input, std::uint8_t* output) noexcept
+	{
+		return sse41(width, input, output);
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	/// Reverses the order of the pixels in a register.
+	static uint8x16_t
+	reversed(uint8x16_t pixels) noexcept
+	{
+		if constexpr (bytes == 1)
+		{
+			pixels = vrev64q_u8(pixels);
+		}
+		else if constexpr (bytes == 2)
+		{
+			pixels = vreinterpretq_u8_u16(vrev64q_u16(vreinterpretq_u16_u8(pixels)));
+		}
+		else if constexpr (bytes == 4)
+		{
+			pixels = vreinterpretq_u8_u32(vrev64q_u32(vreinterpretq_u32_u8(pixels)));
+		}
+		return vcombine_u8(vget_high_u8(pixels), vget_low_u8(pixels));
+	}
+
+	static std::size_t
+	neon(std::size_t width, const std::uint8_t* input, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+
+		if constexpr (bytes == 3)
+		{
+			for (; x + 16 <= width; x += 16)
+			{
+				auto pixels = vld3q_u8(input + (width - x - 16) * 3);
+				for (auto c = 0; c < 3; ++c)
+				{
+					pixels.val[c] = Mirror<1>::reversed(pixels.val[c]);
+				}
+				vst3q_u8(output + 3 * x, pixels);
+			}
+		}
+		else if constexpr (bytes == 1 || bytes == 2 || bytes == 4 || bytes == 8)
+		{
+			constexpr auto n = 16 / bytes;
+			for (; x + n <= width; x += n)
+			{
+				vst1q_u8(output + x * bytes, reversed(vld1q_u8(input + (width - x - n) * bytes)));
+			}
+		}
+
+		return x;
+	}
+#endif
+};
+
+/// Transposes blocks of kBlock by kBlock pixels: output row k gets the pixel k of each input row.
+template<std::size_t bytes>
+struct Transpose
+{
+	static void
+	scalar(Rows rows, OutputRows outputs) noexcept
+	{
+		for (std::size_t k = 0; k < kBlock; ++k)
+		{
+			for (std::size_t i = 0; i < kBlock; ++i)
+			{
+				std::memcpy(outputs[k] + i * bytes, rows[i] + k * bytes, bytes);
+			}
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static void
+	sse41(Rows rows, OutputRows outputs) noexcept
+	{
+		if constexpr (bytes == 1)
+		{
+			__m128i pairs[4];
+			for (auto i = 0; i < 4; ++i)
+			{
+				pairs[i] = _mm_unpacklo_epi8(loadHalf(rows[2 * i]), loadHalf(rows[2 * i + 1]));
+			}
+
+			// Columns 0 to 3 and 4 to 7 of rows 0 to 3, then of rows 4 to 7.
+			const __m128i quads[4] = {_mm_unpacklo_epi16(pairs[0], pairs[1]),
+			                          _mm_unpackhi_epi16(pairs[0], pairs[1]),
+			                          _mm_unpacklo_epi16(pairs[2], pairs[3]),
+			                          _mm_unpackhi_epi16(pairs[2], pairs[3])};
+
+			for (auto k = 0; k < 2; ++k)
+			{
+				// Two columns of the 8 rows each.
+				const auto low = _mm_unpacklo_epi32(quads[k], quads[k + 2]);
+				const auto high = _mm_unpackhi_epi32(quads[k], quads[k + 2]);
+				storeHalves(low, outputs[4 * k], outputs[4 * k + 1]);
+				storeHalves(high, outputs[4 * k + 2], outputs[4 * k + 3]);
+			}
+		}
+		else if constexpr (bytes == 2)
+		{
+			__m128i pairs[8];
+			for (auto i = 0; i < 4; ++i)
+			{
+				const auto a = loadBytes(rows[2 * i]);
+				const auto b = loadBytes(rows[2 * i + 1]);
+				pairs[2 * i] = _mm_unpacklo_epi16(a, b);
+				pairs[2 * i + 1] = _mm_unpackhi_epi16(a, b);
+			}
+
+			for (auto half = 0; half < 2; ++half)
+			{
+				// Columns 0 and 1 or 4 and 5, then 2 and 3 or 6 and 7, of rows 0 to 3 and 4 to 7.
+				const auto top = pairs + half;
+				const __m128i quads[4] = {_mm_unpacklo_epi32(top[0], top[2]),
+				                          _mm_unpackhi_epi32(top[0], top[2]),
+				                          _mm_unpacklo_epi32(top[4], top[6]),
+				                          _mm_unpackhi_epi32(top[4], top[6])};
+
+				for (auto k = 0; k < 2; ++k)
+				{
+					storeBytes(outputs[4 * half + 2 * k], _mm_unpacklo_epi64(quads[k], quads[k + 2]));
+					storeBytes(outputs[4 * half + 2 * k + 1], _mm_unpackhi_epi64(quads[k], quads[k + 2]));
+				}
+			}
+		}
+		else if constexpr (bytes == 4)
+		{
+			// Four blocks of 4 by 4 pixels.
+			for (auto block = 0; block < 4; ++block)
+			{
+				const auto row = 4 * (block / 2);
+				const auto column = 4 * (block % 2);
+				__m128i pixels[4];
+				for (auto i = 0; i < 4; ++i)
+				{
+					pixels[i] = loadBytes(rows[row + i] + 4 * column);
+				}
+
+				const auto t0 = _mm_unpacklo_epi32(pixels[0], pixels[1]);
+				const auto t1 = _mm_unpackhi_epi32(pixels[0], pixels[1]);
+				const auto t2 = _mm_unpacklo_epi32(pixels[2], pixels[3]);
+				const auto t3 = _mm_unpackhi_epi32(pixels[2], pixels[3]);
+				const auto outputRows = outputs + column;
+				storeBytes(outputRows[0] + 4 * row, _mm_unpacklo_epi64(t0, t2));
+				storeBytes(outputRows[1] + 4 * row, _mm_unpackhi_epi64(t0, t2));
+				storeBytes(outputRows[2] + 4 * row, _mm_unpacklo_epi64(t1, t3));
+				storeBytes(outputRows[3] + 4 * row, _mm_unpackhi_epi64(t1, t3));
+			}
+		}
+		else
+		{
+			scalar(rows, outputs);
+		}
+	}
+
+	/// Stores the low and high halves of a register.
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static void
+	storeHalves(__m128i value, std::uint8_t* low, std::uint8_t* high) noexcept
+	{
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(low), value);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(high), _mm_unpackhi_epi64(value, value));
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static void
+	neon(Rows rows, OutputRows outputs) noexcept
+	{
+		if constexpr (bytes == 1)
+		{
+			uint8x8x2_t pairs[4];
+			for (auto i = 0; i < 4; ++i)
+			{
+				pairs[i] = vtrn_u8(vld1_u8(rows[2 * i]), vld1_u8(rows[2 * i + 1]));
+			}
+
+			// Even and odd columns of rows 0 to 3, then of rows 4 to 7.
+			uint16x4x2_t quads[4];
+			for (auto i = 0; i < 4; ++i)
+			{
+				const auto& top = pairs[2 * (i / 2)];
+				const auto& bottom = pairs[2 * (i / 2) + 1];
+				quads[i] = vtrn_u16(vreinterpret_u16_u8(top.val[i % 2]),
+				                    vreinterpret_u16_u8(bottom.val[i % 2]));
+			}
+
+			for (auto i = 0; i < 4; ++i)
+			{
+				// Column i and i + 4 of the 8 rows.
+				const auto columns = vtrn_u32(vreinterpret_u32_u16(quads[i % 2].val[i / 2]),
+				                              vreinterpret_u32_u16(quads[2 + i % 2].val[i / 2]));
+				vst1_u8(outputs[i], vreinterpret_u8_u32(columns.val[0]));
+				vst1_u8(outputs[i + 4], vreinterpret_u8_u32(columns.val[1]));
+			}
+		}
+		else if constexpr (bytes == 2)
+		{
+			uint16x8x2_t pairs[4];
+			for (auto i = 0; i < 4; ++i)
+			{
+				const auto a = vld1q_u16(reinterpret_cast<const std::uint16_t*>(rows[2 * i]));
+				const auto b = vld1q_u16(reinterpret_cast<const std::uint16_t*>(rows[2 * i + 1]));
+				pairs[i] = vtrnq_u16(a, b);
+			}
+
+			for (auto parity = 0; parity < 2; ++parity)
+			{
+				// Columns parity and parity + 4, then parity + 2 and parity + 6.
+				const auto top = vtrnq_u32(vreinterpretq_u32_u16(pairs[0].val[parity]),
+				                           vreinterpretq_u32_u16(pairs[1].val[parity]));
+				const auto bottom = vtrnq_u32(vreinterpretq_u32_u16(pairs[2].val[parity]),
+				                              vreinterpretq_u32_u16(pairs[3].val[parity]));
+
+				for (auto k = 0; k < 2; ++k)
+				{
+					const auto column = parity + 2 * k;
+					const auto low = vcombine_u32(vget_low_u32(top.val[k]), vget_low_u32(bottom.val[k]));
+					const auto high = vcombine_u32(vget_high_u32(top.val[k]), vget_high_u32(bottom.val[k]));
+					vst1q_u8(outputs[column], vreinterpretq_u8_u32(low));
+					vst1q_u8(outputs[column + 4], vreinterpretq_u8_u32(high));
+				}
+			}
+		}
+		else if constexpr (bytes == 4)
+		{
+			for (auto block = 0; block < 4; ++block)
+			{
+				const auto row = 4 * (block / 2);
+				const auto column = 4 * (block % 2);
+				const auto load = [&](int i) {
+					return vld1q_u32(reinterpret_cast<const std::uint32_t*>(rows[row + i]) + column);
+				};
+
+				const auto top = vtrnq_u32(load(0), load(1));
+				const auto bottom = vtrnq_u32(load(2), load(3));
+				const auto outputRows = outputs + column;
+				for (auto k = 0; k < 2; ++k)
+				{
+					const auto low = vcombine_u32(vget_low_u32(top.val[k]), vget_low_u32(bottom.val[k]));
+					const auto high = vcombine_u32(vget_high_u32(top.val[k]), vget_high_u32(bottom.val[k]));
+					vst1q_u8(outputRows[k] + 4 * row, vreinterpretq_u8_u32(low));
+					vst1q_u8(outputRows[k + 2] + 4 * row, vreinterpretq_u8_u32(high));
+				}
+			}
+		}
+		else
+		{
+			scalar(rows, outputs);
+		}
+	}
+#endif
+};
+
+/// Returns the implementation of a block kernel for @p simd, which must be supported.
+template<class Kernel>
+TransposeKernel
+blockKernel(ESimd simd) noexcept
+{
+#ifdef NEURALA_IMAGE_X86
+	if (simd == ESimd::sse41 || simd == ESimd::avx2)
+	{
+		return Kernel::sse41;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	if (simd == ESimd::neon)
+	{
+		return Kernel::neon;
+	}
+#endif
+
+	return Kernel::scalar;
+}
+
+/// Returns the kernel flipping rows of pixels of @p bytes bytes, null if there is none.
+MirrorKernel
+mirrorKernel(std::size_t bytes, ESimd simd) noexcept
+{
+	switch (bytes)
+	{
+		case 1:
+			return kernel<Mirror<1>, MirrorKernel>(simd);
+		case 2:
+			return kernel<Mirror<2>, MirrorKernel>(simd);
+		case 3:
+			return kernel<Mirror<3>, MirrorKernel>(simd);
+		case 4:
+			return kernel<Mirror<4>, MirrorKernel>(simd);
+		case 6:
+			return kernel<Mirror<6>, MirrorKernel>(simd);
+		case 8:
+			return kernel<Mirror<8>, MirrorKernel>(simd);
+		case 12:
+			return kernel<Mirror<12>, MirrorKernel>(simd);
+		case 16:
+			return kernel<Mirror<16>, MirrorKernel>(simd);
+		default:
+			return nullptr;
+	}
+}
+
+/// Returns the kernel transposing blocks of pixels of @p bytes bytes, null if there is none.
+TransposeKernel
+transposeKernel(std::size_t bytes, ESimd simd) noexcept
+{
+	switch (bytes)
+	{
+		case 1:
+			return blockKernel<Transpose<1>>(simd);
+		case 2:
+			return blockKernel<Transpose<2>>(simd);
+		case 3:
+			return blockKernel<Transpose<3>>(simd);
+		case 4:
+			return blockKernel<Transpose<4>>(simd);
+		case 6:
+			return blockKernel<Transpose<6>>(simd);
+		case 8:
+			return blockKernel<Transpose<8>>(simd);
+		case 12:
+			return blockKernel<Transpose<12>>(simd);
+		case 16:
+			return blockKernel<Transpose<16>>(simd);
+		default:
+			return nullptr;
+	}
+}
+
+/// Position in memory of the pixel (y, x) of a normalized plane: origin + y * stepY + x * stepX.
+struct Walk
+{
+	const std::uint8_t* origin;
+	std::ptrdiff_t stepX;
+	std::ptrdiff_t stepY;
+
+	const std::uint8_t* at(std::size_t y, std::size_t x) const noexcept
+	{
+		return origin + static_cast<std::ptrdiff_t>(y) * stepY + static_cast<std::ptrdiff_t>(x) * stepX;
+	}
+};
+
+/// Returns the walk over @p plane, of @p width pixels of @p bytes bytes, in @p orientation.
+Walk
+walk(const ImagePlane& plane,
+     std::size_t width,
+     std::size_t bytes,
+     EOrientation orientation) noexcept
+{
+	const auto data = reinterpret_cast<const std::uint8_t*>(plane.data);
+	const auto pitch = static_cast<std::ptrdiff_t>(plane.pitch);
+	const auto pixel = static_cast<std::ptrdiff_t>(bytes);
+	const auto lastRow = pitch * static_cast<std::ptrdiff_t>(plane.rows - 1);
+	const auto lastColumn = pixel * static_cast<std::ptrdiff_t>(width - 1);
+
+	switch (orientation)
+	{
+		case EOrientation::topRight:
+			return {data + lastColumn, -pixel, pitch};
+		case EOrientation::bottomRight:
+			return {data + lastRow + lastColumn, -pixel, -pitch};
+		case EOrientation::bottomLeft:
+			return {data + lastRow, pixel, -pitch};
+		case EOrientation::leftTop:
+			return {data, pitch, pixel};
+		case EOrientation::rightTop:
+			return {data + lastRow, -pitch, pixel};
+		case EOrientation::rightBottom:
+			return {data + lastRow + lastColumn, -pitch, -pixel};
+		case EOrientation::leftBottom:
+			return {data + lastColumn, pitch, -pixel};
+		default:
+			return {data, pixel, pitch};
+	}
+}
+
+/// Writes the packed plane of @p width by @p height pixels of @p bytes bytes walked by @p walk.
+void
+normalizePlane(const Walk& walk,
+               std::size_t width,
+               std::size_t height,
+               std::size_t bytes,
+               ESimd simd,
+               std::uint8_t* output) noexcept
+{
+	const auto rowBytes = width * bytes;
+	const auto pixel = static_cast<std::ptrdiff_t>(bytes);
+
+	// Rows of the plane are rows in memory, copied or flipped.
+	if (walk.stepX == pixel || walk.stepX == -pixel)
+	{
+		const auto mirror = mirrorKernel(bytes, simd);
+		for (std::size_t y = 0; y < height; ++y, output += rowBytes)
+		{
+			if (walk.stepX > 0)
+			{
+				std::memcpy(output, walk.at(y, 0), rowBytes);
+			}
+			else if (mirror)
+			{
+				mirror(width, walk.at(y, width - 1), output);
+			}
+			else
+			{
+				for (std::size_t x = 0; x < width; ++x)
+				{
+					std::memcpy(output + x * bytes, walk.at(y, x), bytes);
+				}
+			}
+		}
+		return;
+	}
+
+	// Rows of the plane are columns in memory, transposed by blocks within tiles.
+	const auto transpose = transposeKernel(bytes, simd);
+	const auto forward = walk.stepY > 0;
+
+	for (std::size_t tileY = 0; tileY < height; tileY += kTile)
+	{
+		const auto endY = std::min(tileY + kTile, height);
+		for (std::size_t tileX = 0; tileX < width; tileX += kTile)
+		{
+			const auto endX = std::min(tileX + kTile, width);
+			for (auto y = tileY; y < endY; y += kBlock)
+			{
+				for (auto x = tileX; x < endX; x += kBlock)
+				{
+					if (transpose && y + kBlock <= endY && x + kBlock <= endX)
+					{
+						// Each row in memory holds a column of the block, reversed if walked backward.
+						const std::uint8_t* rows[kBlock];
+						std::uint8_t* outputs[kBlock];
+						for (std::size_t i = 0; i < kBlock; ++i)
+						{
+							rows[i] = walk.at(forward ? y : y + kBlock - 1, x + i);
+							outputs[i] = output + (forward ? y + i : y + kBlock - 1 - i) * rowBytes + x * bytes;
+						}
+						transpose(rows, outputs);
+						continue;
+					}
+
+					for (auto blockY = y; blockY < std::min(y + kBlock, endY); ++blockY)
+					{
+						for (auto blockX = x; blockX < std::min(x + kBlock, endX); ++blockX)
+						{
+							std::memcpy(output + blockY * rowBytes + blockX * bytes, walk.at(blockY, blockX), bytes);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/// Returns the size of the pixels of the plane @p plane of images in @p format, in bytes.
+std::size_t
+pixelBytes(const PixelFormat& format, std::size_t plane) noexcept
+{
+	switch (format.layout())
+	{
+		case ELayout::interleaved:
+			return format.channels() * format.bytesPerElement();
+		case ELayout::semiplanar:
+			return (plane == 0 ? 1 : format.channels() - 1) * format.bytesPerElement();
+		default:
+			return format.bytesPerElement();
+	}
+}
+} // namespace
+
+PixelFormat
+normalizedFormat(const PixelFormat& from) noexcept
+{
+	if (!from.known())
+	{
+		return {};
+	}
+
+	switch (from.colorSpace())
+	{
+		case EColorSpace::RGB565:
+		case EColorSpace::bayerRG:
+		case EColorSpace::bayerGR:
+		case EColorSpace::bayerBG:
+		case EColorSpace::bayerGB:
+		case EColorSpace::YUV422:
+			// Images already upright are copied, whatever their format.
+			return from.orientation() == EOrientation::topLeft ? from : PixelFormat();
+		case EColorSpace::YUV420:
+		case EColorSpace::NV12:
+		case EColorSpace::NV21:
+			if (from.layout() == ELayout::interleaved)
+			{
+				return {};
+			}
+			break;
+		default:
+			break;
+	}
+
+	return {from.datatype(), from.colorSpace(), from.layout(), EOrientation::topLeft, from.channels()};
+}
+
+dto::ImageView
+normalizeOrientation(const StridedImageView& source,
+                     std::byte* data,
+                     std::size_t size,
+                     ESimd simd) noexcept
+{
+	const auto& from = source.format();
+	const auto format = normalizedFormat(from);
+	const auto transposed = isTransposed(from.orientation());
+	const auto width = transposed ? source.height() : source.width();
+	const auto height = transposed ? source.width() : source.height();
+
+	if (format.colorSpace() == EColorSpace::unknown || source.empty() || !data
+	    || size < format.frameBytes(width, height))
+	{
+		return {};
+	}
+
+	if (from.orientation() == EOrientation::topLeft)
+	{
+		return source.copyTo(data, size);
+	}
+
+	simd = supportedSimd(simd);
+	auto output = reinterpret_cast<std::uint8_t*>(data);
+
+	for (std::size_t i = 0; i < source.planes(); ++i)
+	{
+		const auto plane = source.plane(i);
+		const auto bytes = pixelBytes(from, i);
+		const auto planeWidth = plane.rowBytes / bytes;
+		const auto normalizedWidth = transposed ? plane.rows : planeWidth;
+		const auto normalizedHeight = transposed ? planeWidth : plane.rows;
+
+		normalizePlane(walk(plane, planeWidth, bytes, from.orientation()),
+		               normalizedWidth,
+		               normalizedHeight,
+		               bytes,
+		               simd,
+		               output);
+		output += normalizedWidth * normalizedHeight * bytes;
+	}
+
+	return {format.metadata(width, height), data};
+}
+
+} // namespace neurala
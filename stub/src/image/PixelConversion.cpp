@@ -0,0 +1,1233 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "neurala/image/PixelConversion.h"
+
+#include "SimdTarget.h"
+#include "Vector.h"
+
+namespace neurala
+{
+namespace
+{
+using namespace detail;
+
+/// Largest sample quantized for the gamma correction.
+constexpr std::uint32_t kGammaTop = 4095;
+
+/// Mapping of the samples of a data type to bytes, or to indices in the gamma table.
+struct Mapping
+{
+	// uint16 samples: ((min(max(x, low), high) - low) * multiplier + 2^15) >> 16.
+	std::uint16_t low16;
+	std::uint16_t high16;
+	std::uint32_t multiplier16;
+	// Floating point samples: the nearest integer to min(max((x - low) * scale, 0), top).
+	float low;
+	float scale;
+	float top;
+	// Mapping of the uint8 samples.
+	const std::uint8_t* bytes;
+	// Gamma table indexed by the mapped samples, which are in [0, kGammaTop], or null.
+	const std::uint8_t* gamma;
+};
+
+/// Tag of the IEEE 754 half precision samples.
+struct Half
+{
+	std::uint16_t bits;
+};
+
+using Planes = const std::uint8_t* const*;
+using OutputPlanes = std::uint8_t* const*;
+
+using SampleKernel = void (*)(std::size_t count,
+                              const std::byte* input,
+                              const Mapping& mapping,
+                              std::uint8_t* output);
+using InterleaveKernel = void (*)(std::size_t width, Planes planes, std::uint8_t* output);
+using DeinterleaveKernel = void (*)(std::size_t width,
+                                    const std::uint8_t* input,
+                                    OutputPlanes planes);
+
+float
+halfToFloat(std::uint16_t half) noexcept
+{
+	const std::uint32_t sign = (half & 0x8000u) << 16;
+	std::uint32_t exponent = (half >> 10) & 0x1f;
+	std::uint32_t mantissa = half & 0x3ff;
+	std::uint32_t bits = sign;
+
+	if (exponent == 0x1f)
+	{
+		bits |= 0x7f800000u | (mantissa << 13);
+	}
+	else if (exponent)
+	{
+		bits |= ((exponent + 112) << 23) | (mantissa << 13);
+	}
+	else if (mantissa)
+	{
+		// Subnormal halves are normal floats.
+		exponent = 113;
+		while (!(mantissa & 0x400))
+		{
+			mantissa <<= 1;
+			--exponent;
+		}
+		bits |= (exponent << 23) | ((mantissa & 0x3ff) << 13);
+	}
+
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/// Returns the sample @p i of @p input, as a float for the floating point types.
+template<class T>
+auto
+sample(const std::byte* input, std::size_t i) noexcept
+{
+	T value;
+	std::memcpy(&value, input + i * sizeof(T), sizeof(T));
+
+	if constexpr (std::is_same_v<T, Half>)
+	{
+		return halfToFloat(value.bits);
+	}
+	else if constexpr (std::is_same_v<T, double>)
+	{
+		return static_cast<float>(value);
+	}
+	else
+	{
+		return value;
+	}
+}
+
+std::uint8_t
+finish(std::uint32_t value, const Mapping& mapping) noexcept
+{
+	return static_cast<std::uint8_t>(mapping.gamma ? mapping.gamma[value] : value);
+}
+
+/// Looks the mapped samples up in the gamma table.
+void
+lookUp(const std::int32_t* values,
+       std::size_t count,
+       const Mapping& mapping,
+       std::uint8_t* output) noexcept
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		output[i] = mapping.gamma[values[i]];
+	}
+}
+
+/// Maps uint8 samples through their table.
+struct Bytes
+{
+	static void
+	scalar(std::size_t i,
+	       std::size_t count,
+	       const std::byte* input,
+	       const Mapping& mapping,
+	       std::uint8_t* output) noexcept
+	{
+		for (; i < count; ++i)
+		{
+			output[i] = mapping.bytes[static_cast<std::uint8_t>(input[i])];
+		}
+	}
+
+	static std::size_t sse41(std::size_t, const std::byte*, const Mapping&, std::uint8_t*) noexcept
+	{
+		return 0;
+	}
+
+	static std::size_t avx2(std::size_t, const std::byte*, const Mapping&, std::uint8_t*) noexcept
+	{
+		return 0;
+	}
+
+	static std::size_t neon(std::size_t, const std::byte*, const Mapping&, std::uint8_t*) noexcept
+	{
+		return 0;
+	}
+};
+
+/// Maps uint16 samples in fixed point.
+struct Uint16
+{
+	static void
+	scalar(std::size_t i,
+	       std::size_t count,
+	       const std::byte* input,
+	       const Mapping& mapping,
+	       std::uint8_t* output) noexcept
+	{
+		for (; i < count; ++i)
+		{
+			const auto x = std::clamp(sample<std::uint16_t>(input, i), mapping.low16, mapping.high16);
+			const auto value = (std::uint32_t(x - mapping.low16) * mapping.multiplier16 + 0x8000) >> 16;
+			output[i] = finish(value, mapping);
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	/// Maps 8 samples to 32 bits.
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static void
+	map(__m128i x, const Mapping& mapping, __m128i& low, __m128i& high) noexcept
+	{
+		const auto low16 = _mm_set1_epi16(static_cast<short>(mapping.low16));
+		const auto multiplier = _mm_set1_epi32(static_cast<int>(mapping.multiplier16));
+		const auto half = _mm_set1_epi32(0x8000);
+
+		x = _mm_min_epu16(_mm_max_epu16(x, low16), _mm_set1_epi16(static_cast<short>(mapping.high16)));
+		x = _mm_sub_epi16(x, low16);
+		low = _mm_cvtepu16_epi32(x);
+		high = _mm_unpackhi_epi16(x, _mm_setzero_si128());
+		low = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(low, multiplier), half), 16);
+		high = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(high, multiplier), half), 16);
+	}
+
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t count,
+	      const std::byte* input,
+	      const Mapping& mapping,
+	      std::uint8_t* output) noexcept
+	{
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m128i values[4];
+			for (auto k = 0; k < 2; ++k)
+			{
+				const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * i + 16 * k));
+				map(x, mapping, values[2 * k], values[2 * k + 1]);
+			}
+
+			if (mapping.gamma)
+			{
+				alignas(16) std::int32_t indices[16];
+				for (auto k = 0; k < 4; ++k)
+				{
+					_mm_store_si128(reinterpret_cast<__m128i*>(indices + 4 * k), values[k]);
+				}
+				lookUp(indices, 16, mapping, output + i);
+				continue;
+			}
+
+			storeBytes(output + i,
+			           _mm_packus_epi16(_mm_packus_epi32(values[0], values[1]),
+			                            _mm_packus_epi32(values[2], values[3])));
+		}
+		return i;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2,f16c")
+	static std::size_t
+	avx2(std::size_t count,
+	     const std::byte* input,
+	     const Mapping& mapping,
+	     std::uint8_t* output) noexcept
+	{
+		const auto low16 = _mm256_set1_epi16(static_cast<short>(mapping.low16));
+		const auto high16 = _mm256_set1_epi16(static_cast<short>(mapping.high16));
+		const auto multiplier = _mm256_set1_epi32(static_cast<int>(mapping.multiplier16));
+		const auto half = _mm256_set1_epi32(0x8000);
+
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			__m256i values[4];
+			for (auto k = 0; k < 2; ++k)
+			{
+				auto x = loadBytes256(reinterpret_cast<const std::uint8_t*>(input) + 2 * i + 32 * k);
+				x = _mm256_sub_epi16(_mm256_min_epu16(_mm256_max_epu16(x, low16), high16), low16);
+
+				const __m256i wide[2] = {_mm256_cvtepu16_epi32(_mm256_castsi256_si128(x)),
+				                         _mm256_cvtepu16_epi32(_mm256_extracti128_si256(x, 1))};
+				for (auto j = 0; j < 2; ++j)
+				{
+					const auto product = _mm256_add_epi32(_mm256_mullo_epi32(wide[j], multiplier), half);
+					values[2 * k + j] = _mm256_srli_epi32(product, 16);
+				}
+			}
+
+			storeValues(values, mapping, output + i);
+		}
+		return i;
+	}
+
+	/// Stores 32 mapped samples, given in order.
+	NEURALA_IMAGE_TARGET("avx2,f16c")
+	static void
+	storeValues(const __m256i* values, const Mapping& mapping, std::uint8_t* output) noexcept
+	{
+		if (mapping.gamma)
+		{
+			alignas(32) std::int32_t indices[32];
+			for (auto k = 0; k < 4; ++k)
+			{
+				_mm256_store_si256(reinterpret_cast<__m256i*>(indices + 8 * k), values[k]);
+			}
+			lookUp(indices, 32, mapping, output);
+			return;
+		}
+
+		// Packing works lane by lane, leaving the groups of 4 samples out of order.
+		const auto bytes = _mm256_packus_epi16(_mm256_packs_epi32(values[0], values[1]),
+		                                       _mm256_packs_epi32(values[2], values[3]));
+		storeBytes256(output,
+		              _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(std::size_t count,
+	     const std::byte* input,
+	     const Mapping& mapping,
+	     std::uint8_t* output) noexcept
+	{
+		const auto low16 = vdupq_n_u16(mapping.low16);
+		const auto high16 = vdupq_n_u16(mapping.high16);
+		const auto multiplier = vdupq_n_u32(mapping.multiplier16);
+		const auto half = vdupq_n_u32(0x8000);
+
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			uint32x4_t values[4];
+			for (auto k = 0; k < 2; ++k)
+			{
+				auto x = vld1q_u16(reinterpret_cast<const std::uint16_t*>(input) + i + 8 * k);
+				x = vsubq_u16(vminq_u16(vmaxq_u16(x, low16), high16), low16);
+
+				const uint32x4_t wide[2] = {vmovl_u16(vget_low_u16(x)), vmovl_u16(vget_high_u16(x))};
+				for (auto j = 0; j < 2; ++j)
+				{
+					values[2 * k + j] = vshrq_n_u32(vmlaq_u32(half, wide[j], multiplier), 16);
+				}
+			}
+
+			storeValues(values, mapping, output + i);
+		}
+		return i;
+	}
+
+	/// Stores 16 mapped samples.
+	static void
+	storeValues(const uint32x4_t* values, const Mapping& mapping, std::uint8_t* output) noexcept
+	{
+		if (mapping.gamma)
+		{
+			std::int32_t indices[16];
+			for (auto k = 0; k < 4; ++k)
+			{
+				vst1q_s32(indices + 4 * k, vreinterpretq_s32_u32(values[k]));
+			}
+			lookUp(indices, 16, mapping, output);
+			return;
+		}
+
+		const auto low = vcombine_u16(vmovn_u32(values[0]), vmovn_u32(values[1]));
+		const auto high = vcombine_u16(vmovn_u32(values[2]), vmovn_u32(values[3]));
+		vst1q_u8(output, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+	}
+#endif
+};
+
+/// Maps floating point samples, converted to single precision.
+template<class T>
+struct Floating
+{
+	static std::uint32_t
+	map(float x, const Mapping& mapping) noexcept
+	{
+		// Comparisons send NaN to 0, as the vector minimum and maximum do.
+		auto t = (x - mapping.low) * mapping.scale;
+		t = t > 0.0f ? t : 0.0f;
+		t = t < mapping.top ? t : mapping.top;
+		return static_cast<std::uint32_t>(std::nearbyint(t));
+	}
+
+	static void
+	scalar(std::size_t i,
+	       std::size_t count,
+	       const std::byte* input,
+	       const Mapping& mapping,
+	       std::uint8_t* output) noexcept
+	{
+		for (; i < count; ++i)
+		{
+			output[i] = finish(map(sample<T>(input, i), mapping), mapping);
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t count,
+	      const std::byte* input,
+	      const Mapping& mapping,
+	      std::uint8_t* output) noexcept
+	{
+		// Half precision conversions come with AVX2.
+		if constexpr (std::is_same_v<T, Half>)
+		{
+			return 0;
+		}
+
+		const auto low = _mm_set1_ps(mapping.low);
+		const auto scale = _mm_set1_ps(mapping.scale);
+		const auto top = _mm_set1_ps(mapping.top);
+
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m128i values[4];
+			for (auto k = 0; k < 4; ++k)
+			{
+				const auto x = load(input + (i + 4 * k) * sizeof(T));
+				// The maximum returns its second operand, 0, if the first one is NaN.
+				auto t = _mm_max_ps(_mm_mul_ps(_mm_sub_ps(x, low), scale), _mm_setzero_ps());
+				values[k] = _mm_cvtps_epi32(_mm_min_ps(t, top));
+			}
+
+			if (mapping.gamma)
+			{
+				alignas(16) std::int32_t indices[16];
+				for (auto k = 0; k < 4; ++k)
+				{
+					_mm_store_si128(reinterpret_cast<__m128i*>(indices + 4 * k), values[k]);
+				}
+				lookUp(indices, 16, mapping, output + i);
+				continue;
+			}
+
+			storeBytes(output + i,
+			           _mm_packus_epi16(_mm_packs_epi32(values[0], values[1]),
+			                            _mm_packs_epi32(values[2], values[3])));
+		}
+		return i;
+	}
+
+	/// Loads 4 samples.
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static __m128
+	load(const std::byte* input) noexcept
+	{
+		if constexpr (std::is_same_v<T, double>)
+		{
+			const auto x = reinterpret_cast<const double*>(input);
+			return _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(x)), _mm_cvtpd_ps(_mm_loadu_pd(x + 2)));
+		}
+		else
+		{
+			return _mm_loadu_ps(reinterpret_cast<const float*>(input));
+		}
+	}
+
+	NEURALA_IMAGE_TARGET("avx2,f16c")
+	static std::size_t
+	avx2(std::size_t count,
+	     const std::byte* input,
+	     const Mapping& mapping,
+	     std::uint8_t* output) noexcept
+	{
+		const auto low = _mm256_set1_ps(mapping.low);
+		const auto scale = _mm256_set1_ps(mapping.scale);
+		const auto top = _mm256_set1_ps(mapping.top);
+
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			__m256i values[4];
+			for (auto k = 0; k < 4; ++k)
+			{
+				const auto x = load256(input + (i + 8 * k) * sizeof(T));
+				auto t = _mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(x, low), scale), _mm256_setzero_ps());
+				values[k] = _mm256_cvtps_epi32(_mm256_min_ps(t, top));
+			}
+
+			Uint16::storeValues(values, mapping, output + i);
+		}
+		return i;
+	}
+
+	/// Loads 8 samples.
+	NEURALA_IMAGE_TARGET("avx2,f16c")
+	static __m256
+	load256(const std::byte* input) noexcept
+	{
+		if constexpr (std::is_same_v<T, Half>)
+		{
+			return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input)));
+		}
+		else if constexpr (std::is_same_v<T, double>)
+		{
+			const auto x = reinterpret_cast<const double*>(input);
+			return _mm256_set_m128(_mm256_cvtpd_ps(_mm256_loadu_pd(x + 4)),
+			                       _mm256_cvtpd_ps(_mm256_loadu_pd(x)));
+		}
+		else
+		{
+			return _mm256_loadu_ps(reinterpret_cast<const float*>(input));
+		}
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(std::size_t count,
+	     const std::byte* input,
+	     const Mapping& mapping,
+	     std::uint8_t* output) noexcept
+	{
+		const auto low = vdupq_n_f32(mapping.low);
+		const auto scale = vdupq_n_f32(mapping.scale);
+		const auto top = vdupq_n_f32(mapping.top);
+
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			uint32x4_t values[4];
+			for (auto k = 0; k < 4; ++k)
+			{
+				const auto x = load(input + (i + 4 * k) * sizeof(T));
+				// The maximum of a number and NaN is the number.
+				auto t = vmaxnmq_f32(vmulq_f32(vsubq_f32(x, low), scale), vdupq_n_f32(0.0f));
+				values[k] = vreinterpretq_u32_s32(vcvtnq_s32_f32(vminq_f32(t, top)));
+			}
+
+			Uint16::storeValues(values, mapping, output + i);
+		}
+		return i;
+	}
+
+	/// Loads 4 samples.
+	static float32x4_t
+	load(const std::byte* input) noexcept
+	{
+		if constexpr (std::is_same_v<T, Half>)
+		{
+			const auto bits = vld1_u16(reinterpret_cast<const std::uint16_t*>(input));
+			return vcvt_f32_f16(vreinterpret_f16_u16(bits));
+		}
+		else if constexpr (std::is_same_v<T, double>)
+		{
+			const auto x = reinterpret_cast<const double*>(input);
+			return vcombine_f32(vcvt_f32_f64(vld1q_f64(x)), vcvt_f32_f64(vld1q_f64(x + 2)));
+		}
+		else
+		{
+			return vld1q_f32(reinterpret_cast<const float*>(input));
+		}
+	}
+#endif
+};
+
+/// Interleaves the rows of 2 planes.
+struct Interleave2
+{
+	static void
+	scalar(std::size_t x, std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			output[2 * x] = planes[0][x];
+			output[2 * x + 1] = planes[1][x];
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto a = loadBytes(planes[0] + x);
+			const auto b = loadBytes(planes[1] + x);
+			storeBytes(output + 2 * x, _mm_unpacklo_epi8(a, b));
+			storeBytes(output + 2 * x + 16, _mm_unpackhi_epi8(a, b));
+		}
+		return x;
+	}
+
+	// Memory bound, AVX2 brings nothing over SSE4.1.
+	NEURALA_IMAGE_TARGET("avx2,f16c")
+	static std::size_t
+	avx2(std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		return sse41(width, planes, output);
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			vst2q_u8(output + 2 * x, (uint8x16x2_t{{vld1q_u8(planes[0] + x), vld1q_u8(planes[1] + x)}}));
+		}
+		return x;
+	}
+#endif
+};
+
+/// Interleaves the rows of 3 planes.
+struct Interleave3
+{
+	static void
+	scalar(std::size_t x, std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			output[3 * x] = planes[0][x];
+			output[3 * x + 1] = planes[1][x];
+			output[3 * x + 2] = planes[2][x];
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			store3(loadBytes(planes[0] + x),
+			       loadBytes(planes[1] + x),
+			       loadBytes(planes[2] + x),
+			       output + 3 * x);
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2,f16c")
+	static std::size_t
+	avx2(std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 32 <= width; x += 32)
+		{
+			store3(loadBytes256(planes[0] + x),
+			       loadBytes256(planes[1] + x),
+			       loadBytes256(planes[2] + x),
+			       output + 3 * x);
+		}
+		return x;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const uint8x16x3_t pixels{
+			  {vld1q_u8(planes[0] + x), vld1q_u8(planes[1] + x), vld1q_u8(planes[2] + x)}};
+			vst3q_u8(output + 3 * x, pixels);
+		}
+		return x;
+	}
+#endif
+};
+
+/// Interleaves the rows of 4 planes.
+struct Interleave4
+{
+	static void
+	scalar(std::size_t x, std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			for (auto c = 0; c < 4; ++c)
+			{
+				output[4 * x + c] = planes[c][x];
+			}
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto a = loadBytes(planes[0] + x);
+			const auto b = loadBytes(planes[1] + x);
+			const auto c = loadBytes(planes[2] + x);
+			const auto d = loadBytes(planes[3] + x);
+			const __m128i pairs[4] = {_mm_unpacklo_epi8(a, b),
+			                          _mm_unpacklo_epi8(c, d),
+			                          _mm_unpackhi_epi8(a, b),
+			                          _mm_unpackhi_epi8(c, d)};
+
+			storeBytes(output + 4 * x, _mm_unpacklo_epi16(pairs[0], pairs[1]));
+			storeBytes(output + 4 * x + 16, _mm_unpackhi_epi16(pairs[0], pairs[1]));
+			storeBytes(output + 4 * x + 32, _mm_unpacklo_epi16(pairs[2], pairs[3]));
+			storeBytes(output + 4 * x + 48, _mm_unpackhi_epi16(pairs[2], pairs[3]));
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2,f16c")
+	static std::size_t
+	avx2(std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		return sse41(width, planes, output);
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(std::size_t width, Planes planes, std::uint8_t* output) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const uint8x16x4_t pixels{{vld1q_u8(planes[0] + x),
+			                           vld1q_u8(planes[1] + x),
+			                           vld1q_u8(planes[2] + x),
+			                           vld1q_u8(planes[3] + x)}};
+			vst4q_u8(output + 4 * x, pixels);
+		}
+		return x;
+	}
+#endif
+};
+
+/// Splits a row of 2 interleaved channels into planes.
+struct Deinterleave2
+{
+	static void
+	scalar(std::size_t x, std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			planes[0][x] = input[2 * x];
+			planes[1][x] = input[2 * x + 1];
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		const auto mask = _mm_set1_epi16(0xff);
+
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto x0 = loadBytes(input + 2 * x);
+			const auto x1 = loadBytes(input + 2 * x + 16);
+			storeBytes(planes[0] + x,
+			           _mm_packus_epi16(_mm_and_si128(x0, mask), _mm_and_si128(x1, mask)));
+			storeBytes(planes[1] + x,
+			           _mm_packus_epi16(_mm_srli_epi16(x0, 8), _mm_srli_epi16(x1, 8)));
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2,f16c")
+	static std::size_t
+	avx2(std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		return sse41(width, input, planes);
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto pixels = vld2q_u8(input + 2 * x);
+			vst1q_u8(planes[0] + x, pixels.val[0]);
+			vst1q_u8(planes[1] + x, pixels.val[1]);
+		}
+		return x;
+	}
+#endif
+};
+
+/// Splits a row of 3 interleaved channels into planes.
+struct Deinterleave3
+{
+	static void
+	scalar(std::size_t x, std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			planes[0][x] = input[3 * x];
+			planes[1][x] = input[3 * x + 1];
+			planes[2][x] = input[3 * x + 2];
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto x0 = loadBytes(input + 3 * x);
+			const auto x1 = loadBytes(input + 3 * x + 16);
+			const auto x2 = loadBytes(input + 3 * x + 32);
+			for (auto plane = 0; plane < 3; ++plane)
+			{
+				storeBytes(planes[plane] + x, extract3(x0, x1, x2, plane));
+			}
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2,f16c")
+	static std::size_t
+	avx2(std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 32 <= width; x += 32)
+		{
+			__m256i a, b, c;
+			load3(input + 3 * x, a, b, c);
+			storeBytes256(planes[0] + x, a);
+			storeBytes256(planes[1] + x, b);
+			storeBytes256(planes[2] + x, c);
+		}
+		return x;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto pixels = vld3q_u8(input + 3 * x);
+			for (auto plane = 0; plane < 3; ++plane)
+			{
+				vst1q_u8(planes[plane] + x, pixels.val[plane]);
+			}
+		}
+		return x;
+	}
+#endif
+};
+
+/// Splits a row of 4 interleaved channels into planes.
+struct Deinterleave4
+{
+	static void
+	scalar(std::size_t x, std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		for (; x < width; ++x)
+		{
+			for (auto c = 0; c < 4; ++c)
+			{
+				planes[c][x] = input[4 * x + c];
+			}
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		// Groups the channels of 4 pixels into 32-bit words, which are then transposed.
+		const auto group = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			__m128i words[4];
+			for (auto k = 0; k < 4; ++k)
+			{
+				words[k] = _mm_shuffle_epi8(loadBytes(input + 4 * x + 16 * k), group);
+			}
+
+			const auto t0 = _mm_unpacklo_epi32(words[0], words[1]);
+			const auto t1 = _mm_unpackhi_epi32(words[0], words[1]);
+			const auto t2 = _mm_unpacklo_epi32(words[2], words[3]);
+			const auto t3 = _mm_unpackhi_epi32(words[2], words[3]);
+			storeBytes(planes[0] + x, _mm_unpacklo_epi64(t0, t2));
+			storeBytes(planes[1] + x, _mm_unpackhi_epi64(t0, t2));
+			storeBytes(planes[2] + x, _mm_unpacklo_epi64(t1, t3));
+			storeBytes(planes[3] + x, _mm_unpackhi_epi64(t1, t3));
+		}
+		return x;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2,f16c")
+	static std::size_t
+	avx2(std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		return sse41(width, input, planes);
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(std::size_t width, const std::uint8_t* input, OutputPlanes planes) noexcept
+	{
+		std::size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			const auto pixels = vld4q_u8(input + 4 * x);
+			for (auto plane = 0; plane < 4; ++plane)
+			{
+				vst1q_u8(planes[plane] + x, pixels.val[plane]);
+			}
+		}
+		return x;
+	}
+#endif
+};
+
+SampleKernel
+sampleKernel(EDatatype datatype, ESimd simd) noexcept
+{
+	switch (datatype)
+	{
+		case EDatatype::uint8:
+			return kernel<Bytes, SampleKernel>(simd);
+		case EDatatype::uint16:
+			return kernel<Uint16, SampleKernel>(simd);
+		case EDatatype::binary16:
+			return kernel<Floating<Half>, SampleKernel>(simd);
+		case EDatatype::binary32:
+			return kernel<Floating<float>, SampleKernel>(simd);
+		case EDatatype::binary64:
+			return kernel<Floating<double>, SampleKernel>(simd);
+		default:
+			return nullptr;
+	}
+}
+
+/// Returns the kernel interleaving @p channels planes, null if there is none.
+InterleaveKernel
+interleaveKernel(std::size_t channels, ESimd simd) noexcept
+{
+	switch (channels)
+	{
+		case 2:
+			return kernel<Interleave2, InterleaveKernel>(simd);
+		case 3:
+			return kernel<Interleave3, InterleaveKernel>(simd);
+		case 4:
+			return kernel<Interleave4, InterleaveKernel>(simd);
+		default:
+			return nullptr;
+	}
+}
+
+/// Returns the kernel splitting @p channels interleaved channels, null if there is none.
+DeinterleaveKernel
+deinterleaveKernel(std::size_t channels, ESimd simd) noexcept
+{
+	switch (channels)
+	{
+		case 2:
+			return kernel<Deinterleave2, DeinterleaveKernel>(simd);
+		case 3:
+			return kernel<Deinterleave3, DeinterleaveKernel>(simd);
+		case 4:
+			return kernel<Deinterleave4, DeinterleaveKernel>(simd);
+		default:
+			return nullptr;
+	}
+}
+
+/**
+ * @brief Returns the mapping of the samples of @p datatype to bytes through @p window, or to
+ *        indices in @p gamma if it is not null.
+ *
+ * @return false if the window is empty for @p datatype
+ */
+bool
+makeMapping(EDatatype datatype,
+            const WindowLevel& window,
+            const std::uint8_t* bytes,
+            const std::uint8_t* gamma,
+            Mapping& mapping) noexcept
+{
+	const auto top = gamma ? kGammaTop : 255u;
+	mapping = {};
+	mapping.bytes = bytes;
+	mapping.gamma = gamma;
+
+	switch (datatype)
+	{
+		case EDatatype::uint8:
+			return window.low < (window.high != 0.0 ? window.high : 255.0);
+		case EDatatype::uint16:
+		{
+			const auto clamp16 = [](double x) {
+				return static_cast<std::uint16_t>(std::clamp(std::round(x), 0.0, 65535.0));
+			};
+			mapping.low16 = clamp16(window.low);
+			mapping.high16 = clamp16(window.high != 0.0 ? window.high : 65535.0);
+			if (mapping.high16 <= mapping.low16)
+			{
+				return false;
+			}
+
+			// The product by the largest difference stays within 32 bits.
+			const auto range = double(mapping.high16 - mapping.low16);
+			mapping.multiplier16 = static_cast<std::uint32_t>(std::round(top * 65536.0 / range));
+			return true;
+		}
+		default:
+		{
+			const auto high = window.high != 0.0 ? window.high : 1.0;
+			mapping.low = static_cast<float>(window.low);
+			mapping.scale = static_cast<float>(top / (high - window.low));
+			mapping.top = static_cast<float>(top);
+			return window.low < high && std::isfinite(mapping.scale);
+		}
+	}
+}
+
+/// Returns @p t, clamped to [0, 1] and raised to the power 1 / @p gamma, as a byte.
+std::uint8_t
+toByte(double t, double gamma) noexcept
+{
+	t = std::clamp(t, 0.0, 1.0);
+	const auto value = gamma == 1.0 ? t : std::pow(t, 1.0 / gamma);
+	return static_cast<std::uint8_t>(std::lround(255.0 * value));
+}
+} // namespace
+
+PixelFormat
+convertedFormat(const PixelFormat& from, ELayout layout) noexcept
+{
+	switch (from.colorSpace())
+	{
+		case EColorSpace::unknown:
+		case EColorSpace::RGB565:
+		case EColorSpace::YUV420:
+		case EColorSpace::NV12:
+		case EColorSpace::NV21:
+		case EColorSpace::YUV422:
+			return {};
+		default:
+			break;
+	}
+
+	const auto supportedLayout = [](ELayout l) {
+		return l == ELayout::planar || l == ELayout::interleaved;
+	};
+
+	if (!supportedLayout(from.layout()) || !supportedLayout(layout) || from.channels() == 0
+	    || from.orientation() == EOrientation::unknown
+	    || !sampleKernel(from.datatype(), ESimd::scalar))
+	{
+		return {};
+	}
+
+	return {EDatatype::uint8, from.colorSpace(), layout, from.orientation(), from.channels()};
+}
+
+PixelConverter::PixelConverter(ELayout layout, const WindowLevel& window, ESimd simd)
+ : m_layout{layout}, m_window{window}, m_simd{supportedSimd(simd)}
+{
+	if (layout != ELayout::planar && layout != ELayout::interleaved)
+	{
+		throw std::invalid_argument("Pixels can only be converted to planar or interleaved layouts");
+	}
+
+	if (!(window.gamma > 0.0) || !std::isfinite(window.gamma))
+	{
+		throw std::invalid_argument("The gamma must be positive");
+	}
+
+	if (window.high != 0.0 && !(window.low < window.high))
+	{
+		throw std::invalid_argument("The window must not be empty");
+	}
+
+	const auto high = window.high != 0.0 ? window.high : 255.0;
+	for (std::size_t i = 0; i < m_bytes.size(); ++i)
+	{
+		m_bytes[i] = toByte((double(i) - window.low) / (high - window.low), window.gamma);
+	}
+
+	if (window.gamma != 1.0)
+	{
+		m_gamma.resize(kGammaTop + 1);
+		for (std::size_t i = 0; i <= kGammaTop; ++i)
+		{
+			m_gamma[i] = toByte(double(i) / kGammaTop, window.gamma);
+		}
+	}
+}
+
+dto::ImageView
+PixelConverter::operator()(const StridedImageView& source,
+                           std::byte* data,
+                           std::size_t size) const noexcept
+{
+	const auto& from = source.format();
+	const auto format = convertedFormat(from, m_layout);
+	const auto width = source.width();
+	const auto height = source.height();
+
+	const auto gamma = m_gamma.empty() ? nullptr : m_gamma.data();
+	Mapping mapping;
+	if (format.datatype() == EDatatype::unknown || source.empty() || !data
+	    || size < format.frameBytes(width, height)
+	    || !makeMapping(from.datatype(), m_window, m_bytes.data(), gamma, mapping))
+	{
+		return {};
+	}
+
+	const auto channels = from.channels();
+	// With a single channel, both layouts are the same.
+	const auto fromPlanar = from.layout() == ELayout::planar && channels > 1;
+	const auto toPlanar = m_layout == ELayout::planar && channels > 1;
+	const auto copy = from.datatype() == EDatatype::uint8 && m_window.low == 0.0
+	                  && (m_window.high == 0.0 || m_window.high == 255.0) && m_window.gamma == 1.0;
+	const auto samples = sampleKernel(from.datatype(), m_simd);
+	const auto output = reinterpret_cast<std::uint8_t*>(data);
+
+	// Maps @p count samples of @p input to @p target, or returns @p input as is if it is copied.
+	const auto map = [&](const std::byte* input, std::size_t count, std::uint8_t* target) {
+		if (copy)
+		{
+			return reinterpret_cast<const std::uint8_t*>(input);
+		}
+		samples(count, input, mapping, target);
+		return static_cast<const std::uint8_t*>(target);
+	};
+
+	try
+	{
+		if (fromPlanar == toPlanar)
+		{
+			const auto planes = fromPlanar ? channels : 1;
+			const auto count = fromPlanar ? width : width * channels;
+			for (std::size_t p = 0; p < planes; ++p)
+			{
+				const auto plane = source.plane(p);
+				for (std::size_t y = 0; y < height; ++y)
+				{
+					const auto target = output + (p * height + y) * count;
+					if (copy)
+					{
+						std::memcpy(target, plane.row(y), count);
+						continue;
+					}
+					samples(count, plane.row(y), mapping, target);
+				}
+			}
+			return {format.metadata(width, height), data};
+		}
+
+		// Each row is mapped to a buffer that stays in the cache, and transposed from it.
+		std::vector<std::uint8_t> buffer(copy ? 0 : width * channels);
+		std::vector<const std::uint8_t*> rows(channels);
+		std::vector<std::uint8_t*> targets(channels);
+
+		for (std::size_t y = 0; y < height; ++y)
+		{
+			if (fromPlanar)
+			{
+				const auto target = output + y * width * channels;
+				for (std::size_t c = 0; c < channels; ++c)
+				{
+					rows[c] = map(source.plane(c).row(y), width, buffer.data() + c * width);
+				}
+
+				if (const auto interleave = interleaveKernel(channels, m_simd))
+				{
+					interleave(width, rows.data(), target);
+					continue;
+				}
+
+				for (std::size_t x = 0; x < width; ++x)
+				{
+					for (std::size_t c = 0; c < channels; ++c)
+					{
+						target[x * channels + c] = rows[c][x];
+					}
+				}
+				continue;
+			}
+
+			const auto row = map(source.plane(0).row(y), width * channels, buffer.data());
+			for (std::size_t c = 0; c < channels; ++c)
+			{
+				targets[c] = output + (c * height + y) * width;
+			}
+
+			if (const auto deinterleave = deinterleaveKernel(channels, m_simd))
+			{
+				deinterleave(width, row, targets.data());
+				continue;
+			}
+
+			for (std::size_t x = 0; x < width; ++x)
+			{
+				for (std::size_t c = 0; c < channels; ++c)
+				{
+					targets[c][x] = row[x * channels + c];
+				}
+			}
+		}
+	}
+	catch (const std::bad_alloc&)
+	{
+		return {};
+	}
+
+	return {format.metadata(width, height), data};
+}
+
+} // namespace neurala
@@ -0,0 +1,806 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "neurala/image/Resize.h"
+
+#include "SimdTarget.h"
+#include "Vector.h"
+
+namespace neurala
+{
+namespace
+{
+using namespace detail;
+
+/// Bits of the fixed point weights of the area interpolation, which sum to 1 along each axis.
+constexpr unsigned kAreaBits = 12;
+
+/// Bits of the fixed point weights of the bilinear interpolation.
+constexpr unsigned kBilinearBits = 7;
+
+constexpr std::uint32_t kBilinearOne = 1u << kBilinearBits;
+
+/// Rows of the result processed by a thread at a time.
+constexpr std::size_t kRowsPerBlock = 16;
+
+constexpr auto kNone = std::numeric_limits<std::size_t>::max();
+
+using AreaKernel = void (*)(std::size_t count,
+                            const std::uint8_t* input,
+                            std::uint32_t weight,
+                            std::uint32_t* sums);
+using BlendKernel = void (*)(std::size_t count,
+                             const std::int16_t* first,
+                             const std::int16_t* second,
+                             std::uint32_t weight,
+                             std::uint8_t* output);
+
+/// Source pixels averaged for each pixel of the result along an axis, with their weights.
+struct AreaTaps
+{
+	// First source pixel of each pixel of the result.
+	std::vector<std::uint32_t> first;
+	// Index of the first weight of each pixel of the result, followed by the number of weights.
+	std::vector<std::uint32_t> offsets;
+	std::vector<std::uint16_t> weights;
+
+	std::size_t count(std::size_t i) const noexcept { return offsets[i + 1] - offsets[i]; }
+};
+
+/// Source pixels interpolated for a pixel of the result along an axis, and the second one's weight.
+struct LinearTap
+{
+	std::uint32_t first;
+	std::uint32_t second;
+	std::uint32_t weight;
+};
+
+/// Returns the taps averaging the pixels covered by each of @p to pixels resized from @p from.
+AreaTaps
+areaTaps(std::size_t from, std::size_t to)
+{
+	AreaTaps taps;
+	taps.first.resize(to);
+	taps.offsets.resize(to + 1);
+	taps.weights.reserve(to * (from / to + 2));
+
+	for (std::size_t i = 0; i < to; ++i)
+	{
+		// The pixel covers [begin, end) in units of 1 / to source pixel.
+		const auto begin = i * from;
+		const auto end = begin + from;
+		std::uint64_t covered = 0;
+		std::uint32_t previous = 0;
+
+		taps.first[i] = static_cast<std::uint32_t>(begin / to);
+		taps.offsets[i] = static_cast<std::uint32_t>(taps.weights.size());
+
+		for (auto s = begin / to; s * to < end; ++s)
+		{
+			covered += std::min(end, (s + 1) * to) - std::max(begin, s * to);
+			// Rounding the cumulated weights makes them sum to exactly 1.
+			const auto cumulated = static_cast<std::uint32_t>(((covered << kAreaBits) + from / 2) / from);
+			taps.weights.push_back(static_cast<std::uint16_t>(cumulated - previous));
+			previous = cumulated;
+		}
+	}
+
+	taps.offsets[to] = static_cast<std::uint32_t>(taps.weights.size());
+	return taps;
+}
+
+/**
+ * @brief Returns the taps interpolating each of @p to pixels resized from @p from.
+ *
+ * Centers are aligned: pixel i samples the source at (i + 1/2) * from / to - 1/2, clamped to its
+ * edges.
+ */
+std::vector<LinearTap>
+linearTaps(std::size_t from, std::size_t to)
+{
+	std::vector<LinearTap> taps(to);
+
+	for (std::size_t i = 0; i < to; ++i)
+	{
+		// Position of the sample in units of 1 / (2 * to) source pixel.
+		const auto position =
+		  static_cast<std::int64_t>((2 * i + 1) * from) - static_cast<std::int64_t>(to);
+		std::size_t first = 0;
+		std::size_t weight = 0;
+
+		if (position > 0)
+		{
+			first = static_cast<std::size_t>(position) / (2 * to);
+			weight = (static_cast<std::size_t>(position) % (2 * to) * kBilinearOne + to) / (2 * to);
+		}
+
+		if (weight == kBilinearOne)
+		{
+			++first;
+			weight = 0;
+		}
+
+		if (first + 1 >= from)
+		{
+			first = from - 1;
+			weight = 0;
+		}
+
+		taps[i] = {static_cast<std::uint32_t>(first),
+		           static_cast<std::uint32_t>(weight ? first + 1 : first),
+		           static_cast<std::uint32_t>(weight)};
+	}
+
+	return taps;
+}
+
+/// Adds the samples of a source row times their weight to the sums of a row of the result.
+struct AreaRow
+{
+	static void
+	scalar(std::size_t i,
+	       std::size_t count,
+	       const std::uint8_t* input,
+	       std::uint32_t weight,
+	       std::uint32_t* sums) noexcept
+	{
+		for (; i < count; ++i)
+		{
+			sums[i] += weight * input[i];
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t count,
+	      const std::uint8_t* input,
+	      std::uint32_t weight,
+	      std::uint32_t* sums) noexcept
+	{
+		// The high halves of the 32-bit samples are zeros, so each product of pairs is the sample
+		// times the weight.
+		const auto w = _mm_set1_epi32(static_cast<int>(weight));
+		const auto zero = _mm_setzero_si128();
+
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			const auto x = loadBytes(input + i);
+			const auto low = _mm_unpacklo_epi8(x, zero);
+			const auto high = _mm_unpackhi_epi8(x, zero);
+			const __m128i values[4] = {_mm_unpacklo_epi16(low, zero),
+			                           _mm_unpackhi_epi16(low, zero),
+			                           _mm_unpacklo_epi16(high, zero),
+			                           _mm_unpackhi_epi16(high, zero)};
+
+			for (auto k = 0; k < 4; ++k)
+			{
+				const auto target = reinterpret_cast<__m128i*>(sums + i + 4 * k);
+				_mm_storeu_si128(target,
+				                 _mm_add_epi32(_mm_loadu_si128(target), _mm_madd_epi16(values[k], w)));
+			}
+		}
+		return i;
+	}
+
+	NEURALA_IMAGE_TARGET("avx2")
+	static std::size_t
+	avx2(std::size_t count,
+	     const std::uint8_t* input,
+	     std::uint32_t weight,
+	     std::uint32_t* sums) noexcept
+	{
+		const auto w = _mm256_set1_epi32(static_cast<int>(weight));
+
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			for (auto k = 0; k < 4; ++k)
+			{
+				const auto values = _mm256_cvtepu8_epi32(loadHalf(input + i + 8 * k));
+				const auto target = reinterpret_cast<__m256i*>(sums + i + 8 * k);
+				_mm256_storeu_si256(
+				  target, _mm256_add_epi32(_mm256_loadu_si256(target), _mm256_madd_epi16(values, w)));
+			}
+		}
+		return i;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	static std::size_t
+	neon(std::size_t count,
+	     const std::uint8_t* input,
+	     std::uint32_t weight,
+	     std::uint32_t* sums) noexcept
+	{
+		const auto w = vdup_n_u16(static_cast<std::uint16_t>(weight));
+
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			const auto x = vld1q_u8(input + i);
+			const uint16x4_t values[4] = {vget_low_u16(vmovl_u8(vget_low_u8(x))),
+			                              vget_high_u16(vmovl_u8(vget_low_u8(x))),
+			                              vget_low_u16(vmovl_u8(vget_high_u8(x))),
+			                              vget_high_u16(vmovl_u8(vget_high_u8(x)))};
+
+			for (auto k = 0; k < 4; ++k)
+			{
+				const auto target = sums + i + 4 * k;
+				vst1q_u32(target, vmlal_u16(vld1q_u32(target), values[k], w));
+			}
+		}
+		return i;
+	}
+#endif
+};
+
+/// Blends two interpolated rows into a row of the result, given the weight of the second.
+struct Blend
+{
+	static constexpr unsigned kShift = 2 * kBilinearBits;
+
+	static void
+	scalar(std::size_t i,
+	       std::size_t count,
+	       const std::int16_t* first,
+	       const std::int16_t* second,
+	       std::uint32_t weight,
+	       std::uint8_t* output) noexcept
+	{
+		const auto w = static_cast<std::int32_t>(weight);
+		const auto one = static_cast<std::int32_t>(kBilinearOne);
+		for (; i < count; ++i)
+		{
+			const auto value = first[i] * (one - w) + second[i] * w + (1 << (kShift - 1));
+			output[i] = static_cast<std::uint8_t>(value >> kShift);
+		}
+	}
+
+#ifdef NEURALA_IMAGE_X86
+	/// Blends 8 samples to 32 bits.
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static __m128i
+	blend(const std::int16_t* first, const std::int16_t* second, __m128i weights) noexcept
+	{
+		const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second));
+		const auto half = _mm_set1_epi32(1 << (kShift - 1));
+		const auto low = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), weights), half);
+		const auto high = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a, b), weights), half);
+		return _mm_packs_epi32(_mm_srai_epi32(low, kShift), _mm_srai_epi32(high, kShift));
+	}
+
+	NEURALA_IMAGE_TARGET("sse4.1")
+	static std::size_t
+	sse41(std::size_t count,
+	      const std::int16_t* first,
+	      const std::int16_t* second,
+	      std::uint32_t weight,
+	      std::uint8_t* output) noexcept
+	{
+		// Pairs of samples of both rows are multiplied by the pair of weights.
+		const auto weights = _mm_set1_epi32(static_cast<int>(weight << 16 | (kBilinearOne - weight)));
+
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			const auto low = blend(first + i, second + i, weights);
+			const auto high = blend(first + i + 8, second + i + 8, weights);
+			storeBytes(output + i, _mm_packus_epi16(low, high));
+		}
+		return i;
+	}
+
+	/// Blends 16 samples to 16 bits.
+	NEURALA_IMAGE_TARGET("avx2")
+	static __m256i
+	blend(const std::int16_t* first, const std::int16_t* second, __m256i weights) noexcept
+	{
+		const auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+		const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second));
+		const auto half = _mm256_set1_epi32(1 << (kShift - 1));
+		const auto low = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), weights), half);
+		const auto high = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), weights), half);
+		// Unpacking and packing both work lane by lane, which keeps the samples in order.
+		return _mm256_packs_epi32(_mm256_srai_epi32(low, kShift), _mm256_srai_epi32(high, kShift));
+	}
+
+	NEURALA_IMAGE_TARGET("avx2")
+	static std::size_t
+	avx2(std::size_t count,
+	     const std::int16_t* first,
+	     const std::int16_t* second,
+	     std::uint32_t weight,
+	     std::uint8_t* output) noexcept
+	{
+		const auto weights = _mm256_set1_epi32(static_cast<int>(weight << 16 | (kBilinearOne - weight)));
+
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			const auto low = blend(first + i, second + i, weights);
+			const auto high = blend(first + i + 16, second + i + 16, weights);
+			const auto bytes = _mm256_packus_epi16(low, high);
+			storeBytes256(output + i, _mm256_permute4x64_epi64(bytes, 0xD8));
+		}
+		return i;
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	/// Blends 8 samples to 16 bits.
+	static int16x8_t
+	blend(const std::int16_t* first, const std::int16_t* second, std::uint32_t weight) noexcept
+	{
+		const auto a = vld1q_s16(first);
+		const auto b = vld1q_s16(second);
+		const auto w0 = static_cast<std::int16_t>(kBilinearOne - weight);
+		const auto w1 = static_cast<std::int16_t>(weight);
+		const auto low = vmlal_n_s16(vmull_n_s16(vget_low_s16(a), w0), vget_low_s16(b), w1);
+		const auto high = vmlal_n_s16(vmull_n_s16(vget_high_s16(a), w0), vget_high_s16(b), w1);
+		return vcombine_s16(vrshrn_n_s32(low, kShift), vrshrn_n_s32(high, kShift));
+	}
+
+	static std::size_t
+	neon(std::size_t count,
+	     const std::int16_t* first,
+	     const std::int16_t* second,
+	     std::uint32_t weight,
+	     std::uint8_t* output) noexcept
+	{
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			const auto low = blend(first + i, second + i, weight);
+			const auto high = blend(first + i + 8, second + i + 8, weight);
+			vst1q_u8(output + i, vcombine_u8(vqmovun_s16(low), vqmovun_s16(high)));
+		}
+		return i;
+	}
+#endif
+};
+
+/// Averages the columns of the sums of the rows covered by a row of the result.
+template<std::size_t kChannels>
+void
+sumColumns(const AreaTaps& taps,
+           std::size_t width,
+           std::size_t channels,
+           const std::uint32_t* sums,
+           std::uint8_t* output) noexcept
+{
+	constexpr unsigned shift = 2 * kAreaBits;
+	const auto c = kChannels ? kChannels : channels;
+
+	for (std::size_t x = 0; x < width; ++x)
+	{
+		const auto input = sums + taps.first[x] * c;
+		const auto weights = taps.weights.data() + taps.offsets[x];
+		const auto count = taps.count(x);
+
+		for (std::size_t j = 0; j < c; ++j)
+		{
+			// Sums of 8-bit samples weighted twice by weights summing to 1 fit in 32 bits.
+			std::uint32_t sum = 1u << (shift - 1);
+			for (std::size_t k = 0; k < count; ++k)
+			{
+				sum += weights[k] * input[k * c + j];
+			}
+			output[x * c + j] = static_cast<std::uint8_t>(sum >> shift);
+		}
+	}
+}
+
+/// Interpolates the columns of a source row for a row of the result.
+template<std::size_t kChannels>
+void
+interpolateColumns(const std::vector<LinearTap>& taps,
+                   std::size_t channels,
+                   const std::uint8_t* input,
+                   std::int16_t* output) noexcept
+{
+	const auto c = kChannels ? kChannels : channels;
+
+	for (std::size_t x = 0; x < taps.size(); ++x)
+	{
+		const auto& tap = taps[x];
+		const auto first = input + tap.first * c;
+		const auto second = input + tap.second * c;
+
+		for (std::size_t j = 0; j < c; ++j)
+		{
+			const auto value = first[j] * (kBilinearOne - tap.weight) + second[j] * tap.weight;
+			output[x * c + j] = static_cast<std::int16_t>(value);
+		}
+	}
+}
+
+/// A plane of the result, and the region of the source plane it is resized from.
+struct PlaneJob
+{
+	ImagePlane plane;
+	std::size_t x = 0;
+	std::size_t y = 0;
+	std::size_t width = 0;
+	std::size_t height = 0;
+	std::size_t resizedWidth = 0;
+	std::size_t resizedHeight = 0;
+	// Samples per pixel.
+	std::size_t channels = 0;
+	std::uint8_t* output = nullptr;
+
+	AreaTaps areaColumns;
+	AreaTaps areaRows;
+	std::vector<LinearTap> linearColumns;
+	std::vector<LinearTap> linearRows;
+
+	/// Returns the row @p y of the region.
+	const std::uint8_t* row(std::size_t y) const noexcept
+	{
+		return reinterpret_cast<const std::uint8_t*>(plane.row(this->y + y)) + x * channels;
+	}
+
+	/// Returns the row @p y of the result.
+	std::uint8_t* resizedRow(std::size_t y) const noexcept
+	{
+		return output + y * resizedWidth * channels;
+	}
+
+	std::size_t blocks() const noexcept
+	{
+		return (resizedHeight + kRowsPerBlock - 1) / kRowsPerBlock;
+	}
+};
+
+/// Resizes the rows [@p begin, @p end) of a plane by averaging areas.
+void
+resizeArea(const PlaneJob& job, std::size_t begin, std::size_t end, AreaKernel accumulate)
+{
+	const auto count = job.width * job.channels;
+	std::vector<std::uint32_t> sums(count);
+
+	for (auto y = begin; y < end; ++y)
+	{
+		std::fill(sums.begin(), sums.end(), 0);
+
+		const auto& rows = job.areaRows;
+		for (std::size_t k = 0; k < rows.count(y); ++k)
+		{
+			const auto weight = rows.weights[rows.offsets[y] + k];
+			if (weight != 0)
+			{
+				accumulate(count, job.row(rows.first[y] + k), weight, sums.data());
+			}
+		}
+
+		const auto output = job.resizedRow(y);
+		switch (job.channels)
+		{
+			case 1:
+				sumColumns<1>(job.areaColumns, job.resizedWidth, 1, sums.data(), output);
+				break;
+			case 2:
+				sumColumns<2>(job.areaColumns, job.resizedWidth, 2, sums.data(), output);
+				break;
+			case 3:
+				sumColumns<3>(job.areaColumns, job.resizedWidth, 3, sums.data(), output);
+				break;
+			case 4:
+				sumColumns<4>(job.areaColumns, job.resizedWidth, 4, sums.data(), output);
+				break;
+			default:
+				sumColumns<0>(job.areaColumns, job.resizedWidth, job.channels, sums.data(), output);
+				break;
+		}
+	}
+}
+
+/// Resizes the rows [@p begin, @p end) of a plane by bilinear interpolation.
+void
+resizeBilinear(const PlaneJob& job, std::size_t begin, std::size_t end, BlendKernel blend)
+{
+	const auto count = job.resizedWidth * job.channels;
+	std::vector<std::int16_t> buffer(2 * count);
+	std::int16_t* const rows[2] = {buffer.data(), buffer.data() + count};
+	// Source rows interpolated in each half of the buffer, kept for the next rows of the result.
+	std::size_t interpolated[2] = {kNone, kNone};
+
+	// Returns the source row @p y interpolated, evicting any row but @p kept.
+	const auto interpolate = [&](std::size_t y, std::size_t kept) {
+		for (auto k = 0; k < 2; ++k)
+		{
+			if (interpolated[k] == y)
+			{
+				return rows[k];
+			}
+		}
+
+		const auto k = interpolated[0] == kept ? 1 : 0;
+		const auto input = job.row(y);
+		switch (job.channels)
+		{
+			case 1:
+				interpolateColumns<1>(job.linearColumns, 1, input, rows[k]);
+				break;
+			case 2:
+				interpolateColumns<2>(job.linearColumns, 2, input, rows[k]);
+				break;
+			case 3:
+				interpolateColumns<3>(job.linearColumns, 3, input, rows[k]);
+				break;
+			case 4:
+				interpolateColumns<4>(job.linearColumns, 4, input, rows[k]);
+				break;
+			default:
+				interpolateColumns<0>(job.linearColumns, job.channels, input, rows[k]);
+				break;
+		}
+		interpolated[k] = y;
+		return rows[k];
+	};
+
+	for (auto y = begin; y < end; ++y)
+	{
+		const auto& tap = job.linearRows[y];
+		const auto first = interpolate(tap.first, tap.second);
+		const auto second = interpolate(tap.second, tap.first);
+		blend(count, first, second, tap.weight, job.resizedRow(y));
+	}
+}
+
+/// Returns if the plane @p plane of images in @p format holds the chroma samples of YUV 4:2:0.
+bool
+subsampled(const PixelFormat& format, std::size_t plane) noexcept
+{
+	switch (format.colorSpace())
+	{
+		case EColorSpace::YUV420:
+		case EColorSpace::NV12:
+		case EColorSpace::NV21:
+			return plane > 0;
+		default:
+			return false;
+	}
+}
+
+/// Returns the number of samples of the pixels of the plane @p plane of images in @p format.
+std::size_t
+samplesPerPixel(const PixelFormat& format, std::size_t plane) noexcept
+{
+	switch (format.layout())
+	{
+		case ELayout::interleaved:
+			return format.channels();
+		case ELayout::semiplanar:
+			return plane == 0 ? 1 : format.channels() - 1;
+		default:
+			return 1;
+	}
+}
+
+/**
+ * @brief Returns if images in @p format can be cropped to @p region and resized to @p width by
+ *        @p height pixels, keeping their chroma samples aligned.
+ */
+bool
+resizable(const PixelFormat& format, const Region& region, std::size_t width, std::size_t height)
+{
+	if (format.colorSpace() == EColorSpace::unknown || region.width == 0 || region.height == 0
+	    || width == 0 || height == 0)
+	{
+		return false;
+	}
+
+	return !subsampled(format, 1)
+	       || ((region.x | region.y | region.width | region.height | width | height) & 1) == 0;
+}
+} // namespace
+
+PixelFormat
+resizedFormat(const PixelFormat& from) noexcept
+{
+	if (!from.known() || from.datatype() != EDatatype::uint8)
+	{
+		return {};
+	}
+
+	switch (from.colorSpace())
+	{
+		case EColorSpace::RGB565:
+		case EColorSpace::bayerRG:
+		case EColorSpace::bayerGR:
+		case EColorSpace::bayerBG:
+		case EColorSpace::bayerGB:
+		case EColorSpace::YUV422:
+			return {};
+		case EColorSpace::YUV420:
+		case EColorSpace::NV12:
+		case EColorSpace::NV21:
+			return from.layout() == ELayout::interleaved ? PixelFormat() : from;
+		default:
+			return from;
+	}
+}
+
+Resizer::Resizer(const Region& region,
+                 std::size_t width,
+                 std::size_t height,
+                 EInterpolation interpolation,
+                 std::size_t threads,
+                 ESimd simd)
+ : m_region{region},
+   m_width{width},
+   m_height{height},
+   m_interpolation{interpolation},
+   m_simd{supportedSimd(simd)},
+   m_pool(threads)
+{ }
+
+Region
+Resizer::region(std::size_t width, std::size_t height) const noexcept
+{
+	if (m_region.x >= width || m_region.y >= height)
+	{
+		return {};
+	}
+
+	const auto right = width - m_region.x;
+	const auto bottom = height - m_region.y;
+	return {m_region.x,
+	        m_region.y,
+	        m_region.width ? std::min(m_region.width, right) : right,
+	        m_region.height ? std::min(m_region.height, bottom) : bottom};
+}
+
+dto::ImageMetadata
+Resizer::metadata(const dto::ImageMetadata& from, std::size_t channels) const
+{
+	const auto format = resizedFormat(PixelFormat::fromMetadata(from, channels));
+	const auto region = this->region(from.width(), from.height());
+	const auto width = m_width ? m_width : region.width;
+	const auto height = m_height ? m_height : region.height;
+
+	if (!resizable(format, region, width, height))
+	{
+		return {};
+	}
+
+	return format.metadata(width, height);
+}
+
+dto::ImageView
+Resizer::operator()(const StridedImageView& source, std::byte* data, std::size_t size) noexcept
+{
+	const auto format = resizedFormat(source.format());
+	const auto region = this->region(source.width(), source.height());
+	const auto width = m_width ? m_width : region.width;
+	const auto height = m_height ? m_height : region.height;
+
+	if (!resizable(format, region, width, height) || source.empty() || !data
+	    || size < format.frameBytes(width, height))
+	{
+		return {};
+	}
+
+	const auto area = m_interpolation == EInterpolation::area;
+	const auto cropped = width == region.width && height == region.height;
+	const auto accumulate = kernel<AreaRow, AreaKernel>(m_simd);
+	const auto blend = kernel<Blend, BlendKernel>(m_simd);
+
+	try
+	{
+		std::vector<PlaneJob> planes(source.planes());
+		auto output = reinterpret_cast<std::uint8_t*>(data);
+		std::size_t blocks = 0;
+
+		for (std::size_t i = 0; i < planes.size(); ++i)
+		{
+			const std::size_t divisor = subsampled(format, i) ? 2 : 1;
+			auto& job = planes[i];
+
+			job.plane = source.plane(i);
+			job.x = region.x / divisor;
+			job.y = region.y / divisor;
+			job.width = region.width / divisor;
+			job.height = region.height / divisor;
+			job.resizedWidth = width / divisor;
+			job.resizedHeight = height / divisor;
+			job.channels = samplesPerPixel(format, i);
+			job.output = output;
+
+			// Cropped rows are copied as is.
+			if (!cropped && area)
+			{
+				job.areaColumns = areaTaps(job.width, job.resizedWidth);
+				job.areaRows = areaTaps(job.height, job.resizedHeight);
+			}
+			else if (!cropped)
+			{
+				job.linearColumns = linearTaps(job.width, job.resizedWidth);
+				job.linearRows = linearTaps(job.height, job.resizedHeight);
+			}
+
+			output += job.resizedWidth * job.resizedHeight * job.channels;
+			blocks += job.blocks();
+		}
+
+		std::atomic<bool> failed{false};
+		const std::function<void(std::size_t)> resizeBlock = [&](std::size_t block) {
+			auto plane = planes.begin();
+			for (; block >= plane->blocks(); ++plane)
+			{
+				block -= plane->blocks();
+			}
+
+			const auto begin = block * kRowsPerBlock;
+			const auto end = std::min(begin + kRowsPerBlock, plane->resizedHeight);
+
+			try
+			{
+				if (cropped)
+				{
+					for (auto y = begin; y < end; ++y)
+					{
+						std::memcpy(plane->resizedRow(y), plane->row(y), plane->width * plane->channels);
+					}
+				}
+				else if (area)
+				{
+					resizeArea(*plane, begin, end, accumulate);
+				}
+				else
+				{
+					resizeBilinear(*plane, begin, end, blend);
+				}
+			}
+			catch (const std::bad_alloc&)
+			{
+				failed = true;
+			}
+		};
+
+		m_pool.run(blocks, resizeBlock);
+
+		if (failed)
+		{
+			return {};
+		}
+	}
+	catch (const std::exception&)
+	{
+		return {};
+	}
+
+	return {format.metadata(width, height), data};
+}
+
+} // namespace neurala
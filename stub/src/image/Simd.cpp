@@ -0,0 +1,143 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "neurala/image/Simd.h"
+
+#include "SimdTarget.h"
+
+#if defined(NEURALA_IMAGE_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace neurala
+{
+namespace
+{
+#if defined(NEURALA_IMAGE_X86) && defined(_MSC_VER)
+bool
+osSavesAvx() noexcept
+{
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+}
+#endif
+
+bool
+supportsAvx2() noexcept
+{
+#if defined(NEURALA_IMAGE_X86) && defined(__GNUC__)
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+#elif defined(NEURALA_IMAGE_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7 || !osSavesAvx())
+	{
+		return false;
+	}
+
+	__cpuid(info, 1);
+	const auto f16c = (info[2] & (1 << 29)) != 0;
+	__cpuidex(info, 7, 0);
+	return f16c && (info[1] & (1 << 5)) != 0;
+#else
+	return false;
+#endif
+}
+
+bool
+supportsNeon() noexcept
+{
+#ifdef NEURALA_IMAGE_NEON
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool
+supportsSse41() noexcept
+{
+#if defined(NEURALA_IMAGE_X86) && defined(__GNUC__)
+	return __builtin_cpu_supports("sse4.1");
+#elif defined(NEURALA_IMAGE_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 19)) != 0;
+#else
+	return false;
+#endif
+}
+} // namespace
+
+ESimd
+bestSimd() noexcept
+{
+	static const auto simd = supportsNeon()    ? ESimd::neon
+	                         : supportsAvx2()  ? ESimd::avx2
+	                         : supportsSse41() ? ESimd::sse41
+	                                           : ESimd::scalar;
+	return simd;
+}
+
+bool
+isSupported(ESimd simd) noexcept
+{
+	switch (simd)
+	{
+		case ESimd::scalar:
+			return true;
+		case ESimd::sse41:
+			return bestSimd() == ESimd::sse41 || bestSimd() == ESimd::avx2;
+		case ESimd::avx2:
+			return bestSimd() == ESimd::avx2;
+		case ESimd::neon:
+			return bestSimd() == ESimd::neon;
+		default:
+			return false;
+	}
+}
+
+ESimd
+supportedSimd(ESimd simd) noexcept
+{
+	if (isSupported(simd))
+	{
+		return simd;
+	}
+
+	return simd == ESimd::avx2 && isSupported(ESimd::sse41) ? ESimd::sse41 : ESimd::scalar;
+}
+
+std::string_view
+toString(ESimd simd) noexcept
+{
+	switch (simd)
+	{
+		case ESimd::sse41:
+			return "sse41";
+		case ESimd::avx2:
+			return "avx2";
+		case ESimd::neon:
+			return "neon";
+		default:
+			return "scalar";
+	}
+}
+
+} // namespace neurala
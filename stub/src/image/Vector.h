@@ -0,0 +1,267 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NEURALA_IMAGE_VECTOR_H
+#define NEURALA_IMAGE_VECTOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "neurala/image/Simd.h"
+
+#include "SimdTarget.h"
+
+// Dispatch and vector helpers shared by the image processing kernels.
+namespace neurala::detail
+{
+/**
+ * @brief Runs a row kernel.
+ *
+ * Kernels provide a scalar implementation starting from any element of the row, and vector
+ * implementations returning the number of elements they processed. The instruction sets a build
+ * lacks fall back to the scalar implementation.
+ */
+template<class Kernel, ESimd simd, class... Args>
+void
+run(std::size_t count, Args... args) noexcept
+{
+	std::size_t i = 0;
+
+#ifdef NEURALA_IMAGE_X86
+	if constexpr (simd == ESimd::sse41)
+	{
+		i = Kernel::sse41(count, args...);
+	}
+	else if constexpr (simd == ESimd::avx2)
+	{
+		i = Kernel::avx2(count, args...);
+	}
+#endif
+
+#ifdef NEURALA_IMAGE_NEON
+	if constexpr (simd == ESimd::neon)
+	{
+		i = Kernel::neon(count, args...);
+	}
+#endif
+
+	Kernel::scalar(i, count, args...);
+}
+
+/// Implementations of a kernel, indexed by ESimd.
+template<class Kernel, class Function>
+struct Kernels;
+
+template<class Kernel, class... Args>
+struct Kernels<Kernel, void (*)(std::size_t, Args...)>
+{
+	static constexpr std::array<void (*)(std::size_t, Args...), 4> kAll = {
+	  run<Kernel, ESimd::scalar, Args...>,
+	  run<Kernel, ESimd::sse41, Args...>,
+	  run<Kernel, ESimd::avx2, Args...>,
+	  run<Kernel, ESimd::neon, Args...>};
+};
+
+/// Returns the implementation of a kernel for @p simd, which must be supported.
+template<class Kernel, class Function>
+Function
+kernel(ESimd simd) noexcept
+{
+	return Kernels<Kernel, Function>::kAll[static_cast<std::size_t>(simd)];
+}
+
+/// Byte shuffle of a 16-byte register, negative indices giving zeros.
+struct ByteShuffle
+{
+	alignas(16) std::int8_t bytes[16];
+};
+
+/// Returns the shuffles building each output register k of 3 interleaved planes, at 3 * k + plane.
+constexpr std::array<ByteShuffle, 9>
+interleave3() noexcept
+{
+	std::array<ByteShuffle, 9> shuffles{};
+	for (auto k = 0; k < 3; ++k)
+	{
+		for (auto plane = 0; plane < 3; ++plane)
+		{
+			for (auto j = 0; j < 16; ++j)
+			{
+				const auto byte = 16 * k + j;
+				const auto index = byte % 3 == plane ? byte / 3 : -128;
+				shuffles[3 * k + plane].bytes[j] = static_cast<std::int8_t>(index);
+			}
+		}
+	}
+	return shuffles;
+}
+
+/// Returns the shuffles extracting each plane of 3 interleaved input registers k, at 3 * plane + k.
+constexpr std::array<ByteShuffle, 9>
+deinterleave3() noexcept
+{
+	std::array<ByteShuffle, 9> shuffles{};
+	for (auto plane = 0; plane < 3; ++plane)
+	{
+		for (auto k = 0; k < 3; ++k)
+		{
+			for (auto j = 0; j < 16; ++j)
+			{
+				const auto byte = 3 * j + plane;
+				const auto index = byte / 16 == k ? byte % 16 : -128;
+				shuffles[3 * plane + k].bytes[j] = static_cast<std::int8_t>(index);
+			}
+		}
+	}
+	return shuffles;
+}
+
+inline constexpr auto kInterleave3 = interleave3();
+inline constexpr auto kDeinterleave3 = deinterleave3();
+
+#ifdef NEURALA_IMAGE_X86
+NEURALA_IMAGE_TARGET("sse4.1")
+inline __m128i
+load(const ByteShuffle& shuffle) noexcept
+{
+	return _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle.bytes));
+}
+
+NEURALA_IMAGE_TARGET("sse4.1")
+inline __m128i
+loadBytes(const std::uint8_t* bytes) noexcept
+{
+	return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+}
+
+/// Loads 8 bytes to the low half of a register.
+NEURALA_IMAGE_TARGET("sse4.1")
+inline __m128i
+loadHalf(const std::uint8_t* bytes) noexcept
+{
+	return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes));
+}
+
+NEURALA_IMAGE_TARGET("sse4.1")
+inline void
+storeBytes(std::uint8_t* bytes, __m128i value) noexcept
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), value);
+}
+
+NEURALA_IMAGE_TARGET("sse4.1")
+inline void
+store3(__m128i a, __m128i b, __m128i c, std::uint8_t* output) noexcept
+{
+	for (auto k = 0; k < 3; ++k)
+	{
+		const auto bytes = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, load(kInterleave3[3 * k])),
+		                                             _mm_shuffle_epi8(b, load(kInterleave3[3 * k + 1]))),
+		                                _mm_shuffle_epi8(c, load(kInterleave3[3 * k + 2])));
+		storeBytes(output + 16 * k, bytes);
+	}
+}
+
+NEURALA_IMAGE_TARGET("sse4.1")
+inline __m128i
+extract3(__m128i x0, __m128i x1, __m128i x2, int plane) noexcept
+{
+	return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, load(kDeinterleave3[3 * plane])),
+	                                 _mm_shuffle_epi8(x1, load(kDeinterleave3[3 * plane + 1]))),
+	                    _mm_shuffle_epi8(x2, load(kDeinterleave3[3 * plane + 2])));
+}
+
+NEURALA_IMAGE_TARGET("avx2")
+inline __m256i
+load256(const ByteShuffle& shuffle) noexcept
+{
+	return _mm256_broadcastsi128_si256(load(shuffle));
+}
+
+NEURALA_IMAGE_TARGET("avx2")
+inline __m256i
+loadBytes256(const std::uint8_t* bytes) noexcept
+{
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+}
+
+NEURALA_IMAGE_TARGET("avx2")
+inline void
+storeBytes256(std::uint8_t* bytes, __m256i value) noexcept
+{
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(bytes), value);
+}
+
+/// Interleaves 32 pixels whose first and last 16 are in the low and high lanes of the planes.
+NEURALA_IMAGE_TARGET("avx2")
+inline void
+store3(__m256i a, __m256i b, __m256i c, std::uint8_t* output) noexcept
+{
+	__m256i lanes[3];
+	for (auto k = 0; k < 3; ++k)
+	{
+		lanes[k] = _mm256_or_si256(
+		  _mm256_or_si256(_mm256_shuffle_epi8(a, load256(kInterleave3[3 * k])),
+		                  _mm256_shuffle_epi8(b, load256(kInterleave3[3 * k + 1]))),
+		  _mm256_shuffle_epi8(c, load256(kInterleave3[3 * k + 2])));
+	}
+
+	storeBytes256(output, _mm256_permute2x128_si256(lanes[0], lanes[1], 0x20));
+	storeBytes256(output + 32, _mm256_permute2x128_si256(lanes[2], lanes[0], 0x30));
+	storeBytes256(output + 64, _mm256_permute2x128_si256(lanes[1], lanes[2], 0x31));
+}
+
+/// Loads 32 interleaved pixels, the first and last 16 being in the low and high lanes.
+NEURALA_IMAGE_TARGET("avx2")
+inline void
+load3(const std::uint8_t* input, __m256i& a, __m256i& b, __m256i& c) noexcept
+{
+	const auto x0 = loadBytes256(input);
+	const auto x1 = loadBytes256(input + 32);
+	const auto x2 = loadBytes256(input + 64);
+	const __m256i lanes[3] = {_mm256_permute2x128_si256(x0, x1, 0x30),
+	                          _mm256_permute2x128_si256(x0, x2, 0x21),
+	                          _mm256_permute2x128_si256(x1, x2, 0x30)};
+
+	__m256i planes[3];
+	for (auto plane = 0; plane < 3; ++plane)
+	{
+		planes[plane] = _mm256_or_si256(
+		  _mm256_or_si256(_mm256_shuffle_epi8(lanes[0], load256(kDeinterleave3[3 * plane])),
+		                  _mm256_shuffle_epi8(lanes[1], load256(kDeinterleave3[3 * plane + 1]))),
+		  _mm256_shuffle_epi8(lanes[2], load256(kDeinterleave3[3 * plane + 2])));
+	}
+
+	a = planes[0];
+	b = planes[1];
+	c = planes[2];
+}
+
+/// Packs 16-bit values to bytes, in order, unlike _mm256_packus_epi16 which packs lane by lane.
+NEURALA_IMAGE_TARGET("avx2")
+inline __m256i
+packInOrder(__m256i a, __m256i b) noexcept
+{
+	return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8);
+}
+#endif
+
+} // namespace neurala::detail
+
+#endif // NEURALA_IMAGE_VECTOR_H
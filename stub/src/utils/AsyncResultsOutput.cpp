@@ -0,0 +1,305 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "neurala/utils/AsyncResultsOutput.h"
+
+namespace neurala
+{
+namespace
+{
+// Set in the sequence of a slot while a thread rewrites or empties it.
+constexpr auto kBusy = std::size_t(1) << (std::numeric_limits<std::size_t>::digits - 1);
+
+template<class T>
+void
+release(std::atomic<T>& sequence, T value) noexcept
+{
+	sequence.store(value, std::memory_order_release);
+	sequence.notify_all();
+}
+} // namespace
+
+void
+SharedResult::assign(const std::string& metadata, const dto::ImageView* image, bool frames)
+{
+	m_metadata.assign(metadata);
+	m_frame = frames && image ? FramePool::shared().share(*image) : SharedFrame();
+	m_view = m_frame.view();
+}
+
+void
+SharedResult::release() noexcept
+{
+	auto references = m_references.load(std::memory_order_acquire);
+	while (references > 1
+	       && !m_references.compare_exchange_weak(references, references - 1,
+	                                              std::memory_order_acq_rel,
+	                                              std::memory_order_acquire))
+	{
+	}
+
+	// The last holder, which sees what the others did with the result, lets the frame go before the
+	// result can be claimed again, so that it does not keep frames while unused.
+	if (references == 1)
+	{
+		m_frame = {};
+		m_references.store(0, std::memory_order_release);
+	}
+}
+
+ResultsOutputWorker::ResultsOutputWorker(ResultsOutput& output,
+                                         std::size_t capacity,
+                                         EOverflowPolicy policy,
+                                         bool frames)
+ : m_output{output}, m_capacity{capacity}, m_policy{policy}, m_frames{frames}
+{
+	if (capacity < 2)
+	{
+		throw std::invalid_argument("Results can only be queued with a capacity of at least 2");
+	}
+
+	m_slots = std::make_unique<Slot[]>(capacity);
+	for (std::size_t i = 0; i < capacity; ++i)
+	{
+		m_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	m_thread = std::thread(&ResultsOutputWorker::run, this);
+}
+
+ResultsOutputWorker::~ResultsOutputWorker() noexcept
+{
+	push(EKind::quit, EOverflowPolicy::block, [](Slot&) {});
+	m_thread.join();
+}
+
+void
+ResultsOutputWorker::onStart(std::string_view id) noexcept
+{
+	push(EKind::start, EOverflowPolicy::block, [id](Slot& slot) { slot.text.assign(id); });
+}
+
+void
+ResultsOutputWorker::onStop(std::string_view id, ResultsOutputStatus status) noexcept
+{
+	push(EKind::stop, EOverflowPolicy::block, [id, status](Slot& slot) {
+		slot.text.assign(id);
+		slot.status = status;
+	});
+}
+
+void
+ResultsOutputWorker::operator()(const std::string& metadata, const dto::ImageView* image) noexcept
+{
+	push(EKind::result, m_policy, [&](Slot& slot) { copy(slot, metadata, image); });
+}
+
+void
+ResultsOutputWorker::operator()(SharedResult& result) noexcept
+{
+	if (!push(EKind::shared, m_policy, [&result](Slot& slot) { slot.shared = &result; }))
+	{
+		result.release();
+	}
+}
+
+template<class Write>
+bool
+ResultsOutputWorker::push(EKind kind, EOverflowPolicy policy, const Write& write) noexcept
+{
+	for (;;)
+	{
+		auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+		auto& slot = m_slots[position % m_capacity];
+		const auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+		if (sequence & kBusy)
+		{
+			slot.sequence.wait(sequence, std::memory_order_relaxed);
+			continue;
+		}
+
+		const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+		if (difference > 0)
+		{
+			// Another thread queued an entry meanwhile.
+			continue;
+		}
+
+		if (difference == 0)
+		{
+			if (m_enqueuePosition.compare_exchange_weak(position, position + 1,
+			                                            std::memory_order_relaxed))
+			{
+				fill(slot, kind, write);
+				release(slot.sequence, position + 1);
+				return true;
+			}
+			continue;
+		}
+
+		// The queue is full: the slot still holds the entry queued a lap before.
+		switch (policy)
+		{
+			case EOverflowPolicy::drop:
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			case EOverflowPolicy::block:
+				slot.sequence.wait(sequence, std::memory_order_relaxed);
+				break;
+			case EOverflowPolicy::coalesce:
+				if (const auto coalesced = coalesce(position, kind, write);
+				    coalesced != ECoalesced::retry)
+				{
+					return coalesced == ECoalesced::replaced;
+				}
+				std::this_thread::yield();
+				break;
+		}
+	}
+}
+
+template<class Write>
+ResultsOutputWorker::ECoalesced
+ResultsOutputWorker::coalesce(std::size_t position, EKind kind, const Write& write) noexcept
+{
+	auto& slot = m_slots[(position - 1) % m_capacity];
+
+	// The last entry may be handed out or still be written meanwhile, in which case the caller
+	// tries again.
+	auto expected = position;
+	if (!slot.sequence.compare_exchange_strong(expected, position | kBusy,
+	                                           std::memory_order_acquire,
+	                                           std::memory_order_relaxed))
+	{
+		return ECoalesced::retry;
+	}
+
+	auto coalesced = ECoalesced::dropped;
+	if (slot.kind == EKind::result || slot.kind == EKind::shared)
+	{
+		if (slot.kind == EKind::shared)
+		{
+			slot.shared->release();
+		}
+
+		m_coalesced.fetch_add(1, std::memory_order_relaxed);
+		fill(slot, kind, write);
+		coalesced = ECoalesced::replaced;
+	}
+	else
+	{
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	release(slot.sequence, position);
+	return coalesced;
+}
+
+template<class Write>
+void
+ResultsOutputWorker::fill(Slot& slot, EKind kind, const Write& write) noexcept
+{
+	try
+	{
+		write(slot);
+		slot.kind = kind;
+	}
+	catch (const std::bad_alloc&)
+	{
+		slot.kind = EKind::none;
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void
+ResultsOutputWorker::copy(Slot& slot, const std::string& metadata, const dto::ImageView* image)
+{
+	// Strings keep their capacity from result to result, so that they are no longer allocated once
+	// results keep their size.
+	slot.frame = {};
+	slot.text.assign(metadata);
+	slot.frame = m_frames && image ? FramePool::shared().share(*image) : SharedFrame();
+}
+
+void
+ResultsOutputWorker::run() noexcept
+{
+	// Entry handed out, swapped with the slot it was queued in so that both keep their buffers.
+	Slot entry;
+
+	for (std::size_t position = 0;; ++position)
+	{
+		auto& slot = m_slots[position % m_capacity];
+
+		auto expected = position + 1;
+		while (!slot.sequence.compare_exchange_strong(expected, (position + 1) | kBusy,
+		                                              std::memory_order_acquire,
+		                                              std::memory_order_relaxed))
+		{
+			// The slot is empty, or rewritten by a coalesced result.
+			slot.sequence.wait(expected, std::memory_order_relaxed);
+			expected = position + 1;
+		}
+
+		entry.kind = slot.kind;
+		entry.status = slot.status;
+		entry.shared = slot.shared;
+		entry.text.swap(slot.text);
+		entry.frame = std::move(slot.frame);
+
+		release(slot.sequence, position + m_capacity);
+
+		switch (entry.kind)
+		{
+			case EKind::none:
+				break;
+			case EKind::start:
+				m_output.onStart(entry.text);
+				break;
+			case EKind::result:
+				if (entry.frame)
+				{
+					const auto image = entry.frame.view();
+					m_output(entry.text, &image);
+					entry.frame = {};
+				}
+				else
+				{
+					m_output(entry.text, nullptr);
+				}
+				break;
+			case EKind::shared:
+				m_output(entry.shared->metadata(), entry.shared->image());
+				entry.shared->release();
+				break;
+			case EKind::stop:
+				m_output.onStop(entry.text, entry.status);
+				break;
+			case EKind::quit:
+				return;
+		}
+	}
+}
+
+} // namespace neurala
@@ -0,0 +1,100 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+
+#include "neurala/utils/BlockPool.h"
+#include "neurala/utils/EventCount.h"
+
+namespace neurala
+{
+namespace
+{
+// Job shared with the workers, kept alive for those starting once it is done.
+struct Job
+{
+	Job(const std::function<void(std::size_t)>& function, std::size_t blocks) noexcept
+	 : function{function}, blocks{blocks}, pending{blocks}
+	{ }
+
+	const std::function<void(std::size_t)>& function;
+	const std::size_t blocks;
+	std::atomic<std::size_t> next{0};
+	std::atomic<std::size_t> pending;
+	EventCount done;
+};
+
+void
+runBlocks(Job& job) noexcept
+{
+	// The function is only called for blocks not processed yet, so never once the job is done.
+	for (auto block = job.next.fetch_add(1, std::memory_order_relaxed); block < job.blocks;
+	     block = job.next.fetch_add(1, std::memory_order_relaxed))
+	{
+		job.function(block);
+
+		if (job.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			job.done.notifyAll();
+		}
+	}
+}
+} // namespace
+
+BlockPool::BlockPool(std::size_t threads, Executor& executor, ETaskPriority priority) noexcept
+ : m_executor{executor},
+   m_threads{threads ? std::min(threads, executor.threads() + 1) : executor.threads()},
+   m_priority{priority}
+{ }
+
+void
+BlockPool::run(std::size_t blocks, const std::function<void(std::size_t)>& job)
+{
+	if (m_threads <= 1 || blocks <= 1)
+	{
+		for (std::size_t block = 0; block < blocks; ++block)
+		{
+			job(block);
+		}
+		return;
+	}
+
+	const auto state = std::make_shared<Job>(job, blocks);
+
+	const auto helpers = std::min(m_threads, blocks) - 1;
+	for (std::size_t i = 0; i < helpers; ++i)
+	{
+		try
+		{
+			m_executor.submit(m_priority, [state] { runBlocks(*state); });
+		}
+		catch (const std::bad_alloc&)
+		{
+			// The blocks are processed by the threads already given the job.
+			break;
+		}
+	}
+
+	runBlocks(*state);
+	state->done.wait([&] { return state->pending.load(std::memory_order_acquire) == 0; });
+}
+
+} // namespace neurala
@@ -0,0 +1,104 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <new>
+#include <stdexcept>
+
+#include "neurala/utils/CompositeResultsOutput.h"
+
+namespace neurala
+{
+ResultsBroadcaster::ResultsBroadcaster(
+  const std::vector<std::reference_wrapper<ResultsOutput>>& outputs,
+  std::size_t capacity,
+  EOverflowPolicy policy,
+  bool frames)
+ : m_frames{frames}, m_results(outputs.size() * (capacity + 1) + 1)
+{
+	if (outputs.empty())
+	{
+		throw std::invalid_argument("Results can only be handed out to some outputs");
+	}
+
+	m_workers.reserve(outputs.size());
+	for (const auto& output : outputs)
+	{
+		m_workers.push_back(
+		  std::make_unique<ResultsOutputWorker>(output.get(), capacity, policy, frames));
+	}
+}
+
+void
+ResultsBroadcaster::onStart(std::string_view id) noexcept
+{
+	for (const auto& worker : m_workers)
+	{
+		worker->onStart(id);
+	}
+}
+
+void
+ResultsBroadcaster::onStop(std::string_view id, ResultsOutputStatus status) noexcept
+{
+	for (const auto& worker : m_workers)
+	{
+		worker->onStop(id, status);
+	}
+}
+
+void
+ResultsBroadcaster::operator()(const std::string& metadata, const dto::ImageView* image) noexcept
+{
+	// Each output holds at most its queue and the result it is given, so a result is always free.
+	// The first ones are preferred, so that the strings of few of them grow to the size of results.
+	for (auto& result : m_results)
+	{
+		if (!result.claim(m_workers.size()))
+		{
+			continue;
+		}
+
+		try
+		{
+			result.assign(metadata, image, m_frames);
+		}
+		catch (const std::bad_alloc&)
+		{
+			for (std::size_t j = 0; j < m_workers.size(); ++j)
+			{
+				result.release();
+			}
+			break;
+		}
+
+		for (const auto& worker : m_workers)
+		{
+			(*worker)(result);
+		}
+		return;
+	}
+
+	// The result could not be copied, or no result was free despite the above: every output loses
+	// it.
+	for (const auto& worker : m_workers)
+	{
+		worker->countDropped();
+	}
+}
+
+} // namespace neurala
@@ -0,0 +1,271 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <string_view>
+#include <utility>
+
+#include "neurala/config/os.h"
+#include "neurala/utils/Executor.h"
+
+#if defined(NEURALA_OS_LINUX)
+#include <sched.h>
+#endif
+
+namespace neurala
+{
+namespace
+{
+// Executor and index of the worker running on the thread, if any.
+thread_local const Executor* t_executor = nullptr;
+thread_local std::size_t t_index = 0;
+
+/// Parses a list of CPUs such as "0-3,8", and returns an empty list if it is invalid.
+std::vector<unsigned>
+parseCpus(std::string_view list)
+{
+	std::vector<unsigned> cpus;
+
+	while (!list.empty())
+	{
+		const auto comma = list.find(',');
+		const auto item = list.substr(0, comma);
+		list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+
+		const auto dash = item.find('-');
+		const auto first = item.substr(0, dash);
+		const auto last = dash == std::string_view::npos ? first : item.substr(dash + 1);
+
+		const auto parse = [](std::string_view text, unsigned& value) {
+			if (text.empty() || text.size() > 9
+			    || !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; }))
+			{
+				return false;
+			}
+
+			value = 0;
+			for (const auto c : text)
+			{
+				value = value * 10 + static_cast<unsigned>(c - '0');
+			}
+			return true;
+		};
+
+		unsigned begin = 0;
+		unsigned end = 0;
+		if (!parse(first, begin) || !parse(last, end) || end < begin)
+		{
+			return {};
+		}
+
+		for (auto cpu = begin; cpu <= end; ++cpu)
+		{
+			cpus.push_back(cpu);
+		}
+	}
+
+	return cpus;
+}
+
+/// Returns the settings of the shared executor, from the environment.
+Executor::Settings
+sharedSettings()
+{
+	Executor::Settings settings;
+
+	// Each plugin has an executor of its own, so they only take half the hardware threads.
+	const auto threads = std::getenv("NEURALA_EXECUTOR_THREADS");
+	const auto count = threads ? std::atoi(threads) : 0;
+	settings.threads = count > 0 ? static_cast<std::size_t>(count)
+	                             : std::max(1u, std::thread::hardware_concurrency() / 2);
+
+	if (const auto cpus = std::getenv("NEURALA_EXECUTOR_CPUS"))
+	{
+		settings.cpus = parseCpus(cpus);
+	}
+
+	return settings;
+}
+} // namespace
+
+Executor::Executor() : Executor(Settings{}) { }
+
+Executor::Executor(Settings settings)
+ : m_settings{std::move(settings)},
+   m_workers{m_settings.threads ? m_settings.threads
+                                : std::max(1u, std::thread::hardware_concurrency())},
+   m_queues{std::make_unique<Queue[]>(m_workers)}
+{
+	m_threads.reserve(m_workers);
+
+	try
+	{
+		for (std::size_t i = 0; i < m_workers; ++i)
+		{
+			m_threads.emplace_back(&Executor::run, this, i);
+		}
+	}
+	catch (...)
+	{
+		m_stopping.store(true, std::memory_order_release);
+		m_work.notifyAll();
+		for (auto& thread : m_threads)
+		{
+			thread.join();
+		}
+		throw;
+	}
+}
+
+Executor::~Executor() noexcept
+{
+	m_stopping.store(true, std::memory_order_release);
+	m_work.notifyAll();
+
+	for (auto& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+Executor&
+Executor::shared() noexcept
+{
+	static auto* const executor = new Executor(sharedSettings());
+	return *executor;
+}
+
+void
+Executor::submit(ETaskPriority priority, std::function<void()> task)
+{
+	auto& queue = isWorker() ? m_queues[t_index] : m_submitted;
+	const auto lane = static_cast<std::size_t>(priority);
+
+	{
+		std::scoped_lock lock(queue.mutex);
+		queue.lanes[lane].push_back(std::move(task));
+		queue.sizes[lane].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	m_queued.fetch_add(1, std::memory_order_seq_cst);
+	m_work.notifyOne();
+}
+
+bool
+Executor::isWorker() const noexcept
+{
+	return t_executor == this;
+}
+
+void
+Executor::run(std::size_t index) noexcept
+{
+	t_executor = this;
+	t_index = index;
+
+#if defined(NEURALA_OS_LINUX)
+	if (!m_settings.cpus.empty())
+	{
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(m_settings.cpus[index % m_settings.cpus.size()], &cpus);
+		// The worker runs on any CPU if it cannot be pinned, such as one out of the process' set.
+		::sched_setaffinity(0, sizeof(cpus), &cpus);
+	}
+#endif
+
+	std::function<void()> task;
+	for (;;)
+	{
+		m_work.wait([&] {
+			return take(index, task) || m_stopping.load(std::memory_order_acquire);
+		});
+
+		if (!task)
+		{
+			return;
+		}
+
+		task();
+		task = nullptr;
+	}
+}
+
+bool
+Executor::take(std::size_t index, std::function<void()>& task) noexcept
+{
+	if (m_queued.load(std::memory_order_seq_cst) == 0)
+	{
+		return false;
+	}
+
+	const auto pop = [&](Queue& queue, std::size_t lane, bool newest) {
+		if (queue.sizes[lane].load(std::memory_order_relaxed) == 0)
+		{
+			return false;
+		}
+
+		std::scoped_lock lock(queue.mutex);
+		auto& tasks = queue.lanes[lane];
+		if (tasks.empty())
+		{
+			return false;
+		}
+
+		if (newest)
+		{
+			task = std::move(tasks.back());
+			tasks.pop_back();
+		}
+		else
+		{
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+
+		queue.sizes[lane].fetch_sub(1, std::memory_order_relaxed);
+		m_queued.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	};
+
+	for (std::size_t lane = 0; lane < kLanes; ++lane)
+	{
+		if (pop(m_queues[index], lane, true))
+		{
+			return true;
+		}
+
+		if (pop(m_submitted, lane, false))
+		{
+			return true;
+		}
+
+		for (std::size_t i = 1; i < m_workers; ++i)
+		{
+			if (pop(m_queues[(index + i) % m_workers], lane, false))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+} // namespace neurala
@@ -0,0 +1,223 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include "neurala/image/views/StridedImageView.h"
+#include "neurala/video/PrefetchingVideoSource.h"
+#include "neurala/video/VideoSourceStatus.h"
+
+namespace neurala
+{
+FramePrefetcher::FramePrefetcher(VideoSource& source, std::size_t buffers)
+ : m_source{source}, m_metadata{source.metadata()}, m_buffers(buffers), m_ready(buffers)
+{
+	if (buffers < 2)
+	{
+		throw std::invalid_argument("Frames can only be prefetched with at least 2 buffers");
+	}
+
+	for (std::size_t i = buffers; i > 0; --i)
+	{
+		m_free.push_back(i - 1);
+	}
+
+	m_thread = std::thread(&FramePrefetcher::prefetch, this);
+}
+
+FramePrefetcher::~FramePrefetcher() noexcept
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_stopping = true;
+	}
+	m_freeCondition.notify_all();
+
+	m_thread.join();
+}
+
+const dto::ImageMetadata&
+FramePrefetcher::metadata() const noexcept
+{
+	return m_current == kNone ? m_metadata : m_buffers[m_current].frame.metadata();
+}
+
+std::error_code
+FramePrefetcher::nextFrame() noexcept
+{
+	std::unique_lock lock(m_mutex);
+
+	// The SDK is done with the frame handed out, so its buffer can acquire another one.
+	if (m_current != kNone)
+	{
+		m_free.push_back(m_current);
+		m_current = kNone;
+		m_freeCondition.notify_one();
+	}
+
+	m_readyCondition.wait(lock, [this] { return m_readyCount > 0; });
+
+	const auto index = m_ready[m_readyFirst];
+	m_readyFirst = (m_readyFirst + 1) % m_ready.size();
+	--m_readyCount;
+
+	const auto& buffer = m_buffers[index];
+	if (buffer.status)
+	{
+		// Failed acquisitions hold no frame.
+		m_free.push_back(index);
+		m_freeCondition.notify_one();
+		return buffer.status;
+	}
+
+	m_current = index;
+	return {};
+}
+
+dto::ImageView
+FramePrefetcher::frame() const noexcept
+{
+	return m_current == kNone ? dto::ImageView() : m_buffers[m_current].frame.view();
+}
+
+dto::ImageView
+FramePrefetcher::frame(std::byte* data, std::size_t capacity) const noexcept
+{
+	if (m_current == kNone)
+	{
+		return {};
+	}
+
+	const auto& frame = m_buffers[m_current].frame;
+	if (!data || capacity < frame.size())
+	{
+		return {};
+	}
+
+	std::memcpy(data, frame.data(), frame.size());
+	return {frame.metadata(), data};
+}
+
+std::error_code
+FramePrefetcher::execute(const std::string& action) noexcept
+{
+	std::scoped_lock lock(m_sourceMutex);
+	return m_source.execute(action);
+}
+
+void
+FramePrefetcher::acquire(Buffer& buffer) noexcept
+{
+	// The previous frame goes back to the pool, unless outputs keep it.
+	buffer.frame = {};
+	buffer.status = m_source.nextFrame();
+	if (buffer.status)
+	{
+		return;
+	}
+
+	try
+	{
+		buffer.frame = FramePool::shared().allocate(m_source.metadata());
+		if (!buffer.frame)
+		{
+			buffer.status = make_error_code(VideoSourceStatus::pixelFormatNotSupported());
+			return;
+		}
+
+		auto view = m_source.frame(buffer.frame.write(), buffer.frame.capacity());
+		if (!view.data())
+		{
+			// The metadata of the source may only catch up with the frame once it is requested, as
+			// when its resolution changes: a frame larger than the buffer is requested again.
+			const auto metadata = m_source.metadata();
+			const auto bytes = requiredBytes(metadata);
+			if (bytes > buffer.frame.capacity())
+			{
+				buffer.frame = FramePool::shared().allocate(metadata, bytes);
+				view = m_source.frame(buffer.frame.write(), buffer.frame.capacity());
+			}
+		}
+
+		if (!view.data())
+		{
+			buffer.frame = {};
+			buffer.status = make_error_code(VideoSourceStatus::error());
+			return;
+		}
+
+		// Frames are labelled by the view the source returned, which may describe them differently
+		// than its metadata, and are copied if the source did not write them to the buffer.
+		const auto bytes = requiredBytes(view.metadata());
+		if (view.data() != buffer.frame.data())
+		{
+			buffer.frame = FramePool::shared().share(view);
+		}
+		else if (!buffer.frame.describe(view.metadata(), bytes ? bytes : buffer.frame.size()))
+		{
+			buffer.frame = {};
+		}
+
+		if (!buffer.frame)
+		{
+			buffer.status = make_error_code(VideoSourceStatus::pixelFormatNotSupported());
+		}
+	}
+	catch (const std::bad_alloc&)
+	{
+		buffer.frame = {};
+		buffer.status = make_error_code(VideoSourceStatus::error());
+	}
+}
+
+void
+FramePrefetcher::prefetch() noexcept
+{
+	for (;;)
+	{
+		std::size_t index = kNone;
+		{
+			std::unique_lock lock(m_mutex);
+			m_freeCondition.wait(lock, [this] { return m_stopping || !m_free.empty(); });
+
+			if (m_stopping)
+			{
+				return;
+			}
+
+			index = m_free.back();
+			m_free.pop_back();
+		}
+
+		{
+			std::scoped_lock lock(m_sourceMutex);
+			acquire(m_buffers[index]);
+		}
+
+		{
+			std::scoped_lock lock(m_mutex);
+			m_ready[(m_readyFirst + m_readyCount) % m_ready.size()] = index;
+			++m_readyCount;
+		}
+		m_readyCondition.notify_one();
+	}
+}
+
+} // namespace neurala
@@ -0,0 +1,91 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <new>
+#include <utility>
+
+#include "neurala/video/ResizingVideoSource.h"
+
+namespace neurala
+{
+ResizingVideoSource::ResizingVideoSource(std::unique_ptr<VideoSource> source,
+                                         const Region& region,
+                                         std::size_t width,
+                                         std::size_t height,
+                                         EInterpolation interpolation,
+                                         std::size_t threads)
+ : m_source{std::move(source)}, m_resizer(region, width, height, interpolation, threads)
+{ }
+
+dto::ImageMetadata
+ResizingVideoSource::metadata() const noexcept
+{
+	auto metadata = m_source->metadata();
+	auto resized = m_resizer.metadata(metadata);
+	return resized.empty() ? metadata : resized;
+}
+
+std::error_code
+ResizingVideoSource::nextFrame() noexcept
+{
+	return m_source->nextFrame();
+}
+
+dto::ImageView
+ResizingVideoSource::frame() const noexcept
+{
+	const auto frame = m_source->frame();
+	const auto resized = m_resizer.metadata(frame.metadata());
+	if (resized.empty() || !frame.data())
+	{
+		return frame;
+	}
+
+	try
+	{
+		// The previous frame goes back to the pool, unless outputs keep it.
+		m_frame = FramePool::shared().allocate(resized);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return {};
+	}
+
+	return m_resizer(StridedImageView(frame), m_frame.write(), m_frame.size());
+}
+
+dto::ImageView
+ResizingVideoSource::frame(std::byte* data, std::size_t capacity) const noexcept
+{
+	const auto frame = m_source->frame();
+	if (m_resizer.metadata(frame.metadata()).empty() || !frame.data())
+	{
+		// The wrapped source copies the frames the resizer does not support.
+		return m_source->frame(data, capacity);
+	}
+
+	return m_resizer(StridedImageView(frame), data, capacity);
+}
+
+std::error_code
+ResizingVideoSource::execute(const std::string& action) noexcept
+{
+	return m_source->execute(action);
+}
+
+} // namespace neurala
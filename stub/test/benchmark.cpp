@@ -0,0 +1,269 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Measures the cost of normalizing the orientation of frames in a source, with the kernels of
+// each instruction set and with a naive per-pixel loop, against handing the frames out in their
+// native orientation, which only copies them. Results are written as JSON.
+//
+// Usage: image_benchmark [--frames count] [--output file]
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "neurala/image/Orientation.h"
+
+namespace
+{
+using namespace neurala;
+
+struct Resolution
+{
+	const char* name;
+	std::size_t width;
+	std::size_t height;
+};
+
+struct Format
+{
+	const char* name;
+	PixelFormat format;
+};
+
+constexpr Resolution kResolutions[] = {{"VGA", 640, 480},
+                                       {"FullHD", 1920, 1080},
+                                       {"4K", 3840, 2160}};
+
+constexpr Format kFormats[] = {
+  {"GRAY8", {EDatatype::uint8, EColorSpace::grayscale, ELayout::interleaved}},
+  {"RGB", {EDatatype::uint8, EColorSpace::RGB, ELayout::interleaved}},
+  {"RGBA", {EDatatype::uint8, EColorSpace::RGBA, ELayout::interleaved}}};
+
+constexpr EOrientation kOrientations[] = {EOrientation::topRight,
+                                          EOrientation::bottomRight,
+                                          EOrientation::bottomLeft,
+                                          EOrientation::leftTop,
+                                          EOrientation::rightTop,
+                                          EOrientation::rightBottom,
+                                          EOrientation::leftBottom};
+
+struct Options
+{
+	int frames = 50;
+	std::string output;
+};
+
+bool
+parseOptions(int argc, char** argv, Options& options)
+{
+	for (auto i = 1; i < argc; ++i)
+	{
+		const std::string argument = argv[i];
+
+		if (i + 1 == argc)
+		{
+			std::cerr << "Missing value for " << argument << '\n';
+			return false;
+		}
+
+		if (argument == "--frames")
+		{
+			options.frames = std::atoi(argv[++i]);
+		}
+		else if (argument == "--output")
+		{
+			options.output = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Unknown option " << argument << '\n';
+			return false;
+		}
+	}
+
+	return options.frames > 0;
+}
+
+/// Normalizes the packed image of @p source pixel by pixel, as a source would without kernels.
+void
+normalizeNaively(const StridedImageView& source, std::byte* output) noexcept
+{
+	const auto bytes = source.format().channels();
+	const auto w = source.width();
+	const auto h = source.height();
+	const auto transposed = isTransposed(source.format().orientation());
+	const auto data = source.plane(0).data;
+
+	for (std::size_t y = 0; y < (transposed ? w : h); ++y)
+	{
+		for (std::size_t x = 0; x < (transposed ? h : w); ++x)
+		{
+			std::size_t r = 0;
+			std::size_t c = 0;
+			switch (source.format().orientation())
+			{
+				case EOrientation::topRight:
+					r = y, c = w - 1 - x;
+					break;
+				case EOrientation::bottomRight:
+					r = h - 1 - y, c = w - 1 - x;
+					break;
+				case EOrientation::bottomLeft:
+					r = h - 1 - y, c = x;
+					break;
+				case EOrientation::leftTop:
+					r = x, c = y;
+					break;
+				case EOrientation::rightTop:
+					r = h - 1 - x, c = y;
+					break;
+				case EOrientation::rightBottom:
+					r = h - 1 - x, c = w - 1 - y;
+					break;
+				default:
+					r = x, c = w - 1 - y;
+					break;
+			}
+			std::memcpy(output, data + (r * w + c) * bytes, bytes);
+			output += bytes;
+		}
+	}
+}
+
+/// Returns the mean time taken by @p work over @p frames frames, in nanoseconds.
+template<class Work>
+double
+measure(int frames, Work work)
+{
+	// The first frame warms the caches up.
+	work();
+	const auto start = std::chrono::steady_clock::now();
+	for (auto i = 0; i < frames; ++i)
+	{
+		work();
+	}
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	return std::chrono::duration<double, std::nano>(elapsed).count() / frames;
+}
+
+void
+writeMethod(std::ostream& os, const char* name, double nanoseconds, std::size_t bytes)
+{
+	os << '"' << name << "\":{\"frameNs\":" << nanoseconds
+	   << ",\"bandwidthMBps\":" << bytes / nanoseconds * 1e3 << '}';
+}
+
+/// Runs a single configuration of the matrix and writes its results as a JSON object.
+void
+run(const Options& options,
+    const Resolution& resolution,
+    const Format& format,
+    EOrientation orientation,
+    std::ostream& os)
+{
+	const PixelFormat oriented{format.format.datatype(),
+	                           format.format.colorSpace(),
+	                           format.format.layout(),
+	                           orientation};
+	const auto bytes = oriented.frameBytes(resolution.width, resolution.height);
+	std::vector<std::byte> frame(bytes);
+	std::vector<std::byte> output(bytes);
+	for (std::size_t i = 0; i < bytes; ++i)
+	{
+		frame[i] = static_cast<std::byte>(i * 7);
+	}
+
+	const StridedImageView view(oriented.metadata(resolution.width, resolution.height), frame.data());
+
+	std::cerr << resolution.name << ' ' << format.name << ' ' << toString(orientation) << "...\n";
+
+	os << "{\"resolution\":\"" << resolution.name << "\",\"format\":\"" << format.name
+	   << "\",\"orientation\":\"" << toString(orientation) << "\",\"frameBytes\":" << bytes << ',';
+	const auto copy = [&] { view.copyTo(output.data(), bytes); };
+	const auto naive = [&] { normalizeNaively(view, output.data()); };
+	writeMethod(os, "native", measure(options.frames, copy), bytes);
+	os << ',';
+	writeMethod(os, "naive", measure(options.frames, naive), bytes);
+
+	for (const auto simd : {ESimd::scalar, ESimd::sse41, ESimd::avx2, ESimd::neon})
+	{
+		if (!isSupported(simd))
+		{
+			continue;
+		}
+
+		const auto nanoseconds = measure(options.frames, [&] {
+			normalizeOrientation(view, output.data(), bytes, simd);
+		});
+		os << ',';
+		writeMethod(os, std::string(toString(simd)).c_str(), nanoseconds, bytes);
+	}
+	os << '}';
+}
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+	Options options;
+
+	if (!parseOptions(argc, argv, options))
+	{
+		std::cerr << "Usage: " << argv[0] << " [--frames count] [--output file]\n";
+		return 1;
+	}
+
+	std::ofstream file;
+	if (!options.output.empty())
+	{
+		file.open(options.output);
+		if (!file)
+		{
+			std::cerr << "Could not open " << options.output << '\n';
+			return 1;
+		}
+	}
+
+	auto& os = options.output.empty() ? std::cout : file;
+	auto first = true;
+
+	os << "{\"frames\":" << options.frames << ",\"simd\":\"" << toString(bestSimd())
+	   << "\",\"results\":[";
+
+	for (const auto& resolution : kResolutions)
+	{
+		for (const auto& format : kFormats)
+		{
+			for (const auto orientation : kOrientations)
+			{
+				os << (first ? "" : ",");
+				run(options, resolution, format, orientation, os);
+				first = false;
+			}
+		}
+	}
+
+	os << "]}\n";
+	return 0;
+}
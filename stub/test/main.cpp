@@ -0,0 +1,1857 @@
+/*
+ * Copyright Neurala Inc. 2013-2025
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:  The above copyright notice and this
+ * permission notice (including the next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+ * NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "neurala/config/os.h"
+#include "neurala/image/ColorConversion.h"
+#include "neurala/image/FramePool.h"
+#include "neurala/image/Orientation.h"
+#include "neurala/image/PixelConversion.h"
+#include "neurala/image/PixelFormat.h"
+#include "neurala/image/Resize.h"
+#include "neurala/image/views/StridedImageView.h"
+#include "neurala/utils/AsyncResultsOutput.h"
+#include "neurala/utils/BlockPool.h"
+#include "neurala/utils/CompositeResultsOutput.h"
+#include "neurala/utils/EventCount.h"
+#include "neurala/utils/Executor.h"
+#include "neurala/utils/SpscRing.h"
+#include "neurala/utils/TripleBuffer.h"
+#include "neurala/video/PrefetchingVideoSource.h"
+#include "neurala/video/ResizingVideoSource.h"
+#include "neurala/video/VideoSourceStatus.h"
+
+#if defined(NEURALA_OS_LINUX)
+#include <sched.h>
+#endif
+
+namespace
+{
+using namespace neurala;
+
+int failures = 0;
+
+void
+check(bool condition, const std::string& what)
+{
+	if (!condition)
+	{
+		std::cerr << "FAILED: " << what << '\n';
+		++failures;
+	}
+}
+
+constexpr ESimd kSimds[] = {ESimd::scalar, ESimd::sse41, ESimd::avx2, ESimd::neon};
+
+/// Image whose planes have padded rows.
+struct Image
+{
+	std::vector<std::byte> bytes;
+	StridedImageView view;
+
+	Image(const PixelFormat& format, std::size_t width, std::size_t height, unsigned seed)
+	{
+		constexpr std::size_t kPadding = 7;
+		std::vector<std::size_t> offsets;
+		for (std::size_t i = 0; i < format.planes(); ++i)
+		{
+			const auto size = format.planeSize(i, width, height);
+			offsets.push_back(bytes.size());
+			bytes.resize(bytes.size() + (size.rowBytes + kPadding) * size.rows);
+		}
+
+		std::mt19937 generator(seed);
+		std::uniform_int_distribution<int> value(0, 255);
+		for (auto& byte : bytes)
+		{
+			byte = static_cast<std::byte>(value(generator));
+		}
+
+		std::vector<ImagePlane> planes;
+		for (std::size_t i = 0; i < format.planes(); ++i)
+		{
+			const auto size = format.planeSize(i, width, height);
+			const auto pitch = size.rowBytes + kPadding;
+			planes.push_back({bytes.data() + offsets[i], pitch, size.rowBytes, size.rows});
+		}
+		view = StridedImageView(
+		  format.metadata(width, height), planes.data(), planes.size(), format.channels());
+	}
+
+	std::uint8_t* plane(std::size_t i) const noexcept
+	{
+		return reinterpret_cast<std::uint8_t*>(const_cast<std::byte*>(view.plane(i).data));
+	}
+};
+
+/// Returns if every name of @p names parses back to its enumerator.
+template<class Enum, class Names, class Parse>
+constexpr bool
+namesParse(const Names& names, Parse parse)
+{
+	for (std::size_t i = 0; i < std::size(names); ++i)
+	{
+		if (parse(toString(static_cast<Enum>(i))) != static_cast<Enum>(i))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// The tables of names are indexed by the enumerators, and hold all of them.
+static_assert(std::size(detail::kDatatypes) == std::size_t(EDatatype::binary64) + 1);
+static_assert(std::size(detail::kColorSpaces) == std::size_t(EColorSpace::multispectral) + 1);
+static_assert(std::size(detail::kLayouts) == std::size_t(ELayout::semiplanar) + 1);
+static_assert(std::size(detail::kOrientations) == std::size_t(EOrientation::leftBottom) + 1);
+static_assert(namesParse<EDatatype>(detail::kDatatypes, parseDatatype));
+static_assert(namesParse<EColorSpace>(detail::kColorSpaces, parseColorSpace));
+static_assert(namesParse<ELayout>(detail::kLayouts, parseLayout));
+static_assert(namesParse<EOrientation>(detail::kOrientations, parseOrientation));
+static_assert(parseColorSpace("nv12") == EColorSpace::unknown
+              && toString(EColorSpace::unknown).empty());
+
+// Sizes of frames of odd sizes, whose chroma planes are rounded up.
+constexpr PixelFormat kI420{EDatatype::uint8, EColorSpace::YUV420, ELayout::planar};
+constexpr PixelFormat kNV12{EDatatype::uint8, EColorSpace::NV12, ELayout::semiplanar};
+constexpr PixelFormat kYUY2{EDatatype::uint8, EColorSpace::YUV422, ELayout::interleaved};
+constexpr PixelFormat kI422{EDatatype::uint8, EColorSpace::YUV422, ELayout::planar};
+static_assert(kRGB8.frameBytes(5, 3) == 45 && kRGB8.planes() == 1 && kRGB8.channels() == 3);
+static_assert(kI420.frameBytes(5, 3) == 15 + 6 + 6 && kI420.planes() == 3);
+static_assert(kI420.planeSize(2, 7, 5).rowBytes == 4 && kI420.planeSize(2, 7, 5).rows == 3);
+static_assert(kNV12.frameBytes(5, 3) == 15 + 12 && kNV12.planeSize(1, 5, 3).rowBytes == 6);
+static_assert(kYUY2.frameBytes(5, 3) == 36 && kYUY2.planeSize(0, 5, 3).rowBytes == 12);
+static_assert(kI422.frameBytes(5, 3) == 15 + 9 + 9);
+static_assert(PixelFormat{EDatatype::uint16, EColorSpace::YUV420, ELayout::planar}.frameBytes(5, 3)
+              == 54);
+static_assert(kI420.planeSize(3, 5, 3).bytes() == 0 && PixelFormat{}.frameBytes(5, 3) == 0);
+
+void
+testPixelFormat()
+{
+	const auto metadata = kNV12.metadata(5, 3);
+	check(metadata.datatype() == "uint8" && metadata.colorSpace() == "NV12"
+	        && metadata.layout() == "semiplanar" && metadata.orientation() == "topLeft"
+	        && PixelFormat::fromMetadata(metadata) == kNV12 && kNV12.known(),
+	      "pixel format converts to and from metadata");
+
+	const dto::ImageMetadata unknown{"uint12", 5, 3, "RGB", "tiled", "topLeft"};
+	const auto parsed = PixelFormat::fromMetadata(unknown);
+	check(parsed.datatype() == EDatatype::unknown && parsed.colorSpace() == EColorSpace::RGB
+	        && parsed.layout() == ELayout::unknown && !parsed.known()
+	        && parsed.frameBytes(5, 3) == 0,
+	      "unknown names give unknown members");
+
+	// Multispectral images take their number of channels from the caller.
+	const PixelFormat spectral{EDatatype::uint16, EColorSpace::multispectral, ELayout::planar};
+	const auto bands = PixelFormat::fromMetadata(spectral.metadata(4, 3), 5);
+	check(!spectral.known() && spectral.frameBytes(4, 3) == 0 && bands.known()
+	        && bands.channels() == 5 && bands.planes() == 5 && bands.frameBytes(4, 3) == 120
+	        && bands.planeSize(4, 4, 3).rowBytes == 8,
+	      "multispectral format has the planes of its channels");
+
+	const PixelFormat interleaved{
+	  EDatatype::uint8, EColorSpace::multispectral, ELayout::interleaved, EOrientation::topLeft, 7};
+	check(interleaved.planes() == 1 && interleaved.frameBytes(3, 2) == 42,
+	      "interleaved multispectral format has a single plane");
+
+	const auto fixed = PixelFormat::fromMetadata(kRGB8.metadata(2, 2), 5);
+	check(fixed.channels() == 3 && fixed == kRGB8, "color space fixes the number of channels");
+}
+
+void
+testStridedImageView()
+{
+	// A packed 5x3 NV12 frame: 15 bytes of luma, then 2 rows of 6 bytes of chroma.
+	std::vector<std::byte> packed(27);
+	for (std::size_t i = 0; i < packed.size(); ++i)
+	{
+		packed[i] = std::byte(i);
+	}
+	const StridedImageView view(dto::ImageView(kNV12.metadata(5, 3), packed.data()));
+	check(view.planes() == 2 && view.plane(1).data == packed.data() + 15
+	        && view.plane(1).rowBytes == 6 && view.plane(1).rows == 2 && !view.plane(2).data
+	        && view.requiredBytes() == 27 && view.packed()
+	        && view.imageView().data() == packed.data(),
+	      "packed view has the planes of its format");
+
+	// The same frame with its rows padded to 8 and then 16 bytes.
+	std::vector<std::byte> copies[2];
+	std::size_t index = 0;
+	for (const std::size_t pitch : {8, 16})
+	{
+		std::vector<std::byte> padded(pitch * 5, std::byte(0xff));
+		for (std::size_t y = 0; y < 5; ++y)
+		{
+			const auto rowBytes = y < 3 ? 5 : 6;
+			const auto offset = y < 3 ? y * 5 : 15 + (y - 3) * 6;
+			std::copy_n(packed.data() + offset, rowBytes, padded.data() + y * pitch);
+		}
+
+		const StridedImageView strided(kNV12.metadata(5, 3), padded.data(), pitch);
+		auto& copy = copies[index++];
+		copy.resize(27);
+		check(strided.plane(1).data == padded.data() + 3 * pitch && strided.plane(1).pitch == pitch
+		        && strided.requiredBytes() == 27 && !strided.packed()
+		        && !strided.imageView().data() && !strided.copyTo(copy.data(), 26).data()
+		        && strided.copyTo(copy.data(), copy.size()).data() == copy.data(),
+		      "padded view is copied to a large enough buffer");
+	}
+	check(copies[0] == packed && copies[1] == packed,
+	      "views with different pitches are packed the same way");
+
+	// Odd 4:2:2 rows hold a whole pair of pixels.
+	const std::vector<std::byte> yuy2(36);
+	const StridedImageView pairs(dto::ImageView(kYUY2.metadata(5, 3), yuy2.data()));
+	check(pairs.planes() == 1 && pairs.plane(0).rowBytes == 12 && pairs.requiredBytes() == 36,
+	      "4:2:2 view rounds its rows up to pairs of pixels");
+
+	// Planes past kMaxPlanes follow the last one stored.
+	const PixelFormat spectral{EDatatype::uint8, EColorSpace::multispectral, ELayout::planar};
+	std::vector<std::byte> bands(6 * 8);
+	const StridedImageView multispectral(dto::ImageView(spectral.metadata(4, 2), bands.data()), 6);
+	std::vector<std::byte> copy(bands.size());
+	check(multispectral.planes() == 6 && multispectral.plane(5).data == bands.data() + 40
+	        && multispectral.plane(5).rows == 2 && multispectral.requiredBytes() == 48
+	        && multispectral.copyTo(copy.data(), copy.size()).data() == copy.data(),
+	      "multispectral view has the planes of its channels");
+
+	const StridedImageView unknown(dto::ImageView(spectral.metadata(4, 2), bands.data()));
+	const StridedImageView none;
+	check(unknown.empty() && unknown.requiredBytes() == 0 && !unknown.plane(0).data
+	        && !unknown.copyTo(copy.data(), copy.size()).data() && none.empty()
+	        && !none.plane(0).data && !none.plane(5).data,
+	      "view of unknown format has no planes");
+}
+
+std::vector<std::byte>
+convert(const StridedImageView& source, EColorSpace colorSpace, ESimd simd)
+{
+	const auto format = convertedFormat(source.format(), colorSpace);
+	std::vector<std::byte> output(format.frameBytes(source.width(), source.height()));
+	if (!convertColor(source, colorSpace, output.data(), output.size(), simd).data())
+	{
+		output.clear();
+	}
+	return output;
+}
+
+void
+testSimd()
+{
+	check(isSupported(ESimd::scalar), "scalar kernels are always supported");
+	check(isSupported(bestSimd()), "the best instruction set is supported");
+	for (const auto simd : kSimds)
+	{
+		check(isSupported(supportedSimd(simd)),
+		      std::string(toString(simd)) + " falls back to a supported one");
+	}
+}
+
+/// Checks that every instruction set gives the same results, over sizes covering all tails.
+void
+testKernelsAgree()
+{
+	const struct
+	{
+		EColorSpace from;
+		ELayout layout;
+		EColorSpace to;
+	} conversions[] = {{EColorSpace::RGB, ELayout::interleaved, EColorSpace::BGR},
+	                   {EColorSpace::BGR, ELayout::interleaved, EColorSpace::RGB},
+	                   {EColorSpace::RGBA, ELayout::interleaved, EColorSpace::BGRA},
+	                   {EColorSpace::RGBA, ELayout::interleaved, EColorSpace::RGB},
+	                   {EColorSpace::BGRA, ELayout::interleaved, EColorSpace::RGB},
+	                   {EColorSpace::grayscale, ELayout::planar, EColorSpace::RGB},
+	                   {EColorSpace::YUV420, ELayout::planar, EColorSpace::RGB},
+	                   {EColorSpace::YUV420, ELayout::planar, EColorSpace::BGR},
+	                   {EColorSpace::NV12, ELayout::semiplanar, EColorSpace::RGB},
+	                   {EColorSpace::NV21, ELayout::semiplanar, EColorSpace::BGR},
+	                   {EColorSpace::YUV422, ELayout::interleaved, EColorSpace::RGB},
+	                   {EColorSpace::YUV422, ELayout::interleaved, EColorSpace::BGR},
+	                   {EColorSpace::bayerRG, ELayout::interleaved, EColorSpace::RGB},
+	                   {EColorSpace::bayerGR, ELayout::interleaved, EColorSpace::BGR},
+	                   {EColorSpace::bayerBG, ELayout::interleaved, EColorSpace::RGB},
+	                   {EColorSpace::bayerGB, ELayout::interleaved, EColorSpace::BGR}};
+
+	for (const auto& conversion : conversions)
+	{
+		const PixelFormat format{EDatatype::uint8, conversion.from, conversion.layout};
+
+		for (const std::size_t width : {2, 3, 17, 33, 66, 101})
+		{
+			const Image image(format, width, 5, static_cast<unsigned>(width));
+			const auto expected = convert(image.view, conversion.to, ESimd::scalar);
+			const auto name = std::string(toString(conversion.from)) + " to "
+			                  + std::string(toString(conversion.to)) + " at width " + std::to_string(width);
+
+			check(!expected.empty(), name + " is supported");
+			for (const auto simd : kSimds)
+			{
+				check(convert(image.view, conversion.to, simd) == expected,
+				      name + " with " + std::string(toString(simd)) + " matches scalar");
+			}
+		}
+	}
+}
+
+void
+testValues()
+{
+	const PixelFormat rgba{EDatatype::uint8, EColorSpace::RGBA, ELayout::interleaved};
+	const Image image(rgba, 40, 3, 1);
+	const auto rgb = convert(image.view, EColorSpace::RGB, bestSimd());
+	const auto bgra = convert(image.view, EColorSpace::BGRA, bestSimd());
+	auto swapped = true;
+	for (std::size_t y = 0; y < 3; ++y)
+	{
+		for (std::size_t x = 0; x < 40; ++x)
+		{
+			const auto pixel = reinterpret_cast<const std::byte*>(image.view.plane(0).row(y)) + 4 * x;
+			const auto i = y * 40 + x;
+			swapped = swapped && rgb[3 * i] == pixel[0] && rgb[3 * i + 2] == pixel[2]
+			          && bgra[4 * i] == pixel[2] && bgra[4 * i + 2] == pixel[0]
+			          && bgra[4 * i + 3] == pixel[3];
+		}
+	}
+	check(swapped, "alpha is dropped and channels are swapped");
+
+	// Black, white and red in BT.601 limited range.
+	const PixelFormat nv12{EDatatype::uint8, EColorSpace::NV12, ELayout::semiplanar};
+	const std::uint8_t yuv[][3] = {{16, 128, 128}, {235, 128, 128}, {81, 90, 240}};
+	const std::uint8_t expected[][3] = {{0, 0, 0}, {255, 255, 255}, {255, 0, 0}};
+	for (auto i = 0; i < 3; ++i)
+	{
+		Image frame(nv12, 64, 4, 2);
+		std::fill_n(frame.plane(0), frame.view.plane(0).size(), yuv[i][0]);
+		for (std::size_t y = 0; y < 2; ++y)
+		{
+			for (std::size_t x = 0; x < 32; ++x)
+			{
+				frame.plane(1)[y * frame.view.plane(1).pitch + 2 * x] = yuv[i][1];
+				frame.plane(1)[y * frame.view.plane(1).pitch + 2 * x + 1] = yuv[i][2];
+			}
+		}
+
+		const auto pixels = convert(frame.view, EColorSpace::RGB, bestSimd());
+		auto close = true;
+		for (std::size_t j = 0; j < pixels.size(); ++j)
+		{
+			close = close && std::abs(int(pixels[j]) - expected[i][j % 3]) <= 2;
+		}
+		check(close, "YUV color " + std::to_string(i) + " is converted");
+	}
+
+	// A mosaic of uniform colors gives uniform pixels.
+	Image mosaic({EDatatype::uint8, EColorSpace::bayerGB, ELayout::interleaved}, 50, 6, 3);
+	for (std::size_t y = 0; y < 6; ++y)
+	{
+		for (std::size_t x = 0; x < 50; ++x)
+		{
+			mosaic.plane(0)[y * mosaic.view.plane(0).pitch + x] = (x + y) % 2 == 0 ? 100 : y % 2 ? 200 : 50;
+		}
+	}
+	const auto pixels = convert(mosaic.view, EColorSpace::RGB, bestSimd());
+	auto uniform = true;
+	for (std::size_t i = 0; i < pixels.size(); i += 3)
+	{
+		uniform = uniform && pixels[i] == std::byte{200} && pixels[i + 1] == std::byte{100}
+		          && pixels[i + 2] == std::byte{50};
+	}
+	check(uniform, "uniform mosaic is interpolated");
+}
+
+void
+testRejections()
+{
+	const Image image(kRGB8, 8, 8, 4);
+	std::vector<std::byte> output(8 * 8 * 3);
+
+	const auto data = output.data();
+	check(convertColor(image.view, EColorSpace::BGR, data, output.size()).data(),
+	      "buffer is large enough");
+	check(!convertColor(image.view, EColorSpace::BGR, data, output.size() - 1).data(),
+	      "small buffer is rejected");
+	check(convertColor(image.view, EColorSpace::RGB, data, output.size()).data(),
+	      "identity is a copy");
+	check(!convertColor(image.view, EColorSpace::NV12, data, output.size()).data(),
+	      "RGB to NV12 is rejected");
+
+	const PixelFormat planar{EDatatype::uint8, EColorSpace::RGB, ELayout::planar};
+	const PixelFormat wide{EDatatype::uint16, EColorSpace::RGB, ELayout::interleaved};
+	check(convertedFormat(planar, EColorSpace::BGR).colorSpace() == EColorSpace::unknown,
+	      "planar RGB is rejected");
+	check(convertedFormat(wide, EColorSpace::BGR).colorSpace() == EColorSpace::unknown,
+	      "16-bit RGB is rejected");
+
+	const Image line({EDatatype::uint8, EColorSpace::bayerRG, ELayout::interleaved}, 8, 1, 5);
+	check(convert(line.view, EColorSpace::RGB, ESimd::scalar).empty(),
+	      "single row mosaic is rejected");
+}
+
+std::vector<std::byte>
+convert(const StridedImageView& source, const PixelConverter& converter)
+{
+	const auto format = converter.format(source.format());
+	std::vector<std::byte> output(format.frameBytes(source.width(), source.height()));
+	if (!converter(source, output.data(), output.size()).data())
+	{
+		output.clear();
+	}
+	return output;
+}
+
+/// Checks that every instruction set maps and transposes samples as the scalar kernels do.
+void
+testPixelKernelsAgree()
+{
+	const struct
+	{
+		EColorSpace colorSpace;
+		std::size_t channels;
+	} colorSpaces[] = {{EColorSpace::grayscale, 1},
+	                   {EColorSpace::multispectral, 2},
+	                   {EColorSpace::RGB, 3},
+	                   {EColorSpace::BGRA, 4},
+	                   {EColorSpace::multispectral, 5}};
+	const EDatatype datatypes[] = {EDatatype::uint8,
+	                               EDatatype::uint16,
+	                               EDatatype::binary16,
+	                               EDatatype::binary32,
+	                               EDatatype::binary64};
+	const WindowLevel windows[] = {{}, {-0.25, 1000.0, 2.2}, WindowLevel::fullRange(12)};
+	const ELayout layouts[] = {ELayout::planar, ELayout::interleaved};
+
+	for (const auto& colorSpace : colorSpaces)
+	{
+		for (const auto datatype : datatypes)
+		{
+			for (const auto from : layouts)
+			{
+				const PixelFormat format{
+				  datatype, colorSpace.colorSpace, from, EOrientation::topLeft, colorSpace.channels};
+
+				for (const auto to : layouts)
+				{
+					for (const auto& window : windows)
+					{
+						for (const std::size_t width : {3, 17, 33, 66})
+						{
+							// Random bytes make floating point samples of all kinds, NaN included.
+							const Image image(format, width, 3, static_cast<unsigned>(width));
+							const auto expected = convert(image.view, PixelConverter(to, window, ESimd::scalar));
+							const auto name = std::string(toString(datatype)) + ' '
+							                  + std::string(toString(colorSpace.colorSpace)) + ' '
+							                  + std::string(toString(from)) + " to "
+							                  + std::string(toString(to)) + " with gamma "
+							                  + std::to_string(window.gamma) + " at width "
+							                  + std::to_string(width);
+
+							check(!expected.empty(), name + " is supported");
+							for (const auto simd : kSimds)
+							{
+								check(convert(image.view, PixelConverter(to, window, simd)) == expected,
+								      name + " with " + std::string(toString(simd)) + " matches scalar");
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/// Returns the bytes of a packed image of @p samples.
+template<class T>
+std::vector<std::byte>
+samples(std::initializer_list<T> values)
+{
+	std::vector<std::byte> bytes(values.size() * sizeof(T));
+	std::memcpy(bytes.data(), values.begin(), bytes.size());
+	return bytes;
+}
+
+/// Returns the 8-bit grayscale samples converted from @p values.
+template<class T>
+std::vector<int>
+mapped(EDatatype datatype, std::initializer_list<T> values, const WindowLevel& window)
+{
+	const auto bytes = samples(values);
+	const PixelFormat format{datatype, EColorSpace::grayscale, ELayout::planar};
+	const StridedImageView view(format.metadata(values.size(), 1), bytes.data());
+	const auto output = convert(view, PixelConverter(ELayout::planar, window));
+	return std::vector<int>(reinterpret_cast<const std::uint8_t*>(output.data()),
+	                        reinterpret_cast<const std::uint8_t*>(output.data() + output.size()));
+}
+
+void
+testPixelValues()
+{
+	const auto nan = std::nan("");
+	check(mapped<std::uint16_t>(EDatatype::uint16, {0, 2048, 4095, 65535}, WindowLevel::fullRange(12))
+	        == std::vector<int>{0, 128, 255, 255},
+	      "12-bit samples are mapped");
+	check(mapped<std::uint16_t>(EDatatype::uint16, {99, 100, 150, 201}, WindowLevel::centered(150, 100))
+	        == std::vector<int>{0, 0, 128, 255},
+	      "16-bit samples are windowed");
+	check(mapped<float>(EDatatype::binary32, {-1.0f, 0.5f, 2.0f, float(nan)}, {})
+	        == std::vector<int>{0, 128, 255, 0},
+	      "single precision samples are mapped");
+	check(mapped<double>(EDatatype::binary64, {0.25, 1.0, nan}, {}) == std::vector<int>{64, 255, 0},
+	      "double precision samples are mapped");
+	// 1, 0.5 and the smallest subnormal half.
+	check(mapped<std::uint16_t>(EDatatype::binary16, {0x3c00, 0x3800, 0x0001}, {})
+	        == std::vector<int>{255, 128, 0},
+	      "half precision samples are mapped");
+	check(mapped<float>(EDatatype::binary32, {0.0f, 0.25f, 1.0f}, {0.0, 0.0, 2.0})
+	        == std::vector<int>{0, 128, 255},
+	      "gamma is applied");
+	check(mapped<std::uint8_t>(EDatatype::uint8, {0, 10, 20, 30}, {10.0, 20.0})
+	        == std::vector<int>{0, 0, 255, 255},
+	      "8-bit samples are windowed");
+
+	// Planar to interleaved and back.
+	const PixelFormat planar{EDatatype::uint16, EColorSpace::RGB, ELayout::planar};
+	const auto wide = samples<std::uint16_t>({0, 255, 510, 765, 1020, 1275});
+	const StridedImageView view(planar.metadata(2, 1), wide.data());
+	const auto interleaved = convert(view, PixelConverter(ELayout::interleaved, {0.0, 1275.0}));
+	check(std::vector<int>(reinterpret_cast<const std::uint8_t*>(interleaved.data()),
+	                       reinterpret_cast<const std::uint8_t*>(interleaved.data() + 6))
+	        == std::vector<int>{0, 102, 204, 51, 153, 255},
+	      "planar samples are interleaved");
+
+	const PixelFormat rgb{EDatatype::uint8, EColorSpace::RGB, ELayout::interleaved};
+	const StridedImageView packed(rgb.metadata(2, 1), interleaved.data());
+	const auto back = convert(packed, PixelConverter(ELayout::planar));
+	check(std::vector<int>(reinterpret_cast<const std::uint8_t*>(back.data()),
+	                       reinterpret_cast<const std::uint8_t*>(back.data() + 6))
+	        == std::vector<int>{0, 51, 102, 153, 204, 255},
+	      "interleaved samples are split into planes");
+}
+
+void
+testPixelRejections()
+{
+	const auto throws = [](ELayout layout, const WindowLevel& window) {
+		try
+		{
+			PixelConverter converter(layout, window);
+		}
+		catch (const std::invalid_argument&)
+		{
+			return true;
+		}
+		return false;
+	};
+	check(throws(ELayout::semiplanar, {}), "semiplanar output is rejected");
+	check(throws(ELayout::planar, {0.0, 0.0, 0.0}), "null gamma is rejected");
+	check(throws(ELayout::planar, {10.0, 5.0}), "empty window is rejected");
+
+	const PixelConverter converter(ELayout::interleaved);
+	const Image image({EDatatype::uint16, EColorSpace::RGB, ELayout::planar}, 8, 8, 6);
+	std::vector<std::byte> output(8 * 8 * 3);
+	check(converter(image.view, output.data(), output.size()).data(), "buffer is large enough");
+	check(!converter(image.view, output.data(), output.size() - 1).data(),
+	      "small buffer is rejected");
+
+	const Image nv12({EDatatype::uint8, EColorSpace::NV12, ELayout::semiplanar}, 8, 8, 7);
+	check(!converter(nv12.view, output.data(), output.size()).data(), "NV12 is rejected");
+
+	const Image gray({EDatatype::uint8, EColorSpace::grayscale, ELayout::planar}, 8, 8, 8);
+	check(!PixelConverter(ELayout::planar, {300.0})(gray.view, output.data(), output.size()).data(),
+	      "window above the 8-bit samples is rejected");
+}
+
+constexpr EOrientation kOrientations[] = {EOrientation::topLeft,
+                                          EOrientation::topRight,
+                                          EOrientation::bottomRight,
+                                          EOrientation::bottomLeft,
+                                          EOrientation::leftTop,
+                                          EOrientation::rightTop,
+                                          EOrientation::rightBottom,
+                                          EOrientation::leftBottom};
+
+std::vector<std::byte>
+normalize(const StridedImageView& source, ESimd simd)
+{
+	const auto format = normalizedFormat(source.format());
+	std::vector<std::byte> output(format.frameBytes(source.width(), source.height()));
+	if (!normalizeOrientation(source, output.data(), output.size(), simd).data())
+	{
+		output.clear();
+	}
+	return output;
+}
+
+/// Normalizes @p source pixel by pixel, following the definitions of the orientations.
+std::vector<std::byte>
+normalizeNaively(const StridedImageView& source)
+{
+	const auto& format = source.format();
+	std::vector<std::byte> output;
+
+	for (std::size_t i = 0; i < source.planes(); ++i)
+	{
+		const auto plane = source.plane(i);
+		const auto bytes = format.layout() == ELayout::interleaved
+		                     ? format.channels() * format.bytesPerElement()
+		                     : (format.layout() == ELayout::semiplanar && i > 0 ? 2 : 1)
+		                         * format.bytesPerElement();
+		const auto w = plane.rowBytes / bytes;
+		const auto h = plane.rows;
+		const auto transposed = isTransposed(format.orientation());
+
+		for (std::size_t y = 0; y < (transposed ? w : h); ++y)
+		{
+			for (std::size_t x = 0; x < (transposed ? h : w); ++x)
+			{
+				std::size_t r = 0;
+				std::size_t c = 0;
+				switch (format.orientation())
+				{
+					case EOrientation::topRight:
+						r = y, c = w - 1 - x;
+						break;
+					case EOrientation::bottomRight:
+						r = h - 1 - y, c = w - 1 - x;
+						break;
+					case EOrientation::bottomLeft:
+						r = h - 1 - y, c = x;
+						break;
+					case EOrientation::leftTop:
+						r = x, c = y;
+						break;
+					case EOrientation::rightTop:
+						r = h - 1 - x, c = y;
+						break;
+					case EOrientation::rightBottom:
+						r = h - 1 - x, c = w - 1 - y;
+						break;
+					case EOrientation::leftBottom:
+						r = x, c = w - 1 - y;
+						break;
+					default:
+						r = y, c = x;
+						break;
+				}
+				const auto pixel = plane.row(r) + c * bytes;
+				output.insert(output.end(), pixel, pixel + bytes);
+			}
+		}
+	}
+	return output;
+}
+
+/// Checks that every orientation is normalized as by the naive loop, with every instruction set.
+void
+testOrientationKernelsAgree()
+{
+	const PixelFormat formats[] = {
+	  {EDatatype::uint8, EColorSpace::grayscale, ELayout::interleaved},
+	  {EDatatype::uint16, EColorSpace::grayscale, ELayout::interleaved},
+	  {EDatatype::uint8, EColorSpace::RGB, ELayout::interleaved},
+	  {EDatatype::uint8, EColorSpace::BGRA, ELayout::interleaved},
+	  {EDatatype::uint8, EColorSpace::multispectral, ELayout::interleaved, EOrientation::topLeft, 5},
+	  {EDatatype::uint16, EColorSpace::RGB, ELayout::interleaved},
+	  {EDatatype::uint16, EColorSpace::RGBA, ELayout::interleaved},
+	  {EDatatype::binary32, EColorSpace::RGB, ELayout::interleaved},
+	  {EDatatype::binary32, EColorSpace::RGBA, ELayout::interleaved},
+	  {EDatatype::uint8, EColorSpace::RGB, ELayout::planar},
+	  {EDatatype::uint8, EColorSpace::YUV420, ELayout::planar},
+	  {EDatatype::uint8, EColorSpace::NV12, ELayout::semiplanar}};
+	const std::pair<std::size_t, std::size_t> sizes[] = {{1, 1}, {9, 17}, {70, 45}, {33, 64}};
+
+	for (const auto& base : formats)
+	{
+		for (const auto orientation : kOrientations)
+		{
+			const PixelFormat format{
+			  base.datatype(), base.colorSpace(), base.layout(), orientation, base.channels()};
+
+			for (const auto& [width, height] : sizes)
+			{
+				const Image image(format, width, height, static_cast<unsigned>(width + height));
+				const auto expected = normalizeNaively(image.view);
+				const auto name = std::string(toString(format.datatype())) + ' '
+				                  + std::string(toString(format.colorSpace())) + ' '
+				                  + std::string(toString(format.layout())) + ' '
+				                  + std::string(toString(orientation)) + ' ' + std::to_string(width)
+				                  + 'x' + std::to_string(height);
+
+				for (const auto simd : kSimds)
+				{
+					check(normalize(image.view, simd) == expected,
+					      name + " with " + std::string(toString(simd)) + " is normalized");
+				}
+			}
+		}
+	}
+}
+
+void
+testOrientationValues()
+{
+	// A frame turned a quarter clockwise to be upright.
+	const std::uint8_t pixels[] = {1, 2, 3, 4, 5, 6};
+	const PixelFormat format{
+	  EDatatype::uint8, EColorSpace::grayscale, ELayout::planar, EOrientation::rightTop};
+	const StridedImageView view(format.metadata(3, 2), pixels);
+	std::vector<std::byte> output(6);
+	const auto upright = normalizeOrientation(view, output.data(), output.size());
+
+	check(upright.metadata().width() == 2 && upright.metadata().height() == 3
+	        && upright.metadata().orientation() == "topLeft",
+	      "width and height of transposed frames are swapped");
+	check(output == std::vector<std::byte>{std::byte{4},
+	                                       std::byte{1},
+	                                       std::byte{5},
+	                                       std::byte{2},
+	                                       std::byte{6},
+	                                       std::byte{3}},
+	      "rightTop frames are turned clockwise");
+
+	check(!normalizeOrientation(view, output.data(), 5).data(), "small buffer is rejected");
+
+	const Image mosaic(
+	  {EDatatype::uint8, EColorSpace::bayerRG, ELayout::interleaved, EOrientation::topRight}, 8, 8, 9);
+	check(normalize(mosaic.view, ESimd::scalar).empty(), "flipped mosaic is rejected");
+
+	const Image upright8({EDatatype::uint8, EColorSpace::bayerRG, ELayout::interleaved}, 8, 8, 10);
+	check(!normalize(upright8.view, ESimd::scalar).empty(), "upright mosaic is copied");
+}
+
+std::vector<std::byte>
+resize(const StridedImageView& source, Resizer& resizer)
+{
+	const auto metadata = resizer.metadata(source.metadata(), source.format().channels());
+	std::vector<std::byte> output(source.format().frameBytes(metadata.width(), metadata.height()));
+	if (metadata.empty() || !resizer(source, output.data(), output.size()).data())
+	{
+		output.clear();
+	}
+	return output;
+}
+
+/// Resizes @p source pixel by pixel in double precision, following the definitions of the
+/// interpolations.
+std::vector<double>
+resizeNaively(const StridedImageView& source,
+              const Region& region,
+              std::size_t width,
+              std::size_t height,
+              EInterpolation interpolation)
+{
+	const auto& format = source.format();
+	std::vector<double> output;
+
+	for (std::size_t i = 0; i < source.planes(); ++i)
+	{
+		const auto plane = source.plane(i);
+		const std::size_t divisor = i > 0 && format.colorSpace() == EColorSpace::YUV420 ? 2
+		                            : i > 0 && format.layout() == ELayout::semiplanar ? 2
+		                                                                              : 1;
+		const std::size_t channels = format.layout() == ELayout::interleaved ? format.channels()
+		                             : divisor == 2 && format.layout() == ELayout::semiplanar
+		                               ? 2
+		                               : 1;
+		const auto x0 = region.x / divisor;
+		const auto y0 = region.y / divisor;
+		const auto w = region.width / divisor;
+		const auto h = region.height / divisor;
+		const auto resizedWidth = width / divisor;
+		const auto resizedHeight = height / divisor;
+		const auto sample = [&](std::size_t x, std::size_t y, std::size_t c) {
+			return static_cast<double>(
+			  std::to_integer<int>(plane.row(y0 + y)[(x0 + x) * channels + c]));
+		};
+		// Returns the overlap of [a, b) and [c, d).
+		const auto overlap = [](double a, double b, double c, double d) {
+			return std::max(0.0, std::min(b, d) - std::max(a, c));
+		};
+
+		for (std::size_t y = 0; y < resizedHeight; ++y)
+		{
+			for (std::size_t x = 0; x < resizedWidth; ++x)
+			{
+				for (std::size_t c = 0; c < channels; ++c)
+				{
+					const auto scaleX = double(w) / resizedWidth;
+					const auto scaleY = double(h) / resizedHeight;
+					double value = 0.0;
+
+					if (interpolation == EInterpolation::area)
+					{
+						for (std::size_t sy = 0; sy < h; ++sy)
+						{
+							const auto wy = overlap(y * scaleY, (y + 1) * scaleY, sy, sy + 1.0);
+							for (std::size_t sx = 0; sx < w && wy > 0.0; ++sx)
+							{
+								const auto wx = overlap(x * scaleX, (x + 1) * scaleX, sx, sx + 1.0);
+								value += wx * wy * sample(sx, sy, c);
+							}
+						}
+						value /= scaleX * scaleY;
+					}
+					else
+					{
+						const auto sx = std::clamp((x + 0.5) * scaleX - 0.5, 0.0, w - 1.0);
+						const auto sy = std::clamp((y + 0.5) * scaleY - 0.5, 0.0, h - 1.0);
+						const auto left = static_cast<std::size_t>(sx);
+						const auto top = static_cast<std::size_t>(sy);
+						const auto right = std::min(left + 1, w - 1);
+						const auto bottom = std::min(top + 1, h - 1);
+						const auto fx = sx - left;
+						const auto fy = sy - top;
+						value = (1 - fy) * ((1 - fx) * sample(left, top, c) + fx * sample(right, top, c))
+						        + fy * ((1 - fx) * sample(left, bottom, c) + fx * sample(right, bottom, c));
+					}
+					output.push_back(value);
+				}
+			}
+		}
+	}
+	return output;
+}
+
+/// Checks that images are resized as by the naive loop, whatever the instruction set and threads.
+void
+testResizeKernelsAgree()
+{
+	const PixelFormat formats[] = {
+	  {EDatatype::uint8, EColorSpace::grayscale, ELayout::interleaved},
+	  {EDatatype::uint8, EColorSpace::RGB, ELayout::interleaved},
+	  {EDatatype::uint8, EColorSpace::BGRA, ELayout::interleaved},
+	  {EDatatype::uint8, EColorSpace::multispectral, ELayout::interleaved, EOrientation::topLeft, 5},
+	  {EDatatype::uint8, EColorSpace::RGB, ELayout::planar},
+	  {EDatatype::uint8, EColorSpace::YUV420, ELayout::planar},
+	  {EDatatype::uint8, EColorSpace::NV12, ELayout::semiplanar}};
+	struct Case
+	{
+		std::size_t width;
+		std::size_t height;
+		Region region;
+		std::size_t resizedWidth;
+		std::size_t resizedHeight;
+	};
+	const Case cases[] = {{64, 48, {}, 16, 12},
+	                      {70, 90, {}, 24, 34},
+	                      {100, 60, {10, 4, 62, 40}, 40, 30},
+	                      {40, 36, {2, 2, 30, 30}, 76, 50},
+	                      {50, 40, {}, 50, 40},
+	                      {50, 40, {8, 6, 0, 0}, 0, 0}};
+
+	for (const auto& format : formats)
+	{
+		for (const auto& c : cases)
+		{
+			const Image image(format, c.width, c.height, static_cast<unsigned>(c.width + c.height));
+
+			for (const auto interpolation : {EInterpolation::area, EInterpolation::bilinear})
+			{
+				const auto name = std::string(toString(format.colorSpace())) + ' '
+				                  + std::string(toString(format.layout())) + ' '
+				                  + std::to_string(c.width) + 'x' + std::to_string(c.height) + " to "
+				                  + std::to_string(c.resizedWidth) + 'x'
+				                  + std::to_string(c.resizedHeight)
+				                  + (interpolation == EInterpolation::area ? " by area" : " bilinearly");
+
+				Resizer reference(
+				  c.region, c.resizedWidth, c.resizedHeight, interpolation, 1, ESimd::scalar);
+				const auto expected = resize(image.view, reference);
+				const auto region = reference.region(c.width, c.height);
+				const auto exact = resizeNaively(image.view,
+				                                 region,
+				                                 c.resizedWidth ? c.resizedWidth : region.width,
+				                                 c.resizedHeight ? c.resizedHeight : region.height,
+				                                 interpolation);
+
+				check(!expected.empty(), name + " is supported");
+
+				// Weights in fixed point round to the nearest, or next to it.
+				const auto tolerance = interpolation == EInterpolation::area ? 0.5 : 1.5;
+				auto close = expected.size() == exact.size();
+				for (std::size_t i = 0; close && i < exact.size(); ++i)
+				{
+					close = std::abs(std::to_integer<int>(expected[i]) - exact[i]) <= tolerance + 0.5;
+				}
+				check(close, name + " is close to the exact result");
+
+				for (const auto simd : kSimds)
+				{
+					for (const std::size_t threads : {1, 3})
+					{
+						Resizer resizer(
+						  c.region, c.resizedWidth, c.resizedHeight, interpolation, threads, simd);
+						check(resize(image.view, resizer) == expected,
+						      name + " with " + std::string(toString(simd)) + " and "
+						        + std::to_string(threads) + " threads is resized");
+					}
+				}
+			}
+		}
+	}
+}
+
+void
+testResizeValues()
+{
+	const std::uint8_t pixels[] = {0, 2, 10, 20, 4, 6, 30, 40, 1, 1, 255, 255, 1, 2, 255, 254};
+	const PixelFormat format{EDatatype::uint8, EColorSpace::grayscale, ELayout::planar};
+	const StridedImageView view(format.metadata(4, 4), pixels);
+	std::vector<std::byte> output(4);
+
+	Resizer half({}, 2, 2);
+	const auto reduced = half(view, output.data(), output.size());
+	check(reduced.metadata().width() == 2 && reduced.metadata().height() == 2,
+	      "reduced frames have the requested size");
+	check(output == std::vector<std::byte>{std::byte{3}, std::byte{25}, std::byte{1}, std::byte{255}},
+	      "areas are averaged, rounding to the nearest");
+
+	Resizer crop({1, 2, 2, 0});
+	check(crop(view, output.data(), output.size()).data()
+	        && output
+	             == std::vector<std::byte>{std::byte{1}, std::byte{255}, std::byte{2}, std::byte{255}},
+	      "regions up to the edge are cropped");
+
+	check(!half(view, output.data(), 3).data(), "small buffer is rejected");
+
+	Resizer outside({4, 0, 1, 1});
+	check(outside.metadata(view.metadata()).empty() && !outside(view, output.data(), 4).data(),
+	      "region outside the frame is rejected");
+
+	const Image yuv({EDatatype::uint8, EColorSpace::YUV420, ELayout::planar}, 8, 8, 11);
+	std::vector<std::byte> chroma(64);
+	check(!Resizer({1, 0, 4, 4})(yuv.view, chroma.data(), chroma.size()).data(),
+	      "region splitting chroma samples is rejected");
+	check(!Resizer({}, 5, 4)(yuv.view, chroma.data(), chroma.size()).data(),
+	      "odd size of YUV 4:2:0 frames is rejected");
+
+	const Image mosaic({EDatatype::uint8, EColorSpace::bayerRG, ELayout::interleaved}, 8, 8, 12);
+	check(Resizer({}, 4, 4).metadata(mosaic.view.metadata()).empty(), "mosaic is rejected");
+}
+
+/// Video source handing out the same frame.
+class StillSource : public VideoSource
+{
+public:
+	explicit StillSource(const StridedImageView& view) : m_view(view) { }
+
+	dto::ImageMetadata metadata() const noexcept override { return m_view.metadata(); }
+
+	std::error_code nextFrame() noexcept override
+	{
+		++frames;
+		return {};
+	}
+
+	dto::ImageView frame() const noexcept override { return m_view.imageView(); }
+
+	dto::ImageView frame(std::byte* data, std::size_t capacity) const noexcept override
+	{
+		++copies;
+		return m_view.copyTo(data, capacity);
+	}
+
+	std::error_code execute(const std::string& action) noexcept override
+	{
+		actions += action;
+		return {};
+	}
+
+	int frames = 0;
+	mutable int copies = 0;
+	std::string actions;
+
+private:
+	StridedImageView m_view;
+};
+
+void
+testResizingVideoSource()
+{
+	std::vector<std::uint8_t> pixels(48 * 32 * 3);
+	for (std::size_t i = 0; i < pixels.size(); ++i)
+	{
+		pixels[i] = static_cast<std::uint8_t>(i * 7);
+	}
+	const StridedImageView view(kRGB8.metadata(48, 32), pixels.data());
+
+	auto still = std::make_unique<StillSource>(view);
+	auto& inner = *still;
+	const ResizingVideoSource source(std::move(still), {8, 0, 32, 32}, 16, 16);
+	auto& mutableSource = const_cast<ResizingVideoSource&>(source);
+
+	check(source.metadata().width() == 16 && source.metadata().height() == 16
+	        && source.metadata().colorSpace() == "RGB",
+	      "resizing source reports the resized metadata");
+	check(!mutableSource.nextFrame() && inner.frames == 1, "resizing source forwards nextFrame()");
+	check(!mutableSource.execute("pause") && inner.actions == "pause",
+	      "resizing source forwards execute()");
+
+	Resizer resizer({8, 0, 32, 32}, 16, 16);
+	const auto expected = resize(view, resizer);
+	std::vector<std::byte> output(expected.size());
+	const auto frame = source.frame(output.data(), output.size());
+	check(frame.data() == output.data() && output == expected && inner.copies == 0,
+	      "resizing source resizes into the given buffer");
+
+	const auto kept = source.frame();
+	check(kept.data() && kept.metadata().width() == 16
+	        && std::memcmp(kept.data(), expected.data(), expected.size()) == 0,
+	      "resizing source keeps the resized frame");
+
+	const Image mosaic({EDatatype::uint8, EColorSpace::bayerRG, ELayout::interleaved}, 8, 8, 13);
+	const ResizingVideoSource passThrough(
+	  std::make_unique<StillSource>(mosaic.view), {}, 4, 4);
+	std::vector<std::byte> raw(64);
+	check(passThrough.metadata().width() == 8 && passThrough.frame(raw.data(), raw.size()).data(),
+	      "resizing source hands out unsupported frames as is");
+}
+
+/// Video source whose frames are filled with their number, failing to acquire some of them.
+class CountingSource : public VideoSource
+{
+public:
+	explicit CountingSource(int failing) : m_failing(failing) { }
+
+	dto::ImageMetadata metadata() const noexcept override { return kRGB8.metadata(4, 2); }
+
+	std::error_code nextFrame() noexcept override
+	{
+		if (++acquired == m_failing)
+		{
+			return make_error_code(VideoSourceStatus::timeout());
+		}
+		return {};
+	}
+
+	dto::ImageView frame() const noexcept override { return {}; }
+
+	dto::ImageView frame(std::byte* data, std::size_t capacity) const noexcept override
+	{
+		if (capacity < 24)
+		{
+			return {};
+		}
+		std::memset(data, acquired, 24);
+		return {metadata(), data};
+	}
+
+	std::error_code execute(const std::string& action) noexcept override
+	{
+		actions += action;
+		return {};
+	}
+
+	std::atomic<int> acquired{0};
+	std::string actions;
+
+private:
+	int m_failing;
+};
+
+void
+testPrefetchingVideoSource()
+{
+	auto counting = std::make_unique<CountingSource>(4);
+	auto& inner = *counting;
+	PrefetchingVideoSource<CountingSource, 3> source(std::move(counting));
+
+	check(source.metadata().width() == 4 && !source.frame().data(),
+	      "prefetching source reports the metadata of the source before the first frame");
+
+	std::vector<std::byte> copy(24);
+	for (auto i = 1; i <= 8; ++i)
+	{
+		const auto status = source.nextFrame();
+		if (i == 4)
+		{
+			check(status == VideoSourceStatus::timeout(), "failed acquisition is handed out in order");
+			continue;
+		}
+
+		const auto frame = source.frame();
+		const auto aligned = reinterpret_cast<std::uintptr_t>(frame.data()) % 64 == 0;
+		check(!status && frame.data() && aligned
+		        && *static_cast<const std::uint8_t*>(frame.data()) == i,
+		      "frame " + std::to_string(i) + " is handed out in order from an aligned buffer");
+		check(source.frame(copy.data(), copy.size()).data() == copy.data()
+		        && copy[23] == std::byte(i),
+		      "frame " + std::to_string(i) + " is copied");
+	}
+
+	// One buffer holds the frame handed out, the others are acquired ahead.
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (inner.acquired < 10 && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	check(inner.acquired == 10, "prefetching source acquires frames ahead, up to its buffers");
+
+	check(!source.execute("pause") && inner.actions == "pause",
+	      "prefetching source forwards execute()");
+	check(!source.frame(copy.data(), 23).data(), "small buffer is rejected");
+}
+
+/**
+ * @brief Video source whose frames change resolution, which its metadata only reports once they are
+ *        requested: 4 by 4 at first, 32 by 32 from the third one, 2 by 2 from the fifth one.
+ */
+class ResolutionSource : public VideoSource
+{
+public:
+	dto::ImageMetadata metadata() const noexcept override
+	{
+		return kRGB8.metadata(m_width, m_width);
+	}
+
+	std::error_code nextFrame() noexcept override
+	{
+		++acquired;
+		return {};
+	}
+
+	dto::ImageView frame() const noexcept override { return {}; }
+
+	dto::ImageView frame(std::byte* data, std::size_t capacity) const noexcept override
+	{
+		m_width = acquired >= 5 ? 2 : acquired >= 3 ? 32 : 4;
+		const auto metadata = kRGB8.metadata(m_width, m_width);
+		if (capacity < requiredBytes(metadata))
+		{
+			return {};
+		}
+		std::memset(data, acquired, requiredBytes(metadata));
+		return {metadata, data};
+	}
+
+	std::error_code execute(const std::string&) noexcept override { return {}; }
+
+	std::atomic<int> acquired{0};
+
+private:
+	mutable std::atomic<std::size_t> m_width{4};
+};
+
+void
+testPrefetchingResolutionChanges()
+{
+	PrefetchingVideoSource<ResolutionSource, 2> source(std::in_place);
+
+	std::vector<std::byte> copy(32 * 32 * 3);
+	for (auto i = 1; i <= 6; ++i)
+	{
+		const std::size_t width = i >= 5 ? 2 : i >= 3 ? 32 : 4;
+		const auto status = source.nextFrame();
+		const auto frame = source.frame();
+		check(!status && frame.data() && frame.metadata().width() == width
+		        && source.metadata().height() == width,
+		      "frame " + std::to_string(i) + " is described by the view of the source");
+		check(!source.frame(copy.data(), width * width * 3 - 1).data()
+		        && source.frame(copy.data(), width * width * 3).data()
+		        && copy[width * width * 3 - 1] == std::byte(i),
+		      "frame " + std::to_string(i) + " is sized by the view of the source");
+	}
+}
+
+/// What a RecordingOutput was given, with a gate holding it at the start of jobs.
+struct Recording
+{
+	std::vector<std::string> log;
+	// Strings of the results.
+	std::vector<const std::string*> strings;
+	std::vector<const void*> images;
+	std::atomic<std::size_t> entries{0};
+	std::atomic<bool> open{true};
+	std::atomic<bool> waiting{false};
+};
+
+/// Results output logging what it is given.
+class RecordingOutput : public ResultsOutput
+{
+public:
+	explicit RecordingOutput(Recording& recording) : m_recording(recording) { }
+
+	void onStart(std::string_view id) noexcept override
+	{
+		m_recording.waiting = true;
+		while (!m_recording.open)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		m_recording.log.push_back("start " + std::string(id));
+		++m_recording.entries;
+	}
+
+	void onStop(std::string_view id, ResultsOutputStatus status) noexcept override
+	{
+		m_recording.log.push_back("stop " + std::string(id) + ' ' + std::to_string(status));
+		++m_recording.entries;
+	}
+
+	void operator()(const std::string& metadata, const dto::ImageView* image) noexcept override
+	{
+		auto entry = metadata;
+		if (image)
+		{
+			entry += ':' + std::to_string(*image->dataAs<std::uint8_t>());
+		}
+		m_recording.log.push_back(entry);
+		m_recording.strings.push_back(&metadata);
+		m_recording.images.push_back(image ? image->data() : nullptr);
+		++m_recording.entries;
+	}
+
+private:
+	Recording& m_recording;
+};
+
+/// Starts a job whose start is held by the output, so that the next results fill the queue.
+template<class Output>
+void
+holdOutput(Output& output, Recording& recording)
+{
+	recording.open = false;
+	output.onStart("job");
+
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!recording.waiting && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+void
+testAsyncResultsOutput()
+{
+	using Log = std::vector<std::string>;
+
+	{
+		Recording recording;
+		std::uint64_t dropped = 0;
+		{
+			AsyncResultsOutput<RecordingOutput, EOverflowPolicy::block, 2> output(std::in_place,
+			                                                                       recording);
+			std::vector<std::uint8_t> frame(24);
+
+			output.onStart("job");
+			for (auto i = 0; i < 10; ++i)
+			{
+				std::fill(frame.begin(), frame.end(), std::uint8_t(i));
+				const dto::ImageView image(kRGB8.metadata(4, 2), frame.data());
+				output(std::to_string(i), &image);
+			}
+			output(std::string(1000, 'x'), nullptr);
+			output.onStop("job", ResultsOutputStatus::faulted());
+			dropped = output.dropped();
+		}
+
+		Log expected{"start job"};
+		for (auto i = 0; i < 10; ++i)
+		{
+			expected.push_back(std::to_string(i) + ':' + std::to_string(i));
+		}
+		expected.push_back(std::string(1000, 'x'));
+		expected.push_back("stop job 1");
+		check(recording.log == expected && dropped == 0,
+		      "blocking asynchronous output hands out everything in order, with copied frames");
+	}
+
+	{
+		Recording recording;
+		std::uint64_t dropped = 0;
+		{
+			AsyncResultsOutput<RecordingOutput, EOverflowPolicy::drop, 4, false> output(std::in_place,
+			                                                                            recording);
+			const std::vector<std::uint8_t> frame(24, 7);
+			const dto::ImageView image(kRGB8.metadata(4, 2), frame.data());
+
+			holdOutput(output, recording);
+			for (auto i = 0; i < 7; ++i)
+			{
+				output(std::to_string(i), &image);
+			}
+			dropped = output.dropped();
+			recording.open = true;
+		}
+
+		check(recording.log == Log{"start job", "0", "1", "2", "3"} && dropped == 3,
+		      "dropping asynchronous output drops the results of a full queue, without frames");
+	}
+
+	{
+		Recording recording;
+		std::uint64_t dropped = 0;
+		std::uint64_t coalesced = 0;
+		{
+			AsyncResultsOutput<RecordingOutput, EOverflowPolicy::coalesce, 4> output(std::in_place,
+			                                                                          recording);
+			holdOutput(output, recording);
+			for (auto i = 0; i < 7; ++i)
+			{
+				output(std::to_string(i), nullptr);
+			}
+			dropped = output.dropped();
+			coalesced = output.coalesced();
+			recording.open = true;
+		}
+
+		check(recording.log == Log{"start job", "0", "1", "2", "6"} && coalesced == 3 && dropped == 0,
+		      "coalescing asynchronous output replaces the last result of a full queue");
+	}
+
+	{
+		Recording recording;
+		std::uint64_t dropped = 0;
+		std::uint64_t coalesced = 0;
+		{
+			AsyncResultsOutput<RecordingOutput, EOverflowPolicy::coalesce, 4> output(std::in_place,
+			                                                                          recording);
+			holdOutput(output, recording);
+			output("0", nullptr);
+			output("1", nullptr);
+			output("2", nullptr);
+			output.onStop("job", ResultsOutputStatus::stopped());
+			output("3", nullptr);
+			dropped = output.dropped();
+			coalesced = output.coalesced();
+			recording.open = true;
+		}
+
+		check(recording.log == Log{"start job", "0", "1", "2", "stop job 0"} && coalesced == 0
+		        && dropped == 1,
+		      "coalescing asynchronous output never replaces the stop of a job");
+	}
+
+	{
+		// Several threads queue results at once.
+		constexpr auto kThreads = 4;
+		constexpr auto kResults = 2000;
+
+		Recording recording;
+		{
+			RecordingOutput inner(recording);
+			ResultsOutputWorker worker(inner, 8, EOverflowPolicy::block);
+			std::vector<std::thread> threads;
+			for (auto t = 0; t < kThreads; ++t)
+			{
+				threads.emplace_back([&worker, t] {
+					for (auto i = 0; i < kResults; ++i)
+					{
+						worker(std::to_string(t) + ' ' + std::to_string(i), nullptr);
+					}
+				});
+			}
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
+		}
+
+		std::vector<int> next(kThreads, 0);
+		auto ordered = recording.log.size() == std::size_t(kThreads * kResults);
+		for (const auto& entry : recording.log)
+		{
+			const auto t = std::stoi(entry);
+			ordered = ordered && std::stoi(entry.substr(entry.find(' '))) == next[t]++;
+		}
+		check(ordered, "results queued by several threads are handed out in order");
+	}
+
+	Recording recording;
+	RecordingOutput inner(recording);
+	auto rejected = false;
+	try
+	{
+		ResultsOutputWorker worker(inner, 1, EOverflowPolicy::drop);
+	}
+	catch (const std::invalid_argument&)
+	{
+		rejected = true;
+	}
+	check(rejected, "asynchronous output with a single slot is rejected");
+}
+
+void
+testCompositeResultsOutput()
+{
+	using Log = std::vector<std::string>;
+
+	Recording slow;
+	Recording first;
+	Recording second;
+	std::uint64_t dropped[3] = {};
+	auto others = false;
+	{
+		BasicCompositeResultsOutput<EOverflowPolicy::drop,
+		                            2,
+		                            RecordingOutput,
+		                            RecordingOutput,
+		                            RecordingOutput>
+		  output(std::make_unique<RecordingOutput>(slow),
+		         std::make_unique<RecordingOutput>(first),
+		         std::make_unique<RecordingOutput>(second));
+		std::vector<std::uint8_t> frame(24);
+
+		holdOutput(output, slow);
+
+		// The other outputs are given each result while the first one is held.
+		others = true;
+		for (std::size_t i = 0; i < 6; ++i)
+		{
+			std::fill(frame.begin(), frame.end(), std::uint8_t(i));
+			const dto::ImageView image(kRGB8.metadata(4, 2), frame.data());
+			output(std::to_string(i), &image);
+
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+			while ((first.entries < i + 2 || second.entries < i + 2)
+			       && std::chrono::steady_clock::now() < deadline)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			others = others && first.entries == i + 2 && second.entries == i + 2;
+		}
+		others = others && slow.entries == 0;
+
+		for (std::size_t i = 0; i < output.broadcaster().size(); ++i)
+		{
+			dropped[i] = output.broadcaster().worker(i).dropped();
+		}
+
+		slow.open = true;
+		output.onStop("job", ResultsOutputStatus::stopped());
+	}
+
+	Log expected{"start job"};
+	for (auto i = 0; i < 6; ++i)
+	{
+		expected.push_back(std::to_string(i) + ':' + std::to_string(i));
+	}
+	expected.push_back("stop job 0");
+
+	check(others && dropped[0] == 4 && dropped[1] == 0 && dropped[2] == 0,
+	      "composite output hands out results to the others while an output is held");
+	check(first.log == expected && second.log == expected,
+	      "composite output hands out every result in order");
+	check(slow.log == Log{"start job", "0:0", "1:1", "stop job 0"},
+	      "held output of a composite output only loses its own results");
+	check(first.strings == second.strings, "outputs of a composite output share a single copy");
+
+	// Every result is either handed out, dropped or coalesced by each output, even while all of
+	// them are held with full queues.
+	Recording held[2];
+	std::uint64_t lost[2] = {};
+	{
+		BasicCompositeResultsOutput<EOverflowPolicy::coalesce, 2, RecordingOutput, RecordingOutput>
+		  output(std::make_unique<RecordingOutput>(held[0]),
+		         std::make_unique<RecordingOutput>(held[1]));
+
+		held[1].open = false;
+		holdOutput(output, held[0]);
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (!held[1].waiting && std::chrono::steady_clock::now() < deadline)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		for (auto i = 0; i < 20; ++i)
+		{
+			output(std::to_string(i), nullptr);
+		}
+
+		for (std::size_t i = 0; i < 2; ++i)
+		{
+			const auto& worker = output.broadcaster().worker(i);
+			lost[i] = worker.dropped() + worker.coalesced();
+			held[i].open = true;
+		}
+		output.onStop("job", ResultsOutputStatus::stopped());
+	}
+
+	for (std::size_t i = 0; i < 2; ++i)
+	{
+		// The log holds the start and the stop of the job besides the results.
+		const auto& log = held[i].log;
+		check(log.size() - 2 + lost[i] == 20 && log[log.size() - 2] == "19",
+		      "held output of a composite output accounts for every result");
+	}
+}
+
+void
+testFramePool()
+{
+	FramePool pool;
+	const auto metadata = kRGB8.metadata(4, 2);
+	const std::byte* data = nullptr;
+	{
+		auto frame = pool.allocate(metadata);
+		const auto aligned =
+		  reinterpret_cast<std::uintptr_t>(frame.data()) % FramePool::kAlignment == 0;
+		check(frame && frame.size() == 24 && frame.metadata() == metadata && aligned
+		        && frame.useCount() == 1,
+		      "pool allocates aligned frames");
+
+		std::memset(frame.write(), 1, frame.size());
+		data = frame.data();
+
+		const auto kept = pool.share(frame.view());
+		check(kept.data() == data && frame.useCount() == 2,
+		      "frame of the pool is shared rather than copied");
+
+		auto* const written = frame.write();
+		written[0] = std::byte(2);
+		check(written != data && kept.data() == data && kept.data()[0] == std::byte(1)
+		        && frame.data()[1] == std::byte(1) && kept.useCount() == 1,
+		      "shared frame is copied on write");
+
+		const std::vector<std::uint8_t> plain(24, 3);
+		const auto copy = pool.share({metadata, plain.data()});
+		check(copy && copy.data() != static_cast<const void*>(plain.data())
+		        && copy.data()[23] == std::byte(3),
+		      "frame out of the pool is copied to the pool");
+
+		const PixelFormat spectral{EDatatype::uint8, EColorSpace::multispectral, ELayout::planar};
+		check(!pool.share({spectral.metadata(4, 2), plain.data()}) && !pool.allocate({}),
+		      "frame of unknown size is rejected");
+
+		// Outputs keep the frames of the shared pool rather than copy them.
+		const auto shared = FramePool::shared().allocate(metadata);
+		Recording recording;
+		{
+			RecordingOutput inner(recording);
+			ResultsOutputWorker worker(inner, 2, EOverflowPolicy::block);
+			const auto image = shared.view();
+			worker("kept", &image);
+		}
+		check(recording.images == std::vector<const void*>{shared.data()},
+		      "asynchronous output keeps frames of the shared pool");
+	}
+
+	const auto buffers = pool.buffers();
+	check(buffers == 3 && !pool.find(data), "frames go back to the pool");
+
+	{
+		const auto first = pool.allocate(metadata);
+		const auto second = pool.allocate(kRGB8.metadata(2, 2));
+		const auto third = pool.allocate(metadata);
+		check(pool.buffers() == buffers, "pool reuses the buffers of released frames");
+	}
+
+	const auto larger = pool.allocate(kRGB8.metadata(40, 20));
+	check(larger && larger.size() == 2400 && pool.buffers() == buffers,
+	      "frames of the same size class reuse released buffers");
+
+	check(pool.capacity(1) == 4096 && pool.capacity(4097) == 5120 && pool.capacity(8192) == 8192
+	        && pool.capacity(8193) == 10240 && pool.capacity(3840 * 2160 * 3) == 25165824,
+	      "pool rounds buffers to size classes");
+
+	// A 4K stream no longer allocates once its frames go back to the pool.
+	const auto uhd = kRGB8.metadata(3840, 2160);
+	{
+		const auto frame = pool.allocate(uhd);
+		const auto aligned =
+		  reinterpret_cast<std::uintptr_t>(frame.data()) % FramePool::kPageAlignment == 0;
+		check(aligned, "pool aligns large frames on pages");
+	}
+	const auto allocations = pool.allocations();
+	for (int i = 0; i < 8; ++i)
+	{
+		const auto frame = pool.allocate(uhd);
+		const auto next = pool.allocate(uhd);
+	}
+	check(pool.allocations() == allocations + 1, "pool allocates no frame in steady state");
+
+	FramePool::Settings settings;
+	settings.hugePages = true;
+	settings.retained = 2;
+	FramePool huge(settings);
+	{
+		std::vector<SharedFrame> frames;
+		for (int i = 0; i < 4; ++i)
+		{
+			frames.push_back(huge.allocate(kRGB8.metadata(1024, 768)));
+		}
+		const auto aligned = reinterpret_cast<std::uintptr_t>(frames[0].data())
+		                       % FramePool::kHugePageAlignment
+		                     == 0;
+		check(aligned && huge.capacity(frames[0].size()) == FramePool::kHugePageAlignment * 2,
+		      "pool rounds frames to huge pages");
+		check(huge.buffers() == 4, "pool allocates frames in use");
+	}
+	check(huge.buffers() == 2, "pool frees buffers past those it retains");
+}
+
+void
+testConcurrency()
+{
+	SpscRing<int, 4> ring;
+	auto pushed = true;
+	for (int i = 0; i < 4; ++i)
+	{
+		pushed &= ring.push(i);
+	}
+	int value = -1;
+	check(pushed && ring.full() && !ring.push(4) && ring.size() == 4, "ring holds its capacity");
+	check(ring.pop(value) && value == 0 && ring.push(4) && ring.pop(value) && value == 1,
+	      "ring hands out values in order");
+
+	EventCount event;
+	const auto start = std::chrono::steady_clock::now();
+	const auto timedOut = !event.waitFor(std::chrono::milliseconds(5), [] { return false; });
+	check(timedOut && std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(5),
+	      "wait times out");
+	check(event.waitFor(std::chrono::hours(1), [] { return true; }), "wait returns once ready");
+
+	// Both sides block on the ring, the producer when it is full and the consumer when it is empty.
+	constexpr std::uint64_t kValues = 100000;
+	SpscRing<std::uint64_t, 8> values;
+	EventCount pushedEvent;
+	EventCount poppedEvent;
+	std::thread producer([&] {
+		for (std::uint64_t i = 1; i <= kValues; ++i)
+		{
+			poppedEvent.wait([&] { return !values.full(); });
+			values.push(i);
+			pushedEvent.notifyAll();
+		}
+	});
+
+	auto ordered = true;
+	for (std::uint64_t i = 1; i <= kValues; ++i)
+	{
+		std::uint64_t next = 0;
+		pushedEvent.wait([&] { return values.pop(next); });
+		poppedEvent.notifyAll();
+		ordered &= next == i;
+	}
+	producer.join();
+	check(ordered && values.empty(), "ring passes values between threads in order");
+
+	// The reader waits for the latest value, which is never torn.
+	TripleBuffer<std::pair<std::uint64_t, std::uint64_t>> latest;
+	EventCount published;
+	std::atomic<bool> done{false};
+	std::thread writer([&] {
+		for (std::uint64_t i = 1; !done.load(std::memory_order_relaxed); ++i)
+		{
+			latest.back() = {i, i};
+			latest.publish();
+			published.notifyAll();
+		}
+	});
+
+	std::uint64_t last = 0;
+	auto consistent = true;
+	for (int i = 0; i < 1000; ++i)
+	{
+		consistent &= published.waitFor(std::chrono::seconds(10), [&] { return latest.read(); });
+		const auto [first, second] = latest.front();
+		consistent &= first == second && first > last;
+		last = first;
+	}
+	done = true;
+	writer.join();
+	check(consistent, "triple buffer hands out the latest values whole and in order");
+}
+
+/// Checks that executors run every task, urgent ones first, and that block pools run on them.
+void
+testExecutor()
+{
+	std::atomic<std::size_t> done{0};
+	EventCount finished;
+	const auto count = [&] {
+		done.fetch_add(1, std::memory_order_release);
+		finished.notifyAll();
+	};
+	const auto waitFor = [&](std::size_t tasks) {
+		return finished.waitFor(std::chrono::seconds(10), [&] { return done.load() == tasks; });
+	};
+
+	{
+		Executor executor({3, {}});
+		check(executor.threads() == 3 && !executor.isWorker(), "executor starts its workers");
+
+		for (int i = 0; i < 1000; ++i)
+		{
+			executor.submit(ETaskPriority::conversion, count);
+		}
+		check(waitFor(1000), "executor runs the tasks submitted");
+
+		// Tasks submitted from tasks are queued by their worker, and taken by the others.
+		done = 0;
+		std::function<void(int)> split = [&](int depth) {
+			if (depth == 0)
+			{
+				count();
+				return;
+			}
+			for (int i = 0; i < 2; ++i)
+			{
+				executor.submit(ETaskPriority::conversion, [&split, depth] { split(depth - 1); });
+			}
+		};
+		executor.submit(ETaskPriority::conversion, [&] { split(10); });
+		check(waitFor(1024), "executor runs the tasks submitted by its tasks");
+
+		auto worker = false;
+		done = 0;
+		executor.submit(ETaskPriority::output, [&] {
+			worker = executor.isWorker();
+			count();
+		});
+		check(waitFor(1) && worker, "tasks run on workers");
+	}
+
+	{
+		// The only worker is held while tasks of each lane are queued.
+		Executor executor({1, {}});
+		std::atomic<bool> release{false};
+		EventCount released;
+		done = 0;
+		executor.submit(ETaskPriority::output, [&] {
+			released.wait([&] { return release.load(); });
+		});
+
+		std::vector<ETaskPriority> order;
+		for (const auto priority :
+		     {ETaskPriority::output, ETaskPriority::conversion, ETaskPriority::capture})
+		{
+			executor.submit(priority, [&, priority] {
+				order.push_back(priority);
+				count();
+			});
+		}
+		release = true;
+		released.notifyAll();
+		check(waitFor(3)
+		        && order
+		             == std::vector{ETaskPriority::capture,
+		                            ETaskPriority::conversion,
+		                            ETaskPriority::output},
+		      "urgent tasks run first");
+
+		// A job run by a worker does not wait for the worker itself.
+		std::vector<int> blocks(100, 0);
+		done = 0;
+		executor.submit(ETaskPriority::conversion, [&] {
+			BlockPool(2, executor).run(blocks.size(), [&](std::size_t block) { ++blocks[block]; });
+			count();
+		});
+		check(waitFor(1) && std::all_of(blocks.begin(), blocks.end(), [](int b) { return b == 1; }),
+		      "block pool runs on a busy executor");
+	}
+
+	{
+		done = 0;
+		{
+			Executor executor({2, {}});
+			for (int i = 0; i < 100; ++i)
+			{
+				executor.submit(ETaskPriority::output, count);
+			}
+		}
+		check(done == 100, "executor runs all its tasks before it stops");
+	}
+
+	{
+		Executor executor({4, {}});
+		BlockPool pool(8, executor);
+		std::vector<std::atomic<int>> blocks(1000);
+		pool.run(blocks.size(), [&](std::size_t block) { blocks[block].fetch_add(1); });
+		check(pool.threads() == 5
+		        && std::all_of(blocks.begin(), blocks.end(), [](const auto& b) { return b == 1; }),
+		      "block pool processes each block once");
+	}
+
+#if defined(NEURALA_OS_LINUX)
+	cpu_set_t allowed;
+	if (::sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+	{
+		unsigned cpu = 0;
+		while (!CPU_ISSET(cpu, &allowed))
+		{
+			++cpu;
+		}
+
+		Executor executor({1, {cpu}});
+		std::atomic<int> ran{-1};
+		done = 0;
+		executor.submit(ETaskPriority::capture, [&] {
+			ran = ::sched_getcpu();
+			count();
+		});
+		check(waitFor(1) && ran == static_cast<int>(cpu), "workers are pinned to their CPU");
+	}
+#endif
+}
+} // namespace
+
+int
+main()
+{
+	testPixelFormat();
+	testStridedImageView();
+	testSimd();
+	testKernelsAgree();
+	testValues();
+	testRejections();
+	testPixelKernelsAgree();
+	testPixelValues();
+	testPixelRejections();
+	testOrientationKernelsAgree();
+	testOrientationValues();
+	testResizeKernelsAgree();
+	testResizeValues();
+	testResizingVideoSource();
+	testPrefetchingVideoSource();
+	testPrefetchingResolutionChanges();
+	testAsyncResultsOutput();
+	testCompositeResultsOutput();
+	testFramePool();
+	testConcurrency();
+	testExecutor();
+
+	if (failures)
+	{
+		std::cerr << failures << " image processing tests failed\n";
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "All image processing tests passed (" << toString(bestSimd()) << ")\n";
+	return EXIT_SUCCESS;
+}